@@ -29,6 +29,7 @@
 #include <iomanip>
 #include <vector>
 #include <unistd.h>
+#include <stdint.h>
 
 #ifdef HAVE_SYSLOG_H
 #include <syslog.h>
@@ -162,7 +163,7 @@ namespace ibrcommon
 
 	void LogWriter::removeStream(std::ostream &stream)
 	{
-		for (std::list<LoggerOutput>::iterator iter = _logger.begin(); iter != _logger.end(); ++iter)
+		for (std::list<LoggerOutput>::iterator iter = _logger.begin(); iter != _logger.end();)
 		{
 			const LoggerOutput &output = (*iter);
 
@@ -170,6 +171,10 @@ namespace ibrcommon
 			{
 				iter = _logger.erase(iter);
 			}
+			else
+			{
+				++iter;
+			}
 		}
 	}
 
@@ -422,7 +427,8 @@ namespace ibrcommon
 				_stream << ": ";
 			}
 
-			_stream << log.str() << std::endl;
+			// streams are flushed once per batch of messages
+			_stream << log.str() << '\n';
 		}
 	}
 
@@ -435,9 +441,14 @@ namespace ibrcommon
 	{
 	}
 
-	void Logger::enableAsync()
+	void Logger::enableAsync(size_t size)
+	{
+		LogWriter::getInstance().enableAsync(size);
+	}
+
+	size_t Logger::getDropped()
 	{
-		LogWriter::getInstance().enableAsync();
+		return LogWriter::getInstance().getDropped();
 	}
 
 	void Logger::enableBuffer(size_t size)
@@ -453,9 +464,11 @@ namespace ibrcommon
 		LogWriter::getInstance().writeBuffer(stream, logmask, options);
 	}
 
-	void LogWriter::enableAsync()
+	void LogWriter::enableAsync(size_t size)
 	{
 		try {
+			if (_ring == NULL) _ring = new LogRing(size);
+			_running = true;
 			_use_queue = true;
 			start();
 		} catch (const ibrcommon::ThreadException &ex) {
@@ -472,6 +485,9 @@ namespace ibrcommon
 	{
 		// stop the LogWriter::run() thread (this is needed with uclibc)
 		LogWriter::getInstance().stop();
+
+		// wait until all queued messages are written
+		LogWriter::getInstance().join();
 	}
 
 	void Logger::reload()
@@ -507,9 +523,9 @@ namespace ibrcommon
 	}
 
 	LogWriter::LogWriter()
-	 : _global_logmask(0), _verbosity(0), _syslog(0), _syslog_mask(0), _queue(50), _use_queue(false), _buffer_size(0), _buffer(NULL),
+	 : _global_logmask(0), _verbosity(0), _syslog(0), _syslog_mask(0), _ring(NULL), _use_queue(false), _sleeping(false), _running(false),
+	   _dropped(0), _dropped_reported(0), _buffer_size(0), _buffer(NULL),
 	   _logfile_output(NULL), _logfile_logmask(0), _logfile_options(0), _default_tag("Core"), _android_tag_prefix("IBR-DTN/")
-	// limit queue to 50 entries
 	{
 	}
 
@@ -521,6 +537,9 @@ namespace ibrcommon
 		// join the LogWriter::run() thread
 		join();
 
+		_use_queue = false;
+		if (_ring != NULL) delete _ring;
+
 		// remove the ring-buffer
 		ibrcommon::MutexLock l(_buffer_mutex);
 		if (_buffer != NULL) delete _buffer;
@@ -624,56 +643,233 @@ namespace ibrcommon
 	{
 		if (_use_queue)
 		{
-			_queue.push(logger);
+			bool queued = _ring->push(logger);
+
+			// severe messages wait up to 100 ms for a free slot,
+			// all others are dropped immediately if the buffer is full
+			for (int i = 0; !queued && (logger.getLevel() <= Logger::LOGGER_WARNING) && (i < 100); ++i)
+			{
+				ibrcommon::Thread::sleep(1);
+				queued = _ring->push(logger);
+			}
+
+			if (!queued)
+			{
+				__sync_add_and_fetch(&_dropped, 1);
+				return;
+			}
+
+			// wake-up the writer only if it is sleeping
+			__sync_synchronize();
+			if (_sleeping)
+			{
+				ibrcommon::MutexLock l(_ring_cond);
+				_ring_cond.signal(true);
+			}
 		}
 		else
 		{
 			flush(logger);
+			flushStreams();
 		}
 	}
 
-	void LogWriter::run() throw ()
+	size_t LogWriter::getDropped() const
 	{
-		try {
-			while (true)
-			{
-				Logger log = _queue.poll();
-				flush(log);
+		return _dropped;
+	}
 
-				// add to ring-buffer
-				ibrcommon::MutexLock l(_buffer_mutex);
-				if (_buffer != NULL)
+	void LogWriter::flushStreams()
+	{
+		for (std::list<LoggerOutput>::iterator iter = _logger.begin(); iter != _logger.end(); ++iter)
+		{
+			(*iter)._stream.flush();
+		}
+
+		ibrcommon::MutexLock l(_logfile_mutex);
+		if (_logfile_output != NULL)
+		{
+			_logfile_stream.flush();
+		}
+	}
+
+	void LogWriter::reportDropped()
+	{
+		const size_t dropped = _dropped;
+		if (dropped == _dropped_reported) return;
+
+		std::stringstream ss;
+		ss << (dropped - _dropped_reported) << " log messages dropped";
+		_dropped_reported = dropped;
+
+		Logger logger = Logger::warning("LogWriter");
+		logger.setMessage(ss.str());
+		flush(logger);
+	}
+
+	size_t LogWriter::drain(Logger &logger, size_t limit)
+	{
+		size_t count = 0;
+
+		while ((count < limit) && _ring->pop(logger))
+		{
+			flush(logger);
+			count++;
+
+			// add to ring-buffer
+			ibrcommon::MutexLock l(_buffer_mutex);
+			if (_buffer != NULL)
+			{
+				_buffer->push_back(logger);
+				while (_buffer->size() > _buffer_size)
 				{
-					_buffer->push_back(log);
-					while (_buffer->size() > _buffer_size)
-					{
-						_buffer->pop_front();
-					}
+					_buffer->pop_front();
 				}
 			}
-		} catch (const std::exception&) {
-			ibrcommon::Queue<Logger>::Locked q = _queue.exclusive();
+		}
 
-			try {
-				// In this block we will write all remaining element in the queue
-				// to the logging streams. While we do this, the queue should be locked
-				// and finally we abort the queue to unblock all waiting threads.
-				while (!q.empty())
-				{
-					Logger &log = q.front();
-					try { flush(log); } catch (const std::exception&) {};
+		return count;
+	}
 
-					q.pop();
-				}
-			} catch (const std::exception&) {
+	void LogWriter::run() throw ()
+	{
+		// container for the messages taken out of the ring-buffer
+		Logger logger(Logger::LOGGER_INFO, "");
 
+		while (true)
+		{
+			// write messages in batches and flush the streams once per batch
+			if (drain(logger, 256) > 0)
+			{
+				reportDropped();
+				flushStreams();
+				continue;
 			}
+
+			ibrcommon::MutexLock l(_ring_cond);
+			if (!_running) break;
+
+			_sleeping = true;
+			__sync_synchronize();
+
+			try {
+				// the timeout covers wake-ups missed by the producers
+				if (_ring->empty()) _ring_cond.wait(100);
+			} catch (const ibrcommon::Conditional::ConditionalAbortException&) { }
+
+			_sleeping = false;
 		}
+
+		// write all remaining messages, further messages are logged synchronously
+		_use_queue = false;
+		while (drain(logger, 256) > 0) { }
+
+		reportDropped();
+		flushStreams();
 	}
 
 	void LogWriter::__cancellation() throw ()
 	{
 		// cancel the main thread in here
-		_queue.abort();
+		ibrcommon::MutexLock l(_ring_cond);
+		_running = false;
+		_ring_cond.signal(true);
+	}
+
+	/**
+	 * Returns the next power of two greater or equal to size
+	 */
+	static size_t __ring_capacity(size_t size)
+	{
+		size_t ret = 2;
+		while (ret < size) ret <<= 1;
+		return ret;
+	}
+
+	LogWriter::LogRing::LogRing(size_t size)
+	 : _slots(NULL), _mask(__ring_capacity(size) - 1), _enqueue(0), _dequeue(0)
+	{
+		_slots = new Slot[_mask + 1];
+
+		for (size_t i = 0; i <= _mask; ++i)
+		{
+			_slots[i].sequence = i;
+			_slots[i].level = Logger::LOGGER_INFO;
+			_slots[i].debug_verbosity = 0;
+		}
+	}
+
+	LogWriter::LogRing::~LogRing()
+	{
+		delete [] _slots;
+	}
+
+	bool LogWriter::LogRing::push(Logger &logger)
+	{
+		size_t pos = _enqueue;
+		Slot *slot = NULL;
+
+		// claim a slot, its sequence equals the position if it is free
+		while (true)
+		{
+			slot = &_slots[pos & _mask];
+			const size_t sequence = slot->sequence;
+			__sync_synchronize();
+
+			const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+			if (diff == 0)
+			{
+				if (__sync_bool_compare_and_swap(&_enqueue, pos, pos + 1)) break;
+				pos = _enqueue;
+			}
+			else if (diff < 0)
+			{
+				// the slot is not consumed yet, the buffer is full
+				return false;
+			}
+			else
+			{
+				// another producer claimed this slot
+				pos = _enqueue;
+			}
+		}
+
+		slot->level = logger._level;
+		slot->tag.assign(logger._tag);
+		slot->debug_verbosity = logger._debug_verbosity;
+		slot->logtime = logger._logtime;
+		slot->data.swap(logger._data);
+
+		// publish the message to the consumer
+		__sync_synchronize();
+		slot->sequence = pos + 1;
+
+		return true;
+	}
+
+	bool LogWriter::LogRing::pop(Logger &logger)
+	{
+		Slot &slot = _slots[_dequeue & _mask];
+		if (slot.sequence != (_dequeue + 1)) return false;
+		__sync_synchronize();
+
+		logger._level = slot.level;
+		logger._tag.assign(slot.tag);
+		logger._debug_verbosity = slot.debug_verbosity;
+		logger._logtime = slot.logtime;
+		logger._data.swap(slot.data);
+
+		// release the slot for the next round of producers
+		__sync_synchronize();
+		slot.sequence = _dequeue + _mask + 1;
+		_dequeue++;
+
+		return true;
+	}
+
+	bool LogWriter::LogRing::empty() const
+	{
+		return (_slots[_dequeue & _mask].sequence != (_dequeue + 1));
 	}
 }
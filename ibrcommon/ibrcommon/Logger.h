@@ -23,6 +23,7 @@
 #define LOGGER_H_
 
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/Conditional.h>
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/data/File.h>
 #include <fstream>
@@ -217,12 +218,21 @@ namespace ibrcommon
 
 		/**
 		 * enable the asynchronous logging
-		 * This starts a separate thread and a thread-safe queue to
+		 * This starts a separate thread and a pre-allocated ring-buffer to
 		 * queue all logging messages first and call the log routine by
 		 * the thread. This option is necessary, if the stream to log into
 		 * are not thread-safe by itself.
+		 * If the ring-buffer is full, messages of the levels notice, info and
+		 * debug are dropped immediately. More severe messages wait a bounded
+		 * time for a free slot before they get dropped.
+		 * @param size The number of messages the ring-buffer can hold.
 		 */
-		static void enableAsync();
+		static void enableAsync(size_t size = 1024);
+
+		/**
+		 * Returns the number of messages dropped due to a full ring-buffer
+		 */
+		static size_t getDropped();
 
 		/**
 		 * Enables the internal ring-buffer.
@@ -279,10 +289,12 @@ namespace ibrcommon
 		struct timeval getLogTime() const;
 
 	private:
+		friend class LogWriter;
+
 		Logger(LogLevel level, const std::string &tag, int debug_verbosity = 0);
 
 		LogLevel _level;
-		const std::string _tag;
+		std::string _tag;
 		int _debug_verbosity;
 		struct timeval _logtime;
 
@@ -346,12 +358,14 @@ namespace ibrcommon
 
 		/**
 		 * enable the asynchronous logging
-		 * This starts a seperate thread and a thread-safe queue to
-		 * queue all logging messages first and call the log routine by
-		 * the thread. This option is nessacary, if the stream to log into
-		 * are not thread-safe by itself.
+		 * @see Logger::enableAsync()
 		 */
-		void enableAsync();
+		void enableAsync(size_t size);
+
+		/**
+		 * Returns the number of messages dropped due to a full ring-buffer
+		 */
+		size_t getDropped() const;
 
 		/**
 		 * Enables the internal ring-buffer.
@@ -386,6 +400,53 @@ namespace ibrcommon
 		void __cancellation() throw ();
 
 	private:
+		/**
+		 * Bounded ring-buffer of log messages with multiple producers and
+		 * a single consumer. Producers claim a slot with an atomic operation
+		 * and never block, thus a full buffer is reported to the caller.
+		 */
+		class LogRing
+		{
+		public:
+			LogRing(size_t size);
+			~LogRing();
+
+			/**
+			 * Move the message of the logger into the buffer.
+			 * @return False, if the buffer is full.
+			 */
+			bool push(Logger &logger);
+
+			/**
+			 * Move the oldest message into the logger.
+			 * Must be called by the consumer thread only.
+			 * @return False, if the buffer is empty.
+			 */
+			bool pop(Logger &logger);
+
+			/**
+			 * Returns true, if there is no message to consume
+			 */
+			bool empty() const;
+
+		private:
+			struct Slot
+			{
+				volatile size_t sequence;
+				Logger::LogLevel level;
+				std::string tag;
+				int debug_verbosity;
+				struct timeval logtime;
+				std::string data;
+			};
+
+			Slot *_slots;
+			const size_t _mask;
+
+			volatile size_t _enqueue;
+			size_t _dequeue;
+		};
+
 		class LoggerOutput
 		{
 		public:
@@ -409,13 +470,38 @@ namespace ibrcommon
 		 */
 		void flush(const Logger &logger);
 
+		/**
+		 * Flush all output streams
+		 */
+		void flushStreams();
+
+		/**
+		 * Write up to limit messages of the ring-buffer to the outputs
+		 * @return The number of written messages
+		 */
+		size_t drain(Logger &logger, size_t limit);
+
+		/**
+		 * Log a message about messages dropped since the last report
+		 */
+		void reportDropped();
+
 		unsigned char _global_logmask;
 		int _verbosity;
 		bool _syslog;
 		unsigned char _syslog_mask;
 
-		ibrcommon::Queue<Logger> _queue;
+		LogRing *_ring;
 		bool _use_queue;
+
+		// wake-up of the writer thread, producers signal only if it sleeps
+		ibrcommon::Conditional _ring_cond;
+		volatile bool _sleeping;
+		bool _running;
+
+		// number of dropped messages
+		volatile size_t _dropped;
+		size_t _dropped_reported;
 		std::list<LoggerOutput> _logger;
 
 		ibrcommon::Mutex _buffer_mutex;
@@ -29,6 +29,7 @@
 #include <cstring>
 #include <cerrno>
 #include <vector>
+#include <unistd.h>
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
 #include <cassert>
@@ -36,9 +37,6 @@
 
 namespace ibrcommon
 {
-	// maximum of concurrent opened files
-	ibrcommon::Semaphore BLOB::_filelimit(10);
-
 	// default BLOB provider - memory based; auto deletion enabled
 	ibrcommon::BLOB::ProviderRef BLOB::provider(new ibrcommon::MemoryBLOBProvider(), true);
 
@@ -50,6 +48,11 @@ namespace ibrcommon
 	{
 	}
 
+	const ibrcommon::File* BLOB::__get_file() const
+	{
+		return NULL;
+	}
+
 	std::streamsize BLOB::size() const
 	{
 		return _const_size;
@@ -300,26 +303,19 @@ namespace ibrcommon
 
 	void FileBLOB::open()
 	{
-		BLOB::_filelimit.wait();
-
 		// open the file
-		_filestream.open(_file.getPath().c_str(), ios::in|ios::binary);
+		_filestream.open(_file, false);
 
 		if (!_filestream.is_open())
 		{
-			// Release semaphore on failed file open
-			ibrcommon::BLOB::_filelimit.post();
-
 			throw ibrcommon::CanNotOpenFileException(_file);
 		}
 	}
 
 	void FileBLOB::close()
 	{
-		// close the file
+		// return the file descriptor to the cache
 		_filestream.close();
-
-		BLOB::_filelimit.post();
 	}
 
 	std::streamsize FileBLOB::__get_size()
@@ -327,44 +323,46 @@ namespace ibrcommon
 		return _file.size();
 	}
 
-	void FileBLOBProvider::TmpFileBLOB::clear()
+	const ibrcommon::File* FileBLOB::__get_file() const
 	{
-		// close the file
-		_filestream.close();
-
-		// open temporary file
-		_filestream.open(_tmpfile.getPath().c_str(), ios::in | ios::out | ios::trunc | ios::binary );
+		return &_file;
+	}
 
-		if (!_filestream.is_open())
+	void FileBLOBProvider::TmpFileBLOB::clear()
+	{
+		if (_filestream.is_open())
+		{
+			// discard the content of the temporary file
+			_filestream.truncate();
+		}
+		else if (::truncate(_tmpfile.getPath().c_str(), 0) != 0)
 		{
-			IBRCOMMON_LOGGER_TAG("TmpFileBLOB::clear", error) << "can not open temporary file " << _tmpfile.getPath() << IBRCOMMON_LOGGER_ENDL;
+			IBRCOMMON_LOGGER_TAG("TmpFileBLOB::clear", error) << "can not truncate temporary file " << _tmpfile.getPath() << IBRCOMMON_LOGGER_ENDL;
 			throw ibrcommon::CanNotOpenFileException(_tmpfile);
 		}
 	}
 
 	FileBLOBProvider::TmpFileBLOB::TmpFileBLOB(const File &tmppath)
-	 : BLOB(), _filestream(), _fd(0), _tmpfile(tmppath, "blob")
+	 : BLOB(), _filestream(), _tmpfile(tmppath, "blob")
 	{
 	}
 
 	FileBLOBProvider::TmpFileBLOB::~TmpFileBLOB()
 	{
+		_filestream.close();
+
 		// delete the file if the last reference is destroyed
+		FileCache::getInstance().invalidate(_tmpfile);
 		_tmpfile.remove();
 	}
 
 	void FileBLOBProvider::TmpFileBLOB::open()
 	{
-		BLOB::_filelimit.wait();
-
 		// open temporary file
-		_filestream.open(_tmpfile.getPath().c_str(), ios::in | ios::out | ios::binary );
+		_filestream.open(_tmpfile, true);
 
 		if (!_filestream.is_open())
 		{
-			// Release semaphore on failed file open
-			ibrcommon::BLOB::_filelimit.post();
-
 			IBRCOMMON_LOGGER_TAG("TmpFileBLOB::open", error) << "can not open temporary file " << _tmpfile.getPath() << IBRCOMMON_LOGGER_ENDL;
 			throw ibrcommon::CanNotOpenFileException(_tmpfile);
 		}
@@ -372,17 +370,19 @@ namespace ibrcommon
 
 	void FileBLOBProvider::TmpFileBLOB::close()
 	{
-		// flush the filestream
-		_filestream.flush();
-
-		// close the file
+		// write buffered data and return the file descriptor to the cache
 		_filestream.close();
-
-		BLOB::_filelimit.post();
 	}
 
 	std::streamsize FileBLOBProvider::TmpFileBLOB::__get_size()
 	{
+		// include buffered data
+		_filestream.flush();
 		return _tmpfile.size();
 	}
+
+	const ibrcommon::File* FileBLOBProvider::TmpFileBLOB::__get_file() const
+	{
+		return &_tmpfile;
+	}
 }
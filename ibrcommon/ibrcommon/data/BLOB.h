@@ -25,7 +25,7 @@
 #include "ibrcommon/thread/Mutex.h"
 #include "ibrcommon/thread/MutexLock.h"
 #include "ibrcommon/data/File.h"
-#include "ibrcommon/thread/Semaphore.h"
+#include "ibrcommon/data/CachedFileStream.h"
 #include "ibrcommon/refcnt_ptr.h"
 #include <iostream>
 #include <sstream>
@@ -44,11 +44,6 @@ namespace ibrcommon
 	class BLOB : public Mutex
 	{
 	public:
-		/**
-		 * This is the global limit for open file handles in BLOBs
-		 */
-		static ibrcommon::Semaphore _filelimit;
-
 		/**
 		 * copy a stream to another stream
 		 */
@@ -102,6 +97,16 @@ namespace ibrcommon
 			{
 				_blob.clear();
 			}
+
+			/**
+			 * Returns the file holding the data of the BLOB or NULL if the
+			 * data is not stored in a file. Pending writes are flushed first.
+			 */
+			const ibrcommon::File* file()
+			{
+				_stream.flush();
+				return _blob.__get_file();
+			}
 		};
 
 		class Reference
@@ -195,6 +200,7 @@ namespace ibrcommon
 
 		virtual std::streamsize __get_size() = 0;
 		virtual std::iostream &__get_stream() = 0;
+		virtual const ibrcommon::File* __get_file() const;
 
 	private:
 		BLOB(const BLOB &ref); // forbidden copy constructor
@@ -202,8 +208,8 @@ namespace ibrcommon
 	};
 
 	/**
-	 * A FileBLOB is a read only BLOB object. It is based on a fstream object, but
-	 * denies write access. This could be used to easy access static files.
+	 * A FileBLOB is a read only BLOB object. It is based on a CachedFileStream object
+	 * and denies write access. This could be used to easy access static files.
 	 */
 	class FileBLOB : public ibrcommon::BLOB
 	{
@@ -223,9 +229,10 @@ namespace ibrcommon
 		}
 
 		std::streamsize __get_size();
+		const ibrcommon::File* __get_file() const;
 
 	private:
-		std::fstream _filestream;
+		ibrcommon::CachedFileStream _filestream;
 		File _file;
 	};
 
@@ -278,8 +285,8 @@ namespace ibrcommon
 
 		/**
 		 * A TmpFileBLOB creates a temporary file on instantiation to hold a large amount
-		 * of data. It is based on fstream objects and limited by the system architecture
-		 * (max. 2GB on 32-bit systems).
+		 * of data. It is based on CachedFileStream objects and limited by the system
+		 * architecture (max. 2GB on 32-bit systems).
 		 */
 		class TmpFileBLOB : public BLOB
 		{
@@ -299,10 +306,10 @@ namespace ibrcommon
 			}
 
 			std::streamsize __get_size();
+			const ibrcommon::File* __get_file() const;
 
 		private:
-			std::fstream _filestream;
-			int _fd;
+			ibrcommon::CachedFileStream _filestream;
 			TemporaryFile _tmpfile;
 		};
 	};
@@ -27,6 +27,12 @@
 #include <limits>
 #include <math.h>
 
+#ifdef __GNUC__
+#define __bloom_prefetch(addr) __builtin_prefetch(addr)
+#else
+#define __bloom_prefetch(addr)
+#endif
+
 namespace ibrcommon
 {
 	HashProvider::~HashProvider()
@@ -64,21 +70,45 @@ namespace ibrcommon
 
 	const std::list<bloom_type> DefaultHashProvider::hash(const unsigned char* begin, std::size_t remaining_length) const
 	{
-		std::list<bloom_type> hashes;
+		bloom_type values[salt_max];
+		hash(begin, remaining_length, values);
+		return std::list<bloom_type>(values, values + _salt.size());
+	}
+
+	void DefaultHashProvider::hash(const unsigned char* begin, std::size_t remaining_length, bloom_type *hashes) const
+	{
+		// this is hash_ap() for all salts at once
+		const std::size_t n = _salt.size();
+		std::copy(_salt.begin(), _salt.end(), hashes);
 
-		for (std::vector<bloom_type>::const_iterator iter = _salt.begin(); iter != _salt.end(); ++iter)
+		const unsigned char* it = begin;
+		while (remaining_length >= 2)
 		{
-			hashes.push_back(hash_ap(begin, remaining_length, (*iter)));
-		}
+			const unsigned char c1 = *it++;
+			const unsigned char c2 = *it++;
 
-		return hashes;
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				bloom_type h = hashes[i];
+				h ^=    (h <<  7) ^  c1 * (h >> 3);
+				h ^= (~((h << 11) + (c2 ^ (h >> 5))));
+				hashes[i] = h;
+			}
+			remaining_length -= 2;
+		}
+		if (remaining_length)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				hashes[i] ^= (hashes[i] <<  7) ^ (*it) * (hashes[i] >> 3);
+			}
+		}
 	}
 
 
 	void DefaultHashProvider::generate_salt()
 	{
-		const unsigned int predef_salt_count = 64;
-		static const bloom_type predef_salt[predef_salt_count] =
+		static const bloom_type predef_salt[salt_max] =
 									{
 										  0xAAAAAAAA, 0x55555555, 0x33333333, 0xCCCCCCCC,
 										  0x66666666, 0x99999999, 0xB5B5B5B5, 0x4B4B4B4B,
@@ -98,7 +128,7 @@ namespace ibrcommon
 										  0x15B6796C, 0x1D6FDFE4, 0x63FF9092, 0xE7401432
 									};
 
-		if (salt_count_ > predef_salt_count)
+		if (salt_count_ > salt_max)
 		{
 			throw ibrcommon::Exception("Max. 64 hash salts supported!");
 		}
@@ -191,11 +221,12 @@ namespace ibrcommon
 		std::size_t bit_index = 0;
 		std::size_t bit = 0;
 
-		std::list<bloom_type> hashes = _hashp.hash(key_begin, length);
+		bloom_type hashes[DefaultHashProvider::salt_max];
+		_hashp.hash(key_begin, length, hashes);
 
-		for (std::list<bloom_type>::iterator iter = hashes.begin(); iter != hashes.end(); ++iter)
+		for (std::size_t i = 0; i < _hashp.count(); ++i)
 		{
-			compute_indices( (*iter), bit_index, bit );
+			compute_indices( hashes[i], bit_index, bit );
 			bit_table_[bit_index / bits_per_char] |= bit_mask[bit];
 		}
 
@@ -217,11 +248,12 @@ namespace ibrcommon
 		std::size_t bit_index = 0;
 		std::size_t bit = 0;
 
-		const std::list<bloom_type> hashes = _hashp.hash(key_begin, length);
+		bloom_type hashes[DefaultHashProvider::salt_max];
+		_hashp.hash(key_begin, length, hashes);
 
-		for (std::list<bloom_type>::const_iterator iter = hashes.begin(); iter != hashes.end(); ++iter)
+		for (std::size_t i = 0; i < _hashp.count(); ++i)
 		{
-			compute_indices( (*iter), bit_index, bit );
+			compute_indices( hashes[i], bit_index, bit );
 			if ((bit_table_[bit_index / bits_per_char] & bit_mask[bit]) != bit_mask[bit])
 			{
 				return false;
@@ -231,6 +263,52 @@ namespace ibrcommon
 		return true;
 	}
 
+	std::size_t BloomFilter::contains_many(const unsigned char* const* keys, const std::size_t* lengths, std::size_t count, bool* result) const
+	{
+		static const std::size_t batch_size = 16;
+		const std::size_t salts = _hashp.count();
+
+		std::size_t bit_index[batch_size * DefaultHashProvider::salt_max];
+		std::size_t bit[batch_size * DefaultHashProvider::salt_max];
+		bloom_type hashes[DefaultHashProvider::salt_max];
+		std::size_t found = 0;
+
+		for (std::size_t offset = 0; offset < count; offset += batch_size)
+		{
+			const std::size_t batch = std::min(batch_size, count - offset);
+
+			// hash all keys of the batch and prefetch the table cells
+			for (std::size_t k = 0; k < batch; ++k)
+			{
+				_hashp.hash(keys[offset + k], lengths[offset + k], hashes);
+
+				for (std::size_t i = 0; i < salts; ++i)
+				{
+					const std::size_t idx = k * salts + i;
+					compute_indices( hashes[i], bit_index[idx], bit[idx] );
+					__bloom_prefetch(bit_table_ + (bit_index[idx] / bits_per_char));
+				}
+			}
+
+			// test the bits
+			for (std::size_t k = 0; k < batch; ++k)
+			{
+				bool ret = true;
+
+				for (std::size_t i = 0; ret && (i < salts); ++i)
+				{
+					const std::size_t idx = k * salts + i;
+					ret = ((bit_table_[bit_index[idx] / bits_per_char] & bit_mask[bit[idx]]) == bit_mask[bit[idx]]);
+				}
+
+				result[offset + k] = ret;
+				if (ret) ++found;
+			}
+		}
+
+		return found;
+	}
+
 	bool BloomFilter::contains(const std::string& key) const
 	{
 		return contains(reinterpret_cast<const unsigned char*>(key.c_str()),key.size());
@@ -363,4 +441,193 @@ namespace ibrcommon
 	{
 		return estimateAllocation(_itemcount, table_size_);
 	}
+
+	BlockedBloomFilter::BlockedBloomFilter(std::size_t table_size, std::size_t salt_count)
+	 : _hashp(2), _buffer(NULL), bit_table_(NULL), blocks_(0), _itemcount(0), salt_count_(salt_count)
+	{
+		alloc((table_size + block_size - 1) / block_size);
+	}
+
+	BlockedBloomFilter::BlockedBloomFilter(const BlockedBloomFilter& filter)
+	 : _hashp(2), _buffer(NULL), bit_table_(NULL), blocks_(0), _itemcount(filter._itemcount), salt_count_(filter.salt_count_)
+	{
+		alloc(filter.blocks_);
+		std::copy(filter.bit_table_, filter.bit_table_ + size(), bit_table_);
+	}
+
+	BlockedBloomFilter::~BlockedBloomFilter()
+	{
+		delete[] _buffer;
+	}
+
+	BlockedBloomFilter& BlockedBloomFilter::operator=(const BlockedBloomFilter& filter)
+	{
+		if (this == &filter) return *this;
+
+		salt_count_ = filter.salt_count_;
+		_itemcount = filter._itemcount;
+		alloc(filter.blocks_);
+		std::copy(filter.bit_table_, filter.bit_table_ + size(), bit_table_);
+		return *this;
+	}
+
+	void BlockedBloomFilter::alloc(std::size_t blocks)
+	{
+		if ((_buffer == NULL) || (blocks != blocks_))
+		{
+			delete[] _buffer;
+
+			// allocate one more block to align the table to the block size
+			_buffer = new cell_type[(blocks + 1) * block_size];
+			const std::size_t misalign = reinterpret_cast<std::size_t>(_buffer) % block_size;
+			bit_table_ = _buffer + ((block_size - misalign) % block_size);
+			blocks_ = blocks;
+		}
+
+		std::fill_n(bit_table_, size(), 0x00);
+	}
+
+	void BlockedBloomFilter::load(const cell_type* data, size_t len)
+	{
+		if ((len % block_size) != 0)
+		{
+			throw ibrcommon::Exception("table length is not a multiple of the block size");
+		}
+
+		alloc(len / block_size);
+		std::copy(data, data + len, bit_table_);
+		_itemcount = 0;
+	}
+
+	bool BlockedBloomFilter::operator!() const
+	{
+		return (0 == blocks_);
+	}
+
+	void BlockedBloomFilter::clear()
+	{
+		std::fill_n(bit_table_, size(), 0x00);
+		_itemcount = 0;
+	}
+
+	std::size_t BlockedBloomFilter::locate(const unsigned char* key_begin, const std::size_t length, bloom_type &h) const
+	{
+		bloom_type hashes[2];
+		_hashp.hash(key_begin, length, hashes);
+
+		h = hashes[1];
+		return (hashes[0] % blocks_) * block_size;
+	}
+
+	void BlockedBloomFilter::insert(const unsigned char* key_begin, const std::size_t length)
+	{
+		if (blocks_ == 0) return;
+
+		bloom_type h = 0;
+		cell_type *block = bit_table_ + locate(key_begin, length, h);
+
+		// double hashing within the block, the odd step visits distinct bits
+		const bloom_type step = (h >> 9) | 1;
+		for (std::size_t i = 0; i < salt_count_; ++i)
+		{
+			const bloom_type pos = (h + static_cast<bloom_type>(i) * step) % (block_size * 8);
+			block[pos / 8] |= static_cast<cell_type>(1 << (pos % 8));
+		}
+
+		if (_itemcount < std::numeric_limits<unsigned int>::max()) _itemcount++;
+	}
+
+	void BlockedBloomFilter::insert(const std::string& key)
+	{
+		insert(reinterpret_cast<const unsigned char*>(key.c_str()), key.size());
+	}
+
+	bool BlockedBloomFilter::contains(const unsigned char* key_begin, const std::size_t length) const
+	{
+		if (blocks_ == 0) return false;
+
+		bloom_type h = 0;
+		const cell_type *block = bit_table_ + locate(key_begin, length, h);
+
+		const bloom_type step = (h >> 9) | 1;
+		for (std::size_t i = 0; i < salt_count_; ++i)
+		{
+			const bloom_type pos = (h + static_cast<bloom_type>(i) * step) % (block_size * 8);
+			if ((block[pos / 8] & (1 << (pos % 8))) == 0) return false;
+		}
+
+		return true;
+	}
+
+	bool BlockedBloomFilter::contains(const std::string& key) const
+	{
+		return contains(reinterpret_cast<const unsigned char*>(key.c_str()), key.size());
+	}
+
+	std::size_t BlockedBloomFilter::contains_many(const unsigned char* const* keys, const std::size_t* lengths, std::size_t count, bool* result) const
+	{
+		static const std::size_t batch_size = 16;
+
+		std::size_t offsets[batch_size];
+		bloom_type values[batch_size];
+		std::size_t found = 0;
+
+		if (blocks_ == 0)
+		{
+			std::fill_n(result, count, false);
+			return 0;
+		}
+
+		for (std::size_t offset = 0; offset < count; offset += batch_size)
+		{
+			const std::size_t batch = std::min(batch_size, count - offset);
+
+			// hash all keys of the batch and prefetch the blocks
+			for (std::size_t k = 0; k < batch; ++k)
+			{
+				offsets[k] = locate(keys[offset + k], lengths[offset + k], values[k]);
+				__bloom_prefetch(bit_table_ + offsets[k]);
+			}
+
+			// test the bits
+			for (std::size_t k = 0; k < batch; ++k)
+			{
+				const cell_type *block = bit_table_ + offsets[k];
+				const bloom_type h = values[k];
+				const bloom_type step = (h >> 9) | 1;
+				bool ret = true;
+
+				for (std::size_t i = 0; ret && (i < salt_count_); ++i)
+				{
+					const bloom_type pos = (h + static_cast<bloom_type>(i) * step) % (block_size * 8);
+					ret = ((block[pos / 8] & (1 << (pos % 8))) != 0);
+				}
+
+				result[offset + k] = ret;
+				if (ret) ++found;
+			}
+		}
+
+		return found;
+	}
+
+	std::size_t BlockedBloomFilter::size() const
+	{
+		return blocks_ * block_size;
+	}
+
+	const cell_type* BlockedBloomFilter::table() const
+	{
+		return bit_table_;
+	}
+
+	double BlockedBloomFilter::getAllocation() const
+	{
+		// approximation of the standard Bloom-filter
+		double n = static_cast<double>(_itemcount);
+		double k = static_cast<double>(salt_count_);
+		double s = static_cast<double>(size() * 8);
+		if (s == 0) return 1.0;
+		return pow(1 - pow(1 - (1 / s), k * n), k);
+	}
 }
@@ -56,6 +56,11 @@ namespace ibrcommon
 	class DefaultHashProvider : public HashProvider
 	{
 	public:
+		/**
+		 * Maximum number of hash salts
+		 */
+		static const std::size_t salt_max = 64;
+
 		DefaultHashProvider(size_t salt_count);
 		virtual ~DefaultHashProvider();
 
@@ -65,6 +70,12 @@ namespace ibrcommon
 
 		const std::list<bloom_type> hash(const unsigned char* begin, std::size_t remaining_length) const;
 
+		/**
+		 * Compute the hashes of all salts in one pass over the data.
+		 * @param hashes Array with space for count() values
+		 */
+		void hash(const unsigned char* begin, std::size_t remaining_length, bloom_type *hashes) const;
+
 	private:
 		void add(bloom_type hash);
 		void generate_salt();
@@ -157,6 +168,17 @@ namespace ibrcommon
 			return end;
 		}
 
+		/**
+		 * Test a batch of keys. All keys of the batch are hashed and the
+		 * referenced table cells are prefetched before the first lookup.
+		 * @param keys Pointers to the keys
+		 * @param lengths Length of each key
+		 * @param count Number of keys
+		 * @param result Set to true for each key contained in the filter
+		 * @return The number of keys contained in the filter
+		 */
+		std::size_t contains_many(const unsigned char* const* keys, const std::size_t* lengths, std::size_t count, bool* result) const;
+
 		virtual std::size_t size() const;
 
 		BloomFilter& operator &= (const BloomFilter& filter);
@@ -195,6 +217,70 @@ namespace ibrcommon
 		 */
 		double estimateAllocation(size_t items, size_t table_size) const;
 	};
+
+	/**
+	 * A Bloom-filter which places all bits of a key into one block of the size
+	 * of a cache line. The bit positions are derived from two hash values
+	 * (double hashing), thus each operation touches one cache line only and
+	 * allocates no memory. The table is encoded like the table of the BloomFilter,
+	 * but the bit positions differ and both variants can not be mixed.
+	 */
+	class BlockedBloomFilter
+	{
+	public:
+		static const std::size_t block_size = 64;
+
+		/**
+		 * @param table_size Size of the table in bytes, rounded up to a
+		 * multiple of the block size
+		 * @param salt_count Number of bits set per key
+		 */
+		BlockedBloomFilter(std::size_t table_size = 1024, std::size_t salt_count = 2);
+		BlockedBloomFilter(const BlockedBloomFilter& filter);
+		virtual ~BlockedBloomFilter();
+
+		BlockedBloomFilter& operator=(const BlockedBloomFilter& filter);
+
+		/**
+		 * Load a table. The length has to be a multiple of the block size.
+		 */
+		void load(const cell_type* data, size_t len);
+
+		bool operator!() const;
+		void clear();
+
+		void insert(const unsigned char* key_begin, const std::size_t length);
+		void insert(const std::string& key);
+
+		bool contains(const unsigned char* key_begin, const std::size_t length) const;
+		bool contains(const std::string& key) const;
+
+		/**
+		 * Test a batch of keys, see BloomFilter::contains_many()
+		 */
+		std::size_t contains_many(const unsigned char* const* keys, const std::size_t* lengths, std::size_t count, bool* result) const;
+
+		std::size_t size() const;
+		const cell_type* table() const;
+
+		/**
+		 * Returns the allocation
+		 */
+		double getAllocation() const;
+
+	private:
+		void alloc(std::size_t blocks);
+		std::size_t locate(const unsigned char* key_begin, const std::size_t length, bloom_type &h) const;
+
+		DefaultHashProvider _hashp;
+
+		cell_type* _buffer;
+		cell_type* bit_table_;
+		std::size_t blocks_;
+
+		unsigned int _itemcount;
+		std::size_t salt_count_;
+	};
 }
 
 
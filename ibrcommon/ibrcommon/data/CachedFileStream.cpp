@@ -0,0 +1,233 @@
+/*
+ * CachedFileStream.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrcommon/data/CachedFileStream.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace ibrcommon
+{
+	CachedFileStream::CachedFileStream(FileCache &cache, const size_t buffer)
+	 : std::iostream(this), _cache(cache), _writable(false), _fd(-1), _offset(0), _in_buf(buffer), _out_buf(buffer)
+	{
+		setg(NULL, NULL, NULL);
+		setp(NULL, NULL);
+	}
+
+	CachedFileStream::~CachedFileStream()
+	{
+		close();
+	}
+
+	void CachedFileStream::open(const ibrcommon::File &file, bool writable)
+	{
+		close();
+
+		_fd = _cache.acquire(file, writable);
+
+		if (_fd < 0)
+		{
+			setstate(std::ios::failbit);
+			return;
+		}
+
+		_file = file;
+		_writable = writable;
+		_offset = 0;
+
+		std::iostream::clear();
+	}
+
+	void CachedFileStream::close()
+	{
+		if (_fd < 0) return;
+
+		if ((pbase() != NULL) && !__flush()) setstate(std::ios::badbit);
+
+		_cache.release(_file, _writable, _fd);
+		_fd = -1;
+
+		setg(NULL, NULL, NULL);
+		setp(NULL, NULL);
+	}
+
+	bool CachedFileStream::is_open() const
+	{
+		return (_fd >= 0);
+	}
+
+	void CachedFileStream::truncate()
+	{
+		if (_fd < 0) return;
+
+		// discard all buffered data
+		setg(NULL, NULL, NULL);
+		setp(NULL, NULL);
+		_offset = 0;
+
+		if (::ftruncate(_fd, 0) != 0)
+		{
+			setstate(std::ios::badbit);
+			return;
+		}
+
+		std::iostream::clear();
+	}
+
+	std::char_traits<char>::int_type CachedFileStream::underflow()
+	{
+		if (gptr() < egptr()) return std::char_traits<char>::to_int_type(*gptr());
+		if (_fd < 0) return std::char_traits<char>::eof();
+
+		// leave the write mode
+		if (pbase() != NULL)
+		{
+			if (!__flush()) return std::char_traits<char>::eof();
+			setp(NULL, NULL);
+		}
+
+		// move the offset behind the consumed data
+		_offset += (egptr() - eback());
+		setg(NULL, NULL, NULL);
+
+		ssize_t len = 0;
+		do {
+			len = ::pread(_fd, &_in_buf[0], _in_buf.size(), _offset);
+		} while ((len < 0) && (errno == EINTR));
+
+		if (len <= 0) return std::char_traits<char>::eof();
+
+		setg(&_in_buf[0], &_in_buf[0], &_in_buf[0] + len);
+
+		return std::char_traits<char>::to_int_type(*gptr());
+	}
+
+	std::char_traits<char>::int_type CachedFileStream::overflow(std::char_traits<char>::int_type c)
+	{
+		if ((_fd < 0) || !_writable) return std::char_traits<char>::eof();
+
+		if (pbase() == NULL)
+		{
+			// leave the read mode at the current position
+			_offset += (gptr() - eback());
+			setg(NULL, NULL, NULL);
+			setp(&_out_buf[0], &_out_buf[0] + _out_buf.size());
+		}
+		else if (!__flush())
+		{
+			return std::char_traits<char>::eof();
+		}
+
+		if (!std::char_traits<char>::eq_int_type(c, std::char_traits<char>::eof()))
+		{
+			*pptr() = std::char_traits<char>::to_char_type(c);
+			pbump(1);
+		}
+
+		return std::char_traits<char>::not_eof(c);
+	}
+
+	int CachedFileStream::sync()
+	{
+		if ((pbase() != NULL) && !__flush()) return -1;
+		return 0;
+	}
+
+	std::streampos CachedFileStream::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode)
+	{
+		if (_fd < 0) return std::streampos(std::streamoff(-1));
+
+		// only one of the areas is active
+		const off_t current = _offset + (gptr() - eback()) + (pptr() - pbase());
+
+		// tellg() and tellp() do not touch the buffers
+		if ((way == std::ios_base::cur) && (off == 0)) return std::streampos(current);
+
+		if ((pbase() != NULL) && !__flush()) return std::streampos(std::streamoff(-1));
+
+		off_t pos = 0;
+
+		switch (way)
+		{
+		case std::ios_base::beg:
+			pos = off;
+			break;
+
+		case std::ios_base::cur:
+			pos = current + off;
+			break;
+
+		default:
+		{
+			struct stat st;
+			if (::fstat(_fd, &st) != 0) return std::streampos(std::streamoff(-1));
+			pos = st.st_size + off;
+			break;
+		}
+		}
+
+		if (pos < 0) return std::streampos(std::streamoff(-1));
+
+		// keep the read buffer if the position is within
+		if ((eback() != NULL) && (pos >= _offset) && (pos < _offset + (egptr() - eback())))
+		{
+			setg(eback(), eback() + (pos - _offset), egptr());
+			return std::streampos(pos);
+		}
+
+		setg(NULL, NULL, NULL);
+		setp(NULL, NULL);
+		_offset = pos;
+
+		return std::streampos(pos);
+	}
+
+	std::streampos CachedFileStream::seekpos(std::streampos pos, std::ios_base::openmode which)
+	{
+		return seekoff(std::streamoff(pos), std::ios_base::beg, which);
+	}
+
+	bool CachedFileStream::__flush()
+	{
+		char *data = pbase();
+
+		while (data < pptr())
+		{
+			const ssize_t len = ::pwrite(_fd, data, pptr() - data, _offset);
+
+			if (len < 0)
+			{
+				if (errno == EINTR) continue;
+
+				// drop the remaining data
+				setp(NULL, NULL);
+				return false;
+			}
+
+			data += len;
+			_offset += len;
+		}
+
+		setp(&_out_buf[0], &_out_buf[0] + _out_buf.size());
+		return true;
+	}
+} /* namespace ibrcommon */
@@ -0,0 +1,90 @@
+/*
+ * CachedFileStream.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IBRCOMMON_CACHEDFILESTREAM_H_
+#define IBRCOMMON_CACHEDFILESTREAM_H_
+
+#include "ibrcommon/data/File.h"
+#include "ibrcommon/data/FileCache.h"
+#include <sys/types.h>
+#include <iostream>
+#include <vector>
+
+namespace ibrcommon
+{
+	/**
+	 * File stream on top of a descriptor of the FileCache. The stream keeps
+	 * its own position and accesses the file with pread() and pwrite(), thus
+	 * several streams may share one descriptor.
+	 */
+	class CachedFileStream : public std::basic_streambuf<char, std::char_traits<char> >, public std::iostream
+	{
+	public:
+		CachedFileStream(FileCache &cache = FileCache::getInstance(), const size_t buffer = 4096);
+		virtual ~CachedFileStream();
+
+		/**
+		 * Open the file and set the position to the beginning. The failbit
+		 * is set if the file can not be opened.
+		 */
+		void open(const ibrcommon::File &file, bool writable);
+
+		/**
+		 * Write buffered data and return the descriptor to the cache
+		 */
+		void close();
+
+		bool is_open() const;
+
+		/**
+		 * Discard the content of the opened file
+		 */
+		void truncate();
+
+	protected:
+		virtual std::char_traits<char>::int_type underflow();
+		virtual std::char_traits<char>::int_type overflow(std::char_traits<char>::int_type c = std::char_traits<char>::eof());
+		virtual int sync();
+
+		virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
+		virtual std::streampos seekpos(std::streampos pos, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
+
+	private:
+		/**
+		 * Write the put area to the file
+		 */
+		bool __flush();
+
+		FileCache &_cache;
+		ibrcommon::File _file;
+		bool _writable;
+		int _fd;
+
+		// file offset of the get area, the put area, or the position
+		// if no area is active
+		off_t _offset;
+
+		std::vector<char> _in_buf;
+		std::vector<char> _out_buf;
+	};
+} /* namespace ibrcommon */
+
+#endif /* IBRCOMMON_CACHEDFILESTREAM_H_ */
@@ -0,0 +1,225 @@
+/*
+ * FileCache.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrcommon/data/FileCache.h"
+#include "ibrcommon/thread/MutexLock.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ibrcommon
+{
+	FileCache::Entry::Entry()
+	 : fd(-1), users(0)
+	{
+	}
+
+	FileCache::FileCache(const size_t limit)
+	 : _limit(limit)
+	{
+	}
+
+	FileCache::~FileCache()
+	{
+		ibrcommon::MutexLock l(_cond);
+
+		for (entry_map::const_iterator it = _entries.begin(); it != _entries.end(); ++it)
+		{
+			::close(it->second.fd);
+		}
+
+		for (std::map<int, size_t>::const_iterator it = _detached.begin(); it != _detached.end(); ++it)
+		{
+			::close(it->first);
+		}
+	}
+
+	FileCache& FileCache::getInstance()
+	{
+		static FileCache instance;
+		return instance;
+	}
+
+	size_t FileCache::getDefaultLimit()
+	{
+		// leave the major part of the descriptors to sockets and databases
+		struct rlimit rl;
+		if (::getrlimit(RLIMIT_NOFILE, &rl) != 0) return 10;
+		if (rl.rlim_cur == RLIM_INFINITY) return 1024;
+
+		const size_t limit = static_cast<size_t>(rl.rlim_cur / 4);
+		if (limit < 10) return 10;
+		if (limit > 1024) return 1024;
+		return limit;
+	}
+
+	int FileCache::acquire(const ibrcommon::File &file, bool writable) throw ()
+	{
+		const key_type key(file.getPath(), writable);
+
+		ibrcommon::MutexLock l(_cond);
+
+		while (true)
+		{
+			entry_map::iterator it = _entries.find(key);
+
+			if (it != _entries.end())
+			{
+				Entry &e = it->second;
+
+				// re-use the descriptor if the file has not been replaced
+				struct stat path_st, fd_st;
+				if ((::stat(key.first.c_str(), &path_st) == 0) && (::fstat(e.fd, &fd_st) == 0)
+						&& (path_st.st_ino == fd_st.st_ino) && (path_st.st_dev == fd_st.st_dev))
+				{
+					if (e.users == 0) _idle.erase(e.idle);
+					e.users++;
+					return e.fd;
+				}
+
+				detach(it);
+				continue;
+			}
+
+			if ((_entries.size() + _detached.size()) < _limit) break;
+
+			if (_idle.empty())
+			{
+				// wait until a descriptor is released
+				try {
+					_cond.wait();
+				} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+					return -1;
+				}
+			}
+			else
+			{
+				evict(_entries.find(_idle.front()));
+			}
+		}
+
+		const int fd = writable ? ::open(key.first.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR) : ::open(key.first.c_str(), O_RDONLY);
+		if (fd < 0) return -1;
+
+		// do not pass the descriptor to child processes
+		::fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+		Entry &e = _entries[key];
+		e.fd = fd;
+		e.users = 1;
+
+		return fd;
+	}
+
+	void FileCache::release(const ibrcommon::File &file, bool writable, int fd) throw ()
+	{
+		ibrcommon::MutexLock l(_cond);
+
+		std::map<int, size_t>::iterator d = _detached.find(fd);
+		if (d != _detached.end())
+		{
+			if (--(d->second) == 0)
+			{
+				::close(fd);
+				_detached.erase(d);
+				_cond.signal(true);
+			}
+			return;
+		}
+
+		entry_map::iterator it = _entries.find(key_type(file.getPath(), writable));
+		if ((it == _entries.end()) || (it->second.fd != fd)) return;
+
+		Entry &e = it->second;
+		if (--e.users > 0) return;
+
+		// keep the descriptor open for later use
+		e.idle = _idle.insert(_idle.end(), it->first);
+
+		shrink();
+		_cond.signal(true);
+	}
+
+	void FileCache::invalidate(const ibrcommon::File &file) throw ()
+	{
+		ibrcommon::MutexLock l(_cond);
+
+		for (int i = 0; i < 2; ++i)
+		{
+			entry_map::iterator it = _entries.find(key_type(file.getPath(), (i == 1)));
+			if (it != _entries.end()) detach(it);
+		}
+
+		_cond.signal(true);
+	}
+
+	void FileCache::setLimit(const size_t limit) throw ()
+	{
+		ibrcommon::MutexLock l(_cond);
+		_limit = limit;
+		shrink();
+		_cond.signal(true);
+	}
+
+	size_t FileCache::getLimit() const throw ()
+	{
+		ibrcommon::MutexLock l(_cond);
+		return _limit;
+	}
+
+	size_t FileCache::size() const throw ()
+	{
+		ibrcommon::MutexLock l(_cond);
+		return _entries.size() + _detached.size();
+	}
+
+	void FileCache::evict(entry_map::iterator it) throw ()
+	{
+		_idle.erase(it->second.idle);
+		::close(it->second.fd);
+		_entries.erase(it);
+	}
+
+	void FileCache::detach(entry_map::iterator it) throw ()
+	{
+		if (it->second.users == 0)
+		{
+			evict(it);
+		}
+		else
+		{
+			// the descriptor is closed when the last user releases it
+			_detached[it->second.fd] = it->second.users;
+			_entries.erase(it);
+		}
+	}
+
+	void FileCache::shrink() throw ()
+	{
+		while (((_entries.size() + _detached.size()) > _limit) && !_idle.empty())
+		{
+			evict(_entries.find(_idle.front()));
+		}
+	}
+} /* namespace ibrcommon */
@@ -0,0 +1,124 @@
+/*
+ * FileCache.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IBRCOMMON_FILECACHE_H_
+#define IBRCOMMON_FILECACHE_H_
+
+#include "ibrcommon/data/File.h"
+#include "ibrcommon/thread/Conditional.h"
+#include <string>
+#include <list>
+#include <map>
+
+namespace ibrcommon
+{
+	/**
+	 * Limits the number of open file descriptors and keeps recently used
+	 * descriptors open for later use. A descriptor is shared by all users
+	 * of the same file and access mode, thus the users have to access the
+	 * file with positional I/O (pread / pwrite) only.
+	 *
+	 * If the limit is reached, the least recently used idle descriptor is
+	 * closed. If all descriptors are in use, acquire() blocks until one is
+	 * released.
+	 */
+	class FileCache
+	{
+	public:
+		FileCache(const size_t limit = getDefaultLimit());
+		virtual ~FileCache();
+
+		/**
+		 * Returns the global cache used by the BLOB implementations
+		 */
+		static FileCache& getInstance();
+
+		/**
+		 * Returns a limit derived from the open file limit of the process
+		 */
+		static size_t getDefaultLimit();
+
+		/**
+		 * Get a descriptor of the given file. The file is created if it does
+		 * not exist and writable is true.
+		 * @return The descriptor or -1 if the file can not be opened
+		 */
+		int acquire(const ibrcommon::File &file, bool writable) throw ();
+
+		/**
+		 * Return a descriptor got by acquire()
+		 */
+		void release(const ibrcommon::File &file, bool writable, int fd) throw ();
+
+		/**
+		 * Drop the cached descriptors of a file. Has to be called
+		 * before a file is removed.
+		 */
+		void invalidate(const ibrcommon::File &file) throw ();
+
+		/**
+		 * Change the maximum number of open descriptors
+		 */
+		void setLimit(const size_t limit) throw ();
+		size_t getLimit() const throw ();
+
+		/**
+		 * Returns the number of open descriptors
+		 */
+		size_t size() const throw ();
+
+	private:
+		typedef std::pair<std::string, bool> key_type;
+		typedef std::list<key_type> key_list;
+
+		class Entry
+		{
+		public:
+			Entry();
+
+			int fd;
+			size_t users;
+
+			// position in the list of idle descriptors
+			key_list::iterator idle;
+		};
+
+		typedef std::map<key_type, Entry> entry_map;
+
+		void evict(entry_map::iterator it) throw ();
+		void detach(entry_map::iterator it) throw ();
+		void shrink() throw ();
+
+		mutable ibrcommon::Conditional _cond;
+
+		entry_map _entries;
+
+		// idle descriptors, the least recently used first
+		key_list _idle;
+
+		// descriptors replaced while in use, closed on release
+		std::map<int, size_t> _detached;
+
+		size_t _limit;
+	};
+} /* namespace ibrcommon */
+
+#endif /* IBRCOMMON_FILECACHE_H_ */
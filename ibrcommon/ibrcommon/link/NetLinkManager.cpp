@@ -317,6 +317,9 @@ namespace ibrcommon
 		nl_socket_free((struct nl_sock*)_nl_handle);
 #endif
 
+		// the fd of the cache manager is gone
+		_generation++;
+
 		// mark this socket as down
 		if (_state == SOCKET_UNMANAGED)
 			_state = SOCKET_DESTROYED;
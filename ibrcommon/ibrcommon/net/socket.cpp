@@ -39,6 +39,10 @@
 #include <netdb.h>
 #endif
 
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
+
 #include <string.h>
 #include <fcntl.h>
 #include <sys/time.h>
@@ -97,13 +101,13 @@ namespace ibrcommon
 	}
 
 	basesocket::basesocket()
-	 : _state(SOCKET_DOWN), _fd(-1), _family(PF_UNSPEC)
+	 : _state(SOCKET_DOWN), _fd(-1), _generation(0), _family(PF_UNSPEC)
 	{
 		__init_sockets();
 	}
 
 	basesocket::basesocket(int fd)
-	 : _state(SOCKET_UNMANAGED), _fd(fd), _family(PF_UNSPEC)
+	 : _state(SOCKET_UNMANAGED), _fd(fd), _generation(0), _family(PF_UNSPEC)
 	{
 		__init_sockets();
 	}
@@ -127,6 +131,7 @@ namespace ibrcommon
 		if ((_state == SOCKET_DOWN) || (_state == SOCKET_DESTROYED)) throw socket_exception("fd not available");
 		int fd = _fd;
 		_fd = -1;
+		_generation++;
 
 		if (_state == SOCKET_UP)
 			_state = SOCKET_DOWN;
@@ -143,6 +148,7 @@ namespace ibrcommon
 			throw socket_exception("close error");
 
 		_fd = -1;
+		_generation++;
 
 		if (_state == SOCKET_UNMANAGED)
 			_state = SOCKET_DESTROYED;
@@ -162,6 +168,11 @@ namespace ibrcommon
 			_state = SOCKET_DOWN;
 	}
 
+	unsigned int basesocket::generation() const
+	{
+		return _generation;
+	}
+
 	bool basesocket::ready() const
 	{
 		return ((_state == SOCKET_UP) || (_state == SOCKET_UNMANAGED));
@@ -369,6 +380,48 @@ namespace ibrcommon
 		return ret;
 	}
 
+	ssize_t clientsocket::sendfile(int in_fd, off_t &offset, size_t count) throw (socket_exception)
+	{
+#ifdef HAVE_SYS_SENDFILE_H
+		ssize_t ret = ::sendfile(this->fd(), in_fd, &offset, count);
+		if (ret == -1) {
+			switch (__errno)
+			{
+			case EPIPE:
+				// connection has been reset
+				throw socket_error(ERROR_EPIPE, "connection has been reset");
+
+			case ECONNRESET:
+				// Connection reset by peer
+				throw socket_error(ERROR_RESET, "Connection reset by peer");
+
+			case EAGAIN:
+				// sent failed but we should retry again
+				throw socket_error(ERROR_AGAIN, "sent failed but we should retry again");
+
+			default:
+				throw socket_error(ERROR_WRITE, "sendfile error");
+			}
+		}
+		return ret;
+#else
+		// copy the data through a local buffer
+		char buf[0x1000];
+		if (count > sizeof(buf)) count = sizeof(buf);
+
+		if (::lseek(in_fd, offset, SEEK_SET) == -1)
+			throw socket_error(ERROR_READ, "can not seek in file");
+
+		ssize_t len = ::read(in_fd, buf, count);
+		if (len == -1) throw socket_error(ERROR_READ, "can not read from file");
+		if (len == 0) return 0;
+
+		ssize_t ret = send(buf, len);
+		offset += ret;
+		return ret;
+#endif
+	}
+
 	ssize_t clientsocket::recv(char *data, size_t len, int flags) throw (socket_exception)
 	{
 		ssize_t ret = ::recv(this->fd(), data, len, flags);
@@ -497,17 +550,23 @@ namespace ibrcommon
 		hints.ai_socktype = SOCK_DGRAM;
 		hints.ai_flags = AI_ADDRCONFIG;
 
+		// keep the strings alive while getaddrinfo() uses them
+		std::string address_str;
+		std::string service_str;
+
 		const char *address = NULL;
 		const char *service = NULL;
 
 		try {
-			address = addr.address().c_str();
+			address_str = addr.address();
+			address = address_str.c_str();
 		} catch (const vaddress::address_not_set&) {
 			throw socket_exception("need at least an address to send to");
 		};
 
 		try {
-			service = addr.service().c_str();
+			service_str = addr.service();
+			service = service_str.c_str();
 		} catch (const vaddress::address_not_set&) { };
 
 		if ((ret = ::getaddrinfo(address, service, &hints, &res)) != 0)
@@ -799,17 +858,23 @@ namespace ibrcommon
 		struct addrinfo *res = NULL;
 		int ret = 0;
 
+		// keep the strings alive while getaddrinfo() uses them
+		std::string address_str;
+		std::string service_str;
+
 		const char *address = NULL;
 		const char *service = NULL;
 
 		try {
-			address = _address.address().c_str();
+			address_str = _address.address();
+			address = address_str.c_str();
 		} catch (const vaddress::address_not_set&) {
 			throw socket_exception("need at least an address to connect to");
 		};
 
 		try {
-			service = _address.service().c_str();
+			service_str = _address.service();
+			service = service_str.c_str();
 		} catch (const vaddress::service_not_set&) { };
 
 		if ((ret = ::getaddrinfo(address, service, &hints, &res)) != 0)
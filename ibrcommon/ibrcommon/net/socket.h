@@ -155,6 +155,13 @@ namespace ibrcommon {
 		 */
 		bool ready() const;
 
+		/**
+		 * Returns a number which changes each time the socket drops its
+		 * file descriptor. Together with fd() it identifies the
+		 * descriptor, even if a new one gets the same number.
+		 */
+		unsigned int generation() const;
+
 		/**
 		 * return the family of a socket
 		 * @return
@@ -210,6 +217,9 @@ namespace ibrcommon {
 		// contains the file descriptor if one is available
 		int _fd;
 
+		// incremented each time the file descriptor is dropped
+		unsigned int _generation;
+
 		// stores the socket family
 		sa_family_t _family;
 	};
@@ -232,6 +242,14 @@ namespace ibrcommon {
 		ssize_t send(const char *data, size_t len, int flags = 0) throw (socket_exception);
 		ssize_t recv(char *data, size_t len, int flags = 0) throw (socket_exception);
 
+		/**
+		 * Send up to <count> bytes of the file <in_fd> starting at <offset>.
+		 * The offset is advanced by the number of bytes sent. If sendfile()
+		 * is available the data is not copied into user-space.
+		 * @return The number of bytes sent.
+		 */
+		ssize_t sendfile(int in_fd, off_t &offset, size_t count) throw (socket_exception);
+
 		void set(CLIENT_OPTION opt, bool val) throw (socket_exception);
 
 	protected:
@@ -153,6 +153,66 @@ namespace ibrcommon
 		return std::char_traits<char>::not_eof(c);
 	}
 
+	void socketstream::sendfile(int fd, std::streamoff offset, std::streamsize length)
+	{
+		// send all buffered data first
+		while (pptr() != &out_buf_[0])
+		{
+			overflow();
+		}
+
+		off_t pos = offset;
+		const off_t end = offset + length;
+
+		while (pos < end)
+		{
+			try {
+				socketset writeset;
+				_socket.select(NULL, &writeset, NULL, NULL);
+
+				// error checking
+				if (writeset.size() == 0) {
+					throw socket_exception("no select result returned");
+				}
+
+				// limit the chunk size to stay responsive on interrupts
+				size_t chunk = 0x100000;
+				if ((end - pos) < static_cast<off_t>(chunk)) chunk = static_cast<size_t>(end - pos);
+
+				clientsocket &sock = static_cast<clientsocket&>(**(writeset.begin()));
+
+				if (sock.sendfile(fd, pos, chunk) == 0) {
+					throw socket_exception("unexpected end of file");
+				}
+			} catch (const vsocket_interrupt &e) {
+				errmsg = ERROR_CLOSED;
+				close();
+				IBRCOMMON_LOGGER_DEBUG_TAG("socketstream", 85) << "select interrupted: " << e.what() << IBRCOMMON_LOGGER_ENDL;
+				throw;
+			} catch (const socket_error &err) {
+				if (err.code() == ERROR_AGAIN) continue;
+
+				// set the last error code
+				errmsg = err.code();
+
+				// close the stream/socket due to failures
+				close();
+
+				// create a detailed exception message
+				std::stringstream ss; ss << "sendfile() failed: " << err.code();
+				throw stream_exception(ss.str());
+			} catch (const socket_exception &ex) {
+				// set the last error code
+				errmsg = ERROR_WRITE;
+
+				// close the stream/socket due to failures
+				close();
+
+				throw stream_exception(std::string("<tcpstream> sendfile() failed: ") + ex.what());
+			}
+		}
+	}
+
 	std::char_traits<char>::int_type socketstream::underflow()
 	{
 		try {
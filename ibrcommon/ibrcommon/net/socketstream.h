@@ -46,6 +46,14 @@ namespace ibrcommon
 		void setTimeout(const timeval &val);
 		void close();
 
+		/**
+		 * Write <length> bytes of the file <fd> starting at <offset> to
+		 * the socket. Buffered data of the stream is sent first. The file
+		 * content is handed to the kernel in chunks, so the transfer is
+		 * interruptible like any other write on this stream.
+		 */
+		void sendfile(int fd, std::streamoff offset, std::streamsize length);
+
 		socket_error_code errmsg;
 
 	protected:
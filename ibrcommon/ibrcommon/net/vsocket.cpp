@@ -24,10 +24,14 @@
 #include "ibrcommon/thread/MutexLock.h"
 #include "ibrcommon/Logger.h"
 
-#ifndef __linux__
+#if !defined(__linux__) || defined(HAVE_SYS_EPOLL_H)
 #include "ibrcommon/TimeMeasurement.h"
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
 #ifdef __WIN32__
 #include <winsock2.h>
 #include <windows.h>
@@ -181,6 +185,170 @@ namespace ibrcommon
 	}
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+	class vsocket::epollset
+	{
+	public:
+		epollset(uint32_t events, basesocket &pipe) throw (socket_exception);
+		~epollset();
+
+		/**
+		 * Bring the registrations in line with the given sockets. Sockets
+		 * may close or re-open their fd on their own, so the registered fds
+		 * and their generation are checked on each call. The sockets are only registered again
+		 * if a registration is outdated, the set has been invalidated or
+		 * some sockets were not ready before.
+		 */
+		void update(const socketset &sockets, TRIGGER trigger);
+
+		void invalidate();
+
+		int wait(struct epoll_event *events, int maxevents, int timeout);
+
+	private:
+		void __unregister(int fd);
+
+		int _fd;
+		const uint32_t _events;
+		bool _dirty;
+
+		// number of sockets not registered by the last update
+		size_t _pending;
+
+		// registered sockets with their fd and its generation at the time of registration
+		typedef std::map<basesocket*, std::pair<int, unsigned int> > registration_map;
+		registration_map _registered;
+	};
+
+	vsocket::epollset::epollset(uint32_t events, basesocket &pipe) throw (socket_exception)
+	 : _fd(-1), _events(events), _dirty(true), _pending(0)
+	{
+		_fd = ::epoll_create(1);
+
+		if (_fd < 0)
+		{
+			IBRCOMMON_LOGGER_TAG("vsocket", error) << "Error " << errno << " creating epoll instance" << IBRCOMMON_LOGGER_ENDL;
+			throw socket_raw_error(errno, "failed to create epoll instance");
+		}
+
+		// the self-pipe is always level-triggered
+		struct epoll_event ev;
+		::memset(&ev, 0, sizeof ev);
+		ev.events = EPOLLIN;
+		ev.data.ptr = &pipe;
+
+		if (::epoll_ctl(_fd, EPOLL_CTL_ADD, pipe.fd(), &ev) < 0)
+		{
+			int errcode = errno;
+			::close(_fd);
+			throw socket_raw_error(errcode, "failed to register the interrupt pipe");
+		}
+	}
+
+	vsocket::epollset::~epollset()
+	{
+		::close(_fd);
+	}
+
+	void vsocket::epollset::invalidate()
+	{
+		_dirty = true;
+	}
+
+	void vsocket::epollset::__unregister(int fd)
+	{
+		// closed fds are removed by the kernel, so errors are expected here
+		struct epoll_event ev;
+		::memset(&ev, 0, sizeof ev);
+		::epoll_ctl(_fd, EPOLL_CTL_DEL, fd, &ev);
+	}
+
+	void vsocket::epollset::update(const socketset &sockets, TRIGGER trigger)
+	{
+		bool stale = _dirty || (_pending > 0);
+
+		// drop registrations of removed, closed or re-opened sockets
+		for (registration_map::iterator iter = _registered.begin(); iter != _registered.end();)
+		{
+			basesocket *sock = (*iter).first;
+			bool valid = (sockets.find(sock) != sockets.end()) && sock->ready();
+
+			if (valid) {
+				try {
+					valid = (sock->fd() == (*iter).second.first) && (sock->generation() == (*iter).second.second);
+				} catch (const socket_exception&) {
+					valid = false;
+				}
+			}
+
+			if (valid) {
+				++iter;
+				continue;
+			}
+
+			// the fd number may have been registered again for another socket
+			bool reused = false;
+			for (registration_map::const_iterator other = _registered.begin(); other != _registered.end(); ++other)
+			{
+				if ((other != iter) && ((*other).second.first == (*iter).second.first)) reused = true;
+			}
+
+			if (!reused) __unregister((*iter).second.first);
+			_registered.erase(iter++);
+			stale = true;
+		}
+
+		if (!stale) return;
+
+		_pending = 0;
+
+		// register new sockets
+		for (socketset::const_iterator iter = sockets.begin(); iter != sockets.end(); ++iter)
+		{
+			basesocket *sock = (*iter);
+			if (_registered.find(sock) != _registered.end()) continue;
+
+			if (!sock->ready())
+			{
+				_pending++;
+				continue;
+			}
+
+			try {
+				const int fd = sock->fd();
+
+				struct epoll_event ev;
+				::memset(&ev, 0, sizeof ev);
+				ev.events = _events;
+				if (trigger == TRIGGER_EDGE) ev.events |= EPOLLET;
+				ev.data.ptr = sock;
+
+				if (::epoll_ctl(_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+				{
+					// the fd number may still be registered for a socket closed in the meantime
+					if ((errno != EEXIST) || (::epoll_ctl(_fd, EPOLL_CTL_MOD, fd, &ev) < 0))
+					{
+						IBRCOMMON_LOGGER_DEBUG_TAG("vsocket", 40) << "epoll registration of fd " << fd << " failed: " << errno << IBRCOMMON_LOGGER_ENDL;
+						_pending++;
+						continue;
+					}
+				}
+
+				_registered[sock] = std::make_pair(fd, sock->generation());
+			} catch (const socket_exception&) {
+				_pending++;
+			}
+		}
+
+		_dirty = false;
+	}
+
+	int vsocket::epollset::wait(struct epoll_event *events, int maxevents, int timeout)
+	{
+		return ::epoll_wait(_fd, events, maxevents, timeout);
+	}
+#endif
+
 	vsocket::pipesocket::pipesocket()
 	 : _output_fd(-1)
 	{ }
@@ -554,24 +722,42 @@ namespace ibrcommon
 		}
 	}
 
-	vsocket::vsocket()
-	 : _state(SocketState::DOWN), _select_count(0)
+	vsocket::vsocket(TRIGGER trigger)
+	 : _state(SocketState::DOWN), _select_count(0), _trigger(trigger)
 	{
 		_pipe.up();
 	}
 
 	vsocket::~vsocket()
 	{
+#ifdef HAVE_SYS_EPOLL_H
+		for (std::map<unsigned int, epollset*>::iterator iter = _epoll.begin(); iter != _epoll.end(); ++iter)
+		{
+			delete (*iter).second;
+		}
+#endif
+
 		try {
 			_pipe.down();
 		} catch (const socket_exception &ex) {
 		}
 	}
 
+	void vsocket::invalidate()
+	{
+#ifdef HAVE_SYS_EPOLL_H
+		for (std::map<unsigned int, epollset*>::iterator iter = _epoll.begin(); iter != _epoll.end(); ++iter)
+		{
+			(*iter).second->invalidate();
+		}
+#endif
+	}
+
 	void vsocket::add(basesocket *socket)
 	{
 		SafeLock l(_state, *this);
 		_sockets.insert(socket);
+		invalidate();
 	}
 
 	void vsocket::add(basesocket *socket, const vinterface &iface)
@@ -579,12 +765,14 @@ namespace ibrcommon
 		SafeLock l(_state, *this);
 		_sockets.insert(socket);
 		_socket_map[iface].insert(socket);
+		invalidate();
 	}
 
 	void vsocket::remove(basesocket *socket)
 	{
 		SafeLock l(_state, *this);
 		_sockets.erase(socket);
+		invalidate();
 
 		// search for the same socket in the map
 		for (std::map<vinterface, socketset>::iterator iter = _socket_map.begin(); iter != _socket_map.end(); ++iter)
@@ -604,6 +792,7 @@ namespace ibrcommon
 		SafeLock l(_state, *this);
 		_sockets.clear();
 		_socket_map.clear();
+		invalidate();
 	}
 
 	void vsocket::destroy()
@@ -617,6 +806,7 @@ namespace ibrcommon
 		}
 		_sockets.clear();
 		_socket_map.clear();
+		invalidate();
 	}
 
 	socketset vsocket::getAll() const
@@ -659,6 +849,12 @@ namespace ibrcommon
 			}
 		}
 
+		{
+			// sockets got new file descriptors
+			ibrcommon::MutexLock l(_socket_lock);
+			invalidate();
+		}
+
 		// set state to IDLE
 		ibrcommon::MutexLock l(_state);
 		_state.set(SocketState::IDLE);
@@ -695,6 +891,7 @@ namespace ibrcommon
 					if ((*iter)->ready()) (*iter)->down();
 				} catch (const socket_exception&) { }
 			}
+			invalidate();
 		}
 
 		ibrcommon::MutexLock sl(_state);
@@ -707,6 +904,159 @@ namespace ibrcommon
 	}
 
 	void vsocket::select(socketset *readset, socketset *writeset, socketset *errorset, struct timeval *tv) throw (socket_exception)
+	{
+#ifdef HAVE_SYS_EPOLL_H
+		__select_epoll(readset, writeset, errorset, tv);
+#else
+		__select_fdset(readset, writeset, errorset, tv);
+#endif
+	}
+
+#ifdef HAVE_SYS_EPOLL_H
+	void vsocket::__select_epoll(socketset *readset, socketset *writeset, socketset *errorset, struct timeval *tv) throw (socket_exception)
+	{
+		// the interest mask selects the epoll instance, so concurrent
+		// readers and writers do not wake up each other
+		uint32_t events = 0;
+		if (readset != NULL) events |= EPOLLIN;
+		if (writeset != NULL) events |= EPOLLOUT;
+		if (errorset != NULL) events |= EPOLLPRI;
+
+		const int max_events = 64;
+		struct epoll_event ready[max_events];
+
+		while (true)
+		{
+			SelectGuard guard(_state, _select_count, *this);
+
+			epollset *eset = NULL;
+
+			{
+				ibrcommon::MutexLock l(_socket_lock);
+
+				std::map<unsigned int, epollset*>::iterator iter = _epoll.find(events);
+				if (iter == _epoll.end()) {
+					eset = new epollset(events, _pipe);
+					_epoll[events] = eset;
+				} else {
+					eset = (*iter).second;
+				}
+
+				eset->update(_sockets, _trigger);
+			}
+
+			// convert the timeout to milliseconds, rounded up
+			int timeout = -1;
+			if (tv != NULL) {
+				timeout = static_cast<int>((tv->tv_sec * 1000) + ((tv->tv_usec + 999) / 1000));
+			}
+
+			TimeMeasurement tm;
+			tm.start();
+
+			int res = eset->wait(ready, max_events, timeout);
+			int errcode = errno;
+
+			// decrement the timeout value like the linux select() does
+			if (tv != NULL)
+			{
+				if (res == 0)
+				{
+					tv->tv_sec = 0;
+					tv->tv_usec = 0;
+				}
+				else
+				{
+					tm.stop();
+
+					struct timespec time_spend;
+					tm.getTime(time_spend);
+
+					tv->tv_sec -= time_spend.tv_sec;
+					tv->tv_usec -= time_spend.tv_nsec / 1000;
+					if (tv->tv_usec < 0) {
+						--tv->tv_sec;
+						tv->tv_usec += 1000000L;
+					}
+
+					// adjust timeout value if that falls below zero
+					if (tv->tv_sec < 0)
+					{
+						tv->tv_sec = 0;
+						tv->tv_usec = 0;
+					}
+				}
+			}
+
+			if (res < 0) {
+				if (errcode == EINTR) {
+					// signal has been caught - handle it as interruption
+					continue;
+				}
+				else if (errcode == EBADF) {
+					throw socket_error(ERROR_CLOSED, "socket was closed");
+				}
+				throw socket_raw_error(errcode, "unknown epoll error");
+			}
+
+			if (res == 0)
+				throw vsocket_timeout("select timeout");
+
+			bool interrupted = false;
+			bool result = false;
+
+			ibrcommon::MutexLock l(_socket_lock);
+			for (int i = 0; i < res; ++i)
+			{
+				basesocket *sock = static_cast<basesocket*>(ready[i].data.ptr);
+				const uint32_t revents = ready[i].events;
+
+				if (sock == &_pipe) {
+					interrupted = true;
+					continue;
+				}
+
+				// errors and hang-ups make a socket readable and writable, as select() does
+				const bool failed = (revents & (EPOLLERR | EPOLLHUP));
+
+				if ((readset != NULL) && ((revents & EPOLLIN) || failed))
+				{
+					readset->insert(sock);
+					result = true;
+				}
+
+				if ((writeset != NULL) && ((revents & EPOLLOUT) || failed))
+				{
+					writeset->insert(sock);
+					result = true;
+				}
+
+				if ((errorset != NULL) && ((revents & EPOLLPRI) || failed))
+				{
+					errorset->insert(sock);
+					result = true;
+				}
+			}
+
+			if (interrupted)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG("vsocket::select", 90) << "unblocked by self-pipe-trick" << IBRCOMMON_LOGGER_ENDL;
+
+				// this was an interrupt with the self-pipe-trick
+				char buf[2];
+				_pipe.read(buf, 2);
+
+				// start over with the select call, unless edge-triggered
+				// events would get lost
+				if (!result) continue;
+			}
+
+			break;
+		}
+	}
+#endif
+
+	void vsocket::__select_fdset(socketset *readset, socketset *writeset, socketset *errorset, struct timeval *tv) throw (socket_exception)
 	{
 		fd_set fds_read;
 		fd_set fds_write;
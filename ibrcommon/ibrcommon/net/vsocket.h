@@ -58,10 +58,23 @@ namespace ibrcommon
 	class vsocket
 	{
 	public:
+		/**
+		 * Trigger mode for the epoll backend. In edge-triggered mode
+		 * select() returns a socket only once per readiness change, so
+		 * the caller has to consume all pending data. The select()
+		 * fallback is always level-triggered.
+		 */
+		enum TRIGGER
+		{
+			TRIGGER_LEVEL,
+			TRIGGER_EDGE
+		};
+
 		/**
 		 * Constructor
+		 * @param trigger The trigger mode used by select()
 		 */
-		vsocket();
+		vsocket(TRIGGER trigger = TRIGGER_LEVEL);
 
 		/**
 		 * Destructor
@@ -211,8 +224,22 @@ namespace ibrcommon
 			ibrcommon::vsocket &_sock;
 		};
 
+		/**
+		 * epoll instance with registrations for one interest mask,
+		 * defined in vsocket.cpp if epoll is available
+		 */
+		class epollset;
+
 		void interrupt();
 
+		/**
+		 * mark all epoll registrations as outdated
+		 */
+		void invalidate();
+
+		void __select_epoll(socketset *readset, socketset *writeset, socketset *errorset, struct timeval *tv) throw (socket_exception);
+		void __select_fdset(socketset *readset, socketset *writeset, socketset *errorset, struct timeval *tv) throw (socket_exception);
+
 		ibrcommon::Mutex _socket_lock;
 		socketset _sockets;
 		std::map<vinterface, socketset> _socket_map;
@@ -221,6 +248,11 @@ namespace ibrcommon
 
 		SocketState _state;
 		int _select_count;
+
+		const TRIGGER _trigger;
+
+		// epoll instances for each interest mask used with select()
+		std::map<unsigned int, epollset*> _epoll;
 	};
 }
 
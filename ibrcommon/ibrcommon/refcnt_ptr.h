@@ -22,9 +22,6 @@
 #ifndef IBRCOMMON_refcnt_ptr_h
 #define IBRCOMMON_refcnt_ptr_h 1
 
-#include "ibrcommon/thread/Mutex.h"
-#include "ibrcommon/thread/MutexLock.h"
-
 template <class T> class refcnt_ptr
 {
 	protected:
@@ -37,8 +34,9 @@ template <class T> class refcnt_ptr
 			virtual ~Holder() { delete ptr_;};
 
 			T* ptr_;
-			unsigned count_;
-			ibrcommon::Mutex lock;
+
+			// modified with atomic operations only
+			volatile unsigned count_;
 		};
 
 		Holder* h_;
@@ -46,12 +44,8 @@ template <class T> class refcnt_ptr
 	private:
 		void down()
 		{
-			bool final = false;
-			{
-				ibrcommon::MutexLock l(h_->lock);
-				if (--h_->count_ == 0) final = true;
-			}
-			if (final) delete h_;
+			// the last reference deletes the holder
+			if (__sync_sub_and_fetch(&h_->count_, 1) == 0) delete h_;
 		}
 
 	public:
@@ -69,8 +63,7 @@ template <class T> class refcnt_ptr
 		// copy and assignment of refcnt_ptr
 		refcnt_ptr (const refcnt_ptr<T>& right) : h_(right.h_)
 		{
-			ibrcommon::MutexLock l(h_->lock);
-			++h_->count_;
+			__sync_add_and_fetch(&h_->count_, 1);
 		}
 
 		refcnt_ptr<T>& operator= (const refcnt_ptr<T>& right)
@@ -78,8 +71,8 @@ template <class T> class refcnt_ptr
 			// ignore assignment to myself
 			if (h_ == right.h_) return *this;
 
-			ibrcommon::MutexLock l(right.h_->lock);
-			++right.h_->count_;
+			// right holds a reference, thus its holder can not vanish here
+			__sync_add_and_fetch(&right.h_->count_, 1);
 
 			down();
 
@@ -98,6 +91,13 @@ template <class T> class refcnt_ptr
 			return h_->ptr_ == other.h_->ptr_;
 		}
 
+		// returns true if no other refcnt_ptr shares the managed object
+		bool unique() const
+		{
+			// atomic read with a full barrier, like all other accesses
+			return __sync_fetch_and_add(&h_->count_, 0) == 1;
+		}
+
 		// access to the managed object
 		T* operator-> () { return h_->ptr_; }
 		T& operator* () { return *h_->ptr_; }
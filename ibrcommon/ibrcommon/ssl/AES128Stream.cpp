@@ -27,12 +27,11 @@
 namespace ibrcommon
 {
 	AES128Stream::AES128Stream(const CipherMode mode, std::ostream& output, const unsigned char key[key_size_in_bytes], const uint32_t salt)
-		: CipherStream(output, mode)
+		: CipherStream(output, mode, BUFF_SIZE)
+#ifdef IBRCOMMON_AES128_EVP_GCM
+		, _ctx(NULL), _finalized(false), _final_result(false)
+#endif
 	{
-		// init gcm and load the key into the context
-		if (gcm_init_and_key(key, key_size_in_bytes, &_ctx))
-			IBRCOMMON_LOGGER_TAG("AES128Stream", critical) << "failed to initialize aes gcm context" << IBRCOMMON_LOGGER_ENDL;
-
 		// convert the salt to network byte order
 		_gcm_iv.salt = htonl(salt);
 
@@ -44,17 +43,15 @@ namespace ibrcommon
 		for (unsigned int i = 0; i < iv_len; ++i)
 			_used_initialisation_vector[i] = _gcm_iv.initialisation_vector[i];
 
-		// init the GCM message
-		gcm_init_message(reinterpret_cast<unsigned char *>(&_gcm_iv), sizeof(gcm_iv), &_ctx);
+		init(key);
 	}
 
 	AES128Stream::AES128Stream(const CipherMode mode, std::ostream& output, const unsigned char key[key_size_in_bytes], const uint32_t salt, const unsigned char iv[iv_len])
-		: CipherStream(output, mode)
+		: CipherStream(output, mode, BUFF_SIZE)
+#ifdef IBRCOMMON_AES128_EVP_GCM
+		, _ctx(NULL), _finalized(false), _final_result(false)
+#endif
 	{
-		// init gcm and load the key into the context
-		if (gcm_init_and_key(key, key_size_in_bytes, &_ctx))
-			IBRCOMMON_LOGGER_TAG("AES128Stream", critical) << "failed to initialize aes gcm context" << IBRCOMMON_LOGGER_ENDL;
-
 		// convert the salt to network byte order
 		_gcm_iv.salt = htonl(salt);
 
@@ -65,14 +62,42 @@ namespace ibrcommon
 			_used_initialisation_vector[i] = iv[i];
 		}
 
-		// init the GCM message
-		gcm_init_message(reinterpret_cast<unsigned char *>(&_gcm_iv), sizeof(gcm_iv), &_ctx);
+		init(key);
 	}
 
 	AES128Stream::~AES128Stream()
 	{
+#ifdef IBRCOMMON_AES128_EVP_GCM
+		// free the cipher context
+		if (_ctx != NULL) EVP_CIPHER_CTX_free(_ctx);
+#else
 		// close the GCM context
 		gcm_end(&_ctx);
+#endif
+	}
+
+	void AES128Stream::init(const unsigned char key[key_size_in_bytes])
+	{
+#ifdef IBRCOMMON_AES128_EVP_GCM
+		_ctx = EVP_CIPHER_CTX_new();
+
+		// the IV is the salt followed by the initialisation vector (96 bit)
+		const int enc = (_mode == CIPHER_ENCRYPT) ? 1 : 0;
+		if ((_ctx == NULL)
+			|| !EVP_CipherInit_ex(_ctx, EVP_aes_128_gcm(), NULL, NULL, NULL, enc)
+			|| !EVP_CIPHER_CTX_ctrl(_ctx, EVP_CTRL_GCM_SET_IVLEN, sizeof(gcm_iv), NULL)
+			|| !EVP_CipherInit_ex(_ctx, NULL, NULL, key, reinterpret_cast<unsigned char *>(&_gcm_iv), enc))
+		{
+			IBRCOMMON_LOGGER_TAG("AES128Stream", critical) << "failed to initialize aes gcm context" << IBRCOMMON_LOGGER_ENDL;
+		}
+#else
+		// init gcm and load the key into the context
+		if (gcm_init_and_key(key, key_size_in_bytes, &_ctx))
+			IBRCOMMON_LOGGER_TAG("AES128Stream", critical) << "failed to initialize aes gcm context" << IBRCOMMON_LOGGER_ENDL;
+
+		// init the GCM message
+		gcm_init_message(reinterpret_cast<unsigned char *>(&_gcm_iv), sizeof(gcm_iv), &_ctx);
+#endif
 	}
 
 	void AES128Stream::getIV(unsigned char (&to_iv)[iv_len]) const
@@ -83,14 +108,34 @@ namespace ibrcommon
 
 	void AES128Stream::getTag(unsigned char (&to_tag)[tag_len])
 	{
+#ifdef IBRCOMMON_AES128_EVP_GCM
+		// openssl only provides the tag of an encryption
+		if (_mode != CIPHER_ENCRYPT)
+			throw ibrcommon::Exception("tag is only available in encryption mode");
+
+		if (!finalize())
+			throw ibrcommon::Exception("tag generation failed");
+
+		::memcpy(to_tag, _tag, tag_len);
+#else
 		ret_type rr = gcm_compute_tag((unsigned char*)to_tag, tag_len, &_ctx);
 
 		if (rr != RETURN_OK)
 			throw ibrcommon::Exception("tag generation failed");
+#endif
 	}
 
 	bool AES128Stream::verify(const unsigned char (&verify_tag)[tag_len])
 	{
+#ifdef IBRCOMMON_AES128_EVP_GCM
+		if (_mode == CIPHER_DECRYPT)
+		{
+			// the expected tag has to be known before finalization
+			if (!_finalized) ::memcpy(_tag, verify_tag, tag_len);
+			return finalize() && (::memcmp(_tag, verify_tag, tag_len) == 0);
+		}
+#endif
+
 		try {
 			// compute the current tag
 			unsigned char tag[tag_len]; getTag(tag);
@@ -102,13 +147,50 @@ namespace ibrcommon
 		}
 	}
 
+#ifdef IBRCOMMON_AES128_EVP_GCM
+	bool AES128Stream::finalize()
+	{
+		if (_finalized) return _final_result;
+		_finalized = true;
+
+		// GCM does not produce any output on finalization
+		unsigned char buf[EVP_MAX_BLOCK_LENGTH];
+		int len = 0;
+
+		if (_ctx == NULL) return false;
+
+		if (_mode == CIPHER_ENCRYPT)
+		{
+			_final_result = EVP_CipherFinal_ex(_ctx, buf, &len)
+				&& EVP_CIPHER_CTX_ctrl(_ctx, EVP_CTRL_GCM_GET_TAG, tag_len, _tag);
+		}
+		else
+		{
+			_final_result = EVP_CIPHER_CTX_ctrl(_ctx, EVP_CTRL_GCM_SET_TAG, tag_len, _tag)
+				&& (EVP_CipherFinal_ex(_ctx, buf, &len) > 0);
+		}
+
+		return _final_result;
+	}
+#endif
+
 	void AES128Stream::encrypt(char *buf, const size_t size)
 	{
+#ifdef IBRCOMMON_AES128_EVP_GCM
+		int len = 0;
+		EVP_CipherUpdate(_ctx, reinterpret_cast<unsigned char *>(buf), &len, reinterpret_cast<unsigned char *>(buf), static_cast<int>(size));
+#else
 		gcm_encrypt(reinterpret_cast<unsigned char *>(buf), size, &_ctx);
+#endif
 	}
 
 	void AES128Stream::decrypt(char *buf, const size_t size)
 	{
+#ifdef IBRCOMMON_AES128_EVP_GCM
+		int len = 0;
+		EVP_CipherUpdate(_ctx, reinterpret_cast<unsigned char *>(buf), &len, reinterpret_cast<unsigned char *>(buf), static_cast<int>(size));
+#else
 		gcm_decrypt(reinterpret_cast<unsigned char *>(buf), size, &_ctx);
+#endif
 	}
 }
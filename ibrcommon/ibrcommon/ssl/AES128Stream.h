@@ -26,8 +26,17 @@
 #include <ostream>
 #include <sys/types.h>
 #include <stdint.h>
+#include <string.h>
 #include "ibrcommon/ssl/CipherStream.h"
+#include <openssl/evp.h>
+
+// use the EVP interface of openssl for AES-GCM if available, it
+// makes use of hardware acceleration (e.g. AES-NI) if present
+#if defined(EVP_CTRL_GCM_SET_IVLEN) && !defined(IBRCOMMON_DISABLE_EVP_GCM)
+#define IBRCOMMON_AES128_EVP_GCM 1
+#else
 #include "ibrcommon/ssl/gcm/gcm.h"
+#endif
 
 namespace ibrcommon
 {
@@ -51,7 +60,7 @@ namespace ibrcommon
 			/** the number of bytes of the verification tag */
 			static const size_t tag_len = 16;
 			/** the size of the buffer in which the data will be streamed */
-			static const size_t BUFF_SIZE = 2048;
+			static const size_t BUFF_SIZE = 16384;
 
 			/**
 			Creates a AES128Stream object, either for encrypting or decrypting,
@@ -97,6 +106,9 @@ namespace ibrcommon
 			virtual void decrypt(char *buf, const size_t size);
 
 		private:
+			/** initialize the cipher context with the key and the IV */
+			void init(const unsigned char key[key_size_in_bytes]);
+
 			/** a way of putting salt and initialisation_vector together in memory,
 			without the use of memcpy().\n
 			TODO it needs to be tested if this behave on little and big endian
@@ -109,8 +121,25 @@ namespace ibrcommon
 			/** the instance of the gcm_iv struct */
 			gcm_iv _gcm_iv;
 
+#ifdef IBRCOMMON_AES128_EVP_GCM
+			/** finalize the cipher context and verify or compute the tag */
+			bool finalize();
+
 			/** the openssl context used for the AES operations */
+			EVP_CIPHER_CTX *_ctx;
+
+			/** true, if the context has been finalized */
+			bool _finalized;
+
+			/** the result of the finalization */
+			bool _final_result;
+
+			/** the computed or expected authentication tag */
+			unsigned char _tag[tag_len];
+#else
+			/** the gcm context used for the AES operations */
 			gcm_ctx _ctx;
+#endif
 
 			/**
 			since the initilisation vector will be refilled with random bytes after encryption, a copy of the last one is stored here
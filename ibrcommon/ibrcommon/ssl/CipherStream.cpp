@@ -35,22 +35,24 @@ namespace ibrcommon
 
 	void CipherStream::encrypt(std::iostream& stream)
 	{
-		char buf[4096];
+		// process the stream in large chunks to keep the number
+		// of seek operations and cipher calls low
+		std::vector<char> buf(CHUNK_SIZE);
 		while (!stream.eof())
 		{
 			std::ios::pos_type pos = stream.tellg();
 
-			stream.read((char*)&buf, 4096);
+			stream.read(&buf[0], buf.size());
 			size_t bytes = stream.gcount();
 
-			encrypt(buf, bytes);
+			encrypt(&buf[0], bytes);
 
 			// clear the error flags if we reached the end of the file
 			// but need to write some data
 			if (stream.eof() && (bytes > 0)) stream.clear();
 
 			stream.seekp(pos, std::ios::beg);
-			stream.write((char*)&buf, bytes);
+			stream.write(&buf[0], bytes);
 		}
 
 		stream.flush();
@@ -59,22 +61,24 @@ namespace ibrcommon
 
 	void CipherStream::decrypt(std::iostream& stream)
 	{
-		char buf[4096];
+		// process the stream in large chunks to keep the number
+		// of seek operations and cipher calls low
+		std::vector<char> buf(CHUNK_SIZE);
 		while (!stream.eof())
 		{
 			std::ios::pos_type pos = stream.tellg();
 
-			stream.read((char*)&buf, 4096);
+			stream.read(&buf[0], buf.size());
 			size_t bytes = stream.gcount();
 
-			decrypt(buf, bytes);
+			decrypt(&buf[0], bytes);
 
 			// clear the error flags if we reached the end of the file
 			// but need to write some data
 			if (stream.eof() && (bytes > 0)) stream.clear();
 
 			stream.seekp(pos, std::ios::beg);
-			stream.write((char*)&buf, bytes);
+			stream.write(&buf[0], bytes);
 		}
 
 		stream.flush();
@@ -38,6 +38,9 @@ namespace ibrcommon
 			CIPHER_DECRYPT = 1
 		};
 
+		/** the size of the chunks used to process seekable streams in place */
+		static const size_t CHUNK_SIZE = 65536;
+
 		CipherStream(std::ostream &stream, const CipherMode mode = CIPHER_DECRYPT, const size_t buffer = 2048);
 		virtual ~CipherStream();
 
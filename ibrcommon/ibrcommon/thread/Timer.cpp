@@ -23,10 +23,7 @@
 #include "ibrcommon/thread/Timer.h"
 #include "ibrcommon/thread/MutexLock.h"
 
-#include <iostream>
-#include <queue>
-#include <utility>
-#include <sstream>
+#include <time.h>
 
 namespace ibrcommon
 {
@@ -41,112 +38,128 @@ namespace ibrcommon
 	}
 
 	Timer::Timer(TimerCallback &callback, size_t timeout)
-	 : _state(TIMER_UNSET), _callback(callback), _timeout(timeout * 1000)
+	 : _callback(callback), _timeout(timeout), _running(false), _paused(false)
 	{
 	}
 
 	Timer::~Timer()
 	{
 		stop();
-		join();
 	}
 
-	void Timer::__cancellation() throw ()
+	void Timer::start() throw (ThreadException)
 	{
-		MutexLock l(_state);
-		_state.setState(TIMER_CANCELLED);
-		_state.abort();
+		MutexLock l(_lock);
+		if (_running) return;
+
+		// a timer without timeout stops immediately
+		if (_timeout == 0) return;
+
+		_running = true;
+		_paused = false;
+		TimerWheel::getInstance().schedule(*this, _timeout * 1000);
+	}
+
+	void Timer::stop() throw ()
+	{
+		{
+			MutexLock l(_lock);
+			_running = false;
+		}
+
+		// wait until a running callback is done
+		TimerWheel::getInstance().cancel(*this);
+	}
+
+	void Timer::join() throw ()
+	{
+		if (isRunning()) return;
+		TimerWheel::getInstance().cancel(*this);
+	}
+
+	bool Timer::isRunning()
+	{
+		MutexLock l(_lock);
+		return _running;
 	}
 
 	void Timer::set(size_t timeout)
 	{
-		MutexLock l(_state);
-		_timeout = timeout * 1000;
-		_state.setState(TIMER_RESET);
+		MutexLock l(_lock);
+		_timeout = timeout;
+
+		if (!_running) return;
+
+		if (_timeout == 0)
+		{
+			_running = false;
+			TimerWheel::getInstance().cancel(*this, false);
+		}
+		else
+		{
+			_paused = false;
+			TimerWheel::getInstance().schedule(*this, _timeout * 1000);
+		}
 	}
 
 	void Timer::reset()
 	{
-		MutexLock l(_state);
-		_state.setState(TIMER_RESET);
+		MutexLock l(_lock);
+		if (!_running) return;
+
+		_paused = false;
+		TimerWheel::getInstance().schedule(*this, _timeout * 1000);
 	}
 
 	void Timer::pause()
 	{
-		MutexLock l(_state);
-		_state.setState(TIMER_STOPPED);
+		MutexLock l(_lock);
+		if (!_running) return;
+
+		_paused = true;
+		TimerWheel::getInstance().cancel(*this, false);
 	}
 
 	size_t Timer::getTimeout() const
 	{
-		return _timeout / 1000;
+		return _timeout;
 	}
 
-	void Timer::run() throw ()
+	void Timer::expired() throw ()
 	{
-		MutexLock l(_state);
-		_state.setState(TIMER_RUNNING);
+		{
+			MutexLock l(_lock);
+			if (!_running || _paused) return;
+		}
+
+		size_t timeout = 0;
+
+		try {
+			// timeout exceeded, call callback method
+			timeout = _callback.timeout(this);
+		} catch (const StopTimerException&) {
+			// stop the timer until it is reset
+			MutexLock l(_lock);
+			_paused = true;
+			return;
+		} catch (const std::exception&) {
+			// an exception from the callback stops the timer
+			timeout = 0;
+		}
+
+		MutexLock l(_lock);
 
-		while (_state.ifState(TIMER_RUNNING) || _state.ifState(TIMER_STOPPED))
+		// the timer has been stopped meanwhile
+		if (!_running || _paused) return;
+
+		_timeout = timeout;
+
+		if (_timeout == 0)
 		{
-			try {
-				if(_state.ifState(TIMER_RUNNING))
-				{
-					if(_timeout > 0)
-					{
-						_state.wait(_timeout);
-					}
-					else
-					{
-						throw ibrcommon::Conditional::ConditionalAbortException(ibrcommon::Conditional::ConditionalAbortException::COND_ABORT);
-					}
-				}
-				else
-				{
-					_state.wait();
-				}
-
-				// got signal, check for reset request
-				if (_state.ifState(TIMER_RESET))
-				{
-					_state.setState(TIMER_RUNNING);
-				}
-				else if(!_state.ifState(TIMER_STOPPED))
-				{
-					// stop the timer
-					_state.setState(TIMER_CANCELLED);
-				}
-			}
-			catch (const ibrcommon::Conditional::ConditionalAbortException &ex)
-			{
-				switch (ex.reason)
-				{
-					case ibrcommon::Conditional::ConditionalAbortException::COND_TIMEOUT:
-					{
-						try
-						{
-							// timeout exceeded, call callback method
-							_timeout = _callback.timeout(this) * 1000;
-							_state.setState(TIMER_RUNNING);
-						}
-						catch(const StopTimerException &ex)
-						{
-							// stop the timer
-							_state.setState(TIMER_STOPPED);
-						}
-						break;
-					}
-
-					case ibrcommon::Conditional::ConditionalAbortException::COND_ABORT:
-					case ibrcommon::Conditional::ConditionalAbortException::COND_ERROR:
-					{
-						_state.setState(TIMER_CANCELLED);
-						return;
-					}
-				}
-			}
-
-			yield();
+			_running = false;
+			return;
 		}
+
+		TimerWheel::getInstance().schedule(*this, _timeout * 1000);
 	}
 }
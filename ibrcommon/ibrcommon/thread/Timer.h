@@ -23,7 +23,8 @@
 #define IBRCOMMON_TIMER_H_
 
 #include "ibrcommon/thread/Thread.h"
-#include "ibrcommon/thread/Conditional.h"
+#include "ibrcommon/thread/Mutex.h"
+#include "ibrcommon/thread/TimerWheel.h"
 #include <map>
 #include <set>
 
@@ -48,7 +49,11 @@ namespace ibrcommon
 		virtual size_t timeout(Timer *timer) = 0;
 	};
 
-	class Timer : public JoinableThread
+	/**
+	 * A timer calling back once the timeout is exceeded. All timers share
+	 * the timing wheel of the process instead of running an own thread.
+	 */
+	class Timer : private TimerWheel::Task
 	{
 	public:
 		typedef size_t time_t;
@@ -80,23 +85,35 @@ namespace ibrcommon
 		 */
 		size_t getTimeout() const;
 
+		/**
+		 * Start the timer
+		 */
+		void start() throw (ThreadException);
+
+		/**
+		 * Stop the timer. The timer can be started again.
+		 */
+		void stop() throw ();
+
+		/**
+		 * Wait until a running callback of this timer has been finished
+		 */
+		void join() throw ();
+
+		/**
+		 * Returns true, if the timer has been started and not stopped
+		 */
+		bool isRunning();
+
 	protected:
-		void run() throw ();
-		void __cancellation() throw ();
+		void expired() throw ();
 
 	private:
-		enum TIMER_STATE
-		{
-			TIMER_UNSET = 0,
-			TIMER_RUNNING = 1,
-			TIMER_RESET = 2,
-			TIMER_STOPPED = 3,
-			TIMER_CANCELLED = 4
-		};
-
-		StatefulConditional<Timer::TIMER_STATE, TIMER_STOPPED> _state;
+		Mutex _lock;
 		TimerCallback &_callback;
 		size_t _timeout;
+		bool _running;
+		bool _paused;
 	public:
 		class StopTimerException : public ibrcommon::Exception
 		{
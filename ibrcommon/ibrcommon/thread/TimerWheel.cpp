@@ -0,0 +1,325 @@
+/*
+ * TimerWheel.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrcommon/config.h"
+#include "ibrcommon/thread/TimerWheel.h"
+#include "ibrcommon/thread/MutexLock.h"
+#include "ibrcommon/MonotonicClock.h"
+
+namespace ibrcommon
+{
+	const size_t TimerWheel::RESOLUTION = 10;
+
+	TimerWheel::Task::Task()
+	 : _prev(NULL), _next(NULL), _slot(NULL), _deadline(0), _wheel(NULL)
+	{
+	}
+
+	TimerWheel::Task::~Task()
+	{
+		if (_wheel != NULL) _wheel->cancel(*this);
+	}
+
+	bool TimerWheel::Task::isScheduled() const
+	{
+		return (_slot != NULL);
+	}
+
+	TimerWheel& TimerWheel::getInstance()
+	{
+		// the wheel is never destroyed, since tasks may be cancelled in static destructors
+		static TimerWheel *instance = new TimerWheel();
+		return *instance;
+	}
+
+	TimerWheel::TimerWheel()
+	 : _size(0), _tick(now()), _expired(NULL), _wakeup(0), _current(NULL), _worker_id(pthread_self()), _running(true), _worker(*this)
+	{
+		for (unsigned int level = 0; level < LEVELS; ++level)
+		{
+			_counts[level] = 0;
+			for (unsigned int i = 0; i < SLOTS; ++i) _slots[level][i] = NULL;
+		}
+
+		_worker.start();
+	}
+
+	TimerWheel::~TimerWheel()
+	{
+		_worker.stop();
+		_worker.join();
+	}
+
+	uint64_t TimerWheel::now()
+	{
+		struct timespec ts;
+		MonotonicClock::gettime(ts);
+		return ((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000) / RESOLUTION;
+	}
+
+	void TimerWheel::schedule(Task &task, size_t timeout) throw ()
+	{
+		MutexLock l(_cond);
+
+		if (task._slot != NULL) __unlink(task);
+
+		// round up to the next tick, but never schedule into the current one
+		task._deadline = now() + (timeout + RESOLUTION - 1) / RESOLUTION;
+		if (task._deadline <= _tick) task._deadline = _tick + 1;
+
+		task._wheel = this;
+		__link(task);
+
+		// wake-up the worker if the task expires before the planned wake-up
+		if ((_wakeup == 0) || (task._deadline < _wakeup)) _cond.signal(true);
+	}
+
+	void TimerWheel::cancel(Task &task, bool wait) throw ()
+	{
+		MutexLock l(_cond);
+
+		if (task._slot != NULL) __unlink(task);
+		if (!wait) return;
+
+		// wait until a running execution of the task is done,
+		// unless the task cancels itself
+		try {
+			while ((_current == &task) && !pthread_equal(pthread_self(), _worker_id)) _cond.wait();
+		} catch (const Conditional::ConditionalAbortException&) { }
+	}
+
+	size_t TimerWheel::size()
+	{
+		MutexLock l(_cond);
+		return _size;
+	}
+
+	void TimerWheel::__link(Task &task)
+	{
+		const uint64_t delta = task._deadline - _tick;
+
+		// select the level covering the remaining time
+		unsigned int level = 0;
+		while ((level < (LEVELS - 1)) && (delta >= ((uint64_t)1 << (SLOT_BITS * (level + 1))))) level++;
+
+		// tasks beyond the range of the wheel are placed into the last slot
+		// and re-linked each time they are cascaded
+		uint64_t position = task._deadline;
+		if (delta >= ((uint64_t)1 << (SLOT_BITS * LEVELS))) position = _tick + ((uint64_t)1 << (SLOT_BITS * LEVELS)) - 1;
+
+		Task **head = &_slots[level][(position >> (SLOT_BITS * level)) & SLOT_MASK];
+
+		task._prev = NULL;
+		task._next = (*head);
+		if (task._next != NULL) task._next->_prev = &task;
+		(*head) = &task;
+		task._slot = head;
+
+		_counts[level]++;
+		_size++;
+	}
+
+	void TimerWheel::__unlink(Task &task)
+	{
+		if (task._prev != NULL) task._prev->_next = task._next;
+		else (*task._slot) = task._next;
+
+		if (task._next != NULL) task._next->_prev = task._prev;
+
+		if (task._slot != &_expired)
+		{
+			_counts[(task._slot - &_slots[0][0]) / SLOTS]--;
+		}
+
+		task._prev = NULL;
+		task._next = NULL;
+		task._slot = NULL;
+		_size--;
+	}
+
+	void TimerWheel::__advance(const uint64_t &tick, Task *&expired)
+	{
+		while (_tick < tick)
+		{
+			if (_size == 0)
+			{
+				_tick = tick;
+				return;
+			}
+
+			if (_counts[0] == 0)
+			{
+				// nothing to expire in the lower level, jump to the next cascade
+				const uint64_t next = (_tick | SLOT_MASK) + 1;
+				_tick = (next < tick) ? next : tick;
+			}
+			else
+			{
+				++_tick;
+			}
+
+			if ((_tick & SLOT_MASK) == 0) __cascade();
+
+			// move all tasks of the current slot to the list of expired tasks
+			Task *&head = _slots[0][_tick & SLOT_MASK];
+			while (head != NULL)
+			{
+				Task &task = (*head);
+				__unlink(task);
+
+				task._next = expired;
+				if (expired != NULL) expired->_prev = &task;
+				expired = &task;
+				task._slot = &expired;
+				_size++;
+			}
+		}
+	}
+
+	void TimerWheel::__cascade()
+	{
+		for (unsigned int level = 1; level < LEVELS; ++level)
+		{
+			const unsigned int idx = (_tick >> (SLOT_BITS * level)) & SLOT_MASK;
+
+			Task *list = _slots[level][idx];
+			_slots[level][idx] = NULL;
+
+			while (list != NULL)
+			{
+				Task &task = (*list);
+				list = task._next;
+
+				_counts[level]--;
+				_size--;
+
+				__link(task);
+			}
+
+			// stop if the upper level is not at a boundary
+			if (idx != 0) break;
+		}
+	}
+
+	uint64_t TimerWheel::__next() const
+	{
+		if (_size == 0) return 0;
+
+		uint64_t next = 0;
+
+		// the lowest level contains tasks which expire within the next round
+		if (_counts[0] > 0)
+		{
+			for (uint64_t k = 1; k < SLOTS; ++k)
+			{
+				if (_slots[0][(_tick + k) & SLOT_MASK] != NULL)
+				{
+					next = _tick + k;
+					break;
+				}
+			}
+		}
+
+		// upper levels are processed at the next cascade of their slot
+		for (unsigned int level = 1; level < LEVELS; ++level)
+		{
+			if (_counts[level] == 0) continue;
+
+			const uint64_t base = _tick >> (SLOT_BITS * level);
+
+			for (uint64_t k = 1; k <= SLOTS; ++k)
+			{
+				if (_slots[level][(base + k) & SLOT_MASK] != NULL)
+				{
+					const uint64_t cascade = (base + k) << (SLOT_BITS * level);
+					if ((next == 0) || (cascade < next)) next = cascade;
+					break;
+				}
+			}
+		}
+
+		return next;
+	}
+
+	void TimerWheel::__run()
+	{
+		MutexLock l(_cond);
+		_worker_id = pthread_self();
+
+		while (_running)
+		{
+			__advance(now(), _expired);
+
+			// execute all expired tasks without holding the lock
+			while (_expired != NULL)
+			{
+				Task &task = (*_expired);
+				__unlink(task);
+				_current = &task;
+
+				_cond.leave();
+				task.expired();
+				_cond.enter();
+
+				_current = NULL;
+				_cond.signal(true);
+			}
+
+			_wakeup = __next();
+
+			try {
+				if (_wakeup == 0)
+				{
+					_cond.wait();
+				}
+				else
+				{
+					const uint64_t current = now();
+					if (_wakeup > current) _cond.wait((_wakeup - current) * RESOLUTION);
+				}
+			} catch (const Conditional::ConditionalAbortException &ex) {
+				if (ex.reason != Conditional::ConditionalAbortException::COND_TIMEOUT) _running = false;
+			}
+		}
+	}
+
+	TimerWheel::Worker::Worker(TimerWheel &wheel)
+	 : _wheel(wheel)
+	{
+	}
+
+	TimerWheel::Worker::~Worker()
+	{
+		join();
+	}
+
+	void TimerWheel::Worker::run() throw ()
+	{
+		_wheel.__run();
+	}
+
+	void TimerWheel::Worker::__cancellation() throw ()
+	{
+		MutexLock l(_wheel._cond);
+		_wheel._running = false;
+		_wheel._cond.abort();
+	}
+}
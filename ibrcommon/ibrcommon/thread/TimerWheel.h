@@ -0,0 +1,175 @@
+/*
+ * TimerWheel.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IBRCOMMON_TIMERWHEEL_H_
+#define IBRCOMMON_TIMERWHEEL_H_
+
+#include "ibrcommon/thread/Thread.h"
+#include "ibrcommon/thread/Conditional.h"
+#include <stdint.h>
+#include <pthread.h>
+
+namespace ibrcommon
+{
+	/**
+	 * A hierarchical timing wheel shared by all timers of the process.
+	 * Tasks are scheduled and cancelled in O(1). One thread advances the
+	 * wheel and sleeps until the next occupied slot, thus an empty wheel
+	 * does not wake up at all. Expired tasks are executed by this thread
+	 * and should return quickly.
+	 */
+	class TimerWheel
+	{
+	public:
+		class Task
+		{
+		public:
+			Task();
+
+			/**
+			 * Cancels the task if it is still scheduled
+			 */
+			virtual ~Task();
+
+			/**
+			 * Returns true, if the task is scheduled on the wheel
+			 */
+			bool isScheduled() const;
+
+		protected:
+			/**
+			 * Called by the wheel thread once the deadline is reached.
+			 * The task may re-schedule itself within this call.
+			 */
+			virtual void expired() throw () = 0;
+
+		private:
+			friend class TimerWheel;
+
+			Task *_prev;
+			Task *_next;
+			Task **_slot;
+			uint64_t _deadline;
+
+			// set once the task has been scheduled
+			TimerWheel *_wheel;
+		};
+
+		/**
+		 * Returns the shared instance of the timing wheel
+		 */
+		static TimerWheel& getInstance();
+
+		/**
+		 * Schedule a task. An already scheduled task is moved to the new deadline.
+		 * @param task The task to schedule.
+		 * @param timeout Timeout in milliseconds.
+		 */
+		void schedule(Task &task, size_t timeout) throw ();
+
+		/**
+		 * Remove a task from the wheel. If the task is currently executed by
+		 * another thread, this call blocks until the execution is done.
+		 * @param wait Set to false to return without waiting for the execution.
+		 */
+		void cancel(Task &task, bool wait = true) throw ();
+
+		/**
+		 * Returns the number of scheduled tasks
+		 */
+		size_t size();
+
+		/**
+		 * Resolution of the wheel in milliseconds
+		 */
+		static const size_t RESOLUTION;
+
+	private:
+		class Worker : public JoinableThread
+		{
+		public:
+			Worker(TimerWheel &wheel);
+			virtual ~Worker();
+
+		protected:
+			void run() throw ();
+			void __cancellation() throw ();
+
+		private:
+			TimerWheel &_wheel;
+		};
+
+		static const unsigned int LEVELS = 4;
+		static const unsigned int SLOT_BITS = 8;
+		static const unsigned int SLOTS = (1 << SLOT_BITS);
+		static const uint64_t SLOT_MASK = (SLOTS - 1);
+
+		TimerWheel();
+		virtual ~TimerWheel();
+
+		/**
+		 * Returns the current time in ticks
+		 */
+		static uint64_t now();
+
+		void __link(Task &task);
+		void __unlink(Task &task);
+
+		/**
+		 * Move forward to the given tick and collect all expired tasks
+		 */
+		void __advance(const uint64_t &tick, Task *&expired);
+
+		/**
+		 * Move the tasks of the upper levels into the lower ones
+		 */
+		void __cascade();
+
+		/**
+		 * Returns the tick of the next slot to process
+		 * or zero if the wheel is empty
+		 */
+		uint64_t __next() const;
+
+		void __run();
+
+		Conditional _cond;
+		Task* _slots[LEVELS][SLOTS];
+		size_t _counts[LEVELS];
+		size_t _size;
+		uint64_t _tick;
+
+		// expired tasks waiting for execution
+		Task *_expired;
+
+		// tick the worker is going to wake up, zero if it sleeps infinitely
+		uint64_t _wakeup;
+
+		// task executed by the worker, used to make cancel() synchronous
+		Task *_current;
+		pthread_t _worker_id;
+		bool _running;
+
+		Worker _worker;
+	};
+}
+
+#endif /* IBRCOMMON_TIMERWHEEL_H_ */
@@ -0,0 +1,296 @@
+/*
+ * vsockettest.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrcommon/config.h"
+#include "net/vsockettest.h"
+#include "ibrcommon/net/vsocket.h"
+#include "ibrcommon/thread/Thread.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (vsockettest);
+
+class SelectThread : public ibrcommon::JoinableThread
+{
+public:
+	SelectThread(ibrcommon::vsocket &sock)
+	 : interrupted(false), _sock(sock) { }
+
+	virtual ~SelectThread() {
+		join();
+	}
+
+	bool interrupted;
+
+protected:
+	void run() throw () {
+		try {
+			ibrcommon::socketset fds;
+			_sock.select(&fds, NULL, NULL, NULL);
+		} catch (const ibrcommon::vsocket_interrupt&) {
+			interrupted = true;
+		} catch (const ibrcommon::socket_exception&) {
+		}
+	}
+
+	void __cancellation() throw () { }
+
+private:
+	ibrcommon::vsocket &_sock;
+};
+
+/**
+ * socket which creates a new socketpair on each up()
+ */
+class ReopenSocket : public ibrcommon::basesocket
+{
+public:
+	ReopenSocket() : peer(-1) { }
+	virtual ~ReopenSocket() { }
+
+	void up() throw (ibrcommon::socket_exception) {
+		int fds[2];
+		if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) throw ibrcommon::socket_exception("socketpair failed");
+		_fd = fds[0];
+		peer = fds[1];
+		_state = SOCKET_UP;
+	}
+
+	void down() throw (ibrcommon::socket_exception) {
+		this->close();
+		::close(peer);
+		peer = -1;
+	}
+
+	int peer;
+};
+
+void vsockettest :: setUp (void)
+{
+}
+
+void vsockettest :: tearDown (void)
+{
+}
+
+void vsockettest :: testTimeout (void)
+{
+	int fds[2];
+	CPPUNIT_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+	ibrcommon::vsocket sock;
+	sock.add(new ibrcommon::tcpsocket(fds[0]));
+	sock.up();
+
+	struct timeval tv;
+	tv.tv_sec = 0;
+	tv.tv_usec = 100000;
+
+	ibrcommon::socketset readset;
+	CPPUNIT_ASSERT_THROW(sock.select(&readset, NULL, NULL, &tv), ibrcommon::vsocket_timeout);
+	CPPUNIT_ASSERT(readset.empty());
+
+	// the remaining time is returned in the timeout value
+	CPPUNIT_ASSERT(!timerisset(&tv));
+
+	sock.destroy();
+	::close(fds[1]);
+}
+
+void vsockettest :: testInterrupt (void)
+{
+	int fds[2];
+	CPPUNIT_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+	ibrcommon::vsocket sock;
+	sock.add(new ibrcommon::tcpsocket(fds[0]));
+	sock.up();
+
+	SelectThread t(sock);
+	t.start();
+
+	// give the thread some time to block in select
+	ibrcommon::Thread::sleep(100);
+
+	// shutdown interrupts the blocking select call
+	sock.down();
+	t.join();
+
+	CPPUNIT_ASSERT(t.interrupted);
+
+	sock.destroy();
+	::close(fds[1]);
+}
+
+void vsockettest :: testLevelTrigger (void)
+{
+	int fds[2];
+	CPPUNIT_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+	ibrcommon::vsocket sock(ibrcommon::vsocket::TRIGGER_LEVEL);
+	sock.add(new ibrcommon::tcpsocket(fds[0]));
+	sock.up();
+
+	CPPUNIT_ASSERT(::write(fds[1], "x", 1) == 1);
+
+	// the socket is returned as long as data is pending
+	for (int i = 0; i < 2; ++i)
+	{
+		struct timeval tv;
+		tv.tv_sec = 1;
+		tv.tv_usec = 0;
+
+		ibrcommon::socketset readset;
+		sock.select(&readset, NULL, NULL, &tv);
+		CPPUNIT_ASSERT_EQUAL((size_t)1, readset.size());
+	}
+
+	sock.destroy();
+	::close(fds[1]);
+}
+
+void vsockettest :: testEdgeTrigger (void)
+{
+	int fds[2];
+	CPPUNIT_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+	ibrcommon::vsocket sock(ibrcommon::vsocket::TRIGGER_EDGE);
+	sock.add(new ibrcommon::tcpsocket(fds[0]));
+	sock.up();
+
+	struct timeval tv;
+	ibrcommon::socketset readset;
+
+	CPPUNIT_ASSERT(::write(fds[1], "x", 1) == 1);
+
+	tv.tv_sec = 1;
+	tv.tv_usec = 0;
+	sock.select(&readset, NULL, NULL, &tv);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, readset.size());
+
+#ifdef HAVE_SYS_EPOLL_H
+	// no new data arrived, so the pending byte is not reported again
+	readset.clear();
+	tv.tv_sec = 0;
+	tv.tv_usec = 100000;
+	CPPUNIT_ASSERT_THROW(sock.select(&readset, NULL, NULL, &tv), ibrcommon::vsocket_timeout);
+#endif
+
+	// new data triggers the next edge
+	CPPUNIT_ASSERT(::write(fds[1], "y", 1) == 1);
+
+	readset.clear();
+	tv.tv_sec = 1;
+	tv.tv_usec = 0;
+	sock.select(&readset, NULL, NULL, &tv);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, readset.size());
+
+	sock.destroy();
+	::close(fds[1]);
+}
+
+void vsockettest :: testHighDescriptors (void)
+{
+#ifdef HAVE_SYS_EPOLL_H
+	// make sure enough file descriptors are available
+	struct rlimit rl;
+	CPPUNIT_ASSERT(::getrlimit(RLIMIT_NOFILE, &rl) == 0);
+	if (rl.rlim_cur < FD_SETSIZE + 64) {
+		if (rl.rlim_max < FD_SETSIZE + 64) return;
+		rl.rlim_cur = FD_SETSIZE + 64;
+		CPPUNIT_ASSERT(::setrlimit(RLIMIT_NOFILE, &rl) == 0);
+	}
+
+	// occupy all descriptors below FD_SETSIZE
+	std::vector<int> fillers;
+	int fd = -1;
+	while ((fd = ::open("/dev/null", O_RDONLY)) < FD_SETSIZE) {
+		CPPUNIT_ASSERT(fd >= 0);
+		fillers.push_back(fd);
+	}
+	fillers.push_back(fd);
+
+	int fds[2];
+	CPPUNIT_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+	CPPUNIT_ASSERT(fds[0] >= FD_SETSIZE);
+
+	{
+		ibrcommon::vsocket sock;
+		sock.add(new ibrcommon::tcpsocket(fds[0]));
+		sock.up();
+
+		CPPUNIT_ASSERT(::write(fds[1], "x", 1) == 1);
+
+		struct timeval tv;
+		tv.tv_sec = 1;
+		tv.tv_usec = 0;
+
+		ibrcommon::socketset readset;
+		sock.select(&readset, NULL, NULL, &tv);
+		CPPUNIT_ASSERT_EQUAL((size_t)1, readset.size());
+
+		sock.destroy();
+	}
+
+	::close(fds[1]);
+
+	for (std::vector<int>::const_iterator iter = fillers.begin(); iter != fillers.end(); ++iter)
+		::close(*iter);
+#endif
+}
+
+void vsockettest :: testReopen (void)
+{
+	ReopenSocket *rs = new ReopenSocket();
+
+	ibrcommon::vsocket sock;
+	sock.add(rs);
+	sock.up();
+
+	struct timeval tv;
+	tv.tv_sec = 0;
+	tv.tv_usec = 10000;
+
+	ibrcommon::socketset readset;
+	CPPUNIT_ASSERT_THROW(sock.select(&readset, NULL, NULL, &tv), ibrcommon::vsocket_timeout);
+
+	// re-open the socket without notice to the vsocket, the fd number is reused
+	rs->down();
+	rs->up();
+
+	CPPUNIT_ASSERT(::write(rs->peer, "x", 1) == 1);
+
+	tv.tv_sec = 1;
+	tv.tv_usec = 0;
+
+	readset.clear();
+	sock.select(&readset, NULL, NULL, &tv);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, readset.size());
+
+	sock.destroy();
+}
@@ -0,0 +1,52 @@
+/*
+ * vsockettest.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VSOCKETTEST_H_
+#define VSOCKETTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class vsockettest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (vsockettest);
+	CPPUNIT_TEST (testTimeout);
+	CPPUNIT_TEST (testInterrupt);
+	CPPUNIT_TEST (testLevelTrigger);
+	CPPUNIT_TEST (testEdgeTrigger);
+	CPPUNIT_TEST (testHighDescriptors);
+	CPPUNIT_TEST (testReopen);
+	CPPUNIT_TEST_SUITE_END ();
+
+	public:
+		void setUp (void);
+		void tearDown (void);
+
+	protected:
+		void testTimeout (void);
+		void testInterrupt (void);
+		void testLevelTrigger (void);
+		void testEdgeTrigger (void);
+		void testHighDescriptors (void);
+		void testReopen (void);
+};
+
+#endif /* VSOCKETTEST_H_ */
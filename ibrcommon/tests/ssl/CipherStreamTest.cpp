@@ -317,3 +317,63 @@ void CipherStreamTest::aesstream_test01()
 		throw ibrcommon::Exception("aesstream_test01 failed. data could not decrypted");
 	}
 }
+
+void CipherStreamTest::aesstream_test02()
+{
+	uint32_t salt = 42;
+	unsigned char iv[ibrcommon::AES128Stream::iv_len];
+	unsigned char etag[ibrcommon::AES128Stream::tag_len];
+	unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes];
+
+	for (unsigned int i = 0; i < ibrcommon::AES128Stream::key_size_in_bytes; ++i)
+	{
+		key[i] = static_cast<unsigned char>(i);
+	}
+
+	// test data spanning several chunks
+	std::string testdata;
+	for (size_t i = 0; i < (3 * ibrcommon::CipherStream::CHUNK_SIZE) + 17; ++i)
+	{
+		testdata.push_back(_plain_data[i % 1024]);
+	}
+
+	std::stringstream data(testdata);
+
+	// encrypt the test data in place
+	{
+		ibrcommon::AES128Stream crypt_stream(ibrcommon::CipherStream::CIPHER_ENCRYPT, data, key, salt);
+		((ibrcommon::CipherStream&)crypt_stream).encrypt(data);
+		crypt_stream.getIV(iv);
+		crypt_stream.getTag(etag);
+	}
+
+	CPPUNIT_ASSERT_EQUAL(testdata.length(), data.str().length());
+	CPPUNIT_ASSERT(data.str() != testdata);
+
+	const std::string ciphertext = data.str();
+
+	// decrypt with a modified tag
+	{
+		unsigned char tag[ibrcommon::AES128Stream::tag_len];
+		::memcpy(tag, etag, ibrcommon::AES128Stream::tag_len);
+		tag[0] ^= 0x01;
+
+		std::stringstream tmp(ciphertext);
+		ibrcommon::AES128Stream crypt_stream(ibrcommon::CipherStream::CIPHER_DECRYPT, tmp, key, salt, iv);
+		((ibrcommon::CipherStream&)crypt_stream).decrypt(tmp);
+		CPPUNIT_ASSERT(!crypt_stream.verify(tag));
+	}
+
+	// decrypt the data in place
+	{
+		data.clear();
+		data.seekg(0);
+		data.seekp(0);
+
+		ibrcommon::AES128Stream crypt_stream(ibrcommon::CipherStream::CIPHER_DECRYPT, data, key, salt, iv);
+		((ibrcommon::CipherStream&)crypt_stream).decrypt(data);
+		CPPUNIT_ASSERT(crypt_stream.verify(etag));
+	}
+
+	CPPUNIT_ASSERT(data.str() == testdata);
+}
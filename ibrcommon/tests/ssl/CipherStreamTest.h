@@ -39,6 +39,7 @@ class CipherStreamTest : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST (xorstream_test04);
 
 	CPPUNIT_TEST (aesstream_test01);
+	CPPUNIT_TEST (aesstream_test02);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -52,6 +53,7 @@ protected:
 	void xorstream_test04();
 
 	void aesstream_test01();
+	void aesstream_test02();
 
 private:
 	// stores some plain data generated while setUp
@@ -21,6 +21,9 @@
 
 #include "StressBLOB.h"
 #include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/data/FileCache.h>
+#include <ibrcommon/TimeMeasurement.h>
+#include <stdlib.h>
 
 StressBLOB::StressBLOB()
 {
@@ -32,6 +35,11 @@ StressBLOB::StressBLOB()
 
 StressBLOB::~StressBLOB()
 {
+	for (std::list<ReadWorker*>::const_iterator iter = _reader.begin(); iter != _reader.end(); ++iter)
+	{
+		delete (*iter);
+	}
+
 	for (std::list<BLOBWorker*>::const_iterator iter = _worker.begin(); iter != _worker.end(); ++iter)
 	{
 		delete (*iter);
@@ -54,11 +62,37 @@ void StressBLOB::stage2()
 void StressBLOB::stage3()
 {
 	for (std::list<BLOBWorker*>::const_iterator iter = _worker.begin(); iter != _worker.end(); ++iter)
+	{
+		(*iter)->join();
+		(*iter)->getFiles(_files);
+	}
+
+	std::cout << "#" << std::endl;
+
+	// read the written files with 200 parallel readers
+	for (unsigned int i = 0; i < 200; ++i)
+	{
+		_reader.push_back(new ReadWorker(_files, 1000, i));
+	}
+
+	ibrcommon::TimeMeasurement tm;
+	tm.start();
+
+	for (std::list<ReadWorker*>::const_iterator iter = _reader.begin(); iter != _reader.end(); ++iter)
+	{
+		(*iter)->start();
+	}
+
+	for (std::list<ReadWorker*>::const_iterator iter = _reader.begin(); iter != _reader.end(); ++iter)
 	{
 		(*iter)->join();
 	}
 
+	tm.stop();
+
 	std::cout << "#" << std::endl;
+	std::cout << _reader.size() << " readers: " << tm.getMilliseconds() << " ms, "
+			<< ibrcommon::FileCache::getInstance().size() << " of " << ibrcommon::FileCache::getInstance().getLimit() << " descriptors open" << std::endl;
 }
 
 bool StressBLOB::check()
@@ -70,6 +104,18 @@ bool StressBLOB::check()
 		std::cout << "$";
 	}
 
+	for (std::list<ReadWorker*>::const_iterator iter = _reader.begin(); iter != _reader.end(); ++iter)
+	{
+		if (!(*iter)->check()) err = true;
+	}
+
+	// the cache must not exceed its limit
+	if (ibrcommon::FileCache::getInstance().size() > ibrcommon::FileCache::getInstance().getLimit())
+	{
+		std::cerr << "ERROR: too many open descriptors" << std::endl;
+		err = true;
+	}
+
 	std::cout << std::endl;
 
 	return !err;
@@ -134,3 +180,75 @@ void StressBLOB::BLOBWorker::run() throw ()
 void StressBLOB::BLOBWorker::__cancellation() throw ()
 {
 }
+
+void StressBLOB::BLOBWorker::getFiles(std::vector<ibrcommon::File> &files)
+{
+	for (std::list<ibrcommon::BLOB::Reference>::iterator iter = _refs.begin(); iter != _refs.end(); ++iter)
+	{
+		ibrcommon::BLOB::iostream stream = (*iter).iostream();
+		const ibrcommon::File *f = stream.file();
+		if (f != NULL) files.push_back(*f);
+	}
+}
+
+StressBLOB::ReadWorker::ReadWorker(const std::vector<ibrcommon::File> &files, const size_t count, const unsigned int seed)
+ : _files(files), _count(count), _seed(seed), _errors(0), teststr("0123456789")
+{
+}
+
+StressBLOB::ReadWorker::~ReadWorker()
+{
+}
+
+bool StressBLOB::ReadWorker::check()
+{
+	return (_errors == 0);
+}
+
+void StressBLOB::ReadWorker::run() throw ()
+{
+	if (_files.empty()) return;
+
+	char buf[1000];
+
+	for (size_t i = 0; i < _count; ++i)
+	{
+		const ibrcommon::File &f = _files[rand_r(&_seed) % _files.size()];
+
+		try {
+			ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::open(f);
+			ibrcommon::BLOB::iostream stream = ref.iostream();
+
+			// read a chunk at a random position
+			const std::streamsize offset = rand_r(&_seed) % (stream.size() - sizeof(buf));
+			(*stream).seekg(offset);
+			(*stream).read(buf, sizeof(buf));
+
+			if ((*stream).gcount() != sizeof(buf))
+			{
+				std::cerr << "ERROR: short read on " << f.getPath() << std::endl;
+				_errors++;
+				continue;
+			}
+
+			for (size_t k = 0; k < sizeof(buf); ++k)
+			{
+				if (buf[k] != teststr[(offset + k) % teststr.length()])
+				{
+					std::cerr << "ERROR: wrong letter found at offset " << (offset + k) << " of " << f.getPath() << std::endl;
+					_errors++;
+					break;
+				}
+			}
+		} catch (const ibrcommon::Exception &ex) {
+			std::cerr << "ERROR: " << ex.what() << std::endl;
+			_errors++;
+		}
+	}
+
+	std::cout << "." << std::flush;
+}
+
+void StressBLOB::ReadWorker::__cancellation() throw ()
+{
+}
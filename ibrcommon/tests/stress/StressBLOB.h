@@ -23,6 +23,7 @@
 #include <ibrcommon/data/BLOB.h>
 #include <ibrcommon/thread/Thread.h>
 #include <list>
+#include <vector>
 
 #ifndef STRESSBLOB_H_
 #define STRESSBLOB_H_
@@ -50,6 +51,11 @@ private:
 		bool check();
 		void __cancellation() throw ();
 
+		/**
+		 * Collect the files of all written BLOBs
+		 */
+		void getFiles(std::vector<ibrcommon::File> &files);
+
 	private:
 		size_t _count;
 		size_t _size;
@@ -58,7 +64,30 @@ private:
 		std::list<ibrcommon::BLOB::Reference> _refs;
 	};
 
+	/**
+	 * Reads from random positions of shared files through FileBLOBs
+	 */
+	class ReadWorker : public ibrcommon::JoinableThread
+	{
+	public:
+		ReadWorker(const std::vector<ibrcommon::File> &files, const size_t count, const unsigned int seed);
+		virtual ~ReadWorker();
+
+		void run() throw ();
+		bool check();
+		void __cancellation() throw ();
+
+	private:
+		const std::vector<ibrcommon::File> &_files;
+		size_t _count;
+		unsigned int _seed;
+		size_t _errors;
+		std::string teststr;
+	};
+
 	std::list<BLOBWorker*> _worker;
+	std::list<ReadWorker*> _reader;
+	std::vector<ibrcommon::File> _files;
 };
 
 #endif /* STRESSBLOB_H_ */
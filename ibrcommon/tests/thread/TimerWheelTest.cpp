@@ -0,0 +1,212 @@
+/*
+ * TimerWheelTest.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "thread/TimerWheelTest.h"
+#include <ibrcommon/thread/Timer.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/TimeMeasurement.h>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TimerWheelTest);
+
+class RecordingTask : public ibrcommon::TimerWheel::Task
+{
+public:
+	RecordingTask(int id, ibrcommon::Conditional &cond, std::vector<int> &fired)
+	 : _id(id), _cond(cond), _fired(fired)
+	{
+	}
+
+	virtual ~RecordingTask()
+	{
+		ibrcommon::TimerWheel::getInstance().cancel(*this);
+	}
+
+protected:
+	void expired() throw ()
+	{
+		ibrcommon::MutexLock l(_cond);
+		_fired.push_back(_id);
+		_cond.signal(true);
+	}
+
+private:
+	const int _id;
+	ibrcommon::Conditional &_cond;
+	std::vector<int> &_fired;
+};
+
+class CountingCallback : public ibrcommon::TimerCallback
+{
+public:
+	CountingCallback() : count(0) { }
+	virtual ~CountingCallback() { }
+
+	size_t timeout(ibrcommon::Timer*)
+	{
+		ibrcommon::MutexLock l(cond);
+		count++;
+		cond.signal(true);
+
+		// stop after the third call
+		if (count >= 3) throw ibrcommon::Timer::StopTimerException();
+		return 1;
+	}
+
+	ibrcommon::Conditional cond;
+	int count;
+};
+
+static void waitFor(ibrcommon::Conditional &cond, std::vector<int> &fired, size_t num, size_t timeout)
+{
+	ibrcommon::MutexLock l(cond);
+	try {
+		while (fired.size() < num) cond.wait(timeout);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) { }
+}
+
+void TimerWheelTest::setUp()
+{
+}
+
+void TimerWheelTest::tearDown()
+{
+}
+
+void TimerWheelTest::testOrder()
+{
+	ibrcommon::Conditional cond;
+	std::vector<int> fired;
+
+	RecordingTask t1(1, cond, fired);
+	RecordingTask t2(2, cond, fired);
+	RecordingTask t3(3, cond, fired);
+
+	ibrcommon::TimerWheel &wheel = ibrcommon::TimerWheel::getInstance();
+	wheel.schedule(t3, 300);
+	wheel.schedule(t1, 50);
+	wheel.schedule(t2, 150);
+
+	waitFor(cond, fired, 3, 2000);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)3, fired.size());
+	CPPUNIT_ASSERT_EQUAL(1, fired[0]);
+	CPPUNIT_ASSERT_EQUAL(2, fired[1]);
+	CPPUNIT_ASSERT_EQUAL(3, fired[2]);
+	CPPUNIT_ASSERT(!t1.isScheduled());
+}
+
+void TimerWheelTest::testCancel()
+{
+	ibrcommon::Conditional cond;
+	std::vector<int> fired;
+
+	RecordingTask t1(1, cond, fired);
+	RecordingTask t2(2, cond, fired);
+
+	ibrcommon::TimerWheel &wheel = ibrcommon::TimerWheel::getInstance();
+	wheel.schedule(t1, 100);
+	wheel.schedule(t2, 200);
+	CPPUNIT_ASSERT(t1.isScheduled());
+
+	wheel.cancel(t1);
+	CPPUNIT_ASSERT(!t1.isScheduled());
+
+	waitFor(cond, fired, 1, 1000);
+	ibrcommon::Thread::sleep(200);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)1, fired.size());
+	CPPUNIT_ASSERT_EQUAL(2, fired[0]);
+}
+
+void TimerWheelTest::testReschedule()
+{
+	ibrcommon::Conditional cond;
+	std::vector<int> fired;
+
+	RecordingTask t1(1, cond, fired);
+	RecordingTask t2(2, cond, fired);
+
+	ibrcommon::TimerWheel &wheel = ibrcommon::TimerWheel::getInstance();
+	wheel.schedule(t1, 100);
+	wheel.schedule(t2, 200);
+
+	// move the first task behind the second one
+	wheel.schedule(t1, 400);
+
+	waitFor(cond, fired, 2, 2000);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)2, fired.size());
+	CPPUNIT_ASSERT_EQUAL(2, fired[0]);
+	CPPUNIT_ASSERT_EQUAL(1, fired[1]);
+}
+
+void TimerWheelTest::testCascade()
+{
+	ibrcommon::Conditional cond;
+	std::vector<int> fired;
+
+	RecordingTask t1(1, cond, fired);
+	RecordingTask t2(2, cond, fired);
+
+	// the timeout exceeds the lowest level of the wheel
+	const size_t timeout = ibrcommon::TimerWheel::RESOLUTION * 300;
+
+	ibrcommon::TimeMeasurement tm;
+	tm.start();
+
+	ibrcommon::TimerWheel &wheel = ibrcommon::TimerWheel::getInstance();
+	wheel.schedule(t1, timeout);
+
+	// a far away task must not disturb the near one
+	wheel.schedule(t2, 3600 * 1000);
+
+	waitFor(cond, fired, 1, timeout * 2);
+	tm.stop();
+
+	CPPUNIT_ASSERT_EQUAL((size_t)1, fired.size());
+	CPPUNIT_ASSERT_EQUAL(1, fired[0]);
+	CPPUNIT_ASSERT(tm.getMilliseconds() + ibrcommon::TimerWheel::RESOLUTION >= timeout);
+	CPPUNIT_ASSERT(t2.isScheduled());
+}
+
+void TimerWheelTest::testTimer()
+{
+	CountingCallback cb;
+	ibrcommon::Timer timer(cb, 1);
+	timer.start();
+
+	{
+		ibrcommon::MutexLock l(cb.cond);
+		try {
+			while (cb.count < 3) cb.cond.wait(5000);
+		} catch (const ibrcommon::Conditional::ConditionalAbortException&) { }
+	}
+
+	CPPUNIT_ASSERT_EQUAL(3, cb.count);
+
+	// the timer is paused but still running
+	CPPUNIT_ASSERT(timer.isRunning());
+
+	timer.stop();
+	CPPUNIT_ASSERT(!timer.isRunning());
+}
@@ -0,0 +1,52 @@
+/*
+ * TimerWheelTest.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef TIMERWHEELTEST_H_
+#define TIMERWHEELTEST_H_
+
+#include <ibrcommon/thread/TimerWheel.h>
+
+class TimerWheelTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TimerWheelTest);
+	CPPUNIT_TEST (testOrder);
+	CPPUNIT_TEST (testCancel);
+	CPPUNIT_TEST (testReschedule);
+	CPPUNIT_TEST (testCascade);
+	CPPUNIT_TEST (testTimer);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void testOrder();
+	void testCancel();
+	void testReschedule();
+	void testCascade();
+	void testTimer();
+};
+
+#endif /* TIMERWHEELTEST_H_ */
@@ -32,7 +32,10 @@
 
 #include "BloomFilterTest.hh"
 #include "ibrcommon/data/BloomFilter.h"
+#include "ibrcommon/TimeMeasurement.h"
+#include "ibrcommon/Exceptions.h"
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <string>
 #include <string.h>
@@ -108,6 +111,45 @@ void BloomFilterTest::testHash()
 
 }
 
+void BloomFilterTest::testHashCompat()
+{
+	/* the hash values are part of the encoding of a Bloom-filter */
+	const ibrcommon::bloom_type salts[] = { 0xAAAAAAAA, 0x55555555, 0x33333333 };
+	const std::string keys[] = { "", "a", "example", "dtn://node1/app" };
+
+	ibrcommon::DefaultHashProvider Provider(3);
+
+	for (size_t k = 0; k < 4; ++k)
+	{
+		const unsigned char *data = reinterpret_cast<const unsigned char*>(keys[k].c_str());
+		ibrcommon::bloom_type hashes[3];
+		Provider.hash(data, keys[k].length(), hashes);
+
+		for (size_t i = 0; i < 3; ++i)
+		{
+			// reference implementation of the AP hash
+			ibrcommon::bloom_type hash = salts[i];
+			const unsigned char *it = data;
+			size_t remaining_length = keys[k].length();
+			while (remaining_length >= 2)
+			{
+				hash ^=    (hash <<  7) ^  (*it++) * (hash >> 3);
+				hash ^= (~((hash << 11) + ((*it++) ^ (hash >> 5))));
+				remaining_length -= 2;
+			}
+			if (remaining_length)
+			{
+				hash ^= (hash <<  7) ^ (*it) * (hash >> 3);
+			}
+
+			CPPUNIT_ASSERT_EQUAL(hash, hashes[i]);
+		}
+
+		const std::list<ibrcommon::bloom_type> l = Provider.hash(data, keys[k].length());
+		CPPUNIT_ASSERT(std::list<ibrcommon::bloom_type>(hashes, hashes + 3) == l);
+	}
+}
+
 /*=== END   tests for class 'DefaultHashProvider' ===*/
 
 /*=== BEGIN tests for class 'BloomFilter' ===*/
@@ -524,8 +566,220 @@ void BloomFilterTest::testMemory()
 	CPPUNIT_ASSERT(!Filter1.contains("test"));
 
 }
+void BloomFilterTest::testContainsMany()
+{
+	ibrcommon::BloomFilter Filter(1024,1024,3);
+	std::vector<std::string> words;
+	std::vector<const unsigned char*> keys;
+	std::vector<size_t> lengths;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		std::stringstream ss; ss << "word-" << i;
+		words.push_back(ss.str());
+		if (i % 2 == 0) Filter.insert(ss.str());
+	}
+
+	for (size_t i = 0; i < words.size(); ++i)
+	{
+		keys.push_back(reinterpret_cast<const unsigned char*>(words[i].c_str()));
+		lengths.push_back(words[i].length());
+	}
+
+	bool result[100];
+	size_t found = Filter.contains_many(&keys[0], &lengths[0], words.size(), result);
+
+	size_t expected = 0;
+	for (size_t i = 0; i < words.size(); ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL(Filter.contains(words[i]), result[i]);
+		if (i % 2 == 0) CPPUNIT_ASSERT(result[i]);
+		if (result[i]) expected++;
+	}
+	CPPUNIT_ASSERT_EQUAL(expected, found);
+}
 /*=== END   tests for class 'BloomFilter' ===*/
 
+/*=== BEGIN tests for class 'BlockedBloomFilter' ===*/
+void BloomFilterTest::testBlockedInsert()
+{
+	ibrcommon::BlockedBloomFilter Filter(1000, 4);
+
+	// the table size is rounded up to the block size
+	CPPUNIT_ASSERT_EQUAL((size_t)1024, Filter.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, reinterpret_cast<size_t>(Filter.table()) % ibrcommon::BlockedBloomFilter::block_size);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		std::stringstream ss; ss << "word-" << i;
+		Filter.insert(ss.str());
+		CPPUNIT_ASSERT(Filter.contains(ss.str()));
+	}
+
+	// the false positive rate has to be low
+	size_t positives = 0;
+	for (int i = 0; i < 1000; ++i)
+	{
+		std::stringstream ss; ss << "other-" << i;
+		if (Filter.contains(ss.str())) positives++;
+	}
+	CPPUNIT_ASSERT(positives < 20);
+
+	Filter.clear();
+	CPPUNIT_ASSERT(!Filter.contains("word-1"));
+
+	ibrcommon::BlockedBloomFilter Empty(0, 2);
+	CPPUNIT_ASSERT(!Empty);
+	Empty.insert("test");
+	CPPUNIT_ASSERT(!Empty.contains("test"));
+}
+
+void BloomFilterTest::testBlockedLoad()
+{
+	ibrcommon::BlockedBloomFilter FilterA(256, 2);
+	FilterA.insert("hello");
+	FilterA.insert("world");
+
+	// copy the encoded table into another filter
+	ibrcommon::BlockedBloomFilter FilterB(64, 2);
+	FilterB.load(FilterA.table(), FilterA.size());
+	CPPUNIT_ASSERT_EQUAL(FilterA.size(), FilterB.size());
+	CPPUNIT_ASSERT(FilterB.contains("hello"));
+	CPPUNIT_ASSERT(FilterB.contains("world"));
+
+	ibrcommon::BlockedBloomFilter FilterC(FilterB);
+	CPPUNIT_ASSERT(FilterC.contains("hello"));
+
+	ibrcommon::BlockedBloomFilter FilterD;
+	FilterD = FilterC;
+	CPPUNIT_ASSERT(FilterD.contains("world"));
+	CPPUNIT_ASSERT_EQUAL((size_t)256, FilterD.size());
+
+	CPPUNIT_ASSERT_THROW(FilterD.load(FilterA.table(), 100), ibrcommon::Exception);
+}
+
+void BloomFilterTest::testBlockedContainsMany()
+{
+	ibrcommon::BlockedBloomFilter Filter(1024, 3);
+	std::vector<std::string> words;
+	std::vector<const unsigned char*> keys;
+	std::vector<size_t> lengths;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		std::stringstream ss; ss << "word-" << i;
+		words.push_back(ss.str());
+		if (i % 2 == 0) Filter.insert(ss.str());
+	}
+
+	for (size_t i = 0; i < words.size(); ++i)
+	{
+		keys.push_back(reinterpret_cast<const unsigned char*>(words[i].c_str()));
+		lengths.push_back(words[i].length());
+	}
+
+	bool result[100];
+	size_t found = Filter.contains_many(&keys[0], &lengths[0], words.size(), result);
+
+	size_t expected = 0;
+	for (size_t i = 0; i < words.size(); ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL(Filter.contains(words[i]), result[i]);
+		if (i % 2 == 0) CPPUNIT_ASSERT(result[i]);
+		if (result[i]) expected++;
+	}
+	CPPUNIT_ASSERT_EQUAL(expected, found);
+}
+/*=== END   tests for class 'BlockedBloomFilter' ===*/
+
+void BloomFilterTest::testBenchmark()
+{
+	const size_t items = 10000;
+	const size_t rounds = 50;
+
+	// keys similar to the raw representation of a bundle id
+	std::vector<std::string> words;
+	std::vector<const unsigned char*> keys;
+	std::vector<size_t> lengths;
+	for (size_t i = 0; i < items; ++i)
+	{
+		std::stringstream ss;
+		ss << "0000000123456789" << "00000000" << i << "dtn://node-" << (i % 100) << "/application";
+		words.push_back(ss.str());
+	}
+	for (size_t i = 0; i < items; ++i)
+	{
+		keys.push_back(reinterpret_cast<const unsigned char*>(words[i].c_str()));
+		lengths.push_back(words[i].length());
+	}
+
+	bool *res = new bool[items];
+
+	// tables larger than the common cache sizes
+	ibrcommon::BloomFilter bf(1 << 22, 1 << 22, 2);
+	ibrcommon::BlockedBloomFilter bbf(1 << 22, 2);
+	for (size_t i = 0; i < items; i += 2)
+	{
+		bf.insert(words[i]);
+		bbf.insert(words[i]);
+	}
+
+	ibrcommon::TimeMeasurement tm;
+	size_t found = 0;
+
+	std::cout << std::endl;
+
+	ibrcommon::DefaultHashProvider hp(2);
+	tm.start();
+	for (size_t r = 0; r < rounds; ++r)
+		for (size_t i = 0; i < items; ++i)
+			found += hp.hash(keys[i], lengths[i]).size();
+	tm.stop();
+	std::cout << "DefaultHashProvider::hash (list): " << (size_t)((double)(items * rounds) / tm.getMilliseconds() * 1000.0) << " keys per second" << std::endl;
+
+	ibrcommon::bloom_type hashes[2];
+	tm.start();
+	for (size_t r = 0; r < rounds; ++r)
+		for (size_t i = 0; i < items; ++i)
+		{
+			hp.hash(keys[i], lengths[i], hashes);
+			found += (hashes[0] != 0) ? 1 : 0;
+		}
+	tm.stop();
+	std::cout << "DefaultHashProvider::hash (array): " << (size_t)((double)(items * rounds) / tm.getMilliseconds() * 1000.0) << " keys per second" << std::endl;
+
+	tm.start();
+	for (size_t r = 0; r < rounds; ++r)
+		for (size_t i = 0; i < items; ++i)
+			if (bf.contains(keys[i], lengths[i])) found++;
+	tm.stop();
+	std::cout << "BloomFilter::contains: " << (size_t)((double)(items * rounds) / tm.getMilliseconds() * 1000.0) << " lookups per second" << std::endl;
+
+	tm.start();
+	for (size_t r = 0; r < rounds; ++r)
+		found += bf.contains_many(&keys[0], &lengths[0], items, res);
+	tm.stop();
+	std::cout << "BloomFilter::contains_many: " << (size_t)((double)(items * rounds) / tm.getMilliseconds() * 1000.0) << " lookups per second" << std::endl;
+
+	tm.start();
+	for (size_t r = 0; r < rounds; ++r)
+		for (size_t i = 0; i < items; ++i)
+			if (bbf.contains(keys[i], lengths[i])) found++;
+	tm.stop();
+	std::cout << "BlockedBloomFilter::contains: " << (size_t)((double)(items * rounds) / tm.getMilliseconds() * 1000.0) << " lookups per second" << std::endl;
+
+	tm.start();
+	for (size_t r = 0; r < rounds; ++r)
+		found += bbf.contains_many(&keys[0], &lengths[0], items, res);
+	tm.stop();
+	std::cout << "BlockedBloomFilter::contains_many: " << (size_t)((double)(items * rounds) / tm.getMilliseconds() * 1000.0) << " lookups per second" << std::endl;
+
+	delete[] res;
+
+	// at least the inserted half of the keys is found in all runs
+	CPPUNIT_ASSERT(found >= 4 * rounds * (items / 2));
+}
+
 void BloomFilterTest::setUp()
 {
 }
@@ -25,6 +25,7 @@ class BloomFilterTest : public CppUnit::TestFixture {
 		void testCount();
 		void testHashClear();
 		void testHash();
+		void testHashCompat();
 		/*=== END   tests for class 'DefaultHashProvider' ===*/
 
 		/*=== BEGIN tests for class 'BloomFilter' ===*/
@@ -42,8 +43,17 @@ class BloomFilterTest : public CppUnit::TestFixture {
 		void testGrow();
 
 		void testMemory();
+		void testContainsMany();
 		/*=== END   tests for class 'BloomFilter' ===*/
 
+		/*=== BEGIN tests for class 'BlockedBloomFilter' ===*/
+		void testBlockedInsert();
+		void testBlockedLoad();
+		void testBlockedContainsMany();
+		/*=== END   tests for class 'BlockedBloomFilter' ===*/
+
+		void testBenchmark();
+
 		void setUp();
 		void tearDown();
 
@@ -53,6 +63,7 @@ class BloomFilterTest : public CppUnit::TestFixture {
 			CPPUNIT_TEST(testCount);
 			CPPUNIT_TEST(testHashClear);
 			CPPUNIT_TEST(testHash);
+			CPPUNIT_TEST(testHashCompat);
 			CPPUNIT_TEST(testLoad);
 			CPPUNIT_TEST(testOperatorAssign);
 			CPPUNIT_TEST(testOperatorNot);
@@ -67,6 +78,13 @@ class BloomFilterTest : public CppUnit::TestFixture {
 			CPPUNIT_TEST(testGrow);
 
 			CPPUNIT_TEST(testMemory);
+			CPPUNIT_TEST(testContainsMany);
+
+			CPPUNIT_TEST(testBlockedInsert);
+			CPPUNIT_TEST(testBlockedLoad);
+			CPPUNIT_TEST(testBlockedContainsMany);
+
+			CPPUNIT_TEST(testBenchmark);
 		CPPUNIT_TEST_SUITE_END();
 };
 #endif /* BLOOMFILTERTEST_HH */
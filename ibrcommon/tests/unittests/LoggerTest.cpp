@@ -0,0 +1,116 @@
+/*
+ * LoggerTest.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "LoggerTest.hh"
+#include "ibrcommon/Logger.h"
+#include "ibrcommon/thread/Thread.h"
+#include <sstream>
+#include <string>
+#include <list>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LoggerTest);
+
+class LoggingThread : public ibrcommon::JoinableThread
+{
+public:
+	LoggingThread(size_t count) : _count(count) { };
+	virtual ~LoggingThread() { join(); };
+
+protected:
+	void run() throw ()
+	{
+		for (size_t i = 0; i < _count; ++i)
+		{
+			IBRCOMMON_LOGGER_TAG("LoggerTest", notice) << "message " << i << IBRCOMMON_LOGGER_ENDL;
+		}
+	}
+
+	void __cancellation() throw () { };
+
+private:
+	const size_t _count;
+};
+
+void LoggerTest::setUp()
+{
+}
+
+void LoggerTest::tearDown()
+{
+}
+
+void LoggerTest::testSync()
+{
+	std::stringstream ss;
+	ibrcommon::Logger::addStream(ss, ibrcommon::Logger::LOGGER_ALL, ibrcommon::Logger::LOG_TAG);
+
+	IBRCOMMON_LOGGER_TAG("LoggerTest", notice) << "hello world" << IBRCOMMON_LOGGER_ENDL;
+
+	ibrcommon::Logger::removeStream(ss);
+
+	CPPUNIT_ASSERT_EQUAL(std::string("LoggerTest: hello world\n"), ss.str());
+}
+
+void LoggerTest::testAsync()
+{
+	const size_t threads = 4;
+	const size_t messages = 2000;
+
+	std::stringstream ss;
+	ibrcommon::Logger::addStream(ss, ibrcommon::Logger::LOGGER_ALL, ibrcommon::Logger::LOG_NONE);
+
+	// use a small buffer to provoke dropped messages
+	ibrcommon::Logger::enableAsync(64);
+
+	{
+		std::list<LoggingThread*> producers;
+
+		for (size_t i = 0; i < threads; ++i)
+		{
+			LoggingThread *t = new LoggingThread(messages);
+			producers.push_back(t);
+			t->start();
+		}
+
+		for (std::list<LoggingThread*>::iterator iter = producers.begin(); iter != producers.end(); ++iter)
+		{
+			delete (*iter);
+		}
+	}
+
+	// write all queued messages
+	ibrcommon::Logger::stop();
+	ibrcommon::Logger::removeStream(ss);
+
+	size_t written = 0;
+	bool reported = false;
+
+	std::string line;
+	while (std::getline(ss, line))
+	{
+		if (line.find("log messages dropped") != std::string::npos) reported = true;
+		else written++;
+	}
+
+	// each message is either written or counted as dropped
+	CPPUNIT_ASSERT_EQUAL(threads * messages, written + ibrcommon::Logger::getDropped());
+	CPPUNIT_ASSERT_EQUAL(ibrcommon::Logger::getDropped() > 0, reported);
+}
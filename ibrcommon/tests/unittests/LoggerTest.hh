@@ -0,0 +1,41 @@
+/*
+ * LoggerTest.hh
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef LOGGERTEST_HH
+#define LOGGERTEST_HH
+class LoggerTest : public CppUnit::TestFixture {
+	private:
+	public:
+		void testSync();
+		void testAsync();
+
+		void setUp();
+		void tearDown();
+
+		CPPUNIT_TEST_SUITE(LoggerTest);
+			CPPUNIT_TEST(testSync);
+			CPPUNIT_TEST(testAsync);
+		CPPUNIT_TEST_SUITE_END();
+};
+#endif /* LOGGERTEST_HH */
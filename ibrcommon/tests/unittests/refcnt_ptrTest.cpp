@@ -32,6 +32,11 @@
 
 #include "refcnt_ptrTest.hh"
 #include <ibrcommon/refcnt_ptr.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/TimeMeasurement.h>
+#include <iostream>
+#include <string>
+#include <list>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(refcnt_ptrTest);
@@ -41,6 +46,47 @@ CPPUNIT_TEST_SUITE_REGISTRATION(refcnt_ptrTest);
 /*=== BEGIN tests for class 'refcnt_ptr' ===*/
 /*=== END   tests for class 'refcnt_ptr' ===*/
 
+/**
+ * counts the number of deleted instances
+ */
+class CountedObject
+{
+public:
+	CountedObject() { };
+	~CountedObject() { __sync_add_and_fetch(&deleted, 1); };
+
+	static volatile unsigned deleted;
+};
+
+volatile unsigned CountedObject::deleted = 0;
+
+class CopyThread : public ibrcommon::JoinableThread
+{
+public:
+	CopyThread(const refcnt_ptr<CountedObject> &ref, size_t count) : _ref(ref), _count(count) { };
+	virtual ~CopyThread() { join(); };
+
+protected:
+	void run() throw ()
+	{
+		for (size_t i = 0; i < _count; ++i)
+		{
+			refcnt_ptr<CountedObject> copy(_ref);
+			refcnt_ptr<CountedObject> other(new CountedObject());
+
+			// drop the reference to the shared object temporarily
+			copy = other;
+			copy = _ref;
+		}
+	}
+
+	void __cancellation() throw () { };
+
+private:
+	const refcnt_ptr<CountedObject> _ref;
+	const size_t _count;
+};
+
 void refcnt_ptrTest::setUp()
 {
 }
@@ -58,3 +104,47 @@ void refcnt_ptrTest::testSelfAssignment()
 	test = copy;
 }
 
+void refcnt_ptrTest::testCopyBenchmark()
+{
+	const size_t threads = 8;
+	const size_t copies = 100000;
+
+	CountedObject::deleted = 0;
+
+	{
+		refcnt_ptr<CountedObject> ref(new CountedObject());
+
+		ibrcommon::TimeMeasurement tm;
+		std::list<CopyThread*> workers;
+
+		for (size_t i = 0; i < threads; ++i)
+		{
+			workers.push_back(new CopyThread(ref, copies));
+		}
+
+		tm.start();
+
+		for (std::list<CopyThread*>::iterator it = workers.begin(); it != workers.end(); ++it)
+		{
+			(*it)->start();
+		}
+
+		for (std::list<CopyThread*>::iterator it = workers.begin(); it != workers.end(); ++it)
+		{
+			(*it)->join();
+			delete (*it);
+		}
+
+		tm.stop();
+
+		// only the temporary objects of the threads are deleted
+		CPPUNIT_ASSERT_EQUAL((unsigned)(threads * copies), (unsigned)CountedObject::deleted);
+
+		// each iteration copies the shared reference twice
+		std::cout << std::endl << threads << " threads: "
+				<< static_cast<size_t>((threads * copies * 2) / (tm.getMicroseconds() / 1000000.0)) << " copies/s" << std::flush;
+	}
+
+	// the last reference deletes the shared object
+	CPPUNIT_ASSERT_EQUAL((unsigned)(threads * copies + 1), (unsigned)CountedObject::deleted);
+}
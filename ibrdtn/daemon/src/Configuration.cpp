@@ -93,7 +93,7 @@ namespace dtn
 		 : _quiet(false), _options(0), _timestamps(false), _verbose(false) {}
 
 		Configuration::Network::Network()
-		 : _routing("default"), _forwarding(true), _accept_nonsingleton(true), _prefer_direct(true), _tcp_nodelay(true), _tcp_chunksize(4096), _tcp_idle_timeout(0), _keepalive_timeout(60), _default_net("lo"), _use_default_net(false), _auto_connect(0), _fragmentation(false), _scheduling(false), _managed_connectivity(false), _link_request_interval(5000)
+		 : _routing("default"), _forwarding(true), _accept_nonsingleton(true), _prefer_direct(true), _tcp_nodelay(true), _tcp_chunksize(4096), _tcp_idle_timeout(0), _tcp_reactor_threads(0), _keepalive_timeout(60), _default_net("lo"), _use_default_net(false), _auto_connect(0), _fragmentation(false), _scheduling(false), _managed_connectivity(false), _link_request_interval(5000)
 		{}
 
 		Configuration::Security::Security()
@@ -672,6 +672,26 @@ namespace dtn
 			return _conf.read<std::string>("use_persistent_bundlesets", "no") == "yes";
 		}
 
+		std::string Configuration::getSQLiteJournalMode() const
+		{
+			return _conf.read<std::string>("storage_sqlite_journal", "wal");
+		}
+
+		std::string Configuration::getSQLiteSynchronous() const
+		{
+			return _conf.read<std::string>("storage_sqlite_sync", "normal");
+		}
+
+		dtn::data::Size Configuration::getSQLiteBatchSize() const
+		{
+			return _conf.read<dtn::data::Size>("storage_sqlite_batch_size", 100);
+		}
+
+		dtn::data::Size Configuration::getSQLiteBatchDelay() const
+		{
+			return _conf.read<dtn::data::Size>("storage_sqlite_batch_delay", 100);
+		}
+
 		void Configuration::Network::load(const ibrcommon::ConfigFile &conf)
 		{
 			/**
@@ -900,6 +920,7 @@ namespace dtn
 			_tcp_nodelay = (conf.read<std::string>("tcp_nodelay", "yes") == "yes");
 			_tcp_chunksize = conf.read<unsigned int>("tcp_chunksize", 4096);
 			_tcp_idle_timeout = conf.read<unsigned int>("tcp_idle_timeout", 0);
+			_tcp_reactor_threads = conf.read<unsigned int>("tcp_reactor_threads", 0);
 
 			/**
 			 * Keep alive interval for network connections
@@ -1037,6 +1058,11 @@ namespace dtn
 			return _tcp_idle_timeout;
 		}
 
+		size_t Configuration::Network::getTCPReactorThreads() const
+		{
+			return _tcp_reactor_threads;
+		}
+
 		dtn::data::Timeout Configuration::Network::getKeepaliveInterval() const
 		{
 			return _keepalive_timeout;
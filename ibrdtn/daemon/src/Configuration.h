@@ -140,6 +140,26 @@ namespace dtn
 
 			bool getUsePersistentBundleSets() const;
 
+			/**
+			 * Returns the journal mode of the sqlite storage (e.g. wal, delete)
+			 */
+			std::string getSQLiteJournalMode() const;
+
+			/**
+			 * Returns the durability of commits in the sqlite storage (off, normal, full)
+			 */
+			std::string getSQLiteSynchronous() const;
+
+			/**
+			 * Returns the maximum number of bundles written in one transaction
+			 */
+			dtn::data::Size getSQLiteBatchSize() const;
+
+			/**
+			 * Returns the maximum delay in milliseconds until written bundles are committed
+			 */
+			dtn::data::Size getSQLiteBatchDelay() const;
+
 			enum RoutingExtension
 			{
 				DEFAULT_ROUTING = 0,
@@ -321,6 +341,7 @@ namespace dtn
 				bool _tcp_nodelay;
 				dtn::data::Length _tcp_chunksize;
 				dtn::data::Timeout _tcp_idle_timeout;
+				size_t _tcp_reactor_threads;
 				dtn::data::Timeout _keepalive_timeout;
 				ibrcommon::vinterface _default_net;
 				bool _use_default_net;
@@ -386,6 +407,12 @@ namespace dtn
 				 */
 				dtn::data::Timeout getTCPIdleTimeout() const;
 
+				/**
+				 * @return The number of reactor threads for TCP connections,
+				 * zero uses dedicated threads for each connection.
+				 */
+				size_t getTCPReactorThreads() const;
+
 				/**
 				 * @return The keep-alive interval for network connections.
 				 */
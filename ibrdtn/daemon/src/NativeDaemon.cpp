@@ -23,6 +23,7 @@
 #include "NativeDaemon.h"
 
 #include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/data/FileCache.h>
 #include <ibrcommon/data/File.h>
 #include <ibrcommon/net/vinterface.h>
 #include <ibrcommon/Logger.h>
@@ -1101,15 +1102,22 @@ namespace dtn
 					IBRCOMMON_LOGGER_TAG(NativeDaemon::TAG, info) << "using sqlite bundle storage in " << path.getPath() << IBRCOMMON_LOGGER_ENDL;
 
 
+					// durability and write batching of the database
+					dtn::storage::SQLiteDatabase::Options options;
+					options.journal_mode = conf.getSQLiteJournalMode();
+					options.synchronous = conf.getSQLiteSynchronous();
+					options.batch_size = conf.getSQLiteBatchSize();
+					options.batch_delay = conf.getSQLiteBatchDelay();
+
 					dtn::storage::SQLiteBundleStorage *sbs;
 					if (conf.getUsePersistentBundleSets())
 					{
-						sbs = new dtn::storage::SQLiteBundleStorage(path, conf.getLimit("storage"), true);
+						sbs = new dtn::storage::SQLiteBundleStorage(path, conf.getLimit("storage"), true, options);
 						IBRCOMMON_LOGGER_TAG(NativeDaemon::TAG, info) << "using persistent bundle-sets" << IBRCOMMON_LOGGER_ENDL;
 					}
 					else
 					{
-						sbs = new dtn::storage::SQLiteBundleStorage(path, conf.getLimit("storage"), false);
+						sbs = new dtn::storage::SQLiteBundleStorage(path, conf.getLimit("storage"), false, options);
 					}
 
 					_components[RUNLEVEL_STORAGE].push_back(sbs);
@@ -1178,6 +1186,14 @@ namespace dtn
 				dtn::core::BundleCore::getInstance().setSeeker( storage );
 			}
 
+			/**
+			 * limit the number of open BLOB files
+			 */
+			const dtn::data::Size blob_files = conf.getLimit("blob_files");
+			if (blob_files > 0) ibrcommon::FileCache::getInstance().setLimit(blob_files);
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(NativeDaemon::TAG, 10) << "up to " << ibrcommon::FileCache::getInstance().getLimit() << " open BLOB files" << IBRCOMMON_LOGGER_ENDL;
+
 			/**
 			 * initialize blob storage mechanism
 			 */
@@ -1384,7 +1400,7 @@ namespace dtn
 							TCPConvergenceLayer *tcpcl = NULL;
 
 							if (it == _cl_map.end()) {
-								tcpcl = new TCPConvergenceLayer();
+								tcpcl = new TCPConvergenceLayer(conf.getNetwork().getTCPReactorThreads());
 							} else {
 								tcpcl = dynamic_cast<TCPConvergenceLayer*>(it->second);
 							}
@@ -355,15 +355,8 @@ namespace dtn
 			// ignore fragments - we can not deliver them directly to the client
 			if (queued.bundle.isFragment()) return;
 
-			ibrcommon::MutexLock l(_connection_lock);
-			for (client_list::iterator iter = _connections.begin(); iter != _connections.end(); ++iter)
-			{
-				ClientHandler &conn = **iter;
-				if (conn.getRegistration().hasSubscribed(queued.bundle.destination))
-				{
-					conn.getRegistration().notify(Registration::NOTIFY_BUNDLE_AVAILABLE);
-				}
-			}
+			// notify all registrations subscribed to the destination
+			Registration::notifySubscribers(queued.bundle.destination, Registration::NOTIFY_BUNDLE_AVAILABLE);
 		}
 
 		void ApiServer::startGarbageCollector()
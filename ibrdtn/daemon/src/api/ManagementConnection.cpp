@@ -485,6 +485,19 @@ namespace dtn
 								_stream << pair.first << ": " << pair.second << std::endl;
 						}
 						_stream << std::endl;
+					} else if ( cmd[1] == "storage" ) {
+						_stream << ClientHandler::API_STATUS_OK << " STATS STORAGE" << std::endl;
+
+						dtn::storage::BundleStorage::stats_data data;
+						dtn::core::BundleCore::getInstance().getStorage().getStats(data);
+
+						_stream << "Stored: " << dtn::core::BundleCore::getInstance().getStorage().count() << std::endl;
+						_stream << "Size: " << dtn::core::BundleCore::getInstance().getStorage().size() << std::endl;
+
+						for (dtn::storage::BundleStorage::stats_data::const_iterator iter = data.begin(); iter != data.end(); ++iter) {
+							_stream << (*iter).first << ": " << (*iter).second << std::endl;
+						}
+						_stream << std::endl;
 					} else if ( cmd[1] == "reset" ) {
 						dtn::core::EventDispatcher<dtn::core::BundleExpiredEvent>::resetCounter();
 						dtn::core::EventDispatcher<dtn::net::TransferCompletedEvent>::resetCounter();
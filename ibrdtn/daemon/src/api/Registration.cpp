@@ -22,6 +22,7 @@
 #include "config.h"
 #include "Configuration.h"
 #include "api/Registration.h"
+#include "api/SubscriptionIndex.h"
 #include "storage/BundleStorage.h"
 #include "core/BundleCore.h"
 #include "core/BundleEvent.h"
@@ -49,6 +50,7 @@ namespace dtn
 		const std::string Registration::TAG = "Registration";
 		ibrcommon::Mutex Registration::_handle_lock;
 		std::set<std::string> Registration::_handles;
+		SubscriptionIndex Registration::_index;
 
 		const std::string Registration::gen_handle()
 		{
@@ -108,9 +110,24 @@ namespace dtn
 
 		Registration::~Registration()
 		{
+			{
+				ibrcommon::MutexLock l(_endpoints_lock);
+
+				// remove all subscriptions from the index
+				for (std::set<dtn::data::EID>::const_iterator iter = _endpoints.begin(); iter != _endpoints.end(); ++iter)
+				{
+					_index.remove(*iter, this);
+				}
+			}
+
 			free_handle(_handle);
 		}
 
+		void Registration::notifySubscribers(const dtn::data::EID &destination, const NOTIFY_CALL call)
+		{
+			_index.notify(destination, call);
+		}
+
 		void Registration::notify(const NOTIFY_CALL call)
 		{
 			ibrcommon::MutexLock l(_wait_for_cond);
@@ -391,10 +408,16 @@ namespace dtn
 				// add endpoint to the local set
 				std::pair<std::set<dtn::data::EID>::iterator, bool> i = _endpoints.insert(endpoint);
 
-				// prepare endpoint for regex matching
-				try {
-					if (i.second) const_cast<dtn::data::EID&>(*i.first).prepare();
-				} catch (const ibrcommon::Exception&) { };
+				if (i.second)
+				{
+					// prepare endpoint for regex matching
+					try {
+						const_cast<dtn::data::EID&>(*i.first).prepare();
+					} catch (const ibrcommon::Exception&) { };
+
+					// add the subscription to the index
+					_index.add(endpoint, this);
+				}
 			}
 
 			// trigger the search for new bundles
@@ -404,7 +427,10 @@ namespace dtn
 		void Registration::unsubscribe(const dtn::data::EID &endpoint)
 		{
 			ibrcommon::MutexLock l(_endpoints_lock);
-			_endpoints.erase(endpoint);
+			if (_endpoints.erase(endpoint) > 0)
+			{
+				_index.remove(endpoint, this);
+			}
 		}
 
 		/**
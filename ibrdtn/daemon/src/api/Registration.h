@@ -36,6 +36,8 @@ namespace dtn
 {
 	namespace api
 	{
+		class SubscriptionIndex;
+
 		class Registration
 		{
 			static const std::string TAG;
@@ -242,6 +244,11 @@ namespace dtn
 			 */
 			static void processIncomingBundle(const dtn::data::EID &source, dtn::data::Bundle &bundle);
 
+			/**
+			 * Notify all registrations with a subscription matching the destination
+			 */
+			static void notifySubscribers(const dtn::data::EID &destination, const NOTIFY_CALL call);
+
 		protected:
 			void underflow();
 
@@ -324,6 +331,9 @@ namespace dtn
 			static ibrcommon::Mutex _handle_lock;
 			static std::set<std::string> _handles;
 
+			// index of all subscriptions of all registrations
+			static SubscriptionIndex _index;
+
 			bool _persistent;
 			bool _detached;
 			ibrcommon::Mutex _attach_lock;
@@ -0,0 +1,229 @@
+/*
+ * SubscriptionIndex.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "api/SubscriptionIndex.h"
+#include <vector>
+#include <utility>
+
+namespace dtn
+{
+	namespace api
+	{
+		// characters with a special meaning in a basic regular expression
+		static const char* const REGEX_META = ".[\\*^$";
+
+		SubscriptionIndex::Pattern::Pattern(const dtn::data::EID &e, bool c)
+		 : eid(e), complete(c)
+		{
+			try {
+				eid.prepare();
+			} catch (const ibrcommon::Exception&) { };
+		}
+
+		SubscriptionIndex::Pattern::~Pattern()
+		{
+		}
+
+		SubscriptionIndex::Node::Node()
+		{
+		}
+
+		SubscriptionIndex::Node::~Node()
+		{
+			for (child_map::iterator iter = children.begin(); iter != children.end(); ++iter)
+			{
+				delete iter->second;
+			}
+		}
+
+		SubscriptionIndex::SubscriptionIndex()
+		 : _size(0)
+		{
+		}
+
+		SubscriptionIndex::~SubscriptionIndex()
+		{
+		}
+
+		size_t SubscriptionIndex::literal(const std::string &expr)
+		{
+			// the dot is followed as wildcard edge in the trie
+			const size_t pos = expr.find_first_of(REGEX_META + 1);
+			if (pos == std::string::npos) return expr.length();
+
+			// a star or an interval applies to the previous character
+			if ((pos > 0) && ((expr[pos] == '*') || (expr[pos] == '\\'))) return pos - 1;
+
+			return pos;
+		}
+
+		void SubscriptionIndex::add(const dtn::data::EID &endpoint, Registration *reg)
+		{
+			const std::string expr = endpoint.getString();
+
+			ibrcommon::MutexLock l(_lock);
+
+			if (expr.find_first_of(REGEX_META) == std::string::npos)
+			{
+				if (_exact[expr].insert(reg).second) _size++;
+				return;
+			}
+
+			const size_t len = literal(expr);
+
+			// walk down the trie and create missing nodes
+			Node *n = &_root;
+			for (size_t i = 0; i < len; ++i)
+			{
+				Node *&next = n->children[expr[i]];
+				if (next == NULL) next = new Node();
+				n = next;
+			}
+
+			Node::pattern_map::iterator it = n->patterns.find(expr);
+			if (it == n->patterns.end())
+			{
+				it = n->patterns.insert(std::make_pair(expr, Pattern(endpoint, len == expr.length()))).first;
+			}
+
+			if (it->second.registrations.insert(reg).second) _size++;
+		}
+
+		void SubscriptionIndex::remove(const dtn::data::EID &endpoint, Registration *reg)
+		{
+			const std::string expr = endpoint.getString();
+
+			ibrcommon::MutexLock l(_lock);
+
+			if (expr.find_first_of(REGEX_META) == std::string::npos)
+			{
+				exact_map::iterator it = _exact.find(expr);
+				if (it == _exact.end()) return;
+
+				_size -= it->second.erase(reg);
+				if (it->second.empty()) _exact.erase(it);
+				return;
+			}
+
+			const size_t len = literal(expr);
+
+			// remember the path to prune empty nodes afterwards
+			std::vector<Node*> path;
+			path.reserve(len + 1);
+
+			Node *n = &_root;
+			path.push_back(n);
+
+			for (size_t i = 0; i < len; ++i)
+			{
+				Node::child_map::iterator next = n->children.find(expr[i]);
+				if (next == n->children.end()) return;
+				n = next->second;
+				path.push_back(n);
+			}
+
+			Node::pattern_map::iterator it = n->patterns.find(expr);
+			if (it == n->patterns.end()) return;
+
+			_size -= it->second.registrations.erase(reg);
+			if (!it->second.registrations.empty()) return;
+
+			n->patterns.erase(it);
+
+			for (size_t i = len; i > 0; --i)
+			{
+				Node *child = path[i];
+				if (!child->children.empty() || !child->patterns.empty()) break;
+
+				path[i - 1]->children.erase(expr[i - 1]);
+				delete child;
+			}
+		}
+
+		void SubscriptionIndex::__find(const dtn::data::EID &destination, registration_set &ret) const
+		{
+			const std::string data = destination.getString();
+
+			exact_map::const_iterator it = _exact.find(data);
+			if (it != _exact.end())
+			{
+				ret.insert(it->second.begin(), it->second.end());
+			}
+
+			std::vector< std::pair<const Node*, size_t> > stack;
+			stack.push_back(std::make_pair(&_root, 0));
+
+			while (!stack.empty())
+			{
+				const Node *n = stack.back().first;
+				const size_t pos = stack.back().second;
+				stack.pop_back();
+
+				for (Node::pattern_map::const_iterator p = n->patterns.begin(); p != n->patterns.end(); ++p)
+				{
+					const Pattern &pattern = p->second;
+
+					if (pattern.complete ? (pos == data.length()) : pattern.eid.match(destination))
+					{
+						ret.insert(pattern.registrations.begin(), pattern.registrations.end());
+					}
+				}
+
+				if (pos == data.length()) continue;
+
+				Node::child_map::const_iterator c = n->children.find(data[pos]);
+				if (c != n->children.end()) stack.push_back(std::make_pair(c->second, pos + 1));
+
+				if (data[pos] == '.') continue;
+
+				c = n->children.find('.');
+				if (c != n->children.end()) stack.push_back(std::make_pair(c->second, pos + 1));
+			}
+		}
+
+		void SubscriptionIndex::find(const dtn::data::EID &destination, registration_set &ret)
+		{
+			ibrcommon::MutexLock l(_lock);
+			__find(destination, ret);
+		}
+
+		void SubscriptionIndex::notify(const dtn::data::EID &destination, const Registration::NOTIFY_CALL call)
+		{
+			registration_set regs;
+
+			// keep the lock while notifying, because registrations
+			// remove themselves from the index before destruction
+			ibrcommon::MutexLock l(_lock);
+			__find(destination, regs);
+
+			for (registration_set::iterator iter = regs.begin(); iter != regs.end(); ++iter)
+			{
+				(*iter)->notify(call);
+			}
+		}
+
+		size_t SubscriptionIndex::size()
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _size;
+		}
+	}
+}
@@ -0,0 +1,128 @@
+/*
+ * SubscriptionIndex.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef SUBSCRIPTIONINDEX_H_
+#define SUBSCRIPTIONINDEX_H_
+
+#include "api/Registration.h"
+#include <ibrdtn/data/EID.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <string>
+#include <map>
+#include <set>
+
+namespace dtn
+{
+	namespace api
+	{
+		/**
+		 * Maps destination EIDs to the registrations which have subscribed them.
+		 * Subscriptions without any regular expression meta-character are looked
+		 * up by their string representation. All other subscriptions are stored
+		 * in a trie keyed by their literal prefix where a '.' is followed as
+		 * wildcard edge. Thus, a lookup only touches the subscriptions which
+		 * share a prefix with the destination.
+		 */
+		class SubscriptionIndex
+		{
+		public:
+			typedef std::set<Registration*> registration_set;
+
+			SubscriptionIndex();
+			virtual ~SubscriptionIndex();
+
+			/**
+			 * Add a subscription of a registration
+			 */
+			void add(const dtn::data::EID &endpoint, Registration *reg);
+
+			/**
+			 * Remove a subscription of a registration
+			 */
+			void remove(const dtn::data::EID &endpoint, Registration *reg);
+
+			/**
+			 * Collect all registrations with a subscription matching
+			 * the given destination
+			 */
+			void find(const dtn::data::EID &destination, registration_set &ret);
+
+			/**
+			 * Call notify() on all registrations with a subscription
+			 * matching the given destination
+			 */
+			void notify(const dtn::data::EID &destination, const Registration::NOTIFY_CALL call);
+
+			/**
+			 * Returns the number of indexed subscriptions
+			 */
+			size_t size();
+
+		private:
+			class Pattern
+			{
+			public:
+				Pattern(const dtn::data::EID &eid, bool complete);
+				~Pattern();
+
+				// prepared EID used to verify a match
+				dtn::data::EID eid;
+
+				// true, if the path through the trie describes the whole pattern
+				bool complete;
+
+				registration_set registrations;
+			};
+
+			class Node
+			{
+			public:
+				Node();
+				~Node();
+
+				typedef std::map<char, Node*> child_map;
+				child_map children;
+
+				typedef std::map<std::string, Pattern> pattern_map;
+				pattern_map patterns;
+			};
+
+			/**
+			 * Returns the number of characters of the expression which
+			 * can be used as trie key. If all characters are usable the
+			 * length of the expression is returned.
+			 */
+			static size_t literal(const std::string &expr);
+
+			void __find(const dtn::data::EID &destination, registration_set &ret) const;
+
+			ibrcommon::Mutex _lock;
+
+			typedef std::map<std::string, registration_set> exact_map;
+			exact_map _exact;
+
+			Node _root;
+			size_t _size;
+		};
+	}
+}
+
+#endif /* SUBSCRIPTIONINDEX_H_ */
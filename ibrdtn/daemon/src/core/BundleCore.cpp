@@ -88,7 +88,8 @@ namespace dtn
 		}
 
 		BundleCore::BundleCore()
-		 : _clock(1), _storage(NULL), _seeker(NULL), _router(NULL), _globally_connected(false)
+		 : _clock(1), _storage(NULL), _seeker(NULL), _router(NULL), _globally_connected(false),
+		   _table_validation(NULL), _table_input(NULL), _table_output(NULL), _table_routing(NULL)
 		{
 			dtn::core::EventDispatcher<dtn::routing::QueueBundleEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::core::BundlePurgeEvent>::add(this);
@@ -102,6 +103,16 @@ namespace dtn
 			dtn::core::EventDispatcher<dtn::core::BundlePurgeEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::net::TransferCompletedEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::net::TransferAbortedEvent>::remove(this);
+
+			delete _table_validation;
+			delete _table_input;
+			delete _table_output;
+			delete _table_routing;
+
+			for (std::list<BundleFilterTable*>::const_iterator it = _retired_tables.begin(); it != _retired_tables.end(); ++it)
+			{
+				delete (*it);
+			}
 		}
 
 		void BundleCore::componentUp() throw ()
@@ -444,8 +455,10 @@ namespace dtn
 			dtn::core::FilterContext context;
 			context.setMetaBundle(obj);
 
-			ibrcommon::MutexLock l(_filter_mutex);
-			if (_table_validation.evaluate(context) != BundleFilter::ACCEPT)
+			const BundleFilterTable *table = getFilterTable(_table_validation);
+			if (table == NULL) return;
+
+			if (table->evaluate(context) != BundleFilter::ACCEPT)
 				throw dtn::data::Validator::RejectedException("rejected by filter");
 		}
 
@@ -512,8 +525,10 @@ namespace dtn
 			dtn::core::FilterContext context;
 			context.setPrimaryBlock(p);
 
-			ibrcommon::MutexLock l(_filter_mutex);
-			if (_table_validation.evaluate(context) != BundleFilter::ACCEPT)
+			const BundleFilterTable *table = getFilterTable(_table_validation);
+			if (table == NULL) return;
+
+			if (table->evaluate(context) != BundleFilter::ACCEPT)
 				throw dtn::data::Validator::RejectedException("rejected by filter");
 		}
 
@@ -531,8 +546,10 @@ namespace dtn
 			dtn::core::FilterContext context;
 			context.setBlock(block, size);
 
-			ibrcommon::MutexLock l(_filter_mutex);
-			if (_table_validation.evaluate(context) != BundleFilter::ACCEPT)
+			const BundleFilterTable *table = getFilterTable(_table_validation);
+			if (table == NULL) return;
+
+			if (table->evaluate(context) != BundleFilter::ACCEPT)
 				throw dtn::data::Validator::RejectedException("rejected by filter");
 		}
 
@@ -567,8 +584,10 @@ namespace dtn
 			context.setPrimaryBlock(bundle);
 			context.setBlock(block, size);
 
-			ibrcommon::MutexLock l(_filter_mutex);
-			if (_table_validation.evaluate(context) != BundleFilter::ACCEPT)
+			const BundleFilterTable *table = getFilterTable(_table_validation);
+			if (table == NULL) return;
+
+			if (table->evaluate(context) != BundleFilter::ACCEPT)
 				throw dtn::data::Validator::RejectedException("rejected by filter");
 		}
 
@@ -612,25 +631,34 @@ namespace dtn
 			dtn::core::FilterContext context;
 			context.setBundle(b);
 
-			ibrcommon::MutexLock l(_filter_mutex);
-			if (_table_validation.evaluate(context) != BundleFilter::ACCEPT)
+			const BundleFilterTable *table = getFilterTable(_table_validation);
+			if (table == NULL) return;
+
+			if (table->evaluate(context) != BundleFilter::ACCEPT)
 				throw dtn::data::Validator::RejectedException("rejected by filter");
 		}
 
 		BundleFilter::ACTION BundleCore::filter(BundleFilter::TABLE table, const FilterContext &context, dtn::data::Bundle &bundle) const
 		{
-			ibrcommon::MutexLock l(_filter_mutex);
-
 			switch (table)
 			{
 				case BundleFilter::INPUT:
-					return _table_input.filter(context, bundle);
+				{
+					const BundleFilterTable *t = getFilterTable(_table_input);
+					return (t == NULL) ? BundleFilter::ACCEPT : t->filter(context, bundle);
+				}
 
 				case BundleFilter::OUTPUT:
-					return _table_output.filter(context, bundle);
+				{
+					const BundleFilterTable *t = getFilterTable(_table_output);
+					return (t == NULL) ? BundleFilter::ACCEPT : t->filter(context, bundle);
+				}
 
 				case BundleFilter::ROUTING:
-					return _table_routing.filter(context, bundle);
+				{
+					const BundleFilterTable *t = getFilterTable(_table_routing);
+					return (t == NULL) ? BundleFilter::ACCEPT : t->filter(context, bundle);
+				}
 			}
 
 			return BundleFilter::ACCEPT;
@@ -638,23 +666,50 @@ namespace dtn
 
 		BundleFilter::ACTION BundleCore::evaluate(BundleFilter::TABLE table, const FilterContext &context) const
 		{
-			ibrcommon::MutexLock l(_filter_mutex);
-
 			switch (table)
 			{
 				case BundleFilter::INPUT:
-					return _table_input.evaluate(context);
+				{
+					const BundleFilterTable *t = getFilterTable(_table_input);
+					return (t == NULL) ? BundleFilter::ACCEPT : t->evaluate(context);
+				}
 
 				case BundleFilter::OUTPUT:
-					return _table_output.evaluate(context);
+				{
+					const BundleFilterTable *t = getFilterTable(_table_output);
+					return (t == NULL) ? BundleFilter::ACCEPT : t->evaluate(context);
+				}
 
 				case BundleFilter::ROUTING:
-					return _table_routing.evaluate(context);
+				{
+					const BundleFilterTable *t = getFilterTable(_table_routing);
+					return (t == NULL) ? BundleFilter::ACCEPT : t->evaluate(context);
+				}
 			}
 
 			return BundleFilter::ACCEPT;
 		}
 
+		const BundleFilterTable* BundleCore::getFilterTable(BundleFilterTable* const &table)
+		{
+			// atomic load with a full barrier, pairs with the swap in publishFilterTable()
+			return __sync_fetch_and_add(const_cast<BundleFilterTable**>(&table), 0);
+		}
+
+		void BundleCore::publishFilterTable(BundleFilterTable* &table, BundleFilterTable *update)
+		{
+			if (update->empty())
+			{
+				delete update;
+				update = NULL;
+			}
+
+			BundleFilterTable *previous = table;
+			while (!__sync_bool_compare_and_swap(&table, previous, update)) previous = table;
+
+			if (previous != NULL) _retired_tables.push_back(previous);
+		}
+
 		const std::string BundleCore::getName() const
 		{
 			return "BundleCore";
@@ -915,12 +970,11 @@ namespace dtn
 
 		void BundleCore::reload_filter_tables() throw ()
 		{
-			ibrcommon::RWLock l(_filter_mutex);
-
-			_table_input.clear();
-			_table_output.clear();
-			_table_routing.clear();
-			_table_validation.clear();
+			// build new tables aside of the active ones
+			BundleFilterTable *table_validation = new BundleFilterTable();
+			BundleFilterTable *table_input = new BundleFilterTable();
+			BundleFilterTable *table_output = new BundleFilterTable();
+			BundleFilterTable *table_routing = new BundleFilterTable();
 
 			/**
 			 * Add security checks according to the configured security level
@@ -929,13 +983,13 @@ namespace dtn
 
 			if (secconf.getLevel() & dtn::daemon::Configuration::Security::SECURITY_LEVEL_AUTHENTICATED)
 			{
-				_table_validation.append(
+				table_validation->append(
 						(new SecurityFilter(SecurityFilter::VERIFY_AUTH, BundleFilter::SKIP))->append(
 						(new LogFilter(ibrcommon::LogLevel::warning, "bundle rejected due to missing authentication"))->append(
 						(new RejectFilter())
 				)));
 
-				_table_output.append(
+				table_output->append(
 						(new SecurityFilter(SecurityFilter::APPLY_AUTH, BundleFilter::SKIP))->append(
 						(new LogFilter(ibrcommon::LogLevel::warning, "can not apply authentication due to missing key"))
 					));
@@ -943,7 +997,7 @@ namespace dtn
 
 			if (secconf.getLevel() & dtn::daemon::Configuration::Security::SECURITY_LEVEL_SIGNED)
 			{
-				_table_validation.append(
+				table_validation->append(
 						(new SecurityFilter(SecurityFilter::VERIFY_INTEGRITY, BundleFilter::SKIP))->append(
 						(new LogFilter(ibrcommon::LogLevel::warning, "bundle rejected due to missing signature"))->append(
 						(new RejectFilter())
@@ -952,27 +1006,39 @@ namespace dtn
 
 			if (secconf.getLevel() & dtn::daemon::Configuration::Security::SECURITY_LEVEL_ENCRYPTED)
 			{
-				_table_validation.append(
+				table_validation->append(
 						(new SecurityFilter(SecurityFilter::VERIFY_CONFIDENTIALITY, BundleFilter::SKIP))->append(
 						(new LogFilter(ibrcommon::LogLevel::warning, "bundle rejected due to missing encryption"))->append(
 						(new RejectFilter())
 				)));
 			}
 
+#ifdef IBRDTN_SUPPORT_BSP
 			/**
 			 * verify integrity and authentication of incoming bundles
+			 * without BSP support the security filters pass every bundle, so the
+			 * input table stays empty and accepts all bundles
 			 */
-			_table_input.append(
+			table_input->append(
 					(new SecurityFilter(SecurityFilter::VERIFY_AUTH, BundleFilter::SKIP))->append(
 					(new LogFilter(ibrcommon::LogLevel::warning, "bundle rejected due to invalid authentication"))->append(
 					(new RejectFilter())
 			)));
 
-			_table_input.append(
+			table_input->append(
 					(new SecurityFilter(SecurityFilter::VERIFY_INTEGRITY, BundleFilter::SKIP))->append(
 					(new LogFilter(ibrcommon::LogLevel::warning, "bundle rejected due to invalid signature"))->append(
 					(new RejectFilter())
 			)));
+#endif
+
+			// publish the new tables, evaluations in progress finish on the previous ones
+			ibrcommon::MutexLock l(_filter_mutex);
+
+			publishFilterTable(_table_validation, table_validation);
+			publishFilterTable(_table_input, table_input);
+			publishFilterTable(_table_output, table_output);
+			publishFilterTable(_table_routing, table_routing);
 		}
 	}
 }
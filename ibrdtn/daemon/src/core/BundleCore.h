@@ -48,6 +48,7 @@
 #include <ibrcommon/link/LinkManager.h>
 
 #include <vector>
+#include <list>
 #include <set>
 #include <map>
 #include "BundleFilterTable.h"
@@ -254,12 +255,32 @@ namespace dtn
 			 */
 			bool _globally_connected;
 
-			BundleFilterTable _table_validation;
-			BundleFilterTable _table_input;
-			BundleFilterTable _table_output;
-			BundleFilterTable _table_routing;
+			/**
+			 * The filter tables are immutable once they are published. On reload
+			 * new tables are created and swapped atomically with the current ones,
+			 * thus the evaluation does not take any lock and continues on the
+			 * previous tables. A NULL table accepts all bundles.
+			 */
+			static const BundleFilterTable* getFilterTable(BundleFilterTable* const &table);
+
+			/**
+			 * Replaces a published table by a new one. An empty table is published
+			 * as NULL and deleted right away.
+			 */
+			void publishFilterTable(BundleFilterTable* &table, BundleFilterTable *update);
+
+			BundleFilterTable *_table_validation;
+			BundleFilterTable *_table_input;
+			BundleFilterTable *_table_output;
+			BundleFilterTable *_table_routing;
+
+			// Replaced tables may still be in use by a concurrent evaluation
+			// and are deleted on destruction only. Reloads are rare, so this
+			// list stays short.
+			std::list<BundleFilterTable*> _retired_tables;
 
-			mutable ibrcommon::RWMutex _filter_mutex;
+			// serializes reloads, never taken by the evaluation
+			ibrcommon::Mutex _filter_mutex;
 		};
 	}
 }
@@ -52,6 +52,11 @@ namespace dtn
 			return "BundleEvent";
 		}
 
+		size_t BundleEvent::getOrderingKey() const
+		{
+			return Event::getOrderingKey(getBundle());
+		}
+
 		std::string BundleEvent::getMessage() const
 		{
 			switch (getAction())
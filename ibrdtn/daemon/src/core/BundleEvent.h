@@ -54,6 +54,8 @@ namespace dtn
 			
 			std::string getMessage() const;
 
+			virtual size_t getOrderingKey() const;
+
 			static void raise(const dtn::data::MetaBundle &bundle, EventBundleAction action, dtn::data::StatusReportBlock::REASON_CODE reason = dtn::data::StatusReportBlock::NO_ADDITIONAL_INFORMATION);
 
 		private:
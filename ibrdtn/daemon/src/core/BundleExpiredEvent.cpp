@@ -61,6 +61,11 @@ namespace dtn
 			return "BundleExpiredEvent";
 		}
 
+		size_t BundleExpiredEvent::getOrderingKey() const
+		{
+			return Event::getOrderingKey(_bundle);
+		}
+
 		std::string BundleExpiredEvent::getMessage() const
 		{
 			return "Bundle has been expired " + _bundle.toString();
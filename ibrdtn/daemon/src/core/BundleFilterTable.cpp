@@ -64,6 +64,11 @@ namespace dtn
 			_chain.clear();
 		}
 
+		bool BundleFilterTable::empty() const
+		{
+			return _chain.empty();
+		}
+
 		BundleFilter::ACTION BundleFilterTable::evaluate(const FilterContext &context) const throw ()
 		{
 			for (chain::const_iterator it = _chain.begin(); it != _chain.end(); ++it)
@@ -50,6 +50,12 @@ namespace dtn
 			 */
 			void clear();
 
+			/**
+			 * Returns true if there is no filter in the chain. An empty
+			 * table accepts all bundles without any evaluation.
+			 */
+			bool empty() const;
+
 			/**
 			 * Evaluates a context and results in ACCEPT, REJECT, or DROP directive
 			 */
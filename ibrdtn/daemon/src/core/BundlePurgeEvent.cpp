@@ -46,6 +46,11 @@ namespace dtn
 			return "BundlePurgeEvent";
 		}
 
+		size_t BundlePurgeEvent::getOrderingKey() const
+		{
+			return Event::getOrderingKey(bundle);
+		}
+
 		std::string BundlePurgeEvent::getMessage() const
 		{
 			return "purging bundle " + bundle.toString();
@@ -45,6 +45,8 @@ namespace dtn
 			const std::string getName() const;
 			std::string getMessage() const;
 
+			virtual size_t getOrderingKey() const;
+
 			const dtn::data::MetaBundle bundle;
 			const REASON_CODE reason;
 
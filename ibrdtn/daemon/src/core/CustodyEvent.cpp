@@ -51,6 +51,11 @@ namespace dtn
 			return "CustodyEvent";
 		}
 
+		size_t CustodyEvent::getOrderingKey() const
+		{
+			return Event::getOrderingKey(getBundle());
+		}
+
 		std::string CustodyEvent::getMessage() const
 		{
 			switch (getAction())
@@ -48,6 +48,8 @@ namespace dtn
 
 			std::string getMessage() const;
 
+			virtual size_t getOrderingKey() const;
+
 			static void raise(const dtn::data::MetaBundle &bundle, const EventCustodyAction action);
 
 		private:
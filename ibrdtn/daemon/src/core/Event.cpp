@@ -38,6 +38,32 @@ namespace dtn
 			_loggable = val;
 		}
 
+		size_t Event::getOrderingKey() const
+		{
+			return 0;
+		}
+
+		size_t Event::getOrderingKey(const dtn::data::EID &eid)
+		{
+			// FNV-1a hash of the endpoint string
+			const std::string s = eid.getString();
+			size_t h = 2166136261U;
+			for (std::string::const_iterator it = s.begin(); it != s.end(); ++it)
+			{
+				h = (h ^ static_cast<unsigned char>(*it)) * 16777619U;
+			}
+			return (h == 0) ? 1 : h;
+		}
+
+		size_t Event::getOrderingKey(const dtn::data::BundleID &id)
+		{
+			// fragments share the key of the original bundle
+			size_t h = getOrderingKey(id.source);
+			h = (h ^ id.timestamp.get<size_t>()) * 16777619U;
+			h = (h ^ id.sequencenumber.get<size_t>()) * 16777619U;
+			return (h == 0) ? 1 : h;
+		}
+
 		std::string Event::toString() const {
 			return this->getName() + ": " + this->getMessage();
 		}
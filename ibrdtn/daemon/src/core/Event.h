@@ -22,6 +22,8 @@
 #ifndef EVENT_H_
 #define EVENT_H_
 
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/EID.h>
 #include <string>
 
 namespace dtn
@@ -54,6 +56,14 @@ namespace dtn
 			 */
 			bool isLoggable() const;
 
+			/**
+			 * Events with the same non-zero ordering key are always
+			 * processed by the same worker of the EventSwitch in the
+			 * order they were queued. The default key zero allows any
+			 * worker to process this event.
+			 */
+			virtual size_t getOrderingKey() const;
+
 			/**
 			 * Contains the priority of this event.
 			 */
@@ -71,6 +81,13 @@ namespace dtn
 			 */
 			void setLoggable(bool val);
 
+			/**
+			 * Derive a non-zero ordering key from a bundle ID or
+			 * an endpoint identifier
+			 */
+			static size_t getOrderingKey(const dtn::data::BundleID &id);
+			static size_t getOrderingKey(const dtn::data::EID &eid);
+
 		private:
 			bool _loggable;
 		};
@@ -35,14 +35,23 @@ namespace dtn
 {
 	namespace core
 	{
+		const size_t EventSwitch::Shard::POOL_SIZE = 256;
+
 		EventSwitch::EventSwitch()
-		 : _running(true), _shutdown(false), _wd(*this, _wlist), _inprogress(false)
+		 : _running(true), _shard_count(1), _next_shard(0), _wd(*this, _wlist), _inprogress(false)
 		{
+			_shards[0] = new Shard();
+			for (size_t i = 1; i < MAX_SHARDS; ++i) _shards[i] = NULL;
 		}
 
 		EventSwitch::~EventSwitch()
 		{
 			componentDown();
+
+			for (size_t i = 0; i < MAX_SHARDS; ++i)
+			{
+				delete _shards[i];
+			}
 		}
 
 		void EventSwitch::componentUp() throw ()
@@ -50,112 +59,177 @@ namespace dtn
 			// routine checked for throw() on 15.02.2013
 
 			// clear all queues
-			_queue = std::queue<Task*>();
-			_prio_queue = std::queue<Task*>();
-			_low_queue = std::queue<Task*>();
+			for (size_t i = 0; i < MAX_SHARDS; ++i)
+			{
+				if (_shards[i] == NULL) continue;
+				ibrcommon::MutexLock l(*_shards[i]);
+				_shards[i]->clear();
+				_shards[i]->shutdown = false;
+			}
+
+			// until the loop starts all events are queued to the first shard
+			_shard_count = 1;
 
 			// reset component state
 			_running = true;
-			_shutdown = false;
-
-			// reset aborted conditional
-			_queue_cond.reset();
 		}
 
 		void EventSwitch::componentDown() throw ()
 		{
-			try {
-				ibrcommon::MutexLock l(_queue_cond);
+			// stop receiving events
+			for (size_t i = 0; i < _shard_count; ++i)
+			{
+				ibrcommon::MutexLock l(*_shards[i]);
+				_shards[i]->shutdown = true;
+			}
 
-				// stop receiving events
-				_shutdown = true;
+			for (size_t i = 0; i < _shard_count; ++i)
+			{
+				Shard &shard = *_shards[i];
 
-				// wait until all queues are empty
-				while (!this->empty())
-				{
-					_queue_cond.wait();
-				}
+				try {
+					ibrcommon::MutexLock l(shard);
+
+					// wait until the queues of this shard are empty
+					while (!shard.empty())
+					{
+						shard.wait();
+					}
 
-				_queue_cond.abort();
-			} catch (const ibrcommon::Conditional::ConditionalAbortException&) {};
+					shard.abort();
+				} catch (const ibrcommon::Conditional::ConditionalAbortException&) {};
+			}
 		}
 
 		bool EventSwitch::empty() const
 		{
-			return (_low_queue.empty() && _queue.empty() && _prio_queue.empty());
+			for (size_t i = 0; i < _shard_count; ++i)
+			{
+				if (!_shards[i]->empty()) return false;
+			}
+			return true;
 		}
 
-		void EventSwitch::process(ibrcommon::TimeMeasurement &tm, bool &inprogress, bool profiling)
+		EventSwitch::Task* EventSwitch::steal(const Shard &shard)
 		{
-			EventSwitch::Task *t = NULL;
+			const size_t count = _shard_count;
 
-			// just look for an event to process
+			for (size_t i = 0; i < count; ++i)
 			{
-				ibrcommon::MutexLock l(_queue_cond);
-				if (!_running) return;
+				Shard &victim = *_shards[i];
+				if (&victim == &shard) continue;
 
-				while (this->empty() && !_shutdown)
-				{
-					_queue_cond.wait();
-				}
+				// skip empty shards without locking them
+				if (victim.empty()) continue;
 
-				if (!_prio_queue.empty())
-				{
-					t = _prio_queue.front();
-					_prio_queue.pop();
-				}
-				else if (!_queue.empty())
+				ibrcommon::MutexLock l(victim);
+				Task *t = victim.pop(true);
+
+				if (t != NULL)
 				{
-					t = _queue.front();
-					_queue.pop();
+					if (victim.shutdown) victim.signal(true);
+					return t;
 				}
-				else if (!_low_queue.empty())
+			}
+
+			return NULL;
+		}
+
+		void EventSwitch::wakeup(const Shard &shard)
+		{
+			const size_t count = _shard_count;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				Shard &s = *_shards[i];
+				if ((&s == &shard) || (s.idle == 0)) continue;
+
+				ibrcommon::MutexLock l(s);
+				if (s.idle == 0) continue;
+				s.signal();
+				return;
+			}
+		}
+
+		bool EventSwitch::process(Shard &shard, Task* &recycle, ibrcommon::TimeMeasurement &tm, bool &inprogress, bool profiling)
+		{
+			EventSwitch::Task *t = NULL;
+
+			// just look for an event to process
+			while (t == NULL)
+			{
 				{
-					t = _low_queue.front();
-					_low_queue.pop();
+					ibrcommon::MutexLock l(shard);
+					if (!_running) return false;
+
+					// return the previously processed task to the pool
+					if (recycle != NULL)
+					{
+						shard.release(recycle);
+						recycle = NULL;
+					}
+
+					t = shard.pop();
+
+					if (t != NULL)
+					{
+						// signal waiting componentDown() calls
+						if (shard.shutdown) shard.signal(true);
+						break;
+					}
 				}
-				else if (_shutdown)
-				{
-					// if all queues are empty and shutdown is requested
-					// set running mode to false
-					_running = false;
 
-					// abort the conditional to release all blocking threads
-					_queue_cond.abort();
+				// try to steal work from a busy shard
+				t = steal(shard);
+				if (t != NULL) break;
 
-					return;
+				ibrcommon::MutexLock l(shard);
+
+				// check again, another thread may has queued a task
+				if (!shard.empty()) continue;
+
+				// if all queues are empty and shutdown is requested
+				// leave the processing loop
+				if (shard.shutdown) return false;
+
+				shard.idle++;
+				try {
+					shard.wait();
+				} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+					shard.idle--;
+					throw;
 				}
+				shard.idle--;
+			}
 
-				_queue_cond.signal(true);
+			if (profiling) {
+				inprogress = true;
+				tm.start();
 			}
+			// execute the event
+			t->processor->process(t->event);
 
-			if (t != NULL)
-			{
-				if (profiling) {
-					inprogress = true;
-					tm.start();
-				}
-				// execute the event
-				t->processor.process(t->event);
+			if (profiling) {
+				tm.stop();
+				inprogress = false;
+			}
 
+			// log the event
+			if (t->event->isLoggable())
+			{
 				if (profiling) {
-					tm.stop();
-					inprogress = false;
+					IBRCOMMON_LOGGER_TAG(t->event->getName(), notice) << t->event->getMessage() << " (" << tm.getMilliseconds() << " ms)" << IBRCOMMON_LOGGER_ENDL;
+				} else {
+					IBRCOMMON_LOGGER_TAG(t->event->getName(), notice) << t->event->getMessage() << IBRCOMMON_LOGGER_ENDL;
 				}
+			}
 
-				// log the event
-				if (t->event->isLoggable())
-				{
-					if (profiling) {
-						IBRCOMMON_LOGGER_TAG(t->event->getName(), notice) << t->event->getMessage() << " (" << tm.getMilliseconds() << " ms)" << IBRCOMMON_LOGGER_ENDL;
-					} else {
-						IBRCOMMON_LOGGER_TAG(t->event->getName(), notice) << t->event->getMessage() << IBRCOMMON_LOGGER_ENDL;
-					}
-				}
+			// delete the event and keep the task for recycling
+			delete t->event;
+			t->event = NULL;
+			recycle = t;
 
-				// delete the Task
-				delete t;
-			}
+			return true;
 		}
 
 		bool EventSwitch::isStalled()
@@ -171,9 +245,43 @@ namespace dtn
 				IBRCOMMON_LOGGER_TAG("EventSwitch", warning) << "Profiling and stalled event detection enabled" << IBRCOMMON_LOGGER_ENDL;
 			}
 
-			for (size_t i = 0; i < threads; ++i)
+			if (threads >= MAX_SHARDS)
+			{
+				IBRCOMMON_LOGGER_TAG("EventSwitch", warning) << "number of event threads limited to " << (MAX_SHARDS - 1) << IBRCOMMON_LOGGER_ENDL;
+				threads = MAX_SHARDS - 1;
+			}
+
+			// allocate one shard per worker
+			for (size_t i = 1; i <= threads; ++i)
+			{
+				if (_shards[i] == NULL) _shards[i] = new Shard();
+			}
+
+			// lock all shards to publish the new number of shards
+			for (size_t i = 0; i <= threads; ++i)
 			{
-				Worker *w = new Worker(*this, profiling);
+				_shards[i]->enter();
+			}
+
+			_shard_count = threads + 1;
+
+			// new shards inherit the shutdown state
+			for (size_t i = 1; i <= threads; ++i)
+			{
+				_shards[i]->shutdown = _shards[0]->shutdown;
+			}
+
+			// move already queued events to the shard of their ordering key
+			_shards[0]->rebalance(_shards, _shard_count);
+
+			for (size_t i = 0; i <= threads; ++i)
+			{
+				_shards[i]->leave();
+			}
+
+			for (size_t i = 1; i <= threads; ++i)
+			{
+				Worker *w = new Worker(*this, *_shards[i], profiling);
 				w->start();
 				_wlist.push_back(w);
 			}
@@ -181,13 +289,14 @@ namespace dtn
 			// bring up watchdog
 			if (profiling) _wd.up();
 
+			Task *recycle = NULL;
+
 			try {
-				while (_running)
-				{
-					process(_tm, _inprogress, profiling);
-				}
+				while (process(*_shards[0], recycle, _tm, _inprogress, profiling)) { };
 			} catch (const ibrcommon::Conditional::ConditionalAbortException&) { };
 
+			delete recycle;
+
 			// shut down watchdog
 			if (profiling) _wd.down();
 			_wd.join();
@@ -201,49 +310,64 @@ namespace dtn
 			}
 
 			_wlist.clear();
+
+			// all events have been processed
+			_running = false;
 		}
 
 		void EventSwitch::queue(EventProcessor &proc, Event *evt)
 		{
 			EventSwitch &s = EventSwitch::getInstance();
 
-			ibrcommon::MutexLock l(s._queue_cond);
+			const size_t key = evt->getOrderingKey();
+			Shard *shard = NULL;
 
-			// do not process any event if the system is going down
-			if (s._shutdown)
+			while (true)
 			{
-				delete evt;
-				return;
-			}
+				// select the shard for this event
+				const size_t count = s._shard_count;
+				shard = (key != 0) ? s._shards[key % count] : s._shards[__sync_fetch_and_add(&s._next_shard, 1) % count];
 
-			EventSwitch::Task *t = new EventSwitch::Task(proc, evt);
+				ibrcommon::MutexLock l(*shard);
 
-			if (evt->prio > 0)
-			{
-				s._prio_queue.push(t);
-			}
-			else if (evt->prio < 0)
-			{
-				s._low_queue.push(t);
-			}
-			else
-			{
-				s._queue.push(t);
+				// select again if the number of shards has been changed meanwhile
+				if (count != s._shard_count) continue;
+
+				// do not process any event if the system is going down
+				if (shard->shutdown)
+				{
+					delete evt;
+					return;
+				}
+
+				shard->push( shard->acquire(proc, evt, key) );
+
+				// wake-up the owner of the shard if it is idle
+				if (shard->idle > 0)
+				{
+					shard->signal();
+					return;
+				}
+
+				break;
 			}
-			s._queue_cond.signal();
+
+			// the owner is busy, let an idle worker steal the event
+			if (key == 0) s.wakeup(*shard);
 		}
 
 		void EventSwitch::shutdown()
 		{
-			try {
-				ibrcommon::MutexLock l(_queue_cond);
-
-				// stop receiving events
-				_shutdown = true;
-
-				// signal all blocking thread to check _shutdown variable
-				_queue_cond.signal(true);
-			} catch (const ibrcommon::Conditional::ConditionalAbortException&) {};
+			// stop receiving events and signal all blocking
+			// threads to check the shutdown flag of their shard
+			for (size_t i = 0; i < _shard_count; ++i)
+			{
+				try {
+					ibrcommon::MutexLock l(*_shards[i]);
+					_shards[i]->shutdown = true;
+					_shards[i]->signal(true);
+				} catch (const ibrcommon::Conditional::ConditionalAbortException&) {};
+			}
 		}
 
 		EventSwitch& EventSwitch::getInstance()
@@ -257,8 +381,8 @@ namespace dtn
 			return "EventSwitch";
 		}
 
-		EventSwitch::Task::Task(EventProcessor &proc, dtn::core::Event *evt)
-		 : processor(proc), event(evt)
+		EventSwitch::Task::Task()
+		 : processor(NULL), event(NULL), key(0)
 		{
 		}
 
@@ -270,8 +394,147 @@ namespace dtn
 			}
 		}
 
-		EventSwitch::Worker::Worker(EventSwitch &sw, bool profiling)
-		 : _switch(sw), _running(true), _inprogress(false), _profiling(profiling)
+		EventSwitch::Shard::Shard()
+		 : idle(0), shutdown(false)
+		{
+			_pool.reserve(POOL_SIZE);
+		}
+
+		EventSwitch::Shard::~Shard()
+		{
+			clear();
+
+			for (std::vector<Task*>::iterator iter = _pool.begin(); iter != _pool.end(); ++iter)
+			{
+				delete (*iter);
+			}
+		}
+
+		EventSwitch::Task* EventSwitch::Shard::acquire(EventProcessor &proc, dtn::core::Event *evt, size_t key)
+		{
+			Task *t = NULL;
+
+			if (_pool.empty())
+			{
+				t = new Task();
+			}
+			else
+			{
+				t = _pool.back();
+				_pool.pop_back();
+			}
+
+			t->processor = &proc;
+			t->event = evt;
+			t->key = key;
+			return t;
+		}
+
+		void EventSwitch::Shard::release(Task *t)
+		{
+			if (_pool.size() < POOL_SIZE)
+			{
+				_pool.push_back(t);
+			}
+			else
+			{
+				delete t;
+			}
+		}
+
+		void EventSwitch::Shard::push(Task *t)
+		{
+			if (t->event->prio > 0)
+			{
+				_prio_queue.push(t);
+			}
+			else if (t->event->prio < 0)
+			{
+				_low_queue.push(t);
+			}
+			else
+			{
+				_queue.push(t);
+			}
+		}
+
+		EventSwitch::Task* EventSwitch::Shard::pop(bool steal)
+		{
+			std::queue<Task*> *q = NULL;
+
+			if (!_prio_queue.empty())
+			{
+				q = &_prio_queue;
+			}
+			else if (!_queue.empty())
+			{
+				q = &_queue;
+			}
+			else if (!_low_queue.empty())
+			{
+				q = &_low_queue;
+			}
+			else
+			{
+				return NULL;
+			}
+
+			// do not steal pinned tasks to preserve their order
+			if (steal && (q->front()->key != 0)) return NULL;
+
+			Task *t = q->front();
+			q->pop();
+			return t;
+		}
+
+		bool EventSwitch::Shard::empty() const
+		{
+			return (_low_queue.empty() && _queue.empty() && _prio_queue.empty());
+		}
+
+		void EventSwitch::Shard::clear()
+		{
+			while (!_prio_queue.empty()) { delete _prio_queue.front(); _prio_queue.pop(); }
+			while (!_queue.empty()) { delete _queue.front(); _queue.pop(); }
+			while (!_low_queue.empty()) { delete _low_queue.front(); _low_queue.pop(); }
+
+			// reset aborted conditional
+			reset();
+		}
+
+		void EventSwitch::Shard::rebalance(Shard **shards, size_t count)
+		{
+			rebalance(_prio_queue, shards, count);
+			rebalance(_queue, shards, count);
+			rebalance(_low_queue, shards, count);
+		}
+
+		void EventSwitch::Shard::rebalance(std::queue<Task*> &q, Shard **shards, size_t count)
+		{
+			std::queue<Task*> keep;
+
+			while (!q.empty())
+			{
+				Task *t = q.front();
+				q.pop();
+
+				Shard *target = (t->key != 0) ? shards[t->key % count] : this;
+
+				if (target == this)
+				{
+					keep.push(t);
+				}
+				else
+				{
+					target->push(t);
+				}
+			}
+
+			q = keep;
+		}
+
+		EventSwitch::Worker::Worker(EventSwitch &sw, Shard &shard, bool profiling)
+		 : _switch(sw), _shard(shard), _inprogress(false), _profiling(profiling)
 		{}
 
 		EventSwitch::Worker::~Worker()
@@ -286,15 +549,21 @@ namespace dtn
 
 		void EventSwitch::Worker::run() throw ()
 		{
+			Task *recycle = NULL;
+
 			try {
-				while (_running)
-					_switch.process(_tm, _inprogress, _profiling);
+				// process events until shutdown and the own shard is empty
+				while (_switch.process(_shard, recycle, _tm, _inprogress, _profiling)) { };
 			} catch (const ibrcommon::Conditional::ConditionalAbortException&) { };
+
+			delete recycle;
 		}
 
 		void EventSwitch::Worker::__cancellation() throw ()
 		{
-			_running = false;
+			// wake-up the worker to check the shutdown state
+			ibrcommon::MutexLock l(_shard);
+			_shard.signal(true);
 		}
 
 		EventSwitch::WatchDog::WatchDog(EventSwitch &sw, std::list<Worker*> &workers)
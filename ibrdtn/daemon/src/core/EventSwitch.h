@@ -31,6 +31,7 @@
 
 #include <list>
 #include <queue>
+#include <vector>
 #include <map>
 
 namespace dtn
@@ -44,7 +45,6 @@ namespace dtn
 			virtual ~EventSwitch();
 
 			bool _running;
-			bool _shutdown;
 
 			/**
 			 * @see Component::getName()
@@ -54,17 +54,80 @@ namespace dtn
 			class Task
 			{
 			public:
-				Task(EventProcessor &proc, dtn::core::Event *evt);
+				Task();
 				~Task();
 
-				EventProcessor &processor;
+				EventProcessor *processor;
 				dtn::core::Event *event;
+
+				// tasks with a non-zero ordering key are never stolen by other workers
+				size_t key;
+			};
+
+			/**
+			 * A shard holds the prioritized queues of exactly one worker.
+			 * Workers with an empty shard steal unpinned tasks from other shards.
+			 */
+			class Shard : public ibrcommon::Conditional
+			{
+			public:
+				Shard();
+				~Shard();
+
+				/**
+				 * Get a task object out of the pool and assign the event to it
+				 */
+				Task* acquire(EventProcessor &proc, dtn::core::Event *evt, size_t key);
+
+				/**
+				 * Return a processed task to the pool
+				 */
+				void release(Task *t);
+
+				void push(Task *t);
+
+				/**
+				 * Get the next task in order of the priority. If steal is true
+				 * only unpinned tasks are returned.
+				 */
+				Task* pop(bool steal = false);
+
+				bool empty() const;
+
+				/**
+				 * Delete all queued tasks and reset the abort state
+				 */
+				void clear();
+
+				/**
+				 * Move pinned tasks to the shard selected by their key
+				 * out of the given number of shards. Requires the lock of
+				 * all involved shards.
+				 */
+				void rebalance(Shard **shards, size_t count);
+
+				// number of workers waiting on this shard
+				size_t idle;
+
+				// set if the system is going down, protected by the lock of the shard
+				bool shutdown;
+
+			private:
+				// limit for the number of recycled task objects
+				static const size_t POOL_SIZE;
+
+				std::queue<Task*> _queue;
+				std::queue<Task*> _prio_queue;
+				std::queue<Task*> _low_queue;
+				std::vector<Task*> _pool;
+
+				void rebalance(std::queue<Task*> &q, Shard **shards, size_t count);
 			};
 
 			class Worker : public ibrcommon::JoinableThread
 			{
 			public:
-				Worker(EventSwitch &sw, bool profiling);
+				Worker(EventSwitch &sw, Shard &shard, bool profiling);
 				~Worker();
 
 				bool isStalled();
@@ -75,7 +138,7 @@ namespace dtn
 
 			private:
 				EventSwitch &_switch;
-				bool _running;
+				Shard &_shard;
 				ibrcommon::TimeMeasurement _tm;
 				bool _inprogress;
 				bool _profiling;
@@ -102,10 +165,17 @@ namespace dtn
 				ibrcommon::Conditional _cond;
 			};
 
-			ibrcommon::Conditional _queue_cond;
-			std::queue<Task*> _queue;
-			std::queue<Task*> _prio_queue;
-			std::queue<Task*> _low_queue;
+			// maximum number of shards, limits the number of worker threads
+			static const size_t MAX_SHARDS = 64;
+
+			// shards are allocated on demand and never released until destruction
+			Shard* _shards[MAX_SHARDS];
+
+			// number of shards in use, shard zero belongs to the loop() thread
+			volatile size_t _shard_count;
+
+			// round-robin counter for unpinned events
+			size_t _next_shard;
 
 			WatchDog _wd;
 			std::list<Worker*> _wlist;
@@ -113,7 +183,21 @@ namespace dtn
 			ibrcommon::TimeMeasurement _tm;
 			bool _inprogress;
 
-			void process(ibrcommon::TimeMeasurement &tm, bool &inprogress, bool profiling);
+			/**
+			 * Process one task of the given shard or steal one of another shard.
+			 * Returns false if the calling thread should leave its loop.
+			 */
+			bool process(Shard &shard, Task* &recycle, ibrcommon::TimeMeasurement &tm, bool &inprogress, bool profiling);
+
+			/**
+			 * Take an unpinned task off any shard except the given one
+			 */
+			Task* steal(const Shard &shard);
+
+			/**
+			 * Wake up one idle worker to steal work from a busy shard
+			 */
+			void wakeup(const Shard &shard);
 
 		protected:
 			virtual void componentUp() throw ();
@@ -138,7 +222,8 @@ namespace dtn
 
 			/**
 			 * Queue an event to one of the event queues of the
-			 * event switch.
+			 * event switch. Events with an ordering key are always queued
+			 * to the same shard, all others are distributed round-robin.
 			 */
 			static void queue(EventProcessor &proc, Event *evt);
 
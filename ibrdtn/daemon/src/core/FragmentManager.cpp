@@ -45,7 +45,7 @@ namespace dtn
 		std::set<FragmentManager::Transmission> FragmentManager::_offsets;
 
 		FragmentManager::FragmentManager()
-		 : _running(false)
+		 : _running(false), _last_expire(0)
 		{
 		}
 
@@ -73,12 +73,8 @@ namespace dtn
 
 		void FragmentManager::componentRun() throw ()
 		{
-			// get reference to the storage
-			dtn::storage::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
-
-			// TODO: scan storage for fragments to reassemble on startup
-
-			dtn::storage::BundleResultList list;
+			// scan storage for fragments to reassemble on startup
+			scan();
 
 			// create a task loop to reassemble fragments asynchronously
 			try {
@@ -86,81 +82,15 @@ namespace dtn
 				{
 					dtn::data::MetaBundle meta = _incoming.poll();
 
-					// skip merge if complete bundle is already in the storage
-					dtn::data::BundleID origin(meta);
-					origin.setFragment(false);
-					if (storage.contains(origin)) continue;
-
-					// search for matching bundles
-					list.clear();
-					search(meta, list);
-
-					IBRCOMMON_LOGGER_DEBUG_TAG(FragmentManager::TAG, 20) << "found " << list.size() << " fragments similar to bundle " << meta.toString() << IBRCOMMON_LOGGER_ENDL;
-
-					// TODO: drop fragments if other fragments available containing the same payload or larger payload
-
-					// check first if all fragment are available
-					std::set<BundleMerger::Chunk> chunks;
-					for (std::list<dtn::data::MetaBundle>::const_iterator iter = list.begin(); iter != list.end(); ++iter)
-					{
-						const dtn::data::MetaBundle &m = (*iter);
-						if (meta.getPayloadLength() > 0)
-						{
-							BundleMerger::Chunk chunk(m.fragmentoffset.get<dtn::data::Length>(), m.getPayloadLength());
-							chunks.insert(chunk);
-						}
-					}
-
-					// wait for the next bundle if the fragment is not complete
-					if (!BundleMerger::Chunk::isComplete(meta.appdatalength.get<dtn::data::Length>(), chunks)) continue;
-
-					// create a new bundle merger container
-					dtn::data::BundleMerger::Container c = dtn::data::BundleMerger::getContainer();
-
-					for (std::list<dtn::data::MetaBundle>::const_iterator iter = list.begin(); iter != list.end(); ++iter)
+					// drop index entries of expired bundles once per second
+					const dtn::data::Timestamp now = dtn::utils::Clock::getTime();
+					if (now != _last_expire)
 					{
-						const dtn::data::MetaBundle &meta = (*iter);
-
-						if (meta.getPayloadLength() > 0)
-						{
-							IBRCOMMON_LOGGER_DEBUG_TAG(FragmentManager::TAG, 20) << "fragment: " << (*iter).toString() << IBRCOMMON_LOGGER_ENDL;
-
-							try {
-								// load bundle from storage
-								const dtn::data::Bundle bundle = dtn::core::BundleCore::getInstance().getStorage().get(*iter);
-
-								// merge the bundle
-								c << bundle;
-							} catch (const dtn::storage::NoBundleFoundException&) {
-								IBRCOMMON_LOGGER_TAG(FragmentManager::TAG, error) << "could not load fragment to merge bundle" << IBRCOMMON_LOGGER_ENDL;
-							};
-						}
+						_last_expire = now;
+						expire(now);
 					}
 
-					if (c.isComplete())
-					{
-						dtn::data::Bundle &merged = c.getBundle();
-
-						IBRCOMMON_LOGGER_TAG(FragmentManager::TAG, notice) << "Bundle " << merged.toString() << " merged" << IBRCOMMON_LOGGER_ENDL;
-
-						// pass merged bundle through the filter
-						FilterContext context;
-						context.setBundle(merged);
-						if (BundleCore::getInstance().filter(BundleFilter::INPUT, context, merged) == BundleFilter::ACCEPT)
-						{
-							// inject bundle into core
-							dtn::core::BundleCore::getInstance().inject(dtn::core::BundleCore::local, merged, false);
-						}
-
-						// delete all fragments of the merged bundle
-						if (merged.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON))
-						{
-							for (std::list<dtn::data::MetaBundle>::const_iterator iter = list.begin(); iter != list.end(); ++iter)
-							{
-								dtn::core::BundlePurgeEvent::raise(*iter);
-							}
-						}
-					}
+					process(meta);
 				}
 			} catch (const ibrcommon::QueueUnblockedException&) { }
 		}
@@ -174,61 +104,282 @@ namespace dtn
 		}
 
 		void FragmentManager::raiseEvent(const dtn::routing::QueueBundleEvent &queued) throw ()
+		{
+			if (!isCandidate(queued.bundle)) return;
+
+			// push the meta bundle into the incoming queue
+			_incoming.push(queued.bundle);
+		}
+
+		bool FragmentManager::isCandidate(const dtn::data::MetaBundle &meta) throw ()
 		{
 			// process fragments
-			if (!queued.bundle.isFragment()) return;
+			if (!meta.isFragment()) return false;
 
 			// do not merge a bundle if it is non-local and singleton
 			// we only touch local and group bundles which might be delivered locally
-			if (queued.bundle.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON))
+			if (meta.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON))
 			{
-				if (!queued.bundle.destination.sameHost(dtn::core::BundleCore::local))
+				if (!meta.destination.sameHost(dtn::core::BundleCore::local))
 				{
-					return;
+					return false;
 				}
 			}
 
-			// push the meta bundle into the incoming queue
-			_incoming.push(queued.bundle);
+			return true;
 		}
 
-		void FragmentManager::search(const dtn::data::MetaBundle &meta, dtn::storage::BundleResult &list)
+		void FragmentManager::scan()
 		{
-			class BundleFilter : public dtn::storage::BundleSelector
+			class FragmentFilter : public dtn::storage::BundleSelector
 			{
 			public:
-				BundleFilter(const dtn::data::MetaBundle &meta)
-				 : _similar(meta)
-				{};
-
-				virtual ~BundleFilter() {};
+				FragmentFilter() {};
+				virtual ~FragmentFilter() {};
 
 				virtual dtn::data::Size limit() const throw () { return 0; };
 
 				virtual bool shouldAdd(const dtn::data::MetaBundle &meta) const throw (dtn::storage::BundleSelectorException)
 				{
-					// fragments only
-					if (!meta.isFragment()) return false;
-
-					// with the same unique bundle id
-					if (meta.source != _similar.source) return false;
-					if (meta.timestamp != _similar.timestamp) return false;
-					if (meta.sequencenumber != _similar.sequencenumber) return false;
-
-					return true;
+					return FragmentManager::isCandidate(meta);
 				};
-
-			private:
-				const dtn::data::MetaBundle &_similar;
 			};
 
-			// create a bundle filter
-			BundleFilter filter(meta);
 			dtn::storage::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
-			
+			dtn::storage::BundleResultList list;
+
 			try {
+				FragmentFilter filter;
 				storage.get(filter, list);
-			} catch (const dtn::storage::NoBundleFoundException&) { }
+			} catch (const dtn::storage::NoBundleFoundException&) {
+				return;
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(FragmentManager::TAG, 20) << "found " << list.size() << " fragments in the storage" << IBRCOMMON_LOGGER_ENDL;
+
+			for (std::list<dtn::data::MetaBundle>::const_iterator iter = list.begin(); iter != list.end(); ++iter)
+			{
+				process(*iter);
+			}
+		}
+
+		void FragmentManager::process(const dtn::data::MetaBundle &meta)
+		{
+			// fragments without payload do not contribute to the merge
+			if (meta.getPayloadLength() == 0) return;
+
+			dtn::data::BundleID origin(meta);
+			origin.setFragment(false);
+
+			// skip merge if complete bundle is already in the storage
+			if (dtn::core::BundleCore::getInstance().getStorage().contains(origin))
+			{
+				_reassemblies.erase(origin);
+				return;
+			}
+
+			reassembly_map::iterator it = _reassemblies.find(origin);
+			if (it == _reassemblies.end())
+			{
+				it = _reassemblies.insert(std::make_pair(origin, Reassembly())).first;
+			}
+
+			Reassembly &r = it->second;
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(FragmentManager::TAG, 20) << "indexed " << (r.fragments.size() + 1) << " fragments similar to bundle " << meta.toString() << IBRCOMMON_LOGGER_ENDL;
+
+			// wait for the next bundle if the fragment is not complete
+			if (!r.add(meta)) return;
+
+			if (merge(r)) _reassemblies.erase(it);
+		}
+
+		bool FragmentManager::merge(Reassembly &r)
+		{
+			dtn::storage::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
+
+			// select the fragments to merge
+			std::list<dtn::data::MetaBundle> selected;
+			if (!r.select(selected)) return false;
+
+			// create a new bundle merger container
+			dtn::data::BundleMerger::Container c = dtn::data::BundleMerger::getContainer();
+
+			for (std::list<dtn::data::MetaBundle>::const_iterator iter = selected.begin(); iter != selected.end(); ++iter)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(FragmentManager::TAG, 20) << "fragment: " << (*iter).toString() << IBRCOMMON_LOGGER_ENDL;
+
+				try {
+					// load bundle from storage
+					const dtn::data::Bundle bundle = storage.get(*iter);
+
+					// merge the bundle, only the missing payload ranges are copied
+					c << bundle;
+				} catch (const dtn::storage::NoBundleFoundException&) {
+					IBRCOMMON_LOGGER_TAG(FragmentManager::TAG, error) << "could not load fragment to merge bundle" << IBRCOMMON_LOGGER_ENDL;
+
+					// forget the missing fragment and wait for other fragments
+					r.remove(*iter);
+					return r.fragments.empty();
+				} catch (const ibrcommon::Exception &ex) {
+					IBRCOMMON_LOGGER_TAG(FragmentManager::TAG, error) << "failed to merge fragment " << (*iter).toString() << ": " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+					r.remove(*iter);
+					return r.fragments.empty();
+				}
+			}
+
+			if (!c.isComplete()) return false;
+
+			dtn::data::Bundle &merged = c.getBundle();
+
+			IBRCOMMON_LOGGER_TAG(FragmentManager::TAG, notice) << "Bundle " << merged.toString() << " merged" << IBRCOMMON_LOGGER_ENDL;
+
+			// pass merged bundle through the filter
+			FilterContext context;
+			context.setBundle(merged);
+			if (BundleCore::getInstance().filter(BundleFilter::INPUT, context, merged) == BundleFilter::ACCEPT)
+			{
+				// inject bundle into core
+				dtn::core::BundleCore::getInstance().inject(dtn::core::BundleCore::local, merged, false);
+			}
+
+			// delete all fragments of the merged bundle
+			if (merged.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON))
+			{
+				for (Reassembly::fragment_set::const_iterator iter = r.fragments.begin(); iter != r.fragments.end(); ++iter)
+				{
+					dtn::core::BundlePurgeEvent::raise(*iter);
+				}
+			}
+
+			return true;
+		}
+
+		void FragmentManager::expire(const dtn::data::Timestamp &timestamp)
+		{
+			for (reassembly_map::iterator iter = _reassemblies.begin(); iter != _reassemblies.end();)
+			{
+				const Reassembly &r = iter->second;
+
+				if (r.fragments.empty() || (r.fragments.begin()->expiretime < timestamp))
+				{
+					_reassemblies.erase(iter++);
+				}
+				else
+				{
+					++iter;
+				}
+			}
+		}
+
+		FragmentManager::Reassembly::Reassembly()
+		 : _covered(0), _length(0)
+		{
+		}
+
+		FragmentManager::Reassembly::~Reassembly()
+		{
+		}
+
+		bool FragmentManager::Reassembly::add(const dtn::data::MetaBundle &fragment)
+		{
+			if (!fragments.insert(fragment).second) return isComplete();
+
+			_length = fragment.appdatalength.get<dtn::data::Length>();
+
+			const dtn::data::Length offset = fragment.fragmentoffset.get<dtn::data::Length>();
+			insert(offset, offset + fragment.getPayloadLength());
+
+			return isComplete();
+		}
+
+		void FragmentManager::Reassembly::insert(const dtn::data::Length &offset, const dtn::data::Length &end)
+		{
+			dtn::data::Length begin = offset;
+			dtn::data::Length last = end;
+
+			// find the first range starting behind the new one
+			std::map<dtn::data::Length, dtn::data::Length>::iterator it = _ranges.upper_bound(begin);
+
+			// extend the previous range if it overlaps or touches
+			if (it != _ranges.begin())
+			{
+				std::map<dtn::data::Length, dtn::data::Length>::iterator prev = it;
+				--prev;
+
+				if (prev->second >= begin)
+				{
+					if (prev->second >= last) return;
+
+					begin = prev->first;
+					_covered -= (prev->second - prev->first);
+					_ranges.erase(prev);
+				}
+			}
+
+			// absorb all following ranges covered by the new one
+			while ((it != _ranges.end()) && (it->first <= last))
+			{
+				if (it->second > last) last = it->second;
+				_covered -= (it->second - it->first);
+				_ranges.erase(it++);
+			}
+
+			_ranges[begin] = last;
+			_covered += (last - begin);
+		}
+
+		void FragmentManager::Reassembly::remove(const dtn::data::MetaBundle &fragment)
+		{
+			if (fragments.erase(fragment) == 0) return;
+
+			// rebuild the ranges of the remaining fragments
+			_ranges.clear();
+			_covered = 0;
+
+			for (fragment_set::const_iterator iter = fragments.begin(); iter != fragments.end(); ++iter)
+			{
+				const dtn::data::Length offset = (*iter).fragmentoffset.get<dtn::data::Length>();
+				insert(offset, offset + (*iter).getPayloadLength());
+			}
+		}
+
+		bool FragmentManager::Reassembly::isComplete() const
+		{
+			return (_length > 0) && (_covered >= _length);
+		}
+
+		bool FragmentManager::Reassembly::select(std::list<dtn::data::MetaBundle> &ret) const
+		{
+			// fragments are ordered by their offset and payload length
+			fragment_set::const_iterator iter = fragments.begin();
+			dtn::data::Length position = 0;
+
+			while (position < _length)
+			{
+				// pick the fragment reaching the farthest from the current position
+				const dtn::data::MetaBundle *best = NULL;
+				dtn::data::Length best_end = position;
+
+				for (; (iter != fragments.end()) && ((*iter).fragmentoffset.get<dtn::data::Length>() <= position); ++iter)
+				{
+					const dtn::data::Length end = (*iter).fragmentoffset.get<dtn::data::Length>() + (*iter).getPayloadLength();
+
+					if (end > best_end)
+					{
+						best = &(*iter);
+						best_end = end;
+					}
+				}
+
+				if (best == NULL) return false;
+
+				ret.push_back(*best);
+				position = best_end;
+			}
+
+			return true;
 		}
 
 		void FragmentManager::setOffset(const dtn::data::EID &peer, const dtn::data::BundleID &id, const dtn::data::Length &abs_offset, const dtn::data::Length &frag_offset) throw ()
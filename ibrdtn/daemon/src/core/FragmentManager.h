@@ -31,6 +31,7 @@
 #include <ibrcommon/thread/Mutex.h>
 #include <list>
 #include <set>
+#include <map>
 
 namespace dtn
 {
@@ -118,6 +119,81 @@ namespace dtn
 				dtn::data::Timestamp expires;
 			};
 
+			/**
+			 * Index of all received fragments of one origin bundle. The received
+			 * payload ranges are kept as disjoint intervals to check the
+			 * completeness of the payload in O(log n) on each arrival.
+			 */
+			class Reassembly
+			{
+			public:
+				Reassembly();
+				virtual ~Reassembly();
+
+				/**
+				 * Add a fragment to the index
+				 * @return true, if the payload of the origin bundle is complete
+				 */
+				bool add(const dtn::data::MetaBundle &fragment);
+
+				/**
+				 * Remove a fragment from the index
+				 */
+				void remove(const dtn::data::MetaBundle &fragment);
+
+				/**
+				 * Returns true, if the payload of the origin bundle is complete
+				 */
+				bool isComplete() const;
+
+				/**
+				 * Select a minimal set of fragments covering the whole payload
+				 * of the origin bundle in the order of their offset
+				 * @return false, if the indexed fragments do not cover the payload
+				 */
+				bool select(std::list<dtn::data::MetaBundle> &ret) const;
+
+				typedef std::set<dtn::data::MetaBundle> fragment_set;
+				fragment_set fragments;
+
+			private:
+				void insert(const dtn::data::Length &offset, const dtn::data::Length &end);
+
+				// received payload ranges mapped from begin to end offset
+				std::map<dtn::data::Length, dtn::data::Length> _ranges;
+				dtn::data::Length _covered;
+				dtn::data::Length _length;
+			};
+
+			typedef std::map<dtn::data::BundleID, Reassembly> reassembly_map;
+
+			/**
+			 * Returns true, if the fragment should be merged by this node
+			 */
+			static bool isCandidate(const dtn::data::MetaBundle &meta) throw ();
+
+			/**
+			 * Index all fragments in the storage and merge complete bundles
+			 */
+			void scan();
+
+			/**
+			 * Add a fragment to the reassembly index and merge the origin
+			 * bundle if all fragments are available
+			 */
+			void process(const dtn::data::MetaBundle &meta);
+
+			/**
+			 * Merge the fragments of a complete origin bundle
+			 * @return true, if the entry is processed and can be removed
+			 */
+			bool merge(Reassembly &r);
+
+			/**
+			 * Remove reassembly entries of expired bundles
+			 */
+			void expire(const dtn::data::Timestamp &timestamp);
+
 			static void expire_offsets(const dtn::data::Timestamp &timestamp);
 			static dtn::data::Length get_payload_offset(const dtn::data::Bundle &bundle, const dtn::data::Length &abs_offset, const dtn::data::Length &frag_offset) throw ();
 
@@ -131,12 +207,13 @@ namespace dtn
 			 */
 			static void addBlocksFromBundleToFragment(const dtn::data::Bundle &bundle, dtn::data::Bundle &fragment, dtn::data::PayloadBlock &fragment_payloadBlock, bool isFirstFragment, bool isLastFragment);
 
-			// search for similar bundles in the storage
-			void search(const dtn::data::MetaBundle &meta, dtn::storage::BundleResult &list);
-
 			ibrcommon::Queue<dtn::data::MetaBundle> _incoming;
 			bool _running;
 
+			// reassembly index, only accessed by the component thread
+			reassembly_map _reassemblies;
+			dtn::data::Timestamp _last_expire;
+
 			static ibrcommon::Mutex _offsets_mutex;
 			static std::set<Transmission> _offsets;
 		};
@@ -67,6 +67,11 @@ namespace dtn
 			return "NodeEvent";
 		}
 
+		size_t NodeEvent::getOrderingKey() const
+		{
+			return Event::getOrderingKey(getNode().getEID());
+		}
+
 		string NodeEvent::getMessage() const
 		{
 			switch (getAction())
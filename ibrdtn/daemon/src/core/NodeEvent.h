@@ -50,6 +50,8 @@ namespace dtn
 
 			std::string getMessage() const;
 
+			virtual size_t getOrderingKey() const;
+
 			static void raise(const Node &n, const EventNodeAction action);
 
 		private:
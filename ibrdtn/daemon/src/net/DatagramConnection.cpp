@@ -33,6 +33,7 @@
 #include <string.h>
 
 #include <iomanip>
+#include <algorithm>
 
 #define AVG_RTT_WEIGHT 0.875
 
@@ -44,8 +45,10 @@ namespace dtn
 
 		DatagramConnection::DatagramConnection(const std::string &identifier, const DatagramService::Parameter &params, DatagramConnectionCallback &callback)
 		 : _send_state(SEND_IDLE), _recv_state(RECV_IDLE), _callback(callback), _identifier(identifier), _stream(*this, params.max_msg_length), _sender(*this, _stream),
-		   _last_ack(0), _next_seqno(0), _head_buf(params.max_msg_length), _head_len(0), _params(params), _avg_rtt(static_cast<double>(params.initial_timeout))
+		   _last_ack(0), _next_seqno(0), _head_buf(params.max_msg_length), _head_len(0), _params(params), _avg_rtt(static_cast<double>(params.initial_timeout)),
+		   _sw_selective(false), _sw_cwnd(1.0)
 		{
+			_sw_cwnd_tm.start();
 		}
 
 		DatagramConnection::~DatagramConnection()
@@ -184,6 +187,13 @@ namespace dtn
 		{
 			IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 25) << "frame received, flags: " << (int)flags << ", seqno: " << seqno << ", len: " << len << IBRCOMMON_LOGGER_ENDL;
 
+			// use selective repeat if offered by the peer and enabled locally
+			if ((flags & DatagramService::SELECTIVE_REPEAT) && (_params.flowcontrol == DatagramService::FLOW_SELECTIVE_REPEAT))
+			{
+				sr_queue(flags, seqno, buf, len);
+				return;
+			}
+
 			try {
 				// we will accept every sequence number on first segments
 				// if this is not the first segment
@@ -195,82 +205,148 @@ namespace dtn
 						throw WrongSeqNoException(_next_seqno);
 				}
 
-				// if this is the last segment then...
-				if ((flags & DatagramService::SEGMENT_FIRST) && (flags & DatagramService::SEGMENT_LAST))
-				{
-					IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 45) << "full segment received" << IBRCOMMON_LOGGER_ENDL;
+				// forward the segment to the stream
+				deliver(flags, buf, len);
 
-					// forward the last segment to the stream
-					_stream.queue(buf, len, true);
+				// increment next sequence number
+				_next_seqno = (seqno + 1) % _params.max_seq_numbers;
+			} catch (const WrongSeqNoException &ex) {
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 15) << "sequence number received " << seqno << ", expected " << ex.expected_seqno << IBRCOMMON_LOGGER_ENDL;
+			}
 
-					// switch to IDLE state
-					_recv_state = RECV_IDLE;
-				}
-				else if (flags & DatagramService::SEGMENT_FIRST)
-				{
-					IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 45) << "first segment received" << IBRCOMMON_LOGGER_ENDL;
+			if (_params.flowcontrol != DatagramService::FLOW_NONE)
+			{
+				// send ack for this message
+				_callback.callback_ack(*this, 0, _next_seqno, getIdentifier(), NULL, 0);
+			}
+		}
 
-					// the first segment is only allowed on IDLE state or on
-					// retransmissions due to lost ACKs
-					if (_recv_state == RECV_IDLE)
-					{
-						// first segment received
-						// store the segment in a buffer
-						::memcpy(&_head_buf[0], buf, len);
-						_head_len = len;
+		void DatagramConnection::sr_queue(const char &flags, const unsigned int &seqno, const char *buf, const dtn::data::Length &len) throw (DatagramException)
+		{
+			// the sender never has more than half of the sequence numbers in flight
+			const unsigned int window = _params.max_seq_numbers / 2;
 
-						// enter the HEAD state
-						_recv_state = RECV_HEAD;
-					}
-					else if (_recv_state == RECV_HEAD)
-					{
-						// last ACK seams to be lost or the peer has been restarted after
-						// sending the first segment
-						// overwrite the buffer with the new segment
-						::memcpy(&_head_buf[0], buf, len);
-						_head_len = len;
-					}
-					else
-					{
-						// failure - abort the stream
-						throw DatagramException("stream went inconsistent");
-					}
-				}
-				else
+			// distance of this frame to the next expected frame
+			const unsigned int offset = (seqno + _params.max_seq_numbers - _next_seqno) % _params.max_seq_numbers;
+
+			if ((flags & DatagramService::SEGMENT_FIRST) && ((offset < window) || (_recv_state == RECV_IDLE)))
+			{
+				// a first segment is only sent with an empty window, so buffered frames
+				// not following this segment belong to an aborted transmission
+				for (std::map<unsigned int, recv_frame>::iterator it = _sr_frames.begin(); it != _sr_frames.end();)
 				{
-					IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 45) << ((flags & DatagramService::SEGMENT_LAST) ? "last" : "middle") << " segment received" << IBRCOMMON_LOGGER_ENDL;
+					const unsigned int n = (it->first + _params.max_seq_numbers - seqno) % _params.max_seq_numbers;
+					if ((n == 0) || (n >= window)) _sr_frames.erase(it++);
+					else ++it;
+				}
 
-					// this is one segment after the HEAD flush the buffers
-					if (_recv_state == RECV_HEAD)
-					{
-						// forward HEAD buffer to the stream
-						_stream.queue(&_head_buf[0], _head_len, true);
-						_head_len = 0;
+				deliver(flags, buf, len);
+				_next_seqno = (seqno + 1) % _params.max_seq_numbers;
+			}
+			else if (offset == 0)
+			{
+				deliver(flags, buf, len);
+				_next_seqno = (seqno + 1) % _params.max_seq_numbers;
+			}
+			else if (offset < window)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 30) << "buffer out-of-order frame seqno: " << seqno << ", expected " << _next_seqno << IBRCOMMON_LOGGER_ENDL;
 
-						// switch to TRANSMISSION state
-						_recv_state = RECV_TRANSMISSION;
-					}
+				recv_frame &f = _sr_frames[seqno];
+				f.flags = flags;
+				f.buf.assign(buf, buf + len);
+			}
+			else
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 15) << "duplicate frame received " << seqno << ", expected " << _next_seqno << IBRCOMMON_LOGGER_ENDL;
+			}
 
-					// forward the current segment to the stream
-					_stream.queue(buf, len, false);
+			// forward buffered frames which are in-order now
+			for (std::map<unsigned int, recv_frame>::iterator it = _sr_frames.find(_next_seqno); it != _sr_frames.end(); it = _sr_frames.find(_next_seqno))
+			{
+				deliver(it->second.flags, &it->second.buf[0], it->second.buf.size());
+				_sr_frames.erase(it);
+				_next_seqno = (_next_seqno + 1) % _params.max_seq_numbers;
+			}
 
-					if (flags & DatagramService::SEGMENT_LAST)
-					{
-						// switch to IDLE state
-						_recv_state = RECV_IDLE;
-					}
-				}
+			// build the SACK bitmap, bit n stands for frame _next_seqno + 1 + n
+			std::vector<char> bitmap((window + 7) / 8, 0);
+			for (std::map<unsigned int, recv_frame>::const_iterator it = _sr_frames.begin(); it != _sr_frames.end(); ++it)
+			{
+				const unsigned int n = (it->first + _params.max_seq_numbers - _next_seqno - 1) % _params.max_seq_numbers;
+				if (n < window) bitmap[n / 8] |= static_cast<char>(1 << (n % 8));
+			}
 
-				// increment next sequence number
-				_next_seqno = (seqno + 1) % _params.max_seq_numbers;
-			} catch (const WrongSeqNoException &ex) {
-				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 15) << "sequence number received " << seqno << ", expected " << ex.expected_seqno << IBRCOMMON_LOGGER_ENDL;
+			// send selective ack for this message
+			_callback.callback_ack(*this, DatagramService::SELECTIVE_REPEAT, _next_seqno, getIdentifier(), &bitmap[0], bitmap.size());
+		}
+
+		void DatagramConnection::deliver(const char &flags, const char *buf, const dtn::data::Length &len) throw (DatagramException)
+		{
+			// if this is the last segment then...
+			if ((flags & DatagramService::SEGMENT_FIRST) && (flags & DatagramService::SEGMENT_LAST))
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 45) << "full segment received" << IBRCOMMON_LOGGER_ENDL;
+
+				// forward the last segment to the stream
+				_stream.queue(buf, len, true);
+
+				// switch to IDLE state
+				_recv_state = RECV_IDLE;
 			}
+			else if (flags & DatagramService::SEGMENT_FIRST)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 45) << "first segment received" << IBRCOMMON_LOGGER_ENDL;
 
-			if (_params.flowcontrol != DatagramService::FLOW_NONE)
+				// the first segment is only allowed on IDLE state or on
+				// retransmissions due to lost ACKs
+				if (_recv_state == RECV_IDLE)
+				{
+					// first segment received
+					// store the segment in a buffer
+					::memcpy(&_head_buf[0], buf, len);
+					_head_len = len;
+
+					// enter the HEAD state
+					_recv_state = RECV_HEAD;
+				}
+				else if (_recv_state == RECV_HEAD)
+				{
+					// last ACK seams to be lost or the peer has been restarted after
+					// sending the first segment
+					// overwrite the buffer with the new segment
+					::memcpy(&_head_buf[0], buf, len);
+					_head_len = len;
+				}
+				else
+				{
+					// failure - abort the stream
+					throw DatagramException("stream went inconsistent");
+				}
+			}
+			else
 			{
-				// send ack for this message
-				_callback.callback_ack(*this, _next_seqno, getIdentifier());
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 45) << ((flags & DatagramService::SEGMENT_LAST) ? "last" : "middle") << " segment received" << IBRCOMMON_LOGGER_ENDL;
+
+				// this is one segment after the HEAD flush the buffers
+				if (_recv_state == RECV_HEAD)
+				{
+					// forward HEAD buffer to the stream
+					_stream.queue(&_head_buf[0], _head_len, true);
+					_head_len = 0;
+
+					// switch to TRANSMISSION state
+					_recv_state = RECV_TRANSMISSION;
+				}
+
+				// forward the current segment to the stream
+				_stream.queue(buf, len, false);
+
+				if (flags & DatagramService::SEGMENT_LAST)
+				{
+					// switch to IDLE state
+					_recv_state = RECV_IDLE;
+				}
 			}
 		}
 
@@ -363,20 +439,17 @@ namespace dtn
 				// transmission failed - abort the stream
 				throw DatagramException("transmission failed - abort the stream");
 			}
-			else if (_params.flowcontrol == DatagramService::FLOW_SLIDING_WINDOW)
+			else if ((_params.flowcontrol == DatagramService::FLOW_SLIDING_WINDOW) || (_params.flowcontrol == DatagramService::FLOW_SELECTIVE_REPEAT))
 			{
+				// offer selective repeat to the peer, it confirms with selective ACKs
+				if (_params.flowcontrol == DatagramService::FLOW_SELECTIVE_REPEAT) flags |= DatagramService::SELECTIVE_REPEAT;
+
 				try {
 					// lock the ACK variables and frame window
 					ibrcommon::MutexLock l(_ack_cond);
 
-					// timeout value
-					struct timespec ts;
-
-					// set timeout to twice the average round-trip-time
-					ibrcommon::Conditional::gettimeout(static_cast<size_t>(_avg_rtt * 2) + 1, &ts);
-
 					// wait until window has at least one free slot
-					while (sw_frames_full()) _ack_cond.wait(&ts);
+					while (sw_frames_full()) sw_wait();
 
 					// add new frame to the window
 					_sw_frames.push_back(window_frame());
@@ -388,8 +461,9 @@ namespace dtn
 					new_frame.buf.assign(buf, buf+len);
 					new_frame.retry = 0;
 
-					// start RTT measurement
+					// start RTT measurement and the retransmission timer
 					new_frame.tm.start();
+					new_frame.timer.start();
 
 					// send the datagram
 					_callback.callback_send(*this, new_frame.flags, new_frame.seqno, getIdentifier(), &new_frame.buf[0], new_frame.buf.size());
@@ -400,32 +474,21 @@ namespace dtn
 					// enter the wait state
 					_send_state = SEND_WAIT_ACK;
 
-					// set timeout to twice the average round-trip-time
-					ibrcommon::Conditional::gettimeout(static_cast<size_t>(_avg_rtt * 2) + 1, &ts);
-
 					// wait until one more slot is available
 					// or no more frames are to ACK (if this was the last frame)
 					while ((last && !_sw_frames.empty()) || (!last && sw_frames_full()))
 					{
-						_ack_cond.wait(&ts);
+						sw_wait();
 					}
 				} catch (const ibrcommon::Conditional::ConditionalAbortException &e) {
-					if (e.reason == ibrcommon::Conditional::ConditionalAbortException::COND_TIMEOUT)
-					{
-						// timeout - retransmit the whole window
-						sw_timeout(last);
-					}
-					else
-					{
-						// maximum number of retransmissions hit
-						_send_state = SEND_ERROR;
+					// maximum number of retransmissions hit
+					_send_state = SEND_ERROR;
 
-						// report failure
-						_callback.reportFailure();
+					// report failure
+					_callback.reportFailure();
 
-						// transmission failed - abort the stream
-						throw DatagramException("transmission failed - abort the stream");
-					}
+					// transmission failed - abort the stream
+					throw DatagramException("transmission failed - abort the stream");
 				}
 
 				// if this is the last segment switch directly to IDLE
@@ -449,73 +512,143 @@ namespace dtn
 
 		bool DatagramConnection::sw_frames_full()
 		{
+			// the congestion window limits the frames in flight once the peer acknowledges selectively
+			if (_sw_selective) return _sw_frames.size() >= static_cast<size_t>(_sw_cwnd);
+
 			return _sw_frames.size() >= (_params.max_seq_numbers / 2);
 		}
 
-		void DatagramConnection::sw_timeout(bool last)
+		void DatagramConnection::sw_wait() throw (DatagramException, ibrcommon::Conditional::ConditionalAbortException)
 		{
-			// timeout value
-			struct timespec ts;
+			// retransmission timeout is twice the average round-trip-time
+			const double rto = (_avg_rtt * 2) + 1;
 
-			while (true) {
-				try {
-					ibrcommon::MutexLock l(_ack_cond);
+			// determine the remaining time of the oldest outstanding frame
+			double remaining = rto;
+			for (std::list<window_frame>::iterator it = _sw_frames.begin(); it != _sw_frames.end(); ++it)
+			{
+				window_frame &f = (*it);
+				if (f.acked) continue;
 
-					// fail -> increment the future timeout
-					adjust_rtt(static_cast<double>(_avg_rtt) * 2);
+				f.timer.stop();
+				const double left = rto - f.timer.getMilliseconds();
+				if (left < remaining) remaining = left;
+			}
 
-					if (_sw_frames.size() > 0)
-					{
-						window_frame &front_frame = _sw_frames.front();
+			if (remaining <= 0)
+			{
+				sw_timeout();
+				return;
+			}
 
-						IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 20) << "ack timeout for seqno " << front_frame.seqno << IBRCOMMON_LOGGER_ENDL;
+			try {
+				_ack_cond.wait(static_cast<size_t>(remaining) + 1);
+			} catch (const ibrcommon::Conditional::ConditionalAbortException &e) {
+				if (e.reason != ibrcommon::Conditional::ConditionalAbortException::COND_TIMEOUT) throw;
+				sw_timeout();
+			}
+		}
 
-						if (front_frame.retry > _params.retry_limit) {
-							// maximum number of retransmissions hit
-							_send_state = SEND_ERROR;
+		void DatagramConnection::sw_timeout() throw (DatagramException)
+		{
+			if (_sw_frames.empty()) return;
 
-							// report failure
-							_callback.reportFailure();
+			const double rto = (_avg_rtt * 2) + 1;
+			bool retransmitted = false;
 
-							// transmission failed - abort the stream
-							throw DatagramException("transmission failed - abort the stream");
-						}
-					}
+			for (std::list<window_frame>::iterator it = _sw_frames.begin(); it != _sw_frames.end(); ++it)
+			{
+				window_frame &f = (*it);
 
-					// retransmit the window
-					for (std::list<window_frame>::iterator it = _sw_frames.begin(); it != _sw_frames.end(); ++it)
-					{
-						window_frame &retry_frame = (*it);
+				// selective repeat only retransmits expired frames
+				if (_sw_selective)
+				{
+					if (f.acked) continue;
 
-						// send the datagram
-						_callback.callback_send(*this, retry_frame.flags, retry_frame.seqno, getIdentifier(), &retry_frame.buf[0], retry_frame.buf.size());
+					f.timer.stop();
+					if (f.timer.getMilliseconds() < rto) continue;
+				}
+				// go-back-n retransmits the whole window if the oldest frame expired
+				else if (!retransmitted)
+				{
+					f.timer.stop();
+					if (f.timer.getMilliseconds() < rto) return;
+				}
 
-						// increment retry counter
-						retry_frame.retry++;
-					}
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 20) << "ack timeout for seqno " << f.seqno << IBRCOMMON_LOGGER_ENDL;
 
-					// enter the wait state
-					_send_state = SEND_WAIT_ACK;
+				if (f.retry > _params.retry_limit) {
+					// maximum number of retransmissions hit
+					_send_state = SEND_ERROR;
 
-					// set timeout to twice the average round-trip-time
-					ibrcommon::Conditional::gettimeout(static_cast<size_t>(_avg_rtt * 2) + 1, &ts);
+					// report failure
+					_callback.reportFailure();
 
-					// wait until one more slot is available
-					// or no more frames are to ACK (if this was the last frame)
-					while ((last && !_sw_frames.empty()) || (!last && sw_frames_full()))
-					{
-						_ack_cond.wait(&ts);
-					}
-				} catch (const ibrcommon::Conditional::ConditionalAbortException &e) {
-					if (e.reason == ibrcommon::Conditional::ConditionalAbortException::COND_TIMEOUT)
-					{
-						// timeout again - repeat at while loop
-						continue;
-					}
+					// transmission failed - abort the stream
+					throw DatagramException("transmission failed - abort the stream");
 				}
 
-				// done
-				return;
+				// send the datagram
+				_callback.callback_send(*this, f.flags, f.seqno, getIdentifier(), &f.buf[0], f.buf.size());
+
+				// restart the timer and increment the retry counter
+				f.timer.start();
+				f.retry++;
+
+				retransmitted = true;
+			}
+
+			if (!retransmitted) return;
+
+			// fail -> increment the future timeout
+			adjust_rtt(static_cast<double>(_avg_rtt) * 2);
+
+			// multiplicative decrease, at most once per round-trip-time
+			_sw_cwnd_tm.stop();
+			if (_sw_selective && (_sw_cwnd_tm.getMilliseconds() > _avg_rtt))
+			{
+				_sw_cwnd = std::max(1.0, _sw_cwnd / 2);
+				_sw_cwnd_tm.start();
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 30) << "congestion window decreased to " << std::setprecision(3) << _sw_cwnd << IBRCOMMON_LOGGER_ENDL;
+			}
+		}
+
+		void DatagramConnection::sw_ack(const unsigned int &seqno)
+		{
+			if (_sw_frames.empty()) return;
+
+			// number of frames covered by this cumulative ACK, stale ACKs are out of range
+			const size_t count = (seqno + _params.max_seq_numbers - _sw_frames.front().seqno) % _params.max_seq_numbers;
+			if ((count == 0) || (count > _sw_frames.size())) return;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				window_frame &f = _sw_frames.front();
+				if (!f.acked) sw_acked(f);
+
+				// remove front element
+				_sw_frames.pop_front();
+			}
+		}
+
+		void DatagramConnection::sw_acked(window_frame &frame)
+		{
+			frame.acked = true;
+
+			// stop the measurement
+			frame.tm.stop();
+
+			// adjust the average rtt, but not on ambiguous retransmitted frames
+			if (frame.retry == 0) adjust_rtt(frame.tm.getMilliseconds());
+
+			// report result
+			_callback.reportSuccess(frame.retry, frame.tm.getMilliseconds());
+
+			// additive increase of the congestion window
+			if (_sw_selective)
+			{
+				_sw_cwnd = std::min(static_cast<double>(_params.max_seq_numbers / 2), _sw_cwnd + (1.0 / _sw_cwnd));
 			}
 		}
 
@@ -538,23 +671,8 @@ namespace dtn
 
 			switch (_params.flowcontrol) {
 				case DatagramService::FLOW_SLIDING_WINDOW:
-					if (_sw_frames.size() > 0) {
-						window_frame &f = _sw_frames.front();
-
-						if (seqno == ((f.seqno + 1) % _params.max_seq_numbers)) {
-							// stop the measurement
-							f.tm.stop();
-
-							// adjust the average rtt
-							adjust_rtt(f.tm.getMilliseconds());
-
-							// report result
-							_callback.reportSuccess(f.retry, f.tm.getMilliseconds());
-
-							// remove front element
-							_sw_frames.pop_front();
-						}
-					}
+				case DatagramService::FLOW_SELECTIVE_REPEAT:
+					sw_ack(seqno);
 					break;
 
 				default:
@@ -565,6 +683,40 @@ namespace dtn
 			_ack_cond.signal(true);
 		}
 
+		void DatagramConnection::sack(const unsigned int &seqno, const char *bitmap, const dtn::data::Length &len)
+		{
+			// selective ACKs are only expected if we offered selective repeat
+			if (_params.flowcontrol != DatagramService::FLOW_SELECTIVE_REPEAT)
+			{
+				ack(seqno);
+				return;
+			}
+
+			ibrcommon::MutexLock l(_ack_cond);
+
+			if (!_sw_selective)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 20) << "peer supports selective repeat" << IBRCOMMON_LOGGER_ENDL;
+				_sw_selective = true;
+			}
+
+			sw_ack(seqno);
+
+			// mark frames received beyond the cumulative ACK
+			for (std::list<window_frame>::iterator it = _sw_frames.begin(); it != _sw_frames.end(); ++it)
+			{
+				window_frame &f = (*it);
+				if (f.acked) continue;
+
+				const size_t n = (f.seqno + _params.max_seq_numbers - seqno - 1) % _params.max_seq_numbers;
+				if ((n / 8) >= len) continue;
+
+				if (bitmap[n / 8] & (1 << (n % 8))) sw_acked(f);
+			}
+
+			_ack_cond.signal(true);
+		}
+
 		void DatagramConnection::setPeerEID(const dtn::data::EID &peer)
 		{
 			_peer_eid = peer;
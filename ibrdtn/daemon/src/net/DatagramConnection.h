@@ -31,6 +31,8 @@
 #include <streambuf>
 #include <iostream>
 #include <vector>
+#include <list>
+#include <map>
 #include <stdint.h>
 
 namespace dtn
@@ -44,7 +46,7 @@ namespace dtn
 		public:
 			virtual ~DatagramConnectionCallback() {};
 			virtual void callback_send(DatagramConnection &connection, const char &flags, const unsigned int &seqno, const std::string &destination, const char *buf, const dtn::data::Length &len) throw (DatagramException) = 0;
-			virtual void callback_ack(DatagramConnection &connection, const unsigned int &seqno, const std::string &destination) throw (DatagramException) = 0;
+			virtual void callback_ack(DatagramConnection &connection, const char &flags, const unsigned int &seqno, const std::string &destination, const char *buf, const dtn::data::Length &len) throw (DatagramException) = 0;
 			virtual void callback_nack(DatagramConnection &connection, const unsigned int &seqno, const std::string &destination) throw (DatagramException) = 0;
 
 			virtual void connectionUp(const DatagramConnection *conn) = 0;
@@ -93,6 +95,14 @@ namespace dtn
 			 */
 			void ack(const unsigned int &seqno);
 
+			/**
+			 * This method is called by the DatagramCL, if a selective ACK is received.
+			 * @param seqno The next sequence number expected by the peer.
+			 * @param bitmap Frames received beyond seqno, bit n stands for seqno + 1 + n
+			 * @param len The length of the bitmap in bytes.
+			 */
+			void sack(const unsigned int &seqno, const char *bitmap, const dtn::data::Length &len);
+
 			/**
 			 * This method is called by the DatagramCL, if an permanent NACK is received.
 			 */
@@ -124,6 +134,37 @@ namespace dtn
 				RECV_ERROR
 			} _recv_state;
 
+			// frame stored in the sliding window until it is acknowledged
+			class window_frame {
+			public:
+				// default constructor
+				window_frame()
+				: flags(0), seqno(0), retry(0), acked(false) { }
+
+				// destructor
+				virtual ~window_frame() { }
+
+				char flags;
+				unsigned int seqno;
+				std::vector<char> buf;
+				unsigned int retry;
+				bool acked;
+				ibrcommon::TimeMeasurement tm;
+				ibrcommon::TimeMeasurement timer;
+			};
+
+			// frame received ahead of the next expected sequence number
+			class recv_frame {
+			public:
+				recv_frame()
+				: flags(0) { }
+
+				virtual ~recv_frame() { }
+
+				char flags;
+				std::vector<char> buf;
+			};
+
 			class Stream : public std::basic_streambuf<char, std::char_traits<char> >, public std::iostream
 			{
 			public:
@@ -239,6 +280,16 @@ namespace dtn
 			 */
 			void stream_send(const char *buf, const dtn::data::Length &len, bool last) throw (DatagramException);
 
+			/**
+			 * Process an in-order frame received from the peer
+			 */
+			void deliver(const char &flags, const char *buf, const dtn::data::Length &len) throw (DatagramException);
+
+			/**
+			 * Accept a frame of a selective repeat sender and buffer it if it is out-of-order
+			 */
+			void sr_queue(const char &flags, const unsigned int &seqno, const char *buf, const dtn::data::Length &len) throw (DatagramException);
+
 			/**
 			 * Adjust the average RTT by the new measured value
 			 */
@@ -250,9 +301,25 @@ namespace dtn
 			bool sw_frames_full();
 
 			/**
-			 * Retransmit the whole sliding window buffer on a timeout
+			 * Remove all frames acknowledged by a cumulative ACK from the window
+			 */
+			void sw_ack(const unsigned int &seqno);
+
+			/**
+			 * Account a frame acknowledged for the first time
+			 */
+			void sw_acked(window_frame &frame);
+
+			/**
+			 * Wait for ACKs until the next frame timer expires
 			 */
-			void sw_timeout(bool last);
+			void sw_wait() throw (DatagramException, ibrcommon::Conditional::ConditionalAbortException);
+
+			/**
+			 * Retransmit expired frames, the whole window if the peer
+			 * does not support selective repeat
+			 */
+			void sw_timeout() throw (DatagramException);
 
 			DatagramConnectionCallback &_callback;
 			const std::string _identifier;
@@ -276,22 +343,19 @@ namespace dtn
 			dtn::data::EID _peer_eid;
 
 			// buffer for sliding window approach
-			class window_frame {
-			public:
-				// default constructor
-				window_frame()
-				: flags(0), seqno(0), retry(0) { }
+			std::list<window_frame> _sw_frames;
 
-				// destructor
-				virtual ~window_frame() { }
+			// true, if the peer acknowledged selectively
+			bool _sw_selective;
 
-				char flags;
-				unsigned int seqno;
-				std::vector<char> buf;
-				unsigned int retry;
-				ibrcommon::TimeMeasurement tm;
-			};
-			std::list<window_frame> _sw_frames;
+			// congestion window used in selective repeat mode
+			double _sw_cwnd;
+
+			// time since the last decrease of the congestion window
+			ibrcommon::TimeMeasurement _sw_cwnd_tm;
+
+			// out-of-order frames received from a selective repeat sender
+			std::map<unsigned int, recv_frame> _sr_frames;
 		};
 	} /* namespace data */
 } /* namespace dtn */
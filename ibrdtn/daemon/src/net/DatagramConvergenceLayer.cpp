@@ -127,13 +127,13 @@ namespace dtn
 			_stats_out += len;
 		}
 
-		void DatagramConvergenceLayer::callback_ack(DatagramConnection&, const unsigned int &seqno, const std::string &destination) throw (DatagramException)
+		void DatagramConvergenceLayer::callback_ack(DatagramConnection&, const char &flags, const unsigned int &seqno, const std::string &destination, const char *buf, const dtn::data::Length &len) throw (DatagramException)
 		{
 			// only on sender at once
 			ibrcommon::MutexLock l(_send_lock);
 
 			// forward the send request to DatagramService
-			_service->send(HEADER_ACK, 0, seqno, destination, NULL, 0);
+			_service->send(HEADER_ACK, flags, seqno, destination, buf, len);
 		}
 
 		void DatagramConvergenceLayer::callback_nack(DatagramConnection&, const unsigned int &seqno, const std::string &destination) throw (DatagramException)
@@ -353,6 +353,11 @@ namespace dtn
 					AckReceived *ack = new AckReceived();
 					ack->address = address;
 					ack->seqno = seqno;
+					ack->flags = flags;
+
+					// selective ACKs carry a bitmap of received frames
+					if (flags & DatagramService::SELECTIVE_REPEAT) ack->data.assign(data.begin(), data.begin() + len);
+
 					_action_queue.push(ack);
 				}
 				else if ( type == HEADER_NACK )
@@ -394,7 +399,10 @@ namespace dtn
 							IBRCOMMON_LOGGER_DEBUG_TAG(TAG, 20) << "ack received for seqno " << ack.seqno << IBRCOMMON_LOGGER_ENDL;
 
 							// Decide in which queue to write based on the src address
-							connection.ack(ack.seqno);
+							if (ack.flags & DatagramService::SELECTIVE_REPEAT)
+								connection.sack(ack.seqno, ack.data.empty() ? NULL : &ack.data[0], ack.data.size());
+							else
+								connection.ack(ack.seqno);
 						} catch (const ConnectionNotAvailableException &ex) {
 							// connection does not exists - ignore the ACK
 						}
@@ -98,7 +98,7 @@ namespace dtn
 			 */
 			void callback_send(DatagramConnection &connection, const char &flags, const unsigned int &seqno, const std::string &destination, const char *buf, const dtn::data::Length &len) throw (DatagramException);
 
-			void callback_ack(DatagramConnection &connection, const unsigned int &seqno, const std::string &destination) throw (DatagramException);
+			void callback_ack(DatagramConnection &connection, const char &flags, const unsigned int &seqno, const std::string &destination, const char *buf, const dtn::data::Length &len) throw (DatagramException);
 
 			void callback_nack(DatagramConnection &connection, const unsigned int &seqno, const std::string &destination) throw (DatagramException);
 
@@ -168,11 +168,13 @@ namespace dtn
 
 			class AckReceived : public Action {
 			public:
-				AckReceived() : seqno(0) {};
+				AckReceived() : seqno(0), flags(0) {};
 				virtual ~AckReceived() {};
 
 				std::string address;
 				unsigned int seqno;
+				char flags;
+				std::vector<char> data;
 			};
 
 			class NackReceived : public Action {
@@ -44,7 +44,8 @@ namespace dtn
 			{
 				FLOW_NONE = 0,
 				FLOW_STOPNWAIT = 1,
-				FLOW_SLIDING_WINDOW = 2
+				FLOW_SLIDING_WINDOW = 2,
+				FLOW_SELECTIVE_REPEAT = 3
 			};
 
 			enum HEADER_FLAGS
@@ -52,7 +53,9 @@ namespace dtn
 				SEGMENT_FIRST = 0x02,
 				SEGMENT_LAST = 0x01,
 				SEGMENT_MIDDLE = 0x00,
-				NACK_TEMPORARY = 0x04
+				NACK_TEMPORARY = 0x04,
+				// offered on segments, confirmed on ACKs carrying a SACK bitmap
+				SELECTIVE_REPEAT = 0x08
 			};
 
 			class Parameter
@@ -53,10 +53,15 @@ namespace dtn
 
 		const int TCPConvergenceLayer::DEFAULT_PORT = 4556;
 
-		TCPConvergenceLayer::TCPConvergenceLayer()
+		TCPConvergenceLayer::TCPConvergenceLayer(size_t reactor_threads)
 		 : _vsocket_state(false), _any_port(0), _stats_in(0), _stats_out(0),
-		   _keepalive_timeout( dtn::daemon::Configuration::getInstance().getNetwork().getKeepaliveInterval() )
+		   _keepalive_timeout( dtn::daemon::Configuration::getInstance().getNetwork().getKeepaliveInterval() ),
+		   _reactor(NULL)
 		{
+			if (reactor_threads > 0)
+			{
+				_reactor = new TCPReactor(*this, reactor_threads, _keepalive_timeout);
+			}
 		}
 
 		TCPConvergenceLayer::~TCPConvergenceLayer()
@@ -71,6 +76,8 @@ namespace dtn
 
 			// delete all sockets
 			_vsocket.destroy();
+
+			delete _reactor;
 		}
 
 		void TCPConvergenceLayer::add(const ibrcommon::vinterface &net, int port) throw ()
@@ -80,18 +87,18 @@ namespace dtn
 
 			if (net.isAny()) {
 				// bind to any interface
-				_vsocket.add(new ibrcommon::tcpserversocket(port));
+				_vsocket.add(new ibrcommon::tcpserversocket(port, SOMAXCONN));
 				_any_port = port;
 			} else if (net.isLoopback()) {
 				// bind to v6 loopback address if supported
 				if (ibrcommon::basesocket::hasSupport(AF_INET6)) {
 					ibrcommon::vaddress addr6(ibrcommon::vaddress::VADDR_LOCALHOST, port, AF_INET6);
-					_vsocket.add(new ibrcommon::tcpserversocket(addr6));
+					_vsocket.add(new ibrcommon::tcpserversocket(addr6, SOMAXCONN));
 				}
 
 				// bind to v4 loopback address
 				ibrcommon::vaddress addr4(ibrcommon::vaddress::VADDR_LOCALHOST, port, AF_INET);
-				_vsocket.add(new ibrcommon::tcpserversocket(addr4));
+				_vsocket.add(new ibrcommon::tcpserversocket(addr4, SOMAXCONN));
 			} else {
 				listen(net, port);
 			}
@@ -141,7 +148,7 @@ namespace dtn
 						case AF_INET6:
 						{
 							addr.setService(ss.str());
-							ibrcommon::tcpserversocket *sock = new ibrcommon::tcpserversocket(addr);
+							ibrcommon::tcpserversocket *sock = new ibrcommon::tcpserversocket(addr, SOMAXCONN);
 							if (_vsocket_state) sock->up();
 							_vsocket.add(sock, net);
 
@@ -329,7 +336,7 @@ namespace dtn
 					ibrcommon::MutexLock l(_portmap_lock);
 					std::stringstream ss; ss << _portmap[evt.getInterface()];
 					bindaddr.setService(ss.str());
-					ibrcommon::tcpserversocket *sock = new ibrcommon::tcpserversocket(bindaddr);
+					ibrcommon::tcpserversocket *sock = new ibrcommon::tcpserversocket(bindaddr, SOMAXCONN);
 					try {
 						sock->up();
 						_vsocket.add(sock, evt.getInterface());
@@ -380,6 +387,12 @@ namespace dtn
 
 		void TCPConvergenceLayer::open(const dtn::core::Node &n)
 		{
+			if (_reactor != NULL)
+			{
+				_reactor->open(n);
+				return;
+			}
+
 			// search for an existing connection
 			ibrcommon::MutexLock l(_connections_cond);
 
@@ -423,6 +436,12 @@ namespace dtn
 
 		void TCPConvergenceLayer::queue(const dtn::core::Node &n, const dtn::net::BundleTransfer &job)
 		{
+			if (_reactor != NULL)
+			{
+				_reactor->queue(n, job);
+				return;
+			}
+
 			// search for an existing connection
 			ibrcommon::MutexLock l(_connections_cond);
 
@@ -550,6 +569,13 @@ namespace dtn
 							const std::string uri = "ip=" + peeraddr.address() + ";port=" + peeraddr.service() + ";";
 							node.add( dtn::core::Node::URI(Node::NODE_CONNECTED, Node::CONN_TCPIP, uri, 0, 10) );
 
+							if (_reactor != NULL)
+							{
+								// hand-over the connection to the reactor
+								_reactor->accept(client, node);
+								continue;
+							}
+
 							// create a new TCPConnection and return the pointer
 							TCPConnection *obj = new TCPConnection(*this, node, client, _keepalive_timeout);
 
@@ -611,6 +637,23 @@ namespace dtn
 			} catch (const ibrcommon::socket_exception &ex) {
 				IBRCOMMON_LOGGER_TAG(TCPConvergenceLayer::TAG, error) << "bind failed (" << ex.what() << ")" << IBRCOMMON_LOGGER_ENDL;
 			}
+
+			if (_reactor != NULL)
+			{
+#ifdef WITH_TLS
+				// the reactor does not support TLS
+				if ( ibrcommon::TLSStream::isInitialized() )
+				{
+					IBRCOMMON_LOGGER_TAG(TCPConvergenceLayer::TAG, warning) << "TLS is not supported by the TCP reactor, using a thread per connection" << IBRCOMMON_LOGGER_ENDL;
+					delete _reactor;
+					_reactor = NULL;
+					return;
+				}
+#endif
+
+				// start the reactor threads
+				_reactor->up();
+			}
 		}
 
 		void TCPConvergenceLayer::componentDown() throw ()
@@ -627,6 +670,9 @@ namespace dtn
 				IBRCOMMON_LOGGER_TAG(TCPConvergenceLayer::TAG, error) << "shutdown failed (" << ex.what() << ")" << IBRCOMMON_LOGGER_ENDL;
 			}
 
+			// close all connections of the reactor and stop the threads
+			if (_reactor != NULL) _reactor->down();
+
 			// close all active connections
 			closeAll();
 
@@ -29,6 +29,7 @@
 #include "core/EventReceiver.h"
 #include "net/ConvergenceLayer.h"
 #include "net/TCPConnection.h"
+#include "net/TCPReactor.h"
 #include "net/DiscoveryBeaconHandler.h"
 #include "net/P2PDialupEvent.h"
 
@@ -52,15 +53,17 @@ namespace dtn
 		class TCPConvergenceLayer : public dtn::daemon::IndependentComponent, public dtn::core::EventReceiver<dtn::net::P2PDialupEvent>, public ConvergenceLayer, public DiscoveryBeaconHandler, public ibrcommon::LinkManager::EventCallback
 		{
 			friend class TCPConnection;
+			friend class TCPReactor;
+			friend class TCPReactorConnection;
 
 			const static std::string TAG;
 		public:
 			/**
 			 * Constructor
-			 * @param[in] bind_addr The address to bind.
-			 * @param[in] port The port to use.
+			 * @param reactor_threads Number of reactor threads driving all
+			 * connections, zero creates a thread set for each connection.
 			 */
-			TCPConvergenceLayer();
+			explicit TCPConvergenceLayer(size_t reactor_threads = 0);
 
 			/**
 			 * Destructor
@@ -181,6 +184,9 @@ namespace dtn
 			size_t _stats_out;
 
 			const size_t _keepalive_timeout;
+
+			// optional reactor for connections without dedicated threads
+			TCPReactor *_reactor;
 		};
 	}
 }
@@ -0,0 +1,588 @@
+/*
+ * TCPReactor.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "net/TCPReactor.h"
+#include "net/TCPReactorConnection.h"
+#include "net/TCPConvergenceLayer.h"
+#include "net/ConnectionEvent.h"
+
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Logger.h>
+
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace dtn
+{
+	namespace net
+	{
+		const std::string TCPReactor::TAG = "TCPReactor";
+
+		TCPReactor::TCPReactor(TCPConvergenceLayer &cl, size_t threads, size_t timeout)
+		 : _cl(cl), _threads(threads), _timeout(timeout), _next_worker(0), _resolver(NULL)
+		{
+		}
+
+		TCPReactor::~TCPReactor()
+		{
+			down();
+		}
+
+		void TCPReactor::up() throw ()
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+
+			// workers are already running
+			if (!_workers.empty()) return;
+
+			try {
+				_resolver = new Resolver(*this);
+				_resolver->start();
+			} catch (const ibrcommon::Exception &ex) {
+				IBRCOMMON_LOGGER_TAG(TCPReactor::TAG, error) << "failed to start resolver: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				delete _resolver;
+				_resolver = NULL;
+			}
+
+			for (size_t i = 0; i < _threads; ++i)
+			{
+				try {
+					Worker *w = new Worker(*this);
+					w->start();
+					_workers.push_back(w);
+				} catch (const ibrcommon::Exception &ex) {
+					IBRCOMMON_LOGGER_TAG(TCPReactor::TAG, error) << "failed to start worker: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				}
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactor::TAG, 25) << _workers.size() << " reactor threads started" << IBRCOMMON_LOGGER_ENDL;
+		}
+
+		void TCPReactor::down() throw ()
+		{
+			// request a shutdown of all connections
+			closeAll();
+
+			std::vector<Worker*> workers;
+			Resolver *resolver = NULL;
+
+			{
+				ibrcommon::MutexLock l(_connections_cond);
+
+				// give the connections a chance to leave gracefully
+				try {
+					const ibrcommon::Timer::time_t deadline = (_timeout + 1) * 1000;
+					ibrcommon::Timer::time_t waited = 0;
+
+					while (!_connections.empty() && !_workers.empty() && (waited < deadline))
+					{
+						try {
+							_connections_cond.wait(100);
+						} catch (const ibrcommon::Conditional::ConditionalAbortException &ex) {
+							if (ex.reason != ibrcommon::Conditional::ConditionalAbortException::COND_TIMEOUT) throw;
+						}
+						waited += 100;
+					}
+				} catch (const ibrcommon::Conditional::ConditionalAbortException&) { }
+
+				workers.swap(_workers);
+				std::swap(resolver, _resolver);
+			}
+
+			// stop the resolver, pending connections are closed by the workers
+			if (resolver != NULL)
+			{
+				resolver->stop();
+				resolver->join();
+				delete resolver;
+			}
+
+			// stop the workers, they close all remaining connections
+			for (std::vector<Worker*>::iterator iter = workers.begin(); iter != workers.end(); ++iter)
+			{
+				Worker *w = (*iter);
+				w->stop();
+				w->join();
+				delete w;
+			}
+		}
+
+		void TCPReactor::open(const dtn::core::Node &n) throw ()
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+
+			for (std::list<TCPReactorConnection*>::iterator iter = _connections.begin(); iter != _connections.end(); ++iter)
+			{
+				if ((*iter)->match(n)) return;
+			}
+
+			if (create(n, NULL) == NULL) return;
+
+			// raise setup event
+			ConnectionEvent::raise(ConnectionEvent::CONNECTION_SETUP, n);
+		}
+
+		void TCPReactor::queue(const dtn::core::Node &n, const dtn::net::BundleTransfer &job) throw ()
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+
+			for (std::list<TCPReactorConnection*>::iterator iter = _connections.begin(); iter != _connections.end(); ++iter)
+			{
+				TCPReactorConnection &conn = *(*iter);
+
+				if (conn.match(n))
+				{
+					conn.queue(job);
+					IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactor::TAG, 15) << "queued bundle to an existing tcp connection (" << conn.getNode().toString() << ")" << IBRCOMMON_LOGGER_ENDL;
+					return;
+				}
+			}
+
+			TCPReactorConnection *conn = create(n, NULL);
+			if (conn == NULL) return;
+
+			// raise setup event
+			ConnectionEvent::raise(ConnectionEvent::CONNECTION_SETUP, n);
+
+			// queue the bundle
+			conn->queue(job);
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactor::TAG, 15) << "queued bundle to an new tcp connection (" << n.toString() << ")" << IBRCOMMON_LOGGER_ENDL;
+		}
+
+		void TCPReactor::accept(ibrcommon::clientsocket *sock, const dtn::core::Node &n) throw ()
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+
+			if (create(n, sock) == NULL) {
+				// no worker available
+				delete sock;
+			}
+		}
+
+		void TCPReactor::closeAll() throw ()
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+			for (std::list<TCPReactorConnection*>::iterator iter = _connections.begin(); iter != _connections.end(); ++iter)
+			{
+				(*iter)->shutdown();
+			}
+		}
+
+		size_t TCPReactor::size() throw ()
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+			return _connections.size();
+		}
+
+		TCPReactorConnection* TCPReactor::create(const dtn::core::Node &n, ibrcommon::clientsocket *sock) throw ()
+		{
+			// has to be called with locked _connections_cond
+			if (_workers.empty()) return NULL;
+
+			// assign connections round-robin to the workers
+			Worker &w = *_workers[_next_worker];
+			_next_worker = (_next_worker + 1) % _workers.size();
+
+			TCPReactorConnection *conn = new TCPReactorConnection(*this, w, n, sock, _timeout);
+			_connections.push_back(conn);
+
+			// hand-over the connection to the worker
+			w.assign(conn);
+
+			// signal that there is a new connection
+			_connections_cond.signal(true);
+
+			return conn;
+		}
+
+		void TCPReactor::remove(TCPReactorConnection *conn) throw ()
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+			for (std::list<TCPReactorConnection*>::iterator iter = _connections.begin(); iter != _connections.end(); ++iter)
+			{
+				if (conn == (*iter))
+				{
+					_connections.erase(iter);
+
+					// signal that there is a connection less
+					_connections_cond.signal(true);
+					return;
+				}
+			}
+		}
+
+		void TCPReactor::resolve(TCPReactorConnection *conn, const dtn::core::Node &node) throw ()
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+
+			// without a resolver the connection runs into its timeout
+			if (_resolver == NULL) return;
+
+			_resolver->resolve(conn, node);
+		}
+
+		void TCPReactor::resolved(TCPReactorConnection *conn, const dtn::core::Node &node, const std::list<Address> &addresses) throw ()
+		{
+			// connections are not deleted while this lock is held
+			ibrcommon::MutexLock l(_connections_cond);
+			for (std::list<TCPReactorConnection*>::iterator iter = _connections.begin(); iter != _connections.end(); ++iter)
+			{
+				if ((conn == (*iter)) && conn->match(node))
+				{
+					conn->resolved(addresses);
+					return;
+				}
+			}
+		}
+
+		TCPReactor::Address::Address(const std::string &u, const std::string &n, const unsigned int p, const struct addrinfo &ai)
+		 : uri(u), name(n), port(p), family(ai.ai_family), socktype(ai.ai_socktype), protocol(ai.ai_protocol), addrlen(ai.ai_addrlen)
+		{
+			::memset(&addr, 0, sizeof addr);
+			::memcpy(&addr, ai.ai_addr, std::min(static_cast<size_t>(ai.ai_addrlen), sizeof addr));
+		}
+
+		TCPReactor::Address::~Address()
+		{
+		}
+
+		TCPReactor::Resolver::Job::Job(TCPReactorConnection *c, const dtn::core::Node &n)
+		 : conn(c), node(n)
+		{
+		}
+
+		TCPReactor::Resolver::Job::~Job()
+		{
+		}
+
+		TCPReactor::Resolver::Resolver(TCPReactor &reactor)
+		 : _reactor(reactor)
+		{
+		}
+
+		TCPReactor::Resolver::~Resolver()
+		{
+			join();
+		}
+
+		void TCPReactor::Resolver::resolve(TCPReactorConnection *conn, const dtn::core::Node &node) throw ()
+		{
+			_jobs.push(Job(conn, node));
+		}
+
+		void TCPReactor::Resolver::run() throw ()
+		{
+			try {
+				while (true)
+				{
+					Job job = _jobs.poll();
+
+					std::list<Address> addresses;
+
+					const std::list<dtn::core::Node::URI> uris = job.node.get(dtn::core::Node::CONN_TCPIP);
+					for (std::list<dtn::core::Node::URI>::const_iterator iter = uris.begin(); iter != uris.end(); ++iter)
+					{
+						std::string address;
+						unsigned int port = 0;
+						(*iter).decode(address, port);
+
+						std::stringstream service; service << port;
+
+						struct addrinfo hints;
+						::memset(&hints, 0, sizeof hints);
+						hints.ai_family = PF_UNSPEC;
+						hints.ai_socktype = SOCK_STREAM;
+
+						struct addrinfo *res = NULL;
+						if (::getaddrinfo(address.c_str(), service.str().c_str(), &hints, &res) != 0)
+						{
+							IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactor::TAG, 15) << "can not resolve " << address << IBRCOMMON_LOGGER_ENDL;
+							continue;
+						}
+
+						for (struct addrinfo *ai = res; ai != NULL; ai = ai->ai_next)
+						{
+							addresses.push_back(Address((*iter).value, address, port, *ai));
+						}
+
+						::freeaddrinfo(res);
+					}
+
+					_reactor.resolved(job.conn, job.node, addresses);
+				}
+			} catch (const ibrcommon::QueueUnblockedException&) {
+				// the resolver has been stopped
+			}
+		}
+
+		void TCPReactor::Resolver::__cancellation() throw ()
+		{
+			_jobs.abort();
+		}
+
+		TCPReactor::Worker::Worker(TCPReactor &reactor)
+		 : _reactor(reactor), _vsocket(ibrcommon::vsocket::TRIGGER_EDGE), _wake_socket(NULL), _wake_fd(-1), _woken(false)
+		{
+			int fds[2];
+			if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+				throw ibrcommon::socket_raw_error(errno, "cannot create wake-up socket");
+
+			// the wake-up socket never blocks the caller
+			::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+			_wake_fd = fds[1];
+
+			_wake_socket = new ibrcommon::filesocket(fds[0]);
+			_wake_socket->set(ibrcommon::clientsocket::BLOCKING, false);
+			_vsocket.add(_wake_socket);
+		}
+
+		TCPReactor::Worker::~Worker()
+		{
+			join();
+
+			// deletes the wake-up socket
+			_vsocket.destroy();
+
+			::close(_wake_fd);
+		}
+
+		void TCPReactor::Worker::assign(TCPReactorConnection *conn) throw ()
+		{
+			{
+				ibrcommon::MutexLock l(_pending_lock);
+				_assigned.push_back(conn);
+			}
+			wakeup();
+		}
+
+		void TCPReactor::Worker::signal(TCPReactorConnection *conn) throw ()
+		{
+			{
+				ibrcommon::MutexLock l(_pending_lock);
+				_signaled.insert(conn);
+			}
+			wakeup();
+		}
+
+		void TCPReactor::Worker::wakeup() throw ()
+		{
+			{
+				ibrcommon::MutexLock l(_pending_lock);
+
+				// one byte in the socket is enough to wake-up the worker
+				if (_woken) return;
+				_woken = true;
+			}
+
+			const char c = 0;
+			::send(_wake_fd, &c, 1, 0);
+		}
+
+		void TCPReactor::Worker::watch(ibrcommon::clientsocket *sock, TCPReactorConnection *conn) throw ()
+		{
+			_vsocket.add(sock);
+			_sockets[sock] = conn;
+		}
+
+		void TCPReactor::Worker::unwatch(ibrcommon::clientsocket *sock) throw ()
+		{
+			_vsocket.remove(sock);
+			_sockets.erase(sock);
+		}
+
+		void TCPReactor::Worker::drain() throw ()
+		{
+			std::list<TCPReactorConnection*> assigned;
+			std::set<TCPReactorConnection*> signaled;
+
+			{
+				ibrcommon::MutexLock l(_pending_lock);
+				assigned.swap(_assigned);
+				signaled.swap(_signaled);
+				_woken = false;
+			}
+
+			for (std::list<TCPReactorConnection*>::const_iterator iter = assigned.begin(); iter != assigned.end(); ++iter)
+			{
+				TCPReactorConnection *conn = (*iter);
+				_connections.insert(conn);
+				conn->initialize();
+				_active.insert(conn);
+			}
+
+			for (std::set<TCPReactorConnection*>::const_iterator iter = signaled.begin(); iter != signaled.end(); ++iter)
+			{
+				TCPReactorConnection *conn = (*iter);
+				if (_connections.find(conn) == _connections.end()) continue;
+				conn->signaled();
+				_active.insert(conn);
+			}
+		}
+
+		void TCPReactor::Worker::process(TCPReactorConnection *conn) throw ()
+		{
+			if (conn->getState() != TCPReactorConnection::STATE_CLOSED)
+			{
+				// write pending data and wait for writable sockets if necessary
+				if (conn->writable()) {
+					_blocked.insert(conn);
+				} else {
+					_blocked.erase(conn);
+				}
+			}
+
+			if (conn->getState() == TCPReactorConnection::STATE_CLOSED)
+			{
+				release(conn);
+			}
+		}
+
+		void TCPReactor::Worker::release(TCPReactorConnection *conn) throw ()
+		{
+			// requeue bundles and raise events
+			conn->finish();
+
+			// no other thread can find the connection anymore
+			_reactor.remove(conn);
+
+			{
+				ibrcommon::MutexLock l(_pending_lock);
+				_signaled.erase(conn);
+			}
+
+			_connections.erase(conn);
+			_blocked.erase(conn);
+			_hot.erase(conn);
+
+			delete conn;
+		}
+
+		void TCPReactor::Worker::run() throw ()
+		{
+			try {
+				_vsocket.up();
+			} catch (const ibrcommon::socket_exception &ex) {
+				IBRCOMMON_LOGGER_TAG(TCPReactor::TAG, error) << "worker failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				return;
+			}
+
+			dtn::data::Timestamp last_tick = dtn::utils::Clock::getMonotonicTimestamp();
+
+			drain();
+
+			while (true)
+			{
+				// process all connections touched in the last round
+				std::set<TCPReactorConnection*> active;
+				active.swap(_active);
+				for (std::set<TCPReactorConnection*>::const_iterator iter = active.begin(); iter != active.end(); ++iter)
+				{
+					process(*iter);
+				}
+
+				ibrcommon::socketset readfds;
+				ibrcommon::socketset writefds;
+
+				// do not block if there is unprocessed input
+				timeval tv;
+				timerclear(&tv);
+				if (_hot.empty()) tv.tv_sec = 1;
+
+				try {
+					// only ask for writable sockets if a connection waits for it
+					_vsocket.select(&readfds, _blocked.empty() ? NULL : &writefds, NULL, &tv);
+				} catch (const ibrcommon::vsocket_timeout&) {
+				} catch (const ibrcommon::socket_exception&) {
+					// the worker has been stopped
+					break;
+				}
+
+				if (readfds.erase(_wake_socket) > 0)
+				{
+					char buf[64];
+					while (::recv(_wake_socket->fd(), buf, sizeof buf, 0) > 0) { };
+				}
+
+				// take over new connections and jobs
+				drain();
+
+				for (ibrcommon::socketset::const_iterator iter = writefds.begin(); iter != writefds.end(); ++iter)
+				{
+					std::map<ibrcommon::basesocket*, TCPReactorConnection*>::const_iterator it = _sockets.find(*iter);
+					if (it != _sockets.end()) _active.insert((*it).second);
+				}
+
+				for (ibrcommon::socketset::const_iterator iter = readfds.begin(); iter != readfds.end(); ++iter)
+				{
+					std::map<ibrcommon::basesocket*, TCPReactorConnection*>::const_iterator it = _sockets.find(*iter);
+					if (it != _sockets.end()) _hot.insert((*it).second);
+				}
+
+				// read from all connections with pending input
+				std::set<TCPReactorConnection*> hot;
+				hot.swap(_hot);
+				for (std::set<TCPReactorConnection*>::const_iterator iter = hot.begin(); iter != hot.end(); ++iter)
+				{
+					TCPReactorConnection *conn = (*iter);
+					if (conn->readable()) _hot.insert(conn);
+					_active.insert(conn);
+				}
+
+				// check keepalive and timeouts once a second
+				const dtn::data::Timestamp now = dtn::utils::Clock::getMonotonicTimestamp();
+				if (now != last_tick)
+				{
+					last_tick = now;
+					for (std::set<TCPReactorConnection*>::const_iterator iter = _connections.begin(); iter != _connections.end(); ++iter)
+					{
+						(*iter)->tick(now);
+						_active.insert(*iter);
+					}
+				}
+			}
+
+			// close all remaining connections
+			drain();
+			_active.clear();
+
+			while (!_connections.empty())
+			{
+				TCPReactorConnection *conn = (*_connections.begin());
+				conn->close();
+				release(conn);
+			}
+		}
+
+		void TCPReactor::Worker::__cancellation() throw ()
+		{
+			_vsocket.down();
+		}
+	}
+}
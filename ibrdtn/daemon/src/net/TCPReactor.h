@@ -0,0 +1,254 @@
+/*
+ * TCPReactor.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef TCPREACTOR_H_
+#define TCPREACTOR_H_
+
+#include "core/Node.h"
+#include "net/BundleTransfer.h"
+
+#include <ibrcommon/net/socket.h>
+#include <ibrcommon/net/vsocket.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/Queue.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+
+#include <vector>
+#include <list>
+#include <set>
+#include <map>
+
+namespace dtn
+{
+	namespace net
+	{
+		class TCPConvergenceLayer;
+		class TCPReactorConnection;
+
+		/**
+		 * The reactor drives TCP convergence layer connections with a fixed
+		 * pool of threads instead of three threads per connection. Each worker
+		 * waits on the sockets of its connections and runs the non-blocking
+		 * protocol state machines implemented by TCPReactorConnection.
+		 */
+		class TCPReactor
+		{
+			friend class TCPReactorConnection;
+
+			static const std::string TAG;
+
+		public:
+			/**
+			 * A resolved socket address of a node URI
+			 */
+			class Address
+			{
+			public:
+				Address(const std::string &uri, const std::string &name, const unsigned int port, const struct addrinfo &ai);
+				~Address();
+
+				// value of the node URI and the decoded host and port
+				std::string uri;
+				std::string name;
+				unsigned int port;
+
+				int family;
+				int socktype;
+				int protocol;
+				struct sockaddr_storage addr;
+				socklen_t addrlen;
+			};
+
+			/**
+			 * Resolves the addresses of outgoing connections. Name lookups
+			 * may block for a long time and are kept away from the workers.
+			 */
+			class Resolver : public ibrcommon::JoinableThread
+			{
+			public:
+				Resolver(TCPReactor &reactor);
+				virtual ~Resolver();
+
+				/**
+				 * Queue the TCP URIs of the node for the name lookup
+				 */
+				void resolve(TCPReactorConnection *conn, const dtn::core::Node &node) throw ();
+
+			protected:
+				void run() throw ();
+				void __cancellation() throw ();
+
+			private:
+				class Job
+				{
+				public:
+					Job(TCPReactorConnection *conn, const dtn::core::Node &node);
+					~Job();
+
+					TCPReactorConnection *conn;
+					dtn::core::Node node;
+				};
+
+				TCPReactor &_reactor;
+				ibrcommon::Queue<Job> _jobs;
+			};
+
+			class Worker : public ibrcommon::JoinableThread
+			{
+			public:
+				Worker(TCPReactor &reactor);
+				virtual ~Worker();
+
+				/**
+				 * Hand over a new connection to this worker
+				 */
+				void assign(TCPReactorConnection *conn) throw ();
+
+				/**
+				 * Notify the worker about pending jobs of a connection
+				 */
+				void signal(TCPReactorConnection *conn) throw ();
+
+				/**
+				 * Add or remove the socket of a connection to the set of
+				 * watched sockets. Only called by the worker thread.
+				 */
+				void watch(ibrcommon::clientsocket *sock, TCPReactorConnection *conn) throw ();
+				void unwatch(ibrcommon::clientsocket *sock) throw ();
+
+			protected:
+				void run() throw ();
+				void __cancellation() throw ();
+
+			private:
+				void wakeup() throw ();
+				void drain() throw ();
+				void process(TCPReactorConnection *conn) throw ();
+				void release(TCPReactorConnection *conn) throw ();
+
+				TCPReactor &_reactor;
+
+				// edge-triggered set of all connection sockets
+				ibrcommon::vsocket _vsocket;
+
+				// socket pair to wake-up the worker
+				ibrcommon::clientsocket *_wake_socket;
+				int _wake_fd;
+
+				// connections and jobs handed over by other threads
+				ibrcommon::Mutex _pending_lock;
+				std::list<TCPReactorConnection*> _assigned;
+				std::set<TCPReactorConnection*> _signaled;
+				bool _woken;
+
+				// connections owned by this worker
+				std::set<TCPReactorConnection*> _connections;
+				std::map<ibrcommon::basesocket*, TCPReactorConnection*> _sockets;
+
+				// connections waiting for writable sockets
+				std::set<TCPReactorConnection*> _blocked;
+
+				// connections with unprocessed input
+				std::set<TCPReactorConnection*> _hot;
+
+				// connections to process in the current round
+				std::set<TCPReactorConnection*> _active;
+			};
+
+			/**
+			 * Constructor
+			 * @param cl The convergence layer using this reactor
+			 * @param threads The number of worker threads
+			 * @param timeout The keepalive timeout announced in the contact header
+			 */
+			TCPReactor(TCPConvergenceLayer &cl, size_t threads, size_t timeout);
+			virtual ~TCPReactor();
+
+			/**
+			 * Create and start the worker threads
+			 */
+			void up() throw ();
+
+			/**
+			 * Close all connections and stop the worker threads
+			 */
+			void down() throw ();
+
+			/**
+			 * Open a connection to the given node
+			 */
+			void open(const dtn::core::Node &n) throw ();
+
+			/**
+			 * Queue a transfer for the given node, opens a connection if necessary
+			 */
+			void queue(const dtn::core::Node &n, const dtn::net::BundleTransfer &job) throw ();
+
+			/**
+			 * Take over an accepted client socket
+			 */
+			void accept(ibrcommon::clientsocket *sock, const dtn::core::Node &n) throw ();
+
+			/**
+			 * Request the shutdown of all connections
+			 */
+			void closeAll() throw ();
+
+			/**
+			 * Returns the number of active connections
+			 */
+			size_t size() throw ();
+
+		private:
+			TCPReactorConnection* create(const dtn::core::Node &n, ibrcommon::clientsocket *sock) throw ();
+			void remove(TCPReactorConnection *conn) throw ();
+
+			/**
+			 * Hand over an outgoing connection to the resolver
+			 */
+			void resolve(TCPReactorConnection *conn, const dtn::core::Node &node) throw ();
+
+			/**
+			 * Deliver resolved addresses to a connection if it still exists
+			 */
+			void resolved(TCPReactorConnection *conn, const dtn::core::Node &node, const std::list<Address> &addresses) throw ();
+
+			TCPConvergenceLayer &_cl;
+			const size_t _threads;
+			const size_t _timeout;
+
+			std::vector<Worker*> _workers;
+			size_t _next_worker;
+
+			Resolver *_resolver;
+
+			ibrcommon::Conditional _connections_cond;
+			std::list<TCPReactorConnection*> _connections;
+		};
+	}
+}
+
+#endif /* TCPREACTOR_H_ */
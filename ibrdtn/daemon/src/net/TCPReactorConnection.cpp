@@ -0,0 +1,1188 @@
+/*
+ * TCPReactorConnection.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "config.h"
+#include "Configuration.h"
+#include "core/BundleCore.h"
+#include "core/FragmentManager.h"
+#include "storage/BundleStorage.h"
+
+#include "net/TCPReactorConnection.h"
+#include "net/TCPConvergenceLayer.h"
+#include "net/ConnectionEvent.h"
+#include "net/TransferAbortedEvent.h"
+
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/data/BundleFragment.h>
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Logger.h>
+
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace dtn
+{
+	namespace net
+	{
+		const std::string TCPReactorConnection::TAG = "TCPReactorConnection";
+
+		TCPReactorConnection::Transmission::Transmission(const dtn::net::BundleTransfer &j, const dtn::data::Length &o)
+		 : job(j), offset(o)
+		{
+		}
+
+		TCPReactorConnection::Transmission::~Transmission()
+		{
+		}
+
+		TCPReactorConnection::Spool::Part::Part(const std::string &d)
+		 : data(d), blob(false), offset(0), length(d.size())
+		{
+		}
+
+		TCPReactorConnection::Spool::Part::Part(const dtn::data::Length &o, const dtn::data::Length &l)
+		 : blob(true), offset(o), length(l)
+		{
+		}
+
+		TCPReactorConnection::Spool::Part::~Part()
+		{
+		}
+
+		TCPReactorConnection::Spool::Spool()
+		 : std::ostream(&_buf), _pos(0), _size(0)
+		{
+		}
+
+		TCPReactorConnection::Spool::~Spool()
+		{
+		}
+
+		void TCPReactorConnection::Spool::append(const ibrcommon::BLOB::Reference &ref, const dtn::data::Length &offset, const dtn::data::Length &length)
+		{
+			// keep the order of buffered data and payload ranges
+			commit();
+
+			if (length == 0) return;
+
+			_parts.push_back(Part(offset, length));
+			_refs.push_back(ref);
+			_size += length;
+		}
+
+		void TCPReactorConnection::Spool::commit()
+		{
+			const std::string data = _buf.str();
+			if (data.empty()) return;
+
+			_buf.str(std::string());
+			_parts.push_back(Part(data));
+			_size += data.size();
+		}
+
+		dtn::data::Length TCPReactorConnection::Spool::size()
+		{
+			commit();
+			return _size;
+		}
+
+		void TCPReactorConnection::Spool::read(std::string &data, dtn::data::Length length) throw (ibrcommon::IOException)
+		{
+			commit();
+
+			while ((length > 0) && !_parts.empty())
+			{
+				const Part &part = _parts.front();
+				const dtn::data::Length len = std::min(length, part.length - _pos);
+
+				if (part.blob)
+				{
+					// read the payload range out of the BLOB
+					ibrcommon::BLOB::iostream io = _refs.front().iostream();
+					(*io).seekg(static_cast<std::streamoff>(part.offset + _pos), std::ios::beg);
+
+					const std::string::size_type begin = data.size();
+					data.resize(begin + len);
+					(*io).read(&data[begin], static_cast<std::streamsize>(len));
+
+					if (static_cast<dtn::data::Length>((*io).gcount()) != len)
+						throw ibrcommon::IOException("can not read the payload of the bundle");
+				}
+				else
+				{
+					data.append(part.data, _pos, len);
+				}
+
+				_pos += len;
+				_size -= len;
+				length -= len;
+
+				if (_pos == part.length)
+				{
+					if (part.blob) _refs.pop_front();
+					_parts.pop_front();
+					_pos = 0;
+				}
+			}
+		}
+
+		void TCPReactorConnection::Spool::discard()
+		{
+			_buf.str(std::string());
+			_parts.clear();
+			_refs.clear();
+			_pos = 0;
+			_size = 0;
+		}
+
+		TCPReactorConnection::TCPReactorConnection(TCPReactor &reactor, TCPReactor::Worker &worker, const dtn::core::Node &node, ibrcommon::clientsocket *sock, const size_t timeout)
+		 : _reactor(reactor), _worker(worker), _node(node), _socket(sock), _timeout(timeout), _state(STATE_CONNECTING),
+		   _flags(0), _ack_support(false), _nack_support(false), _shutdown(false), _resolved_pending(false),
+		   _rx_pos(0), _recv_state(RECV_SEGMENT), _recv_remain(0), _recv_flags(0), _recv_size(0), _recv_reject(false),
+		   _bundle(ibrcommon::BLOB::create()), _recv_stored(0),
+		   _tx_pos(0), _out_pos(0), _out_active(false), _rejected_segments(0), _lastack(0),
+		   _chunksize(dtn::daemon::Configuration::getInstance().getNetwork().getTCPChunkSize()),
+		   _started(dtn::utils::Clock::getMonotonicTimestamp()), _last_recv(_started), _last_sent(_started), _last_data(_started),
+		   _idle_timeout(dtn::daemon::Configuration::getInstance().getNetwork().getTCPIdleTimeout())
+		{
+			_flags |= dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS;
+			_flags |= dtn::streams::StreamContactHeader::REQUEST_NEGATIVE_ACKNOWLEDGMENTS;
+
+			if (dtn::daemon::Configuration::getInstance().getNetwork().doFragmentation())
+			{
+				_flags |= dtn::streams::StreamContactHeader::REQUEST_FRAGMENTATION;
+			}
+		}
+
+		TCPReactorConnection::~TCPReactorConnection()
+		{
+			// the socket is closed by close() in the worker
+			delete _socket;
+		}
+
+		void TCPReactorConnection::queue(const dtn::net::BundleTransfer &job) throw ()
+		{
+			{
+				ibrcommon::MutexLock l(_queue_lock);
+				_queue.push_back(job);
+			}
+			_worker.signal(this);
+		}
+
+		void TCPReactorConnection::shutdown() throw ()
+		{
+			{
+				ibrcommon::MutexLock l(_queue_lock);
+				_shutdown = true;
+			}
+			_worker.signal(this);
+		}
+
+		void TCPReactorConnection::resolved(const std::list<TCPReactor::Address> &addresses) throw ()
+		{
+			{
+				ibrcommon::MutexLock l(_queue_lock);
+				_resolved = addresses;
+				_resolved_pending = true;
+			}
+			_worker.signal(this);
+		}
+
+		bool TCPReactorConnection::match(const dtn::core::Node &n) const
+		{
+			return (_node == n);
+		}
+
+		const dtn::core::Node& TCPReactorConnection::getNode() const
+		{
+			return _node;
+		}
+
+		TCPReactorConnection::State TCPReactorConnection::getState() const throw ()
+		{
+			return _state;
+		}
+
+		void TCPReactorConnection::initialize() throw ()
+		{
+			if (_socket == NULL)
+			{
+				// outgoing connection, connect as soon as the addresses are known
+				_reactor.resolve(this, _node);
+			}
+			else
+			{
+				// accepted connection
+				_worker.watch(_socket, this);
+				connected();
+			}
+		}
+
+		void TCPReactorConnection::connect() throw ()
+		{
+			while (!_addresses.empty())
+			{
+				const TCPReactor::Address &addr = _addresses.front();
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 15) << "Initiate TCP connection to " << addr.name << ":" << addr.port << IBRCOMMON_LOGGER_ENDL;
+
+				int fd = ::socket(addr.family, addr.socktype, addr.protocol);
+
+				if (fd != -1)
+				{
+					::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+					if ((::connect(fd, (const struct sockaddr*)&addr.addr, addr.addrlen) == 0) || (errno == EINPROGRESS))
+					{
+						_socket = new ibrcommon::tcpsocket(fd);
+						_worker.watch(_socket, this);
+						_started = dtn::utils::Clock::getMonotonicTimestamp();
+						return;
+					}
+
+					::close(fd);
+				}
+
+				_addresses.pop_front();
+			}
+
+			// no connection has been established
+			IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, warning) << "connection to " << _node.toString() << " failed" << IBRCOMMON_LOGGER_ENDL;
+			close();
+		}
+
+		void TCPReactorConnection::connected() throw ()
+		{
+			try {
+				_socket->set(ibrcommon::clientsocket::BLOCKING, false);
+
+				if ( dtn::daemon::Configuration::getInstance().getNetwork().getTCPOptionNoDelay() )
+				{
+					_socket->set(ibrcommon::clientsocket::NO_DELAY, true);
+				}
+			} catch (const ibrcommon::socket_exception &ex) {
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, warning) << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			}
+
+			if (!_addresses.empty())
+			{
+				// add TCP connection descriptor to the node object
+				ibrcommon::MutexLock l(_reactor._connections_cond);
+				const std::string value = _addresses.front().uri;
+				_node.clear();
+				_node.add( dtn::core::Node::URI(dtn::core::Node::NODE_CONNECTED, dtn::core::Node::CONN_TCPIP, value, 0, 10) );
+			}
+			_addresses.clear();
+
+			// send the local contact header
+			dtn::streams::StreamContactHeader header(dtn::core::BundleCore::local);
+			header._keepalive = static_cast<uint16_t>(_timeout);
+			header._flags = _flags;
+
+			std::stringstream ss;
+			ss << header;
+			_tx.append(ss.str());
+
+			_started = dtn::utils::Clock::getMonotonicTimestamp();
+			_state = STATE_HANDSHAKE;
+		}
+
+		void TCPReactorConnection::handshake() throw ()
+		{
+			// enable/disable ACK/NACK support
+			_ack_support = _peer._flags.getBit(dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS);
+			_nack_support = _peer._flags.getBit(dtn::streams::StreamContactHeader::REQUEST_NEGATIVE_ACKNOWLEDGMENTS);
+
+			{
+				ibrcommon::MutexLock l(_reactor._connections_cond);
+
+				// copy old attributes and urls to the new node object
+				dtn::core::Node n_old = _node;
+				_node = dtn::core::Node(_peer._localeid);
+				_node += n_old;
+			}
+
+			// check if the peer has the same EID
+			if (_node.getEID() == dtn::core::BundleCore::getInstance().local)
+			{
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, warning) << "connection to local endpoint rejected" << IBRCOMMON_LOGGER_ENDL;
+
+				// forget the peer to suppress the down event
+				_peer._localeid = dtn::data::EID();
+				close();
+				return;
+			}
+
+			_last_recv = _last_sent = _last_data = dtn::utils::Clock::getMonotonicTimestamp();
+			_state = STATE_ESTABLISHED;
+
+			// raise up event
+			ConnectionEvent::raise(ConnectionEvent::CONNECTION_UP, _node);
+		}
+
+		bool TCPReactorConnection::readable() throw ()
+		{
+			if ((_socket == NULL) || (_state == STATE_CONNECTING) || (_state == STATE_CLOSED)) return false;
+
+			// limit the amount of data read in one round to be fair to other connections
+			size_t budget = 256 * 1024;
+			char buf[16384];
+
+			while (budget > 0)
+			{
+				const ssize_t ret = ::recv(_socket->fd(), buf, sizeof buf, 0);
+
+				if (ret > 0)
+				{
+					_last_recv = dtn::utils::Clock::getMonotonicTimestamp();
+					received(buf, ret);
+					if (_state == STATE_CLOSED) return false;
+					budget -= std::min(budget, static_cast<size_t>(ret));
+				}
+				else if (ret == 0)
+				{
+					IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 40) << "connection closed by peer" << IBRCOMMON_LOGGER_ENDL;
+					close();
+					return false;
+				}
+				else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				{
+					return false;
+				}
+				else if (errno != EINTR)
+				{
+					IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 10) << "read error: " << ::strerror(errno) << IBRCOMMON_LOGGER_ENDL;
+					close();
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		void TCPReactorConnection::received(const char *data, size_t len) throw ()
+		{
+			_rx.insert(_rx.end(), data, data + len);
+
+			try {
+				while ((_rx_pos < _rx.size()) && ((_state == STATE_HANDSHAKE) || (_state == STATE_ESTABLISHED)))
+				{
+					if (_state == STATE_HANDSHAKE)
+					{
+						if (!parseHeader()) break;
+						handshake();
+					}
+					else if (_recv_state == RECV_DATA)
+					{
+						const size_t avail = std::min(_rx.size() - _rx_pos, static_cast<size_t>(_recv_remain));
+
+						if (!_recv_reject) store(&_rx[_rx_pos], avail);
+						_rx_pos += avail;
+						_recv_remain -= avail;
+
+						// record statistics
+						_reactor._cl.addTrafficIn(avail);
+
+						if (_recv_remain == 0) segmentReceived();
+					}
+					else if (!parseSegment())
+					{
+						break;
+					}
+				}
+			} catch (const dtn::InvalidProtocolException &ex) {
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, warning) << "protocol error: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				if (_state == STATE_HANDSHAKE)
+				{
+					// tell the peer about the mismatch and leave
+					sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_SHUTDOWN_VERSION_MISSMATCH));
+					_state = STATE_CLOSING;
+					_started = dtn::utils::Clock::getMonotonicTimestamp();
+				}
+				else
+				{
+					close();
+				}
+			}
+
+			// drop consumed data
+			if (_rx_pos == _rx.size())
+			{
+				_rx.clear();
+				_rx_pos = 0;
+			}
+			else if (_rx_pos > 0)
+			{
+				_rx.erase(_rx.begin(), _rx.begin() + _rx_pos);
+				_rx_pos = 0;
+			}
+		}
+
+		bool TCPReactorConnection::parseHeader() throw (dtn::InvalidProtocolException)
+		{
+			const size_t avail = _rx.size() - _rx_pos;
+			const char *p = &_rx[_rx_pos];
+
+			if ((avail >= 4) && (::memcmp(p, "dtn!", 4) != 0))
+				throw dtn::InvalidProtocolException("not talking dtn");
+
+			if ((avail >= 5) && (p[4] != dtn::streams::TCPCL_VERSION))
+				throw dtn::InvalidProtocolException("invalid bundle protocol version");
+
+			// magic, version, flags and keepalive
+			if (avail < 9) return false;
+
+			// decode the length of the EID
+			std::istringstream ss(std::string(p + 8, std::min(avail - 8, static_cast<size_t>(10))));
+			ss.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
+
+			dtn::data::Number eid_length;
+			try {
+				ss >> eid_length;
+			} catch (const std::ios_base::failure&) {
+				return false;
+			} catch (const dtn::InvalidDataException &ex) {
+				throw dtn::InvalidProtocolException(ex.what());
+			}
+
+			if (eid_length > 65535) throw dtn::InvalidProtocolException("endpoint identifier too long");
+
+			const size_t total = 8 + static_cast<size_t>(ss.tellg()) + eid_length.get<size_t>();
+			if (avail < total) return false;
+
+			// the complete header is available
+			std::istringstream hs(std::string(p, total));
+			hs >> _peer;
+			_rx_pos += total;
+
+			return true;
+		}
+
+		bool TCPReactorConnection::parseSegment() throw (dtn::InvalidProtocolException)
+		{
+			const size_t avail = _rx.size() - _rx_pos;
+
+			// header byte, shutdown reason and SDNV
+			std::istringstream ss(std::string(&_rx[_rx_pos], std::min(avail, static_cast<size_t>(24))));
+			ss.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
+
+			dtn::streams::StreamDataSegment seg;
+			try {
+				ss >> seg;
+			} catch (const std::ios_base::failure&) {
+				return false;
+			} catch (const dtn::InvalidDataException &ex) {
+				throw dtn::InvalidProtocolException(ex.what());
+			}
+
+			if ((seg._type < dtn::streams::StreamDataSegment::MSG_DATA_SEGMENT) || (seg._type > dtn::streams::StreamDataSegment::MSG_SHUTDOWN))
+				throw dtn::InvalidProtocolException("unknown segment type");
+
+			_rx_pos += static_cast<size_t>(ss.tellg());
+
+			processSegment(seg);
+			return true;
+		}
+
+		void TCPReactorConnection::processSegment(const dtn::streams::StreamDataSegment &seg) throw ()
+		{
+			if (seg._type != dtn::streams::StreamDataSegment::MSG_KEEPALIVE)
+			{
+				// reset idle timeout
+				_last_data = _last_recv;
+			}
+
+			switch (seg._type)
+			{
+				case dtn::streams::StreamDataSegment::MSG_DATA_SEGMENT:
+				{
+					if (seg._flags & dtn::streams::StreamDataSegment::MSG_MARK_BEGINN)
+					{
+						_recv_size = seg._value.get<dtn::data::Length>();
+						_recv_reject = false;
+						clearBundle();
+					}
+					else
+					{
+						_recv_size += seg._value.get<dtn::data::Length>();
+					}
+
+					_recv_flags = seg._flags;
+					_recv_remain = seg._value.get<dtn::data::Length>();
+					_recv_state = RECV_DATA;
+
+					if (_recv_remain == 0) segmentReceived();
+					break;
+				}
+
+				case dtn::streams::StreamDataSegment::MSG_ACK_SEGMENT:
+					if (_ack_support) bundleAck(seg._value.get<dtn::data::Length>());
+					break;
+
+				case dtn::streams::StreamDataSegment::MSG_REFUSE_BUNDLE:
+					if (_ack_support && _nack_support)
+					{
+						bundleRefused();
+					}
+					else
+					{
+						IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, error) << "got an unexpected NACK" << IBRCOMMON_LOGGER_ENDL;
+					}
+					break;
+
+				case dtn::streams::StreamDataSegment::MSG_KEEPALIVE:
+					break;
+
+				case dtn::streams::StreamDataSegment::MSG_SHUTDOWN:
+					IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 40) << "MSG_SHUTDOWN received" << IBRCOMMON_LOGGER_ENDL;
+
+					// send pending data and close the connection
+					_state = STATE_CLOSING;
+					_started = dtn::utils::Clock::getMonotonicTimestamp();
+					break;
+			}
+		}
+
+		void TCPReactorConnection::segmentReceived() throw ()
+		{
+			_recv_state = RECV_SEGMENT;
+
+			if (_recv_reject)
+			{
+				// refuse every segment of a rejected bundle
+				if (_nack_support) sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_REFUSE_BUNDLE));
+				return;
+			}
+
+			if (_recv_flags & dtn::streams::StreamDataSegment::MSG_MARK_END)
+			{
+				// the ACK of the last segment is sent with the verdict on the bundle
+				if (processBundle(false))
+				{
+					if (_ack_support) sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_ACK_SEGMENT, _recv_size));
+				}
+				else if (_nack_support)
+				{
+					sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_REFUSE_BUNDLE));
+				}
+				else if (_ack_support)
+				{
+					sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_ACK_SEGMENT, _recv_size));
+				}
+
+				clearBundle();
+				_recv_size = 0;
+			}
+			else if (_ack_support)
+			{
+				// New data segment received. Send an ACK.
+				sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_ACK_SEGMENT, _recv_size));
+			}
+		}
+
+		void TCPReactorConnection::store(const char *data, size_t len) throw ()
+		{
+			try {
+				ibrcommon::BLOB::iostream io = _bundle.iostream();
+
+				// append the data to the received part of the bundle
+				(*io).seekp(0, std::ios::end);
+				(*io).write(data, len);
+
+				if (!(*io).good()) throw ibrcommon::IOException("write to the bundle buffer failed");
+
+				_recv_stored += len;
+			} catch (const ibrcommon::IOException &ex) {
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, error) << "can not store received data: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// refuse the bundle
+				_recv_reject = true;
+			}
+		}
+
+		void TCPReactorConnection::clearBundle() throw ()
+		{
+			_recv_stored = 0;
+
+			try {
+				ibrcommon::BLOB::iostream io = _bundle.iostream();
+				io.clear();
+			} catch (const ibrcommon::IOException &ex) {
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, error) << "can not clear the bundle buffer: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// do not append further data to stale data
+				_recv_reject = true;
+			}
+		}
+
+		bool TCPReactorConnection::processBundle(bool partial) throw ()
+		{
+			try {
+				dtn::data::Bundle bundle;
+
+				{
+					ibrcommon::BLOB::iostream io = _bundle.iostream();
+					std::iostream &stream = *io;
+
+					stream.clear();
+					stream.seekg(0, std::ios::beg);
+					stream.exceptions(std::ios::badbit | std::ios::eofbit);
+
+					// create a deserializer for the received data
+					dtn::data::DefaultDeserializer deserializer(stream, dtn::core::BundleCore::getInstance());
+
+					// enable/disable fragmentation support according to the contact header.
+					deserializer.setFragmentationSupport(_peer._flags.getBit(dtn::streams::StreamContactHeader::REQUEST_FRAGMENTATION));
+
+					// read the bundle (or the fragment if fragmentation is enabled)
+					try {
+						deserializer >> bundle;
+					} catch (...) {
+						stream.exceptions(std::ios::goodbit);
+						throw;
+					}
+
+					stream.exceptions(std::ios::goodbit);
+				}
+
+				// check the bundle
+				if ( ( bundle.destination == dtn::data::EID() ) || ( bundle.source == dtn::data::EID() ) )
+				{
+					// invalid bundle!
+					throw dtn::data::Validator::RejectedException("destination or source EID is null");
+				}
+
+				// push bundle through the filter routines
+				dtn::core::FilterContext context;
+				context.setPeer(_peer._localeid);
+				context.setProtocol(_reactor._cl.getDiscoveryProtocol());
+				context.setBundle(bundle);
+
+				dtn::core::BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().filter(dtn::core::BundleFilter::INPUT, context, bundle);
+
+				switch (ret) {
+					case dtn::core::BundleFilter::ACCEPT:
+					case dtn::core::BundleFilter::PASS:
+					case dtn::core::BundleFilter::SKIP:
+						// inject bundle into core
+						dtn::core::BundleCore::getInstance().inject(_peer._localeid, bundle, false);
+						break;
+
+					case dtn::core::BundleFilter::REJECT:
+						throw dtn::data::Validator::RejectedException("rejected by input filter");
+						break;
+
+					case dtn::core::BundleFilter::DROP:
+						break;
+				}
+
+				return true;
+			} catch (const dtn::data::Validator::RejectedException &ex) {
+				IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 2) << "bundle has been rejected: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			} catch (const dtn::InvalidDataException &ex) {
+				IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 2) << "invalid bundle-data received: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			} catch (const std::exception &ex) {
+				if (!partial) {
+					IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 2) << "bundle processing failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				}
+			}
+
+			return false;
+		}
+
+		void TCPReactorConnection::sendSegment(const dtn::streams::StreamDataSegment &seg) throw ()
+		{
+			std::stringstream ss;
+			ss << seg;
+			_tx.append(ss.str());
+		}
+
+		bool TCPReactorConnection::writable() throw ()
+		{
+			if ((_socket == NULL) || (_state == STATE_CLOSED)) return false;
+
+			if (_state == STATE_CONNECTING)
+			{
+				int err = 0;
+				socklen_t len = sizeof(err);
+				if (::getsockopt(_socket->fd(), SOL_SOCKET, SO_ERROR, &err, &len) == -1) err = errno;
+
+				if (err == 0)
+				{
+					struct sockaddr_storage addr;
+					socklen_t addrlen = sizeof(addr);
+
+					if (::getpeername(_socket->fd(), (struct sockaddr*)&addr, &addrlen) == 0) {
+						connected();
+					} else if (errno == ENOTCONN) {
+						// connect still in progress
+						return true;
+					} else {
+						err = errno;
+					}
+				}
+
+				if (err != 0)
+				{
+					IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 15) << "connect failed: " << ::strerror(err) << IBRCOMMON_LOGGER_ENDL;
+
+					// try the next address
+					_worker.unwatch(_socket);
+					delete _socket;
+					_socket = NULL;
+
+					_addresses.pop_front();
+					connect();
+					return false;
+				}
+			}
+
+			while (true)
+			{
+				if (_tx_pos < _tx.size())
+				{
+					const ssize_t ret = ::send(_socket->fd(), _tx.data() + _tx_pos, _tx.size() - _tx_pos, MSG_NOSIGNAL);
+
+					if (ret < 0)
+					{
+						if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) return true;
+						if (errno == EINTR) continue;
+
+						IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 10) << "write error: " << ::strerror(errno) << IBRCOMMON_LOGGER_ENDL;
+						close();
+						return false;
+					}
+
+					_tx_pos += ret;
+					_last_sent = dtn::utils::Clock::getMonotonicTimestamp();
+					continue;
+				}
+
+				// all pending data written
+				_tx.clear();
+				_tx_pos = 0;
+
+				if (_state == STATE_CLOSING)
+				{
+					close();
+					return false;
+				}
+
+				if (_state != STATE_ESTABLISHED) return false;
+
+				// get the next bundle to transmit
+				if (!_out_active && !nextTransmission()) return false;
+
+				nextSegment();
+
+				if (_state == STATE_CLOSED) return false;
+			}
+
+			return false;
+		}
+
+		bool TCPReactorConnection::nextTransmission() throw ()
+		{
+			dtn::storage::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
+
+			while (true)
+			{
+				std::list<dtn::net::BundleTransfer> jobs;
+
+				{
+					ibrcommon::MutexLock l(_queue_lock);
+					if (_queue.empty()) return false;
+					jobs.splice(jobs.begin(), _queue, _queue.begin());
+				}
+
+				dtn::net::BundleTransfer &transfer = jobs.front();
+
+				// check if the transfer is directed to the connected neighbor
+				if (transfer.getNeighbor() != _node.getEID()) continue;
+
+				try {
+					// read the bundle out of the storage
+					dtn::data::Bundle bundle = storage.get(transfer.getBundle());
+
+					// push bundle through the filter routines
+					dtn::core::FilterContext context;
+					context.setPeer(_peer._localeid);
+					context.setProtocol(_reactor._cl.getDiscoveryProtocol());
+					context.setBundle(bundle);
+
+					dtn::core::BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().filter(dtn::core::BundleFilter::OUTPUT, context, bundle);
+
+					if (ret != dtn::core::BundleFilter::ACCEPT)
+					{
+						transfer.abort(dtn::net::TransferAbortedEvent::REASON_REFUSED_BY_FILTER);
+						continue;
+					}
+
+					// get the offset, if this bundle has been reactively fragmented before
+					dtn::data::Length offset = 0;
+					if (dtn::daemon::Configuration::getInstance().getNetwork().doFragmentation()
+							&& !bundle.get(dtn::data::PrimaryBlock::DONT_FRAGMENT))
+					{
+						offset = dtn::core::FragmentManager::getOffset(_node.getEID(), bundle);
+					}
+
+					// payload data are read out of the BLOB segment by segment
+					_out.discard();
+					dtn::data::DefaultSerializer serializer(_out);
+
+					if (offset > 0)
+					{
+						IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 4) << "Resume transfer of bundle " << bundle.toString() << " to " << _node.getEID().getString() << ", offset: " << offset << IBRCOMMON_LOGGER_ENDL;
+
+						// transmit the fragment
+						serializer << dtn::data::BundleFragment(bundle, offset, -1);
+					}
+					else
+					{
+						// transmit the bundle
+						serializer << bundle;
+					}
+
+					_out_pos = 0;
+					_out_active = true;
+
+					// put the bundle into the sentqueue
+					_sentqueue.push_back(Transmission(transfer, offset));
+
+					return true;
+				} catch (const dtn::storage::NoBundleFoundException&) {
+					// send transfer aborted event
+					transfer.abort(dtn::net::TransferAbortedEvent::REASON_BUNDLE_DELETED);
+				} catch (const ibrcommon::Exception &ex) {
+					IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 10) << "serialization failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+					_out.discard();
+					transfer.abort(dtn::net::TransferAbortedEvent::REASON_UNDEFINED);
+				}
+			}
+		}
+
+		void TCPReactorConnection::nextSegment() throw ()
+		{
+			const dtn::data::Length chunksize = (_chunksize > 0) ? _chunksize : 4096;
+			const dtn::data::Length remain = _out.size();
+			const dtn::data::Length len = std::min(chunksize, remain);
+
+			// read the data of the next segment
+			std::string data;
+			try {
+				_out.read(data, len);
+			} catch (const ibrcommon::IOException &ex) {
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, error) << "can not read bundle data: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// the transmission can not be completed
+				close();
+				return;
+			}
+
+			// wrap a segment around the data
+			dtn::streams::StreamDataSegment seg(dtn::streams::StreamDataSegment::MSG_DATA_SEGMENT, len);
+			if (_out_pos == 0) seg._flags |= dtn::streams::StreamDataSegment::MSG_MARK_BEGINN;
+			if (len == remain) seg._flags |= dtn::streams::StreamDataSegment::MSG_MARK_END;
+
+			sendSegment(seg);
+			_tx.append(data);
+			_out_pos += len;
+
+			// record statistics
+			_reactor._cl.addTrafficOut(len);
+			_last_data = dtn::utils::Clock::getMonotonicTimestamp();
+
+			// put the segment into the queue
+			if (_ack_support)
+			{
+				_segments.push_back(seg._flags);
+			}
+
+			if (seg._flags & dtn::streams::StreamDataSegment::MSG_MARK_END)
+			{
+				_out.discard();
+				_out_pos = 0;
+				_out_active = false;
+
+				// without ACK support we have to assume that a bundle is forwarded
+				// when the last segment is sent.
+				if (!_ack_support && !_sentqueue.empty())
+				{
+					_sentqueue.front().job.complete();
+					_sentqueue.pop_front();
+					_lastack = 0;
+				}
+			}
+		}
+
+		void TCPReactorConnection::bundleAck(const dtn::data::Length &ack) throw ()
+		{
+			if (_segments.empty())
+			{
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, error) << "got an unexpected ACK with size of " << ack << IBRCOMMON_LOGGER_ENDL;
+				return;
+			}
+
+			_lastack = ack;
+
+			if ((_segments.front() & dtn::streams::StreamDataSegment::MSG_MARK_END) && !_sentqueue.empty())
+			{
+				// mark job as complete
+				_sentqueue.front().job.complete();
+				_sentqueue.pop_front();
+				_lastack = 0;
+			}
+
+			_segments.pop_front();
+		}
+
+		void TCPReactorConnection::bundleRefused() throw ()
+		{
+			// skip segments
+			if (_rejected_segments > 0)
+			{
+				--_rejected_segments;
+				return;
+			}
+
+			if (_segments.empty())
+			{
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, error) << "got an unexpected NACK" << IBRCOMMON_LOGGER_ENDL;
+				return;
+			}
+
+			_segments.pop_front();
+
+			// get all segment ACKs in the queue for this transmission
+			while (!_segments.empty() && !(_segments.front() & dtn::streams::StreamDataSegment::MSG_MARK_BEGINN))
+			{
+				_segments.pop_front();
+				++_rejected_segments;
+			}
+
+			if (!_sentqueue.empty())
+			{
+				// abort the transmission
+				_sentqueue.front().job.abort(dtn::net::TransferAbortedEvent::REASON_REFUSED);
+				_sentqueue.pop_front();
+			}
+			else
+			{
+				IBRCOMMON_LOGGER_TAG(TCPReactorConnection::TAG, error) << "transfer refused without a bundle in queue" << IBRCOMMON_LOGGER_ENDL;
+			}
+
+			_lastack = 0;
+
+			// the queue is empty, then skip the current transfer
+			if (_segments.empty() && _out_active)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 25) << "skip the current transfer" << IBRCOMMON_LOGGER_ENDL;
+				_out.discard();
+				_out_pos = 0;
+				_out_active = false;
+			}
+		}
+
+		void TCPReactorConnection::signaled() throw ()
+		{
+			bool shutdown = false;
+			bool resolved = false;
+			{
+				ibrcommon::MutexLock l(_queue_lock);
+				shutdown = _shutdown;
+				_shutdown = false;
+
+				if (_resolved_pending)
+				{
+					_addresses.swap(_resolved);
+					_resolved.clear();
+					_resolved_pending = false;
+					resolved = true;
+				}
+			}
+
+			// connect to the resolved addresses
+			if (resolved && (_state == STATE_CONNECTING) && (_socket == NULL))
+			{
+				connect();
+			}
+
+			if (!shutdown) return;
+
+			switch (_state)
+			{
+				case STATE_ESTABLISHED:
+					sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_SHUTDOWN_NONE));
+					_state = STATE_CLOSING;
+					_started = dtn::utils::Clock::getMonotonicTimestamp();
+					break;
+
+				case STATE_CONNECTING:
+				case STATE_HANDSHAKE:
+					close();
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		void TCPReactorConnection::tick(const dtn::data::Timestamp &now) throw ()
+		{
+			switch (_state)
+			{
+				case STATE_CONNECTING:
+				case STATE_HANDSHAKE:
+				case STATE_CLOSING:
+					if ((now - _started) > _timeout)
+					{
+						IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 15) << "timeout in state " << _state << " of " << _node.toString() << IBRCOMMON_LOGGER_ENDL;
+
+						if ((_state == STATE_CONNECTING) && (_socket != NULL))
+						{
+							// try the next address
+							_worker.unwatch(_socket);
+							delete _socket;
+							_socket = NULL;
+
+							_addresses.pop_front();
+							connect();
+						}
+						else
+						{
+							close();
+						}
+					}
+					break;
+
+				case STATE_ESTABLISHED:
+					if (_peer._keepalive > 0)
+					{
+						// the peer has to send something within two keepalive intervals
+						if ((now - _last_recv) > (_peer._keepalive * 2))
+						{
+							ConnectionEvent::raise(ConnectionEvent::CONNECTION_TIMEOUT, _node);
+							close();
+							return;
+						}
+
+						// send a keepalive if nothing has been sent for a while
+						if ((now - _last_sent) >= _peer._keepalive)
+						{
+							sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_KEEPALIVE));
+							_last_sent = now;
+						}
+					}
+
+					if ((_idle_timeout > 0) && ((now - _last_data) > _idle_timeout) && _sentqueue.empty() && !_out_active)
+					{
+						bool idle = false;
+						{
+							ibrcommon::MutexLock l(_queue_lock);
+							idle = _queue.empty();
+						}
+
+						if (idle)
+						{
+							IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 15) << "idle timeout of " << _node.toString() << IBRCOMMON_LOGGER_ENDL;
+							sendSegment(dtn::streams::StreamDataSegment(dtn::streams::StreamDataSegment::MSG_SHUTDOWN_IDLE_TIMEOUT));
+							_state = STATE_CLOSING;
+							_started = now;
+						}
+					}
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		void TCPReactorConnection::close() throw ()
+		{
+			if (_socket != NULL)
+			{
+				_worker.unwatch(_socket);
+				delete _socket;
+				_socket = NULL;
+			}
+
+			_state = STATE_CLOSED;
+		}
+
+		void TCPReactorConnection::finish() throw ()
+		{
+			IBRCOMMON_LOGGER_DEBUG_TAG(TCPReactorConnection::TAG, 60) << "TCPReactorConnection down" << IBRCOMMON_LOGGER_ENDL;
+
+			// process partially received bundle as fragment
+			if ((_recv_size > 0) && !_recv_reject && (_recv_stored > 0)
+					&& _peer._flags.getBit(dtn::streams::StreamContactHeader::REQUEST_FRAGMENTATION))
+			{
+				processBundle(true);
+			}
+			clearBundle();
+
+			// requeue all bundles still in transit
+			while (!_sentqueue.empty())
+			{
+				const Transmission &t = _sentqueue.front();
+
+				if ((_lastack > 0) && (_peer._flags.getBit(dtn::streams::StreamContactHeader::REQUEST_FRAGMENTATION)))
+				{
+					// some data are already acknowledged
+					// store this information in the fragment manager
+					dtn::core::FragmentManager::setOffset(_peer.getEID(), t.job.getBundle(), _lastack, t.offset);
+				}
+
+				// set last ack to zero
+				_lastack = 0;
+
+				// release the job
+				_sentqueue.pop_front();
+			}
+
+			{
+				ibrcommon::MutexLock l(_queue_lock);
+				_queue.clear();
+			}
+
+			if (_peer._localeid != dtn::data::EID())
+			{
+				// event
+				ConnectionEvent::raise(ConnectionEvent::CONNECTION_DOWN, _node);
+			}
+		}
+	}
+}
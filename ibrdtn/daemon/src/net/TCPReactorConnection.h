@@ -0,0 +1,292 @@
+/*
+ * TCPReactorConnection.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef TCPREACTORCONNECTION_H_
+#define TCPREACTORCONNECTION_H_
+
+#include "core/Node.h"
+#include "net/BundleTransfer.h"
+#include "net/TCPReactor.h"
+
+#include <ibrdtn/data/Number.h>
+#include <ibrdtn/data/Exceptions.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/streams/StreamContactHeader.h>
+#include <ibrdtn/streams/StreamDataSegment.h>
+
+#include <ibrcommon/net/socket.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/Exceptions.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <deque>
+#include <list>
+#include <vector>
+#include <stdint.h>
+
+namespace dtn
+{
+	namespace net
+	{
+		/**
+		 * Non-blocking state machine of a TCP convergence layer connection.
+		 * It implements the same wire format as dtn::streams::StreamConnection
+		 * (contact header exchange, data segments, ACKs, refuse, keepalive and
+		 * shutdown messages) but never blocks on the socket. All methods except
+		 * queue(), shutdown(), resolved() and match() are called by the owning
+		 * worker only.
+		 */
+		class TCPReactorConnection
+		{
+			static const std::string TAG;
+
+		public:
+			enum State
+			{
+				STATE_CONNECTING = 0,
+				STATE_HANDSHAKE = 1,
+				STATE_ESTABLISHED = 2,
+				STATE_CLOSING = 3,
+				STATE_CLOSED = 4
+			};
+
+			TCPReactorConnection(TCPReactor &reactor, TCPReactor::Worker &worker, const dtn::core::Node &node, ibrcommon::clientsocket *sock, const size_t timeout);
+			virtual ~TCPReactorConnection();
+
+			/**
+			 * Queue a bundle for this connection. (thread-safe)
+			 */
+			void queue(const dtn::net::BundleTransfer &job) throw ();
+
+			/**
+			 * Request the shutdown of the connection. (thread-safe)
+			 */
+			void shutdown() throw ();
+
+			/**
+			 * Hand over the resolved addresses of the node. (thread-safe)
+			 */
+			void resolved(const std::list<TCPReactor::Address> &addresses) throw ();
+
+			bool match(const dtn::core::Node &n) const;
+
+			/**
+			 * Returns the associated node object
+			 */
+			const dtn::core::Node& getNode() const;
+
+			/**
+			 * Start the connection setup or the handshake
+			 */
+			void initialize() throw ();
+
+			/**
+			 * Read and process available data of the socket
+			 * @return True, if the read budget has been exhausted and
+			 * more data may be available.
+			 */
+			bool readable() throw ();
+
+			/**
+			 * Write pending data to the socket
+			 * @return True, if the socket is not writable at the moment
+			 * and the connection waits for a writable event.
+			 */
+			bool writable() throw ();
+
+			/**
+			 * Process queued jobs and shutdown requests
+			 */
+			void signaled() throw ();
+
+			/**
+			 * Check keepalive and timeouts, called once per second
+			 */
+			void tick(const dtn::data::Timestamp &now) throw ();
+
+			/**
+			 * Returns the current state
+			 */
+			State getState() const throw ();
+
+			/**
+			 * Close the socket immediately
+			 */
+			void close() throw ();
+
+			/**
+			 * Release all resources of a closed connection: requeue unsent
+			 * bundles, store reactive fragmentation offsets and raise the
+			 * connection down event.
+			 */
+			void finish() throw ();
+
+		private:
+			enum ReceiveState
+			{
+				RECV_SEGMENT = 0,
+				RECV_DATA = 1
+			};
+
+			class Transmission
+			{
+			public:
+				Transmission(const dtn::net::BundleTransfer &job, const dtn::data::Length &offset);
+				~Transmission();
+
+				dtn::net::BundleTransfer job;
+				dtn::data::Length offset;
+			};
+
+			/**
+			 * Output stream for the serialization of outgoing bundles. Block
+			 * headers are buffered in memory while the payload is referenced
+			 * and read out of its BLOB segment by segment.
+			 */
+			class Spool : public std::ostream, public dtn::data::PayloadBlock::Sink
+			{
+			public:
+				Spool();
+				virtual ~Spool();
+
+				virtual void append(const ibrcommon::BLOB::Reference &ref, const dtn::data::Length &offset, const dtn::data::Length &length);
+
+				/**
+				 * Returns the number of bytes not read yet
+				 */
+				dtn::data::Length size();
+
+				/**
+				 * Read the next bytes of the bundle and append them to data
+				 */
+				void read(std::string &data, dtn::data::Length length) throw (ibrcommon::IOException);
+
+				/**
+				 * Discard all data of the bundle
+				 */
+				void discard();
+
+			private:
+				class Part
+				{
+				public:
+					Part(const std::string &data);
+					Part(const dtn::data::Length &offset, const dtn::data::Length &length);
+					~Part();
+
+					// buffered data or a range of the next referenced BLOB
+					std::string data;
+					bool blob;
+					dtn::data::Length offset;
+					dtn::data::Length length;
+				};
+
+				void commit();
+
+				std::stringbuf _buf;
+				std::deque<Part> _parts;
+				std::deque<ibrcommon::BLOB::Reference> _refs;
+				dtn::data::Length _pos;
+				dtn::data::Length _size;
+			};
+
+			void connect() throw ();
+			void connected() throw ();
+			void handshake() throw ();
+
+			bool parseHeader() throw (dtn::InvalidProtocolException);
+			bool parseSegment() throw (dtn::InvalidProtocolException);
+			void received(const char *data, size_t len) throw ();
+			void processSegment(const dtn::streams::StreamDataSegment &seg) throw ();
+			void segmentReceived() throw ();
+			void store(const char *data, size_t len) throw ();
+			void clearBundle() throw ();
+			bool processBundle(bool partial) throw ();
+
+			void sendSegment(const dtn::streams::StreamDataSegment &seg) throw ();
+			bool nextTransmission() throw ();
+			void nextSegment() throw ();
+
+			void bundleAck(const dtn::data::Length &ack) throw ();
+			void bundleRefused() throw ();
+
+			TCPReactor &_reactor;
+			TCPReactor::Worker &_worker;
+
+			dtn::core::Node _node;
+			ibrcommon::clientsocket *_socket;
+			const size_t _timeout;
+
+			State _state;
+
+			// connection setup
+			std::list<TCPReactor::Address> _addresses;
+
+			// contact header of this node and the peer
+			dtn::data::Bitset<dtn::streams::StreamContactHeader::HEADER_BITS> _flags;
+			dtn::streams::StreamContactHeader _peer;
+			bool _ack_support;
+			bool _nack_support;
+
+			// jobs queued by other threads
+			ibrcommon::Mutex _queue_lock;
+			std::list<dtn::net::BundleTransfer> _queue;
+			bool _shutdown;
+			std::list<TCPReactor::Address> _resolved;
+			bool _resolved_pending;
+
+			// receiver
+			std::vector<char> _rx;
+			size_t _rx_pos;
+			ReceiveState _recv_state;
+			dtn::data::Length _recv_remain;
+			uint8_t _recv_flags;
+			dtn::data::Length _recv_size;
+			bool _recv_reject;
+			ibrcommon::BLOB::Reference _bundle;
+			dtn::data::Length _recv_stored;
+
+			// sender
+			std::string _tx;
+			size_t _tx_pos;
+			Spool _out;
+			dtn::data::Length _out_pos;
+			bool _out_active;
+			std::deque<uint8_t> _segments;
+			size_t _rejected_segments;
+			std::deque<Transmission> _sentqueue;
+			dtn::data::Length _lastack;
+			const dtn::data::Length _chunksize;
+
+			// timer values
+			dtn::data::Timestamp _started;
+			dtn::data::Timestamp _last_recv;
+			dtn::data::Timestamp _last_sent;
+			dtn::data::Timestamp _last_data;
+			const dtn::data::Timeout _idle_timeout;
+		};
+	}
+}
+
+#endif /* TCPREACTORCONNECTION_H_ */
@@ -82,6 +82,11 @@ namespace dtn
 			return "undefined";
 		}
 
+		size_t TransferAbortedEvent::getOrderingKey() const
+		{
+			return dtn::core::Event::getOrderingKey(_bundle);
+		}
+
 		string TransferAbortedEvent::getMessage() const
 		{
 			return "transfer of bundle " + _bundle.toString() + " to " + _peer.getString() + " aborted. (" + getReason(reason) + ")";
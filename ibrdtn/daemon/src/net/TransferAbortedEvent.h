@@ -50,6 +50,8 @@ namespace dtn
 
 			std::string getMessage() const;
 
+			virtual size_t getOrderingKey() const;
+
 			static void raise(const dtn::data::EID &peer, const dtn::data::BundleID &id, const AbortReason reason = REASON_UNDEFINED);
 
 			const dtn::data::EID& getPeer() const;
@@ -59,6 +59,11 @@ namespace dtn
 			return _bundle;
 		}
 
+		size_t TransferCompletedEvent::getOrderingKey() const
+		{
+			return dtn::core::Event::getOrderingKey(_bundle);
+		}
+
 		string TransferCompletedEvent::getMessage() const
 		{
 			return "transfer of bundle " + _bundle.toString() + " to " + _peer.getString() + " completed";
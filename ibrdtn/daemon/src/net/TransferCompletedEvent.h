@@ -39,6 +39,8 @@ namespace dtn
 
 			std::string getMessage() const;
 
+			virtual size_t getOrderingKey() const;
+
 			static void raise(const dtn::data::EID peer, const dtn::data::MetaBundle &bundle);
 
 			const dtn::data::EID& getPeer() const;
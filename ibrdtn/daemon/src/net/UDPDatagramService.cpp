@@ -42,7 +42,7 @@ namespace dtn
 			// set connection parameters
 			_params.max_msg_length = mtu - 2;	// minus 2 bytes because we encode seqno and flags into 2 bytes
 			_params.max_seq_numbers = 16;		// seqno 0..15
-			_params.flowcontrol = DatagramService::FLOW_SLIDING_WINDOW;
+			_params.flowcontrol = DatagramService::FLOW_SELECTIVE_REPEAT;	// falls back to go-back-n with older peers
 			_params.initial_timeout = 50;		// initial timeout 50ms
 			_params.retry_limit = 5;
 		}
@@ -217,6 +217,11 @@ namespace dtn
 			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::net::ConnectionEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::core::BundlePurgeEvent>::add(this);
+
+			// feed new bundles into the neighbor database
+			try {
+				getStorage().attach(&_neighbor_database.getFeed());
+			} catch (const ibrcommon::Exception&) { };
 		}
 
 		void BaseRouter::componentDown() throw ()
@@ -229,6 +234,10 @@ namespace dtn
 			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::net::ConnectionEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::core::BundlePurgeEvent>::remove(this);
+
+			try {
+				getStorage().detach(&_neighbor_database.getFeed());
+			} catch (const ibrcommon::Exception&) { };
 		}
 
 		/**
@@ -288,6 +297,9 @@ namespace dtn
 				NeighborDatabase::NeighborEntry &entry = _neighbor_database.get(event.getPeer());
 				entry.releaseTransfer(event.getBundleID());
 
+				// the bundle has to be examined again
+				entry.invalidate();
+
 				if (event.reason == dtn::net::TransferAbortedEvent::REASON_REFUSED)
 				{
 					const dtn::data::MetaBundle meta = getStorage().info(event.getBundleID());
@@ -318,6 +330,9 @@ namespace dtn
 				{
 					ibrcommon::MutexLock l(_neighbor_database);
 					_neighbor_database.create( event.getNode().getEID() );
+
+					// routing decisions depend on the set of neighbors
+					_neighbor_database.invalidate();
 				}
 
 				// trigger all routing modules to search for bundles to forward
@@ -332,6 +347,10 @@ namespace dtn
 			{
 				try {
 					ibrcommon::MutexLock l(_neighbor_database);
+
+					// routing decisions depend on the set of neighbors
+					_neighbor_database.invalidate();
+
 					_neighbor_database.get( event.getNode().getEID() ).reset();
 				} catch (const NeighborDatabase::EntryNotFoundException&) { };
 
@@ -381,7 +400,10 @@ namespace dtn
 		{
 			dtn::data::Timestamp expire_time = event.getTimestamp();
 
-			// do the expiration only every 60 seconds
+			// do the expiration only every 60 seconds, driven by the time event
+			// and not by the timing wheel: persistent bundle sets expire and sync
+			// on disk, which would stall other timers on the wheel thread while
+			// the time event is processed by an event switch worker
 			if (expire_time > _next_expiration) {
 				// store the next expiration time
 				_next_expiration = expire_time + 60;
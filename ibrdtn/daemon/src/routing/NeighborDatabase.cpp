@@ -23,28 +23,146 @@
 #include "core/BundleCore.h"
 #include <ibrdtn/utils/Clock.h>
 #include <ibrcommon/Logger.h>
+#include <ibrcommon/thread/MutexLock.h>
 #include <limits>
+#include <time.h>
 
 namespace dtn
 {
 	namespace routing
 	{
+		const dtn::data::Size NeighborDatabase::BundleFeed::MAX_BUNDLES = 10000;
+
+		NeighborDatabase::BundleFeed::BundleFeed()
+		 : _offset(0)
+		{
+		}
+
+		NeighborDatabase::BundleFeed::~BundleFeed()
+		{
+		}
+
+		void NeighborDatabase::BundleFeed::add(const dtn::data::MetaBundle &b)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			// a bundle added again moves to the end of the feed
+			id_map::iterator it = _ids.find(b);
+			if (it != _ids.end()) _bundles[(*it).second - _offset].second = false;
+
+			_ids[b] = _offset + _bundles.size();
+			_bundles.push_back(std::make_pair(b, true));
+
+			// drop the oldest bundle if the feed is full
+			if (_bundles.size() > MAX_BUNDLES) pop();
+		}
+
+		void NeighborDatabase::BundleFeed::remove(const dtn::data::BundleID &id)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			id_map::iterator it = _ids.find(id);
+			if (it == _ids.end()) return;
+
+			// mark the bundle as removed, the positions of all others stay the same
+			_bundles[(*it).second - _offset].second = false;
+			_ids.erase(it);
+		}
+
+		void NeighborDatabase::BundleFeed::get(const dtn::storage::BundleSelector &cb, dtn::storage::BundleResult &result) throw (dtn::storage::NoBundleFoundException, dtn::storage::BundleSelectorException)
+		{
+			dtn::data::MetaBundle meta;
+			dtn::data::Size items_added = 0;
+
+			for (dtn::data::Size position = begin(); next(position, meta) && ((cb.limit() == 0) || (items_added < cb.limit())); ++position)
+			{
+				if (cb.addIfSelected(result, meta)) items_added++;
+			}
+
+			if (items_added == 0) throw dtn::storage::NoBundleFoundException();
+		}
+
+		const std::set<dtn::data::EID> NeighborDatabase::BundleFeed::getDistinctDestinations()
+		{
+			ibrcommon::MutexLock l(_lock);
+			std::set<dtn::data::EID> ret;
+
+			for (std::deque<feed_entry>::const_iterator it = _bundles.begin(); it != _bundles.end(); ++it)
+			{
+				if ((*it).second) ret.insert((*it).first.destination);
+			}
+
+			return ret;
+		}
+
+		dtn::data::Size NeighborDatabase::BundleFeed::begin() const
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _offset;
+		}
+
+		dtn::data::Size NeighborDatabase::BundleFeed::end() const
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _offset + _bundles.size();
+		}
+
+		bool NeighborDatabase::BundleFeed::next(dtn::data::Size &position, dtn::data::MetaBundle &meta) const
+		{
+			ibrcommon::MutexLock l(_lock);
+			if (position < _offset) position = _offset;
+
+			for (; (position - _offset) < _bundles.size(); ++position)
+			{
+				const feed_entry &e = _bundles[position - _offset];
+				if (e.second)
+				{
+					meta = e.first;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void NeighborDatabase::BundleFeed::trim(const dtn::data::Size &position)
+		{
+			ibrcommon::MutexLock l(_lock);
+			while ((_offset < position) && !_bundles.empty()) pop();
+		}
+
+		void NeighborDatabase::BundleFeed::pop()
+		{
+			if (_bundles.front().second) _ids.erase(_bundles.front().first);
+			_bundles.pop_front();
+			_offset++;
+		}
+
+		NeighborDatabase::BundleCursor::BundleCursor()
+		 : valid(false), position(0)
+		{
+		}
+
+		ibrcommon::Mutex NeighborDatabase::NeighborEntry::__version_lock;
+		dtn::data::Size NeighborDatabase::NeighborEntry::__version = 0;
+
 		NeighborDatabase::NeighborEntry::NeighborEntry()
-		 : eid(), _filter(), _filter_expire(0), _filter_state(FILTER_EXPIRED, FILTER_FINAL)
+		 : eid(), _filter(), _filter_version(0), _filter_expire(0), _sent_version(0), _filter_state(FILTER_EXPIRED, FILTER_FINAL)
 		{}
 
 		NeighborDatabase::NeighborEntry::NeighborEntry(const dtn::data::EID &e)
-		 : eid(e), _filter(), _filter_expire(0), _filter_state(FILTER_EXPIRED, FILTER_FINAL)
+		 : eid(e), _filter(), _filter_version(0), _filter_expire(0), _sent_version(0), _filter_state(FILTER_EXPIRED, FILTER_FINAL)
 		{ }
 
 		NeighborDatabase::NeighborEntry::~NeighborEntry()
 		{
 		}
 
-		void NeighborDatabase::NeighborEntry::update(const ibrcommon::BloomFilter &bf, const dtn::data::Number &lifetime)
+		void NeighborDatabase::NeighborEntry::update(const ibrcommon::BloomFilter &bf, const dtn::data::Number &lifetime, const dtn::data::Number &version)
 		{
 			ibrcommon::ThreadsafeState<FILTER_REQUEST_STATE>::Locked l = _filter_state.lock();
 			_filter = bf;
+			_filter_version = version;
 
 			if (lifetime == 0)
 			{
@@ -56,6 +174,47 @@ namespace dtn
 			}
 
 			l = FILTER_AVAILABLE;
+
+			// the neighbor may miss bundles rejected before
+			invalidate();
+		}
+
+		const ibrcommon::BloomFilter& NeighborDatabase::NeighborEntry::getSummaryVector() const
+		{
+			return _filter;
+		}
+
+		const dtn::data::Number& NeighborDatabase::NeighborEntry::getSummaryVersion() const
+		{
+			return _filter_version;
+		}
+
+		void NeighborDatabase::NeighborEntry::resetSummaryVersion()
+		{
+			_filter_version = 0;
+		}
+
+		const dtn::data::Number& NeighborDatabase::NeighborEntry::setSentSummaryVector(const ibrcommon::BloomFilter &bf)
+		{
+			ibrcommon::MutexLock l(__version_lock);
+
+			// start with the current time to avoid the re-use of versions after a restart
+			const dtn::data::Size now = static_cast<dtn::data::Size>(::time(NULL)) << 20;
+			__version = (__version < now) ? now : (__version + 1);
+
+			_sent_filter = bf;
+			_sent_version = __version;
+			return _sent_version;
+		}
+
+		const ibrcommon::BloomFilter& NeighborDatabase::NeighborEntry::getSentSummaryVector() const
+		{
+			return _sent_filter;
+		}
+
+		const dtn::data::Number& NeighborDatabase::NeighborEntry::getSentSummaryVersion() const
+		{
+			return _sent_version;
 		}
 
 		void NeighborDatabase::NeighborEntry::reset()
@@ -66,6 +225,8 @@ namespace dtn
 
 			// do not expire again in the next 60 seconds
 			_filter_expire = dtn::utils::Clock::getTime() + 60;
+
+			invalidate();
 		}
 
 		void NeighborDatabase::NeighborEntry::add(const dtn::data::MetaBundle &bundle)
@@ -123,6 +284,8 @@ namespace dtn
 
 					// do not expire again in the next 60 seconds
 					_filter_expire = timestamp + 60;
+
+					invalidate();
 				}
 			}
 
@@ -187,6 +350,22 @@ namespace dtn
 				_datasets.erase(ret.first);
 				_datasets.insert( dset );
 			}
+
+			// routing decisions may change with the new data-set
+			invalidate();
+		}
+
+		NeighborDatabase::BundleCursor& NeighborDatabase::NeighborEntry::getCursor(const RoutingExtension *owner)
+		{
+			return _cursors[owner];
+		}
+
+		void NeighborDatabase::NeighborEntry::invalidate()
+		{
+			for (cursor_map::iterator it = _cursors.begin(); it != _cursors.end(); ++it)
+			{
+				(*it).second.valid = false;
+			}
 		}
 
 		NeighborDatabase::NeighborDatabase()
@@ -237,6 +416,38 @@ namespace dtn
 			return *(*iter).second;
 		}
 
+		void NeighborDatabase::invalidate()
+		{
+			for (neighbor_map::iterator iter = _entries.begin(); iter != _entries.end(); ++iter)
+			{
+				(*iter).second->invalidate();
+			}
+		}
+
+		NeighborDatabase::BundleFeed& NeighborDatabase::getFeed()
+		{
+			return _feed;
+		}
+
+		void NeighborDatabase::trim()
+		{
+			dtn::data::Size position = _feed.end();
+
+			// look for the lowest position of all valid cursors
+			for (neighbor_map::const_iterator iter = _entries.begin(); iter != _entries.end(); ++iter)
+			{
+				const NeighborEntry::cursor_map &cursors = (*iter).second->_cursors;
+
+				for (NeighborEntry::cursor_map::const_iterator it = cursors.begin(); it != cursors.end(); ++it)
+				{
+					const BundleCursor &cursor = (*it).second;
+					if (cursor.valid && (cursor.position < position)) position = cursor.position;
+				}
+			}
+
+			_feed.trim(position);
+		}
+
 		void NeighborDatabase::remove(const dtn::data::EID &eid)
 		{
 			neighbor_map::iterator iter = _entries.find(eid);
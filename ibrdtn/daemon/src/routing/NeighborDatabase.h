@@ -23,6 +23,7 @@
 #define NEIGHBORDATABASE_H_
 
 #include "routing/NeighborDataset.h"
+#include "storage/BundleIndex.h"
 #include <ibrdtn/data/BundleSet.h>
 #include <ibrdtn/data/EID.h>
 #include <ibrdtn/data/BundleID.h>
@@ -30,13 +31,17 @@
 #include <ibrcommon/data/BloomFilter.h>
 #include <ibrcommon/Exceptions.h>
 #include <ibrcommon/thread/ThreadsafeState.h>
+#include <ibrcommon/thread/Mutex.h>
 #include <algorithm>
+#include <deque>
 #include <map>
 
 namespace dtn
 {
 	namespace routing
 	{
+		class RoutingExtension;
+
 		/**
 		 * The neighbor database contains collected information about neighbors.
 		 * This includes the last timestamp on which a neighbor was seen, the bundles
@@ -92,6 +97,88 @@ namespace dtn
 				virtual ~DatasetNotAvailableException() throw () { };
 			};
 
+			/**
+			 * The feed records all bundles added to the storage. Routing
+			 * extensions use it to examine only bundles they have not seen
+			 * before instead of querying the whole storage.
+			 */
+			class BundleFeed : public dtn::storage::BundleIndex
+			{
+			public:
+				BundleFeed();
+				virtual ~BundleFeed();
+
+				virtual void add(const dtn::data::MetaBundle &b);
+				virtual void remove(const dtn::data::BundleID &id);
+
+				/**
+				 * Query the bundles of the feed.
+				 * @see BundleSeeker::get(BundleSelector &cb, BundleResult &result)
+				 */
+				virtual void get(const dtn::storage::BundleSelector &cb, dtn::storage::BundleResult &result) throw (dtn::storage::NoBundleFoundException, dtn::storage::BundleSelectorException);
+
+				/**
+				 * @see BundleSeeker::getDistinctDestinations()
+				 */
+				virtual const std::set<dtn::data::EID> getDistinctDestinations();
+
+				/**
+				 * Returns the position of the oldest bundle in the feed.
+				 */
+				dtn::data::Size begin() const;
+
+				/**
+				 * Returns the position of the next bundle added to the feed.
+				 */
+				dtn::data::Size end() const;
+
+				/**
+				 * Look for the next bundle at or after the given position.
+				 * @param position Moved to the position of the returned bundle
+				 * @param meta Set to the bundle found
+				 * @return False, if there are no more bundles
+				 */
+				bool next(dtn::data::Size &position, dtn::data::MetaBundle &meta) const;
+
+				/**
+				 * Discard all bundles before the given position.
+				 */
+				void trim(const dtn::data::Size &position);
+
+			private:
+				// the feed is bounded, lagging cursors have to scan the storage again
+				static const dtn::data::Size MAX_BUNDLES;
+
+				// drop the oldest bundle, the lock has to be held
+				void pop();
+
+				// bundles with a flag set to false once they are removed
+				typedef std::pair<dtn::data::MetaBundle, bool> feed_entry;
+
+				mutable ibrcommon::Mutex _lock;
+				std::deque<feed_entry> _bundles;
+
+				// position of each bundle in the feed
+				typedef std::map<dtn::data::BundleID, dtn::data::Size> id_map;
+				id_map _ids;
+
+				dtn::data::Size _offset;
+			};
+
+			/**
+			 * Position of a routing extension in the bundle feed for one
+			 * neighbor. All bundles before the position have been examined
+			 * for this neighbor if the cursor is valid.
+			 */
+			class BundleCursor
+			{
+			public:
+				BundleCursor();
+
+				bool valid;
+				dtn::data::Size position;
+			};
+
 			class NeighborEntry
 			{
 			public:
@@ -103,8 +190,43 @@ namespace dtn
 				 * updates the bloomfilter of this entry with a new one
 				 * @param bf The bloomfilter object
 				 * @param lifetime The desired lifetime of this bloomfilter
+				 * @param version The version of the summary vector, zero if unknown
 				 */
-				void update(const ibrcommon::BloomFilter &bf, const dtn::data::Number &lifetime = 0);
+				void update(const ibrcommon::BloomFilter &bf, const dtn::data::Number &lifetime = 0, const dtn::data::Number &version = 0);
+
+				/**
+				 * Returns the last summary vector received from this neighbor
+				 */
+				const ibrcommon::BloomFilter& getSummaryVector() const;
+
+				/**
+				 * Returns the version of the last summary vector received
+				 * from this neighbor or zero if the version is unknown
+				 */
+				const dtn::data::Number& getSummaryVersion() const;
+
+				/**
+				 * Forget the version of the received summary vector, the next
+				 * summary vector has to be transferred completely.
+				 */
+				void resetSummaryVersion();
+
+				/**
+				 * Remember the own summary vector sent to this neighbor
+				 * @return The version assigned to the summary vector
+				 */
+				const dtn::data::Number& setSentSummaryVector(const ibrcommon::BloomFilter &bf);
+
+				/**
+				 * Returns the own summary vector last sent to this neighbor
+				 */
+				const ibrcommon::BloomFilter& getSentSummaryVector() const;
+
+				/**
+				 * Returns the version of the own summary vector last sent
+				 * to this neighbor or zero if none has been sent
+				 */
+				const dtn::data::Number& getSentSummaryVersion() const;
 
 				void reset();
 
@@ -188,6 +310,17 @@ namespace dtn
 				 */
 				void putDataset(NeighborDataset &dset);
 
+				/**
+				 * Returns the bundle cursor of a routing extension.
+				 */
+				BundleCursor& getCursor(const RoutingExtension *owner);
+
+				/**
+				 * Invalidate all bundle cursors of this entry. The next
+				 * query of each routing extension examines all bundles again.
+				 */
+				void invalidate();
+
 				/**
 				 * Remove a data-set.
 				 */
@@ -200,17 +333,35 @@ namespace dtn
 					if (it == _datasets.end()) return;
 
 					_datasets.erase(it);
+
+					// routing decisions may change without the data-set
+					invalidate();
 				}
 
 			private:
+				friend class NeighborDatabase;
+
+				// position of each routing extension in the bundle feed
+				typedef std::map<const RoutingExtension*, BundleCursor> cursor_map;
+				cursor_map _cursors;
+
 				// stores bundle currently in transit
 				std::set<dtn::data::BundleID> _transit_bundles;
 
 				// bloomfilter used as summary vector
 				ibrcommon::BloomFilter _filter;
+				dtn::data::Number _filter_version;
 				dtn::data::BundleSet _summary;
 				dtn::data::Timestamp _filter_expire;
 
+				// own summary vector sent to this neighbor
+				ibrcommon::BloomFilter _sent_filter;
+				dtn::data::Number _sent_version;
+
+				// versions of sent summary vectors are unique across restarts
+				static ibrcommon::Mutex __version_lock;
+				static dtn::data::Size __version;
+
 				// extended neighbor data
 				typedef std::set<NeighborDataset> data_set;
 				data_set _datasets;
@@ -260,9 +411,28 @@ namespace dtn
 			 */
 			void expire(const dtn::data::Timestamp &timestamp);
 
+			/**
+			 * Invalidate the bundle cursors of all entries.
+			 */
+			void invalidate();
+
+			/**
+			 * Returns the feed of recently added bundles. It has to be
+			 * attached to the bundle storage.
+			 */
+			BundleFeed& getFeed();
+
+			/**
+			 * Discard all bundles of the feed already examined by
+			 * all valid cursors.
+			 */
+			void trim();
+
 		private:
 			typedef std::map<dtn::data::EID, NeighborDatabase::NeighborEntry* > neighbor_map;
 			neighbor_map _entries;
+
+			BundleFeed _feed;
 		};
 	}
 }
@@ -154,7 +154,7 @@ namespace dtn
 							BundleFilter filter(*this, entry, plist);
 
 							// query an unknown bundle from the storage, the list contains max. 10 items.
-							(**this).getSeeker().get(filter, list);
+							query(entry, filter, list);
 						}
 
 						IBRCOMMON_LOGGER_DEBUG_TAG(NeighborRoutingExtension::TAG, 5) << "got " << list.size() << " items to transfer to " << task.eid.getString() << IBRCOMMON_LOGGER_ENDL;
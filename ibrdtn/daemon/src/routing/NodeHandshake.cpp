@@ -20,6 +20,7 @@
  */
 
 #include "routing/NodeHandshake.h"
+#include <vector>
 
 namespace dtn
 {
@@ -160,6 +161,52 @@ namespace dtn
 			return ss.str();
 		}
 
+		void NodeHandshake::serializeItems(std::ostream &stream, const item_set &items)
+		{
+			// the number of items
+			dtn::data::Number number_of_items(items.size());
+			stream << number_of_items;
+
+			for (NodeHandshake::item_set::const_iterator iter = items.begin(); iter != items.end(); ++iter)
+			{
+				const NodeHandshakeItem &item = (**iter);
+
+				// first the identifier of the item
+				dtn::data::Number id(item.getIdentifier());
+				stream << id;
+
+				// then the length of the payload
+				dtn::data::Number len(item.getLength());
+				stream << len;
+
+				item.serialize(stream);
+			}
+		}
+
+		void NodeHandshake::deserializeItems(std::istream &stream, StreamMap &items)
+		{
+			// the number of items
+			dtn::data::Number number_of_items;
+			stream >> number_of_items;
+
+			for (size_t i = 0; number_of_items > i; ++i)
+			{
+				// first the identifier of the item
+				dtn::data::Number id;
+				stream >> id;
+
+				// then the length of the payload
+				dtn::data::Number len;
+				stream >> len;
+
+				// add to raw map and create data container
+				std::stringstream &data = items.get(id);
+
+				// copy data to stringstream
+				ibrcommon::BLOB::copy(data, stream, len.get<std::streamsize>());
+			}
+		}
+
 		std::ostream& operator<<(std::ostream &stream, const NodeHandshake &hs)
 		{
 			// first the type as SDNV
@@ -176,30 +223,20 @@ namespace dtn
 					dtn::data::Number req(*iter);
 					stream << req;
 				}
+
+				// optional parameters of the requests, ignored by older implementations
+				if (!hs._items.empty())
+				{
+					NodeHandshake::serializeItems(stream, hs._items);
+				}
 			}
 			else if (hs.getType() == NodeHandshake::HANDSHAKE_RESPONSE)
 			{
 				// then the lifetime of this data
 				stream << hs._lifetime;
 
-				// then the number of request items
-				dtn::data::Number number_of_items(hs._items.size());
-				stream << number_of_items;
-
-				for (NodeHandshake::item_set::const_iterator iter = hs._items.begin(); iter != hs._items.end(); ++iter)
-				{
-					const NodeHandshakeItem &item = (**iter);
-
-					// first the identifier of the item
-					dtn::data::Number id(item.getIdentifier());
-					stream << id;
-
-					// then the length of the payload
-					dtn::data::Number len(item.getLength());
-					stream << len;
-
-					item.serialize(stream);
-				}
+				// then the items
+				NodeHandshake::serializeItems(stream, hs._items);
 			}
 
 			return stream;
@@ -225,33 +262,20 @@ namespace dtn
 					stream >> req;
 					hs._requests.insert(req);
 				}
+
+				// optional parameters of the requests
+				if (stream.peek() != std::char_traits<char>::eof())
+				{
+					NodeHandshake::deserializeItems(stream, hs._raw_items);
+				}
 			}
 			else if (hs.getType() == NodeHandshake::HANDSHAKE_RESPONSE)
 			{
 				// then the lifetime of this data
 				stream >> hs._lifetime;
 
-				// then the number of request items
-				dtn::data::Number number_of_items;
-				stream >> number_of_items;
-
-				for (size_t i = 0; number_of_items > i; ++i)
-				{
-					// first the identifier of the item
-					dtn::data::Number id;
-					stream >> id;
-
-					// then the length of the payload
-					dtn::data::Number len;
-					stream >> len;
-
-					// add to raw map and create data container
-					//std::stringstream *data = new std::stringstream();
-					std::stringstream &data = hs._raw_items.get(id);
-
-					// copy data to stringstream
-					ibrcommon::BLOB::copy(data, stream, len.get<std::streamsize>());
-				}
+				// then the items
+				NodeHandshake::deserializeItems(stream, hs._raw_items);
 			}
 
 			return stream;
@@ -390,6 +414,137 @@ namespace dtn
 
 		const dtn::data::Number BloomFilterPurgeVector::identifier = NodeHandshakeItem::BLOOM_FILTER_PURGE_VECTOR;
 
+		BloomFilterSummaryDelta::BloomFilterSummaryDelta()
+		 : _base(0), _version(0), _table_size(0)
+		{
+		}
+
+		BloomFilterSummaryDelta::BloomFilterSummaryDelta(const dtn::data::Number &version)
+		 : _base(0), _version(version), _table_size(0)
+		{
+		}
+
+		BloomFilterSummaryDelta::BloomFilterSummaryDelta(const dtn::data::Number &base, const dtn::data::Number &version)
+		 : _base(base), _version(version), _table_size(0)
+		{
+		}
+
+		BloomFilterSummaryDelta::BloomFilterSummaryDelta(const dtn::data::Number &base, const dtn::data::Number &version, const ibrcommon::BloomFilter &from, const ibrcommon::BloomFilter &to)
+		 : _base(base), _version(version), _table_size(to.size())
+		{
+			const ibrcommon::cell_type *t1 = from.table();
+			const ibrcommon::cell_type *t2 = to.table();
+
+			// filters of different size are not comparable
+			if (from.size() != to.size()) return;
+
+			dtn::data::Size last = 0;
+
+			for (dtn::data::Size i = 0; i < to.size(); ++i)
+			{
+				if (t1[i] == t2[i]) continue;
+
+				_changes.push_back( std::make_pair(dtn::data::Number(i - last), static_cast<ibrcommon::cell_type>(t1[i] ^ t2[i])) );
+				last = i;
+			}
+		}
+
+		BloomFilterSummaryDelta::~BloomFilterSummaryDelta()
+		{
+		}
+
+		const dtn::data::Number& BloomFilterSummaryDelta::getIdentifier() const
+		{
+			return identifier;
+		}
+
+		const dtn::data::Number& BloomFilterSummaryDelta::getBase() const
+		{
+			return _base;
+		}
+
+		const dtn::data::Number& BloomFilterSummaryDelta::getVersion() const
+		{
+			return _version;
+		}
+
+		dtn::data::Size BloomFilterSummaryDelta::size() const
+		{
+			return _changes.size();
+		}
+
+		bool BloomFilterSummaryDelta::apply(ibrcommon::BloomFilter &filter) const
+		{
+			if (filter.size() != _table_size.get<dtn::data::Size>()) return false;
+
+			std::vector<ibrcommon::cell_type> table(filter.table(), filter.table() + filter.size());
+
+			dtn::data::Size pos = 0;
+			for (change_list::const_iterator it = _changes.begin(); it != _changes.end(); ++it)
+			{
+				pos += (*it).first.get<dtn::data::Size>();
+				if (pos >= table.size()) return false;
+				table[pos] ^= (*it).second;
+			}
+
+			if (!table.empty()) filter.load(&table[0], table.size());
+			return true;
+		}
+
+		dtn::data::Length BloomFilterSummaryDelta::getLength() const
+		{
+			dtn::data::Length ret = _base.getLength() + _version.getLength() + _table_size.getLength();
+
+			// number of changes
+			ret += dtn::data::Number(_changes.size()).getLength();
+
+			for (change_list::const_iterator it = _changes.begin(); it != _changes.end(); ++it)
+			{
+				ret += (*it).first.getLength() + 1;
+			}
+
+			return ret;
+		}
+
+		std::ostream& BloomFilterSummaryDelta::serialize(std::ostream &stream) const
+		{
+			stream << _base << _version << _table_size;
+			stream << dtn::data::Number(_changes.size());
+
+			for (change_list::const_iterator it = _changes.begin(); it != _changes.end(); ++it)
+			{
+				stream << (*it).first;
+				stream.put(static_cast<char>((*it).second));
+			}
+
+			return stream;
+		}
+
+		std::istream& BloomFilterSummaryDelta::deserialize(std::istream &stream)
+		{
+			dtn::data::Number changes;
+
+			_changes.clear();
+
+			stream >> _base >> _version >> _table_size;
+			stream >> changes;
+
+			for (dtn::data::Size i = 0; (i < changes.get<dtn::data::Size>()) && stream.good(); ++i)
+			{
+				dtn::data::Number distance;
+				char value = 0;
+
+				stream >> distance;
+				stream.get(value);
+
+				_changes.push_back( std::make_pair(distance, static_cast<ibrcommon::cell_type>(value)) );
+			}
+
+			return stream;
+		}
+
+		const dtn::data::Number BloomFilterSummaryDelta::identifier = NodeHandshakeItem::BLOOM_FILTER_SUMMARY_DELTA;
+
 		RoutingLimitations::RoutingLimitations()
 		 : NeighborDataSetImpl(RoutingLimitations::identifier)
 		{
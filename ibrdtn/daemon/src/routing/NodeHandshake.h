@@ -25,6 +25,7 @@
 #include "routing/NeighborDataset.h"
 #include <ibrdtn/data/BundleSet.h>
 #include <ibrdtn/data/SDNV.h>
+#include <ibrcommon/data/BloomFilter.h>
 #include <iostream>
 #include <sstream>
 #include <list>
@@ -45,7 +46,8 @@ namespace dtn
 				BLOOM_FILTER_PURGE_VECTOR = 2,
 				DELIVERY_PREDICTABILITY_MAP = 3,
 				PROPHET_ACKNOWLEDGEMENT_SET = 4,
-				ROUTING_LIMITATIONS = 5
+				ROUTING_LIMITATIONS = 5,
+				BLOOM_FILTER_SUMMARY_DELTA = 6
 			};
 
 			virtual ~NodeHandshakeItem() { };
@@ -91,6 +93,51 @@ namespace dtn
 			dtn::data::BundleSet _vector;
 		};
 
+		/**
+		 * Changes of a summary vector since a version known by the receiver.
+		 * In a request the item announces the version held by the requester.
+		 * In a response it either carries the changes between the base version
+		 * and the new version, or it announces the version of the full summary
+		 * vector in the same response if the base is zero.
+		 */
+		class BloomFilterSummaryDelta : public NodeHandshakeItem
+		{
+		public:
+			BloomFilterSummaryDelta();
+			BloomFilterSummaryDelta(const dtn::data::Number &version);
+			BloomFilterSummaryDelta(const dtn::data::Number &base, const dtn::data::Number &version);
+			BloomFilterSummaryDelta(const dtn::data::Number &base, const dtn::data::Number &version, const ibrcommon::BloomFilter &from, const ibrcommon::BloomFilter &to);
+			virtual ~BloomFilterSummaryDelta();
+			const dtn::data::Number& getIdentifier() const;
+			dtn::data::Length getLength() const;
+			std::ostream& serialize(std::ostream&) const;
+			std::istream& deserialize(std::istream&);
+			static const dtn::data::Number identifier;
+
+			const dtn::data::Number& getBase() const;
+			const dtn::data::Number& getVersion() const;
+
+			/**
+			 * Returns the number of changed cells
+			 */
+			dtn::data::Size size() const;
+
+			/**
+			 * Apply the changes to a filter of the base version
+			 * @return False, if the filter does not match the changes
+			 */
+			bool apply(ibrcommon::BloomFilter &filter) const;
+
+		private:
+			dtn::data::Number _base;
+			dtn::data::Number _version;
+			dtn::data::Number _table_size;
+
+			// changed cells as distance to the previous change and xor value
+			typedef std::list<std::pair<dtn::data::Number, ibrcommon::cell_type> > change_list;
+			change_list _changes;
+		};
+
 		class RoutingLimitations : public NeighborDataSetImpl, public NodeHandshakeItem
 		{
 		public:
@@ -154,6 +201,9 @@ namespace dtn
 			template<class T>
 			T& get();
 
+			template<class T>
+			const T& get() const;
+
 		private:
 			class StreamMap
 			{
@@ -173,6 +223,9 @@ namespace dtn
 			NodeHandshakeItem* getItem(const dtn::data::Number &identifier) const;
 			void clear();
 
+			static void serializeItems(std::ostream &stream, const item_set &items);
+			static void deserializeItems(std::istream &stream, StreamMap &items);
+
 			dtn::data::Number _type;
 			dtn::data::Number _lifetime;
 
@@ -210,6 +263,13 @@ namespace dtn
 
 			return dynamic_cast<T&>(*item);
 		}
+
+		template<class T>
+		const T& NodeHandshake::get() const
+		{
+			// items are de-serialized on first access
+			return const_cast<NodeHandshake*>(this)->get<T>();
+		}
 	} /* namespace routing */
 } /* namespace dtn */
 #endif /* NODEHANDSHAKE_H_ */
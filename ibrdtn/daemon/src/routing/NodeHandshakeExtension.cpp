@@ -35,6 +35,8 @@
 #include <ibrcommon/thread/RWLock.h>
 #include <ibrcommon/Logger.h>
 
+#include <memory>
+
 namespace dtn
 {
 	namespace routing
@@ -57,18 +59,22 @@ namespace dtn
 			request.addRequest(RoutingLimitations::identifier);
 		}
 
-		void NodeHandshakeExtension::responseHandshake(const dtn::data::EID&, const NodeHandshake &request, NodeHandshake &answer)
+		void NodeHandshakeExtension::responseHandshake(const dtn::data::EID &source, const NodeHandshake &request, NodeHandshake &answer)
 		{
 			if (request.hasRequest(BloomFilterSummaryVector::identifier))
 			{
 				// add own summary vector to the message
 				const dtn::data::BundleSet vec = (**this).getKnownBundles();
 
-				// create an item
-				BloomFilterSummaryVector *item = new BloomFilterSummaryVector(vec);
+				// send only the changes if the neighbor supports it
+				if (!request.hasRequest(BloomFilterSummaryDelta::identifier) || !responseSummaryDelta(source, request, vec, answer))
+				{
+					// create an item
+					BloomFilterSummaryVector *item = new BloomFilterSummaryVector(vec);
 
-				// add it to the handshake
-				answer.addItem(item);
+					// add it to the handshake
+					answer.addItem(item);
+				}
 			}
 
 			if (request.hasRequest(BloomFilterPurgeVector::identifier))
@@ -99,25 +105,118 @@ namespace dtn
 			}
 		}
 
-		void NodeHandshakeExtension::processHandshake(const dtn::data::EID &source, NodeHandshake &answer)
+		bool NodeHandshakeExtension::responseSummaryDelta(const dtn::data::EID &source, const NodeHandshake &request, const dtn::data::BundleSet &vec, NodeHandshake &answer)
 		{
+			// the version of our summary vector known by the neighbor
+			dtn::data::Number known = 0;
+
 			try {
-				const BloomFilterSummaryVector bfsv = answer.get<BloomFilterSummaryVector>();
+				known = request.get<BloomFilterSummaryDelta>().getVersion();
+			} catch (const std::exception&) { };
 
-				IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "summary vector received from " << source.getString() << IBRCOMMON_LOGGER_ENDL;
+			const ibrcommon::BloomFilter &filter = vec.getBloomFilter();
 
-				// get the summary vector (bloomfilter) of this ECM
-				const ibrcommon::BloomFilter &filter = bfsv.getVector().getBloomFilter();
+			NeighborDatabase &db = (**this).getNeighborDB();
+			ibrcommon::MutexLock l(db);
+			NeighborDatabase::NeighborEntry &entry = db.create(source.getNode());
 
-				/**
-				 * Update the neighbor database with the received filter.
-				 * The filter was sent by the owner, so we assign the contained summary vector to
-				 * the EID of the sender of this bundle.
-				 */
+			// filters of different size are not comparable, send the whole vector then
+			if ((known != 0) && (known == entry.getSentSummaryVersion()) && (entry.getSentSummaryVector().size() == filter.size()))
+			{
+				const ibrcommon::BloomFilter sent = entry.getSentSummaryVector();
+				const dtn::data::Number version = entry.setSentSummaryVector(filter);
+
+				std::auto_ptr<BloomFilterSummaryDelta> delta(new BloomFilterSummaryDelta(known, version, sent, filter));
+
+				// send the changes only if they are smaller than the whole vector
+				if (delta->getLength() < vec.getLength())
+				{
+					IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 15) << "summary vector delta with " << delta->size() << " changes for " << source.getString() << IBRCOMMON_LOGGER_ENDL;
+
+					answer.addItem(delta.release());
+					return true;
+				}
+
+				// announce the version of the whole summary vector
+				answer.addItem(new BloomFilterSummaryDelta(0, version));
+				return false;
+			}
+
+			// announce the version of the whole summary vector
+			answer.addItem(new BloomFilterSummaryDelta(0, entry.setSentSummaryVector(filter)));
+			return false;
+		}
+
+		void NodeHandshakeExtension::requestSummaryDelta(const dtn::data::EID &destination, NodeHandshake &request)
+		{
+			// the version of the summary vector we have
+			dtn::data::Number version = 0;
+
+			try {
 				NeighborDatabase &db = (**this).getNeighborDB();
 				ibrcommon::MutexLock l(db);
-				db.get(source.getNode()).update(filter, answer.getLifetime());
-			} catch (std::exception&) { };
+				version = db.get(destination.getNode()).getSummaryVersion();
+			} catch (const NeighborDatabase::EntryNotFoundException&) { };
+
+			request.addRequest(BloomFilterSummaryDelta::identifier);
+			request.addItem(new BloomFilterSummaryDelta(version));
+		}
+
+		void NodeHandshakeExtension::processHandshake(const dtn::data::EID &source, NodeHandshake &answer)
+		{
+			try {
+				const BloomFilterSummaryDelta &delta = answer.get<BloomFilterSummaryDelta>();
+
+				NeighborDatabase &db = (**this).getNeighborDB();
+				ibrcommon::MutexLock l(db);
+				NeighborDatabase::NeighborEntry &entry = db.get(source.getNode());
+
+				if (delta.getBase() == 0)
+				{
+					// the version belongs to the whole summary vector of this answer
+					const BloomFilterSummaryVector &bfsv = answer.get<BloomFilterSummaryVector>();
+					entry.update(bfsv.getVector().getBloomFilter(), answer.getLifetime(), delta.getVersion());
+				}
+				else if (delta.getBase() == entry.getSummaryVersion())
+				{
+					IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "summary vector delta (" << delta.size() << " changes) received from " << source.getString() << IBRCOMMON_LOGGER_ENDL;
+
+					// apply the changes to the known summary vector
+					ibrcommon::BloomFilter filter = entry.getSummaryVector();
+
+					if (delta.apply(filter))
+					{
+						entry.update(filter, answer.getLifetime(), delta.getVersion());
+					}
+					else
+					{
+						entry.resetSummaryVersion();
+					}
+				}
+				else
+				{
+					// the delta does not match, request the whole vector next time
+					entry.resetSummaryVersion();
+				}
+			} catch (std::exception&) {
+				try {
+					const BloomFilterSummaryVector &bfsv = answer.get<BloomFilterSummaryVector>();
+
+					IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "summary vector received from " << source.getString() << IBRCOMMON_LOGGER_ENDL;
+
+					// get the summary vector (bloomfilter) of this ECM
+					const ibrcommon::BloomFilter &filter = bfsv.getVector().getBloomFilter();
+
+					/**
+					 * Update the neighbor database with the received filter.
+					 * The filter was sent by the owner, so we assign the contained summary vector to
+					 * the EID of the sender of this bundle.
+					 */
+					NeighborDatabase &db = (**this).getNeighborDB();
+					ibrcommon::MutexLock l(db);
+					db.get(source.getNode()).update(filter, answer.getLifetime());
+				} catch (std::exception&) { };
+			};
 
 			try {
 				const BloomFilterPurgeVector bfpv = answer.get<BloomFilterPurgeVector>();
@@ -332,6 +431,12 @@ namespace dtn
 			// walk through all extensions to generate a request
 			(*_callback).requestHandshake(origin, request);
 
+			// ask for the changes of the summary vector only
+			if (request.hasRequest(BloomFilterSummaryVector::identifier))
+			{
+				_callback.requestSummaryDelta(origin, request);
+			}
+
 			IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 15) << "handshake query for " << origin.getString() << ": " << request.toString() << IBRCOMMON_LOGGER_ENDL;
 
 			// create a new bundle with a zero timestamp (+age block)
@@ -69,6 +69,21 @@ namespace dtn
 		protected:
 			void processHandshake(const dtn::data::Bundle &bundle);
 
+			/**
+			 * Add the version of the summary vector known from the destination
+			 * to the request. This allows the destination to answer with the
+			 * changes of its summary vector only.
+			 */
+			void requestSummaryDelta(const dtn::data::EID &destination, NodeHandshake &request);
+
+			/**
+			 * Add the changes of the own summary vector since the version known by
+			 * the neighbor to the answer. If this is not possible, the version of
+			 * the whole vector is announced.
+			 * @return True, if the changes have been added to the answer
+			 */
+			bool responseSummaryDelta(const dtn::data::EID &source, const NodeHandshake &request, const dtn::data::BundleSet &vec, NodeHandshake &answer);
+
 		private:
 			class HandshakeEndpoint : public dtn::core::AbstractWorker
 			{
@@ -49,6 +49,11 @@ namespace dtn
 			return "QueueBundleEvent";
 		}
 
+		size_t QueueBundleEvent::getOrderingKey() const
+		{
+			return dtn::core::Event::getOrderingKey(bundle);
+		}
+
 		string QueueBundleEvent::getMessage() const
 		{
 			return "New bundle queued " + bundle.toString();
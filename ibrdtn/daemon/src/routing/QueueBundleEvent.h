@@ -40,6 +40,8 @@ namespace dtn
 
 			std::string getMessage() const;
 
+			virtual size_t getOrderingKey() const;
+
 			static void raise(const dtn::data::MetaBundle &bundle, const dtn::data::EID &origin);
 
 			const dtn::data::MetaBundle bundle;
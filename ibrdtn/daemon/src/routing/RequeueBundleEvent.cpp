@@ -49,6 +49,11 @@ namespace dtn
 			return "RequeueBundleEvent";
 		}
 
+		size_t RequeueBundleEvent::getOrderingKey() const
+		{
+			return dtn::core::Event::getOrderingKey(_bundle);
+		}
+
 		string RequeueBundleEvent::getMessage() const
 		{
 			return "Bundle requeued " + _bundle.toString();
@@ -40,6 +40,8 @@ namespace dtn
 
 			std::string getMessage() const;
 
+			virtual size_t getOrderingKey() const;
+
 			const dtn::data::EID& getPeer() const;
 
 			const dtn::data::BundleID& getBundle() const;
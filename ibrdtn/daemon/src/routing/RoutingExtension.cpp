@@ -77,8 +77,14 @@ namespace dtn
 				// get the neighbor entry for the next hop
 				NeighborDatabase::NeighborEntry &entry = (**this).getNeighborDB().get(destination, true);
 
-				// acquire the transfer, could throw already in transit or no resource left exception
-				entry.acquireTransfer(meta);
+				try {
+					// acquire the transfer, could throw already in transit or no resource left exception
+					entry.acquireTransfer(meta);
+				} catch (const NeighborDatabase::NoMoreTransfersAvailable&) {
+					// the remaining bundles of the query are not transferred
+					entry.getCursor(this).valid = false;
+					throw;
+				}
 			}
 			try{
 				//create the transfer object
@@ -89,11 +95,74 @@ namespace dtn
 
 				IBRCOMMON_LOGGER_DEBUG_TAG(RoutingExtension::TAG, 20) << "bundle " << meta.toString() << " queued by " << getTag() << " for " << destination.getString() << " via protocol " << dtn::core::Node::toString(p) << IBRCOMMON_LOGGER_ENDL;
 			} catch (const dtn::core::P2PDialupException&) {
+				rewind(destination);
+
 				// the bundle transfer queues the bundle for retransmission, thus abort the query here
 				throw NeighborDatabase::EntryNotFoundException();
 			} catch (const ibrcommon::Exception &e) {
 				// ignore any other error
+				rewind(destination);
+			}
+		}
+
+		void RoutingExtension::rewind(const dtn::data::EID &destination)
+		{
+			NeighborDatabase &db = (**this).getNeighborDB();
+			ibrcommon::MutexLock l(db);
+
+			try {
+				// examine all bundles again with the next query
+				db.get(destination).getCursor(this).valid = false;
+			} catch (const NeighborDatabase::EntryNotFoundException&) { }
+		}
+
+		void RoutingExtension::query(NeighborDatabase::NeighborEntry &entry, const dtn::storage::BundleSelector &filter, RoutingResult &result) throw (dtn::storage::NoBundleFoundException, dtn::storage::BundleSelectorException)
+		{
+			NeighborDatabase &db = (**this).getNeighborDB();
+			NeighborDatabase::BundleFeed &feed = db.getFeed();
+			NeighborDatabase::BundleCursor &cursor = entry.getCursor(this);
+
+			const dtn::data::Size limit = filter.limit();
+			const dtn::data::Size initial = result.size();
+			dtn::data::Size items_added = 0;
+
+			// bundles dropped from the feed have not been examined
+			if (cursor.position < feed.begin()) cursor.valid = false;
+
+			if (cursor.valid)
+			{
+				dtn::data::MetaBundle meta;
+
+				// examine the bundles added since the previous query
+				while (((limit == 0) || (items_added < limit)) && feed.next(cursor.position, meta))
+				{
+					if (filter.addIfSelected(result, meta)) items_added++;
+					cursor.position++;
+				}
+			}
+			else
+			{
+				// bundles added during the query are examined again next time
+				const dtn::data::Size position = feed.end();
+
+				try {
+					(**this).getSeeker().get(filter, result);
+				} catch (const dtn::storage::NoBundleFoundException&) { }
+
+				items_added = result.size() - initial;
+
+				// all bundles are examined unless the query stopped at the limit
+				if ((limit == 0) || (items_added < limit))
+				{
+					cursor.valid = true;
+					cursor.position = position;
+				}
 			}
+
+			// discard bundles examined by all extensions
+			db.trim();
+
+			if (items_added == 0) throw dtn::storage::NoBundleFoundException();
 		}
 
 		void RoutingExtension::eventTransferSlotChanged(const dtn::data::EID &peer) throw ()
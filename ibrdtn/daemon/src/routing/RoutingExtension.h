@@ -23,6 +23,7 @@
 #define ROUTINGEXTENSION_H_
 
 #include "storage/BundleResult.h"
+#include "storage/BundleSelector.h"
 #include "routing/NeighborDatabase.h"
 #include "routing/NodeHandshake.h"
 #include "core/Event.h"
@@ -118,6 +119,24 @@ namespace dtn
 			 */
 			void transferTo(const dtn::data::EID &destination, const dtn::data::MetaBundle &meta, const dtn::core::Node::Protocol);
 
+			/**
+			 * Query bundles to transfer to a neighbor. The first query after the cursor
+			 * of this extension became invalid asks the bundle seeker, all following queries
+			 * only examine bundles added since the previous one.
+			 * The neighbor database has to be locked by the caller.
+			 * @param entry The neighbor entry of the peer
+			 * @param filter The selector of this extension
+			 * @param result The result list
+			 */
+			void query(NeighborDatabase::NeighborEntry &entry, const dtn::storage::BundleSelector &filter, RoutingResult &result) throw (dtn::storage::NoBundleFoundException, dtn::storage::BundleSelectorException);
+
+			/**
+			 * Invalidate the cursor of this extension for a neighbor. Has to be called
+			 * if a bundle returned by query() could not be transferred.
+			 * @param destination The EID of the neighbor
+			 */
+			void rewind(const dtn::data::EID &destination);
+
 			BaseRouter& operator*();
 		};
 	} /* namespace routing */
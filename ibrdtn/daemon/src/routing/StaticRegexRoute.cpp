@@ -15,7 +15,7 @@ namespace dtn
 	namespace routing
 	{
 		StaticRegexRoute::StaticRegexRoute(const std::string &regex, const dtn::data::EID &dest)
-			: _dest(dest), _regex_str(regex), _invalid(false), _expire(0)
+			: _dest(dest), _regex_str(regex), _literal(extractLiteral(regex)), _invalid(false), _expire(0)
 		{
 			if ( regcomp(&_regex, regex.c_str(), 0) )
 			{
@@ -32,7 +32,7 @@ namespace dtn
 		}
 
 		StaticRegexRoute::StaticRegexRoute(const StaticRegexRoute &obj)
-			: _dest(obj._dest), _regex_str(obj._regex_str), _invalid(obj._invalid)
+			: _dest(obj._dest), _regex_str(obj._regex_str), _literal(obj._literal), _invalid(obj._invalid)
 		{
 			if ( regcomp(&_regex, _regex_str.c_str(), 0) )
 			{
@@ -49,6 +49,7 @@ namespace dtn
 
 			_dest = obj._dest;
 			_regex_str = obj._regex_str;
+			_literal = obj._literal;
 			_invalid = obj._invalid;
 
 			if (!_invalid)
@@ -113,6 +114,131 @@ namespace dtn
 			dtn::routing::StaticRouteChangeEvent::raiseEvent(dtn::routing::StaticRouteChangeEvent::ROUTE_EXPIRED, _dest, _regex_str);
 		}
 
+		const std::string StaticRegexRoute::getMatchingLiteral() const
+		{
+			return _literal;
+		}
+
+		std::string StaticRegexRoute::extractLiteral(const std::string &regex)
+		{
+			std::string longest;
+			std::string current;
+
+			// true, if the last character of current is a single atom
+			bool atom = false;
+
+			for (size_t i = 0; i <= regex.length(); ++i)
+			{
+				const char c = (i < regex.length()) ? regex[i] : '\0';
+				bool quantifier = false;
+				bool literal = false;
+				char value = c;
+
+				if (c == '\\')
+				{
+					if (++i >= regex.length()) return "";
+					value = regex[i];
+
+					switch (value)
+					{
+					case '|':
+						// an alternation does not require any literal
+						return "";
+
+					case '(':
+					{
+						// skip the whole group, it may be repeated or optional
+						size_t depth = 1;
+						for (++i; (i < regex.length()) && (depth > 0); ++i)
+						{
+							if (regex[i] != '\\') continue;
+							if (++i >= regex.length()) break;
+							if (regex[i] == '(') ++depth;
+							if (regex[i] == ')') --depth;
+						}
+						--i;
+						break;
+					}
+
+					case '{':
+						// skip the interval, the preceding atom is optional
+						while ((i + 1 < regex.length()) && !((regex[i] == '\\') && (regex[i + 1] == '}'))) ++i;
+						++i;
+						quantifier = true;
+						break;
+
+					case '?':
+						quantifier = true;
+						break;
+
+					case '+':
+						// the atom is required once, but may not be followed
+						// by the next literal
+						atom = false;
+						break;
+
+					case '.': case '[': case ']': case '*': case '^': case '$': case '\\': case '/':
+						literal = true;
+						break;
+
+					default:
+						// back-references and extensions like \w or \<
+						break;
+					}
+				}
+				else if (c == '[')
+				{
+					// skip the bracket expression
+					++i;
+					if ((i < regex.length()) && (regex[i] == '^')) ++i;
+					if ((i < regex.length()) && (regex[i] == ']')) ++i;
+					while ((i < regex.length()) && (regex[i] != ']'))
+					{
+						// skip classes like [:alpha:] within the expression
+						if ((regex[i] == '[') && (i + 1 < regex.length()) && ((regex[i + 1] == ':') || (regex[i + 1] == '.') || (regex[i + 1] == '=')))
+						{
+							const char delim = regex[i + 1];
+							for (i += 2; (i + 1 < regex.length()) && !((regex[i] == delim) && (regex[i + 1] == ']')); ++i);
+							++i;
+						}
+						++i;
+					}
+				}
+				else if (c == '*')
+				{
+					quantifier = true;
+				}
+				else if ((c == '^') && (i == 0))
+				{
+					continue;
+				}
+				else if ((c != '.') && (c != '^') && (c != '$') && (c != '\0'))
+				{
+					literal = true;
+				}
+
+				// a quantifier makes the preceding atom optional
+				if (quantifier && atom)
+				{
+					current.erase(current.length() - 1);
+				}
+
+				if (literal)
+				{
+					current.push_back(value);
+					atom = true;
+				}
+				else
+				{
+					if (current.length() > longest.length()) longest = current;
+					current.clear();
+					atom = false;
+				}
+			}
+
+			return longest;
+		}
+
 		bool StaticRegexRoute::equals(const StaticRoute &route) const
 		{
 			try {
@@ -34,6 +34,11 @@ namespace dtn
 			 */
 			bool equals(const StaticRoute &route) const;
 
+			/**
+			 * Returns the longest literal string required by the expression
+			 */
+			const std::string getMatchingLiteral() const;
+
 			/**
 			 * copy and assignment operators
 			 * @param obj The object to copy
@@ -49,8 +54,15 @@ namespace dtn
 			const std::string toString() const;
 
 		private:
+			/**
+			 * Extract the longest string of the basic regular expression
+			 * which is part of every matching string
+			 */
+			static std::string extractLiteral(const std::string &regex);
+
 			dtn::data::EID _dest;
 			std::string _regex_str;
+			std::string _literal;
 			regex_t _regex;
 			bool _invalid;
 			const dtn::data::Timestamp _expire;
@@ -13,5 +13,15 @@ namespace dtn
 	{
 		// virtual destructor
 		StaticRoute::~StaticRoute() {}
+
+		const dtn::data::EID StaticRoute::getMatchingNode() const
+		{
+			return dtn::data::EID();
+		}
+
+		const std::string StaticRoute::getMatchingLiteral() const
+		{
+			return "";
+		}
 	}
 }
@@ -33,6 +33,19 @@ namespace dtn
 			 * Compare this static route with another one
 			 */
 			virtual bool equals(const StaticRoute &route) const = 0;
+
+			/**
+			 * Returns the node matched by this route. Routes which may
+			 * match more than one node return dtn:none.
+			 */
+			virtual const dtn::data::EID getMatchingNode() const;
+
+			/**
+			 * Returns a string contained in every EID matched by this route.
+			 * It is used to pre-select the routes to check, an empty string
+			 * means the route has to be checked for every EID.
+			 */
+			virtual const std::string getMatchingLiteral() const;
 		};
 	}
 }
@@ -0,0 +1,350 @@
+/*
+ * StaticRouteTable.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "routing/StaticRouteTable.h"
+#include <queue>
+
+namespace dtn
+{
+	namespace routing
+	{
+		StaticRouteTable::StaticRouteTable()
+		 : _next_id(0)
+		{
+		}
+
+		StaticRouteTable::~StaticRouteTable()
+		{
+			clear();
+		}
+
+		void StaticRouteTable::add(StaticRoute *route)
+		{
+			// replace similar routes
+			remove(*route);
+
+			index(_next_id++, route);
+		}
+
+		void StaticRouteTable::remove(const StaticRoute &route)
+		{
+			// equal routes have the same string representation
+			key_index::const_iterator it = _keys.find(route.toString());
+			if (it == _keys.end()) return;
+
+			const id_set ids = it->second;
+			for (id_set::const_iterator id_it = ids.begin(); id_it != ids.end(); ++id_it)
+			{
+				if (_routes[*id_it]->equals(route)) erase(*id_it);
+			}
+		}
+
+		void StaticRouteTable::clear()
+		{
+			for (route_map::const_iterator it = _routes.begin(); it != _routes.end(); ++it)
+			{
+				delete it->second;
+			}
+
+			_routes.clear();
+			_nodes.clear();
+			_nexthops.clear();
+			_keys.clear();
+			_unindexed.clear();
+			_literals.clear();
+		}
+
+		dtn::data::Timestamp StaticRouteTable::expire(const dtn::data::Timestamp &timestamp)
+		{
+			dtn::data::Timestamp next = 0;
+
+			for (route_map::iterator it = _routes.begin(); it != _routes.end();)
+			{
+				const StaticRoute &route = *(it->second);
+				const size_t id = it->first;
+				++it;
+
+				if (route.getExpiration() == 0) continue;
+
+				if (route.getExpiration() < timestamp)
+				{
+					route.raiseExpired();
+					erase(id);
+				}
+				else if ((next == 0) || (next > route.getExpiration()))
+				{
+					next = route.getExpiration();
+				}
+			}
+
+			return next;
+		}
+
+		void StaticRouteTable::match(const dtn::data::EID &destination, route_list &routes) const
+		{
+			// routes without index are candidates for all destinations
+			id_set candidates = _unindexed;
+
+			eid_index::const_iterator it = _nodes.find(destination.getNode());
+			if (it != _nodes.end()) candidates.insert(it->second.begin(), it->second.end());
+
+			_literals.scan(destination.getString(), candidates);
+
+			// verify each candidate, the ids preserve the order of insertion
+			for (id_set::const_iterator id_it = candidates.begin(); id_it != candidates.end(); ++id_it)
+			{
+				const StaticRoute *route = _routes.find(*id_it)->second;
+				if (route->match(destination)) routes.push_back(route);
+			}
+		}
+
+		bool StaticRouteTable::hasNextHop(const dtn::data::EID &nexthop) const
+		{
+			return (_nexthops.find(nexthop) != _nexthops.end());
+		}
+
+		size_t StaticRouteTable::size() const
+		{
+			return _routes.size();
+		}
+
+		void StaticRouteTable::index(size_t id, StaticRoute *route)
+		{
+			_routes[id] = route;
+			_keys[route->toString()].insert(id);
+			_nexthops[route->getDestination()].insert(id);
+
+			const dtn::data::EID node = route->getMatchingNode();
+			const std::string literal = route->getMatchingLiteral();
+
+			if (!node.isNone())
+			{
+				_nodes[node].insert(id);
+			}
+			else if (literal.length() > 0)
+			{
+				_literals.add(literal, id);
+			}
+			else
+			{
+				_unindexed.insert(id);
+			}
+		}
+
+		void StaticRouteTable::erase(size_t id)
+		{
+			route_map::iterator it = _routes.find(id);
+			if (it == _routes.end()) return;
+
+			StaticRoute *route = it->second;
+			_routes.erase(it);
+
+			key_index::iterator key_it = _keys.find(route->toString());
+			key_it->second.erase(id);
+			if (key_it->second.empty()) _keys.erase(key_it);
+
+			eid_index::iterator hop_it = _nexthops.find(route->getDestination());
+			hop_it->second.erase(id);
+			if (hop_it->second.empty()) _nexthops.erase(hop_it);
+
+			const dtn::data::EID node = route->getMatchingNode();
+			const std::string literal = route->getMatchingLiteral();
+
+			if (!node.isNone())
+			{
+				eid_index::iterator node_it = _nodes.find(node);
+				node_it->second.erase(id);
+				if (node_it->second.empty()) _nodes.erase(node_it);
+			}
+			else if (literal.length() > 0)
+			{
+				_literals.remove(literal, id);
+			}
+			else
+			{
+				_unindexed.erase(id);
+			}
+
+			delete route;
+		}
+
+		StaticRouteTable::LiteralAutomaton::State::State()
+		 : fail(0), output(0)
+		{
+		}
+
+		StaticRouteTable::LiteralAutomaton::LiteralAutomaton()
+		 : _states(1), _dirty(false)
+		{
+		}
+
+		StaticRouteTable::LiteralAutomaton::~LiteralAutomaton()
+		{
+		}
+
+		void StaticRouteTable::LiteralAutomaton::add(const std::string &literal, size_t id)
+		{
+			size_t s = 0;
+
+			for (std::string::const_iterator it = literal.begin(); it != literal.end(); ++it)
+			{
+				State::transition_map::const_iterator t = _states[s].next.find(*it);
+
+				if (t == _states[s].next.end())
+				{
+					size_t n = 0;
+
+					// reuse a reclaimed state if possible
+					if (_free.empty())
+					{
+						_states.push_back(State());
+						n = _states.size() - 1;
+					}
+					else
+					{
+						n = _free.back();
+						_free.pop_back();
+					}
+
+					_states[s].next[*it] = n;
+					s = n;
+				}
+				else
+				{
+					s = t->second;
+				}
+			}
+
+			_states[s].ids.insert(id);
+			_dirty = true;
+		}
+
+		void StaticRouteTable::LiteralAutomaton::remove(const std::string &literal, size_t id)
+		{
+			// states along the literal, starting at the root
+			std::vector<size_t> path(1, 0);
+
+			for (std::string::const_iterator it = literal.begin(); it != literal.end(); ++it)
+			{
+				State::transition_map::const_iterator t = _states[path.back()].next.find(*it);
+				if (t == _states[path.back()].next.end()) return;
+				path.push_back(t->second);
+			}
+
+			_states[path.back()].ids.erase(id);
+
+			// reclaim the states left without ids and transitions, bottom-up
+			for (size_t i = literal.length(); i > 0; --i)
+			{
+				State &state = _states[path[i]];
+				if (!state.ids.empty() || !state.next.empty()) break;
+
+				_states[path[i - 1]].next.erase(literal[i - 1]);
+				state = State();
+				_free.push_back(path[i]);
+			}
+
+			// failure and output links may point to reclaimed states
+			_dirty = true;
+		}
+
+		void StaticRouteTable::LiteralAutomaton::clear()
+		{
+			_states.assign(1, State());
+			_free.clear();
+			_dirty = false;
+		}
+
+		void StaticRouteTable::LiteralAutomaton::build()
+		{
+			std::queue<size_t> queue;
+
+			// the states of the first level fall back to the root
+			State &root = _states[0];
+			for (State::transition_map::const_iterator it = root.next.begin(); it != root.next.end(); ++it)
+			{
+				_states[it->second].fail = 0;
+				_states[it->second].output = 0;
+				queue.push(it->second);
+			}
+
+			// breadth-first traversal, the failure state of a state is
+			// always on a lower level and already processed
+			while (!queue.empty())
+			{
+				const size_t r = queue.front();
+				queue.pop();
+
+				for (State::transition_map::const_iterator it = _states[r].next.begin(); it != _states[r].next.end(); ++it)
+				{
+					const char c = it->first;
+					const size_t s = it->second;
+					queue.push(s);
+
+					size_t f = _states[r].fail;
+					while ((f != 0) && (_states[f].next.find(c) == _states[f].next.end()))
+					{
+						f = _states[f].fail;
+					}
+
+					State::transition_map::const_iterator t = _states[f].next.find(c);
+					const size_t target = ((t != _states[f].next.end()) && (t->second != s)) ? t->second : 0;
+
+					_states[s].fail = target;
+					_states[s].output = _states[target].ids.empty() ? _states[target].output : target;
+				}
+			}
+
+			_dirty = false;
+		}
+
+		void StaticRouteTable::LiteralAutomaton::scan(const std::string &text, id_set &ids)
+		{
+			if (_dirty) build();
+
+			size_t s = 0;
+
+			for (std::string::const_iterator it = text.begin(); it != text.end(); ++it)
+			{
+				// follow the failure links until a transition exists
+				while (true)
+				{
+					State::transition_map::const_iterator t = _states[s].next.find(*it);
+
+					if (t != _states[s].next.end())
+					{
+						s = t->second;
+						break;
+					}
+
+					if (s == 0) break;
+					s = _states[s].fail;
+				}
+
+				// collect the ids of all literals ending here
+				for (size_t o = _states[s].ids.empty() ? _states[s].output : s; o != 0; o = _states[o].output)
+				{
+					ids.insert(_states[o].ids.begin(), _states[o].ids.end());
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,170 @@
+/*
+ * StaticRouteTable.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef STATICROUTETABLE_H_
+#define STATICROUTETABLE_H_
+
+#include "routing/StaticRoute.h"
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/Number.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+
+namespace dtn
+{
+	namespace routing
+	{
+		/**
+		 * Holds the static routes and selects the routes matching a
+		 * destination without testing each of them. Routes bound to a
+		 * single node are looked up by the node EID. The literals of
+		 * pattern routes are compiled into one automaton which yields all
+		 * candidate routes in one pass over the destination, only these
+		 * routes are checked by their own match() method.
+		 *
+		 * The table is not thread-safe.
+		 */
+		class StaticRouteTable
+		{
+		public:
+			typedef std::list<const StaticRoute*> route_list;
+
+			StaticRouteTable();
+			virtual ~StaticRouteTable();
+
+			/**
+			 * Add a route to the table. Equal routes are replaced.
+			 * The table takes the ownership of the route.
+			 */
+			void add(StaticRoute *route);
+
+			/**
+			 * Remove and delete all routes equal to the given one
+			 */
+			void remove(const StaticRoute &route);
+
+			/**
+			 * Remove and delete all routes
+			 */
+			void clear();
+
+			/**
+			 * Remove all routes expired before the given timestamp
+			 * and raise the expiration event for each of them
+			 * @return The next expiration time or zero if no route expires
+			 */
+			dtn::data::Timestamp expire(const dtn::data::Timestamp &timestamp);
+
+			/**
+			 * Collect all routes matching the given destination in the order
+			 * they were added to the table
+			 */
+			void match(const dtn::data::EID &destination, route_list &routes) const;
+
+			/**
+			 * Returns true, if at least one route leads to the given next-hop
+			 */
+			bool hasNextHop(const dtn::data::EID &nexthop) const;
+
+			/**
+			 * Returns the number of routes
+			 */
+			size_t size() const;
+
+		private:
+			typedef std::set<size_t> id_set;
+
+			/**
+			 * Aho-Corasick automaton over the literals of the pattern routes.
+			 * Literals are added and removed incrementally, the failure links
+			 * are rebuilt on the first scan after a change. States left
+			 * without literals are reclaimed and reused.
+			 */
+			class LiteralAutomaton
+			{
+			public:
+				LiteralAutomaton();
+				~LiteralAutomaton();
+
+				void add(const std::string &literal, size_t id);
+				void remove(const std::string &literal, size_t id);
+				void clear();
+
+				/**
+				 * Add the ids of all literals contained in the given text
+				 */
+				void scan(const std::string &text, id_set &ids);
+
+			private:
+				class State
+				{
+				public:
+					State();
+
+					typedef std::map<char, size_t> transition_map;
+					transition_map next;
+
+					// longest proper suffix which is a state too
+					size_t fail;
+
+					// next state on the failure path which has ids
+					size_t output;
+
+					id_set ids;
+				};
+
+				void build();
+
+				std::vector<State> _states;
+
+				// states reclaimed by remove() and reused by add()
+				std::vector<size_t> _free;
+
+				bool _dirty;
+			};
+
+			void index(size_t id, StaticRoute *route);
+			void erase(size_t id);
+
+			typedef std::map<size_t, StaticRoute*> route_map;
+			route_map _routes;
+
+			typedef std::map<dtn::data::EID, id_set> eid_index;
+			eid_index _nodes;
+			eid_index _nexthops;
+
+			typedef std::map<std::string, id_set> key_index;
+			key_index _keys;
+
+			// routes without a node or literal to index
+			id_set _unindexed;
+
+			mutable LiteralAutomaton _literals;
+
+			size_t _next_id;
+		};
+	}
+}
+
+#endif /* STATICROUTETABLE_H_ */
@@ -57,14 +57,6 @@ namespace dtn
 		StaticRoutingExtension::~StaticRoutingExtension()
 		{
 			join();
-
-			// delete all static routes
-			for (std::list<StaticRoute*>::iterator iter = _routes.begin();
-					iter != _routes.end(); ++iter)
-			{
-				StaticRoute *route = (*iter);
-				delete route;
-			}
 		}
 
 		void StaticRoutingExtension::__cancellation() throw ()
@@ -77,7 +69,7 @@ namespace dtn
 			class BundleFilter : public dtn::storage::BundleSelector
 			{
 			public:
-				BundleFilter(const NeighborDatabase::NeighborEntry &entry, const std::list<const StaticRoute*> &routes, const dtn::core::FilterContext &context, const dtn::net::ConnectionManager::protocol_list &plist)
+				BundleFilter(const NeighborDatabase::NeighborEntry &entry, const StaticRouteTable &routes, const dtn::core::FilterContext &context, const dtn::net::ConnectionManager::protocol_list &plist)
 				 : _entry(entry), _routes(routes), _plist(plist), _context(context)
 				{};
 
@@ -137,12 +129,16 @@ namespace dtn
 					dtn::core::FilterContext context = _context;
 					context.setMetaBundle(meta);
 
+					// get all routes matching the destination
+					StaticRouteTable::route_list routes;
+					_routes.match(meta.destination, routes);
+
 					// search for one rule that match
-					for (std::list<const StaticRoute*>::const_iterator iter = _routes.begin(); iter != _routes.end(); ++iter)
+					for (StaticRouteTable::route_list::const_iterator iter = routes.begin(); iter != routes.end(); ++iter)
 					{
 						const StaticRoute &route = (**iter);
 
-						if (route.match(meta.destination))
+						if (route.getDestination() == _entry.eid)
 						{
 							// check bundle filter for each possible path
 							for (dtn::net::ConnectionManager::protocol_list::const_iterator it = _plist.begin(); it != _plist.end(); ++it)
@@ -170,7 +166,7 @@ namespace dtn
 
 			private:
 				const NeighborDatabase::NeighborEntry &_entry;
-				const std::list<const StaticRoute*> &_routes;
+				const StaticRouteTable &_routes;
 				const dtn::net::ConnectionManager::protocol_list &_plist;
 				const dtn::core::FilterContext &_context;
 			};
@@ -189,7 +185,6 @@ namespace dtn
 			while (true)
 			{
 				NeighborDatabase &db = (**this).getNeighborDB();
-				std::list<const StaticRoute*> routes;
 
 				try {
 					Task *t = _taskqueue.poll();
@@ -200,25 +195,11 @@ namespace dtn
 					try {
 						SearchNextBundleTask &task = dynamic_cast<SearchNextBundleTask&>(*t);
 
-						// remove all routes of the previous round
-						routes.clear();
-
 						// clear the result list
 						list.clear();
 
 						// look for routes to this node
-						for (std::list<StaticRoute*>::const_iterator iter = _routes.begin();
-								iter != _routes.end(); ++iter)
-						{
-							const StaticRoute *route = (*iter);
-							if (route->getDestination() == task.eid)
-							{
-								// add to the valid routes
-								routes.push_back(route);
-							}
-						}
-
-						if (!routes.empty())
+						if (_routes.hasNextHop(task.eid))
 						{
 							// lock the neighbor database while searching for bundles
 							{
@@ -240,13 +221,13 @@ namespace dtn
 								context.setRouting(*this);
 
 								// get the bundle filter of the neighbor
-								BundleFilter filter(entry, routes, context, plist);
+								BundleFilter filter(entry, _routes, context, plist);
 
 								// some debug
 								IBRCOMMON_LOGGER_DEBUG_TAG(StaticRoutingExtension::TAG, 40) << "search some bundles not known by " << task.eid.getString() << IBRCOMMON_LOGGER_ENDL;
 
-								// query all bundles from the storage
-								(**this).getSeeker().get(filter, list);
+								// query the bundles not examined for this neighbor yet
+								query(entry, filter, list);
 							}
 
 							// send the bundles as long as we have resources
@@ -276,52 +257,52 @@ namespace dtn
 						if ((task.bundle.hopcount <= 1) && (task.bundle.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON))) continue;
 
 						// look for routes to this node
-						for (std::list<StaticRoute*>::const_iterator iter = _routes.begin(); iter != _routes.end(); ++iter)
+						StaticRouteTable::route_list routes;
+						_routes.match(task.bundle.destination, routes);
+
+						for (StaticRouteTable::route_list::const_iterator iter = routes.begin(); iter != routes.end(); ++iter)
 						{
 							const StaticRoute &route = (**iter);
 
-							IBRCOMMON_LOGGER_DEBUG_TAG(StaticRoutingExtension::TAG, 50) << "check static route: " << route.toString() << IBRCOMMON_LOGGER_ENDL;
+							IBRCOMMON_LOGGER_DEBUG_TAG(StaticRoutingExtension::TAG, 50) << "matching static route: " << route.toString() << IBRCOMMON_LOGGER_ENDL;
 
 							try {
-								if (route.match(task.bundle.destination))
+								// lock the neighbor database while checking if the bundle
+								// is already known by the peer
 								{
-									// lock the neighbor database while checking if the bundle
-									// is already known by the peer
-									{
-										// get data about the potential next-hop
-										ibrcommon::MutexLock l(db);
-										NeighborDatabase::NeighborEntry &entry = db.get(route.getDestination(), true);
+									// get data about the potential next-hop
+									ibrcommon::MutexLock l(db);
+									NeighborDatabase::NeighborEntry &entry = db.get(route.getDestination(), true);
 
-										// do not forward bundles already known by the destination
-										if (entry.has(task.bundle)) continue;
-									}
+									// do not forward bundles already known by the destination
+									if (entry.has(task.bundle)) continue;
+								}
 
-									// get a list of protocols supported by both, the local BPA and the remote peer
-									const dtn::net::ConnectionManager::protocol_list plist =
-											dtn::core::BundleCore::getInstance().getConnectionManager().getSupportedProtocols(route.getDestination());
+								// get a list of protocols supported by both, the local BPA and the remote peer
+								const dtn::net::ConnectionManager::protocol_list plist =
+										dtn::core::BundleCore::getInstance().getConnectionManager().getSupportedProtocols(route.getDestination());
 
-									// create a filter context
-									dtn::core::FilterContext context;
-									context.setPeer(route.getDestination());
-									context.setRouting(*this);
+								// create a filter context
+								dtn::core::FilterContext context;
+								context.setPeer(route.getDestination());
+								context.setRouting(*this);
 
-									// check bundle filter for each possible path
-									for (dtn::net::ConnectionManager::protocol_list::const_iterator it = plist.begin(); it != plist.end(); ++it)
-									{
-										const dtn::core::Node::Protocol &p = (*it);
+								// check bundle filter for each possible path
+								for (dtn::net::ConnectionManager::protocol_list::const_iterator it = plist.begin(); it != plist.end(); ++it)
+								{
+									const dtn::core::Node::Protocol &p = (*it);
 
-										// update context with current protocol
-										context.setProtocol(p);
+									// update context with current protocol
+									context.setProtocol(p);
 
-										// execute filtering
-										dtn::core::BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().evaluate(dtn::core::BundleFilter::ROUTING, context);
+									// execute filtering
+									dtn::core::BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().evaluate(dtn::core::BundleFilter::ROUTING, context);
 
-										if (ret == dtn::core::BundleFilter::ACCEPT)
-										{
-											// transfer the bundle to the neighbor
-											transferTo(route.getDestination(), task.bundle, p);
-											break;
-										}
+									if (ret == dtn::core::BundleFilter::ACCEPT)
+									{
+										// transfer the bundle to the neighbor
+										transferTo(route.getDestination(), task.bundle, p);
+										break;
 									}
 								}
 							} catch (const NeighborDatabase::EntryNotFoundException&) {
@@ -337,25 +318,17 @@ namespace dtn
 					try {
 						const RouteChangeTask &task = dynamic_cast<RouteChangeTask&>(*t);
 
-						// delete all similar routes
-						for (std::list<StaticRoute*>::iterator iter = _routes.begin();
-								iter != _routes.end();)
+						if (task.type == RouteChangeTask::ROUTE_ADD)
 						{
-							StaticRoute *route = (*iter);
-							if (route->equals(*task.route))
-							{
-								delete route;
-								_routes.erase(iter++);
-							}
-							else
+							// replaces all similar routes
+							_routes.add(task.route);
+
+							// bundles rejected before may match the new route
 							{
-								++iter;
+								ibrcommon::MutexLock l(db);
+								db.invalidate();
 							}
-						}
 
-						if (task.type == RouteChangeTask::ROUTE_ADD)
-						{
-							_routes.push_back(task.route);
 							_taskqueue.push( new SearchNextBundleTask(task.route->getDestination()) );
 
 							if (task.route->getExpiration() > 0)
@@ -369,6 +342,8 @@ namespace dtn
 						}
 						else
 						{
+							// delete all similar routes
+							_routes.remove(*task.route);
 							delete task.route;
 
 							// force a expiration process
@@ -381,12 +356,6 @@ namespace dtn
 						dynamic_cast<ClearRoutesTask&>(*t);
 
 						// delete all static routes
-						for (std::list<StaticRoute*>::iterator iter = _routes.begin();
-								iter != _routes.end(); ++iter)
-						{
-							StaticRoute *route = (*iter);
-							delete route;
-						}
 						_routes.clear();
 
 						ibrcommon::MutexLock l(_expire_lock);
@@ -396,31 +365,9 @@ namespace dtn
 					try {
 						const ExpireTask &task = dynamic_cast<ExpireTask&>(*t);
 
+						// remove expired routes
 						ibrcommon::MutexLock l(_expire_lock);
-						next_expire = 0;
-
-						// search for expired items
-						for (std::list<StaticRoute*>::iterator iter = _routes.begin();
-								iter != _routes.end();)
-						{
-							StaticRoute *route = (*iter);
-
-							if ((route->getExpiration() > 0) && (route->getExpiration() < task.timestamp))
-							{
-								route->raiseExpired();
-								delete route;
-								_routes.erase(iter++);
-							}
-							else
-							{
-								if ((next_expire == 0) || (next_expire > route->getExpiration()))
-								{
-									next_expire = route->getExpiration();
-								}
-
-								++iter;
-							}
-						}
+						next_expire = _routes.expire(task.timestamp);
 					} catch (const bad_cast&) { };
 
 				} catch (const std::exception &ex) {
@@ -572,6 +519,11 @@ namespace dtn
 			dtn::routing::StaticRouteChangeEvent::raiseEvent(dtn::routing::StaticRouteChangeEvent::ROUTE_EXPIRED, _nexthop, _match);
 		}
 
+		const dtn::data::EID StaticRoutingExtension::EIDRoute::getMatchingNode() const
+		{
+			return _match.getNode();
+		}
+
 		bool StaticRoutingExtension::EIDRoute::equals(const StaticRoute &route) const
 		{
 			try {
@@ -23,6 +23,7 @@
 #define STATICROUTINGEXTENSION_H_
 
 #include "routing/StaticRoute.h"
+#include "routing/StaticRouteTable.h"
 #include "routing/RoutingExtension.h"
 #include "routing/StaticRouteChangeEvent.h"
 #include "core/TimeEvent.h"
@@ -95,6 +96,11 @@ namespace dtn
 				 */
 				bool equals(const StaticRoute &route) const;
 
+				/**
+				 * Returns the node of the matching EID
+				 */
+				const dtn::data::EID getMatchingNode() const;
+
 			private:
 				const dtn::data::EID _nexthop;
 				const dtn::data::EID _match;
@@ -174,9 +180,9 @@ namespace dtn
 			ibrcommon::Queue<StaticRoutingExtension::Task* > _taskqueue;
 
 			/**
-			 * static list of routes
+			 * table of static routes
 			 */
-			std::list<StaticRoute*> _routes;
+			StaticRouteTable _routes;
 			ibrcommon::Mutex _expire_lock;
 			dtn::data::Timestamp next_expire;
 		};
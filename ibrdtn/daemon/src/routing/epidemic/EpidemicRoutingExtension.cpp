@@ -333,7 +333,7 @@ namespace dtn
 								IBRCOMMON_LOGGER_DEBUG_TAG(EpidemicRoutingExtension::TAG, 40) << "search some bundles not known by " << task.eid.getString() << IBRCOMMON_LOGGER_ENDL;
 
 								// query some unknown bundle from the storage
-								(**this).getSeeker().get(filter, list);
+								query(entry, filter, list);
 							} catch (const dtn::storage::BundleSelectorException&) {
 								// query a new summary vector from this neighbor
 								(**this).doHandshake(task.eid);
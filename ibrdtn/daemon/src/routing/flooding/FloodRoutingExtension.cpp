@@ -291,8 +291,8 @@ namespace dtn
 								// some debug
 								IBRCOMMON_LOGGER_DEBUG_TAG(FloodRoutingExtension::TAG, 40) << "search some bundles not known by " << task.eid.getString() << IBRCOMMON_LOGGER_ENDL;
 
-								// query all bundles from the storage
-								(**this).getSeeker().get(filter, list);
+								// query the bundles not examined for this neighbor yet
+								query(entry, filter, list);
 							}
 
 							// send the bundles as long as we have resources
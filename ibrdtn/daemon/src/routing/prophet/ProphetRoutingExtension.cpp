@@ -134,6 +134,13 @@ namespace dtn
 
 				/* update predictability for this neighbor */
 				updateNeighbor(neighbor_node, neighbor_dp_map);
+
+				// the local predictabilities have changed, examine all bundles again
+				{
+					NeighborDatabase &db = (**this).getNeighborDB();
+					ibrcommon::MutexLock l(db);
+					db.invalidate();
+				}
 			} catch (std::exception&) { }
 
 			try {
@@ -551,7 +558,7 @@ namespace dtn
 								IBRCOMMON_LOGGER_DEBUG_TAG(ProphetRoutingExtension::TAG, 40) << "search some bundles not known by " << task.eid.getString() << IBRCOMMON_LOGGER_ENDL;
 
 								// query some unknown bundle from the storage, the list contains max. 10 items.
-								(**this).getSeeker().get(filter, list);
+								query(entry, filter, list);
 							} catch (const NeighborDatabase::DatasetNotAvailableException&) {
 								// if there is no DeliveryPredictabilityMap for the next hop
 								// perform a routing handshake with the peer
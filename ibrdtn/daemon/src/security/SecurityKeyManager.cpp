@@ -23,6 +23,8 @@
 #include "core/BundleCore.h"
 #include "security/SecurityKeyManager.h"
 #include <ibrdtn/data/DTNTime.h>
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/Logger.h>
 #include <sstream>
 #include <iomanip>
@@ -39,6 +41,9 @@ namespace dtn
 	{
 		const std::string SecurityKeyManager::TAG = "SecurityKeyManager";
 
+		const dtn::data::Timestamp SecurityKeyManager::SESSION_KEY_LIFETIME = 3600;
+		const size_t SecurityKeyManager::SESSION_KEY_MAX_USES = 1000;
+
 		SecurityKeyManager& SecurityKeyManager::getInstance()
 		{
 			static SecurityKeyManager instance;
@@ -50,9 +55,71 @@ namespace dtn
 		}
 
 		SecurityKeyManager::~SecurityKeyManager()
+		{
+			ibrcommon::MutexLock l(_session_lock);
+			for (std::map<dtn::data::EID, Session*>::iterator it = _sessions.begin(); it != _sessions.end(); ++it)
+				delete it->second;
+			_sessions.clear();
+		}
+
+		SecurityKeyManager::Session::Session(const dtn::security::SecurityKey &key)
+		 : file(key.file.getPath()), lastmodify(key.file.lastmodify()), created(dtn::utils::Clock::getMonotonicTimestamp()), uses(0), session(key)
 		{
 		}
 
+		SecurityKeyManager::Session::~Session()
+		{
+		}
+
+		const dtn::security::PayloadConfidentialBlock::SessionKey SecurityKeyManager::getSessionKey(const dtn::security::SecurityKey &key)
+		{
+			ibrcommon::MutexLock l(_session_lock);
+
+			std::map<dtn::data::EID, Session*>::iterator it = _sessions.find(key.reference);
+			if (it != _sessions.end())
+			{
+				Session &s = *(it->second);
+
+				// re-use the session key if it is still valid
+				if ((s.file == key.file.getPath())
+					&& (s.lastmodify == key.file.lastmodify())
+					&& (s.uses < SESSION_KEY_MAX_USES)
+					&& (dtn::utils::Clock::getMonotonicTimestamp() < (s.created + SESSION_KEY_LIFETIME)))
+				{
+					++s.uses;
+					return s.session;
+				}
+
+				delete it->second;
+				_sessions.erase(it);
+			}
+
+			// create a new session key
+			Session *s = new Session(key);
+			_sessions[key.reference] = s;
+
+			++s->uses;
+			return s->session;
+		}
+
+		void SecurityKeyManager::flush(const dtn::security::SecurityKey &key)
+		{
+			// drop parsed key contexts
+			dtn::security::SecurityKey::flush(key.file);
+
+			// drop session keys recovered with this key
+			dtn::security::PayloadConfidentialBlock::flush(key.file);
+
+			// drop the session key
+			ibrcommon::MutexLock l(_session_lock);
+			std::map<dtn::data::EID, Session*>::iterator it = _sessions.find(key.reference);
+			if (it != _sessions.end())
+			{
+				delete it->second;
+				_sessions.erase(it);
+			}
+		}
+
 		void SecurityKeyManager::onConfigurationChanged(const dtn::daemon::Configuration &conf) throw ()
 		{
 			const dtn::daemon::Configuration::Security &sec = conf.getSecurity();
@@ -224,6 +291,9 @@ namespace dtn
 			keystream << data;
 			keystream.close();
 
+			// drop cached data of the previous key
+			flush(keydata);
+
 			// store meta-data
 			std::ofstream metastream(keydata.getMetaFilename().getPath().c_str(), std::ios::out | std::ios::trunc);
 			metastream << key;
@@ -240,6 +310,9 @@ namespace dtn
 			keystream << data;
 			keystream.close();
 
+			// drop cached data of the previous key
+			flush(keydata);
+
 			// store meta-data
 			std::ofstream metastream(keydata.getMetaFilename().getPath().c_str(), std::ios::out | std::ios::trunc);
 			metastream << key;
@@ -253,6 +326,9 @@ namespace dtn
 
 			// remove meta file
 			key.getMetaFilename().remove();
+
+			// drop cached data of the key
+			flush(key);
 		}
 
 		const ibrcommon::File SecurityKeyManager::getKeyFile(const dtn::data::EID &peer, const dtn::security::SecurityKey::KeyType type) const
@@ -24,11 +24,14 @@
 
 #include "Configuration.h"
 #include <ibrdtn/security/SecurityKey.h>
+#include <ibrdtn/security/PayloadConfidentialBlock.h>
 #include <ibrdtn/data/EID.h>
 #include <ibrdtn/data/BundleString.h>
 #include <ibrdtn/data/SDNV.h>
 #include <ibrcommon/data/File.h>
+#include <ibrcommon/thread/Mutex.h>
 #include <iostream>
+#include <map>
 
 namespace dtn
 {
@@ -107,6 +110,19 @@ namespace dtn
 			 */
 			void remove(const SecurityKey &key);
 
+			/**
+			 * Returns a session key to encrypt bundles for the owner of the
+			 * given public key. The session key is re-used for a limited
+			 * time and number of bundles to avoid a RSA operation per bundle.
+			 */
+			const dtn::security::PayloadConfidentialBlock::SessionKey getSessionKey(const dtn::security::SecurityKey &key);
+
+			/** the maximum age of a session key in seconds */
+			static const dtn::data::Timestamp SESSION_KEY_LIFETIME;
+
+			/** the maximum number of bundles encrypted with one session key */
+			static const size_t SESSION_KEY_MAX_USES;
+
 		private:
 			SecurityKeyManager();
 
@@ -130,6 +146,27 @@ namespace dtn
 			 */
 			void load(dtn::security::SecurityKey &key) const;
 
+			/**
+			 * Drop cached contexts and session keys of a key
+			 */
+			void flush(const dtn::security::SecurityKey &key);
+
+			class Session
+			{
+			public:
+				Session(const dtn::security::SecurityKey &key);
+				~Session();
+
+				const std::string file;
+				const time_t lastmodify;
+				const dtn::data::Timestamp created;
+				size_t uses;
+				const dtn::security::PayloadConfidentialBlock::SessionKey session;
+			};
+
+			ibrcommon::Mutex _session_lock;
+			std::map<dtn::data::EID, Session*> _sessions;
+
 			ibrcommon::File _path;
 			ibrcommon::File _ca;
 			ibrcommon::File _key;
@@ -194,8 +194,11 @@ namespace dtn
 				// get the encryption key
 				dtn::security::SecurityKey key = SecurityKeyManager::getInstance().get(bundle.destination, dtn::security::SecurityKey::KEY_PUBLIC);
 
+				// get a session key for the destination
+				const dtn::security::PayloadConfidentialBlock::SessionKey session = SecurityKeyManager::getInstance().getSessionKey(key);
+
 				// encrypt the payload of the bundle
-				dtn::security::PayloadConfidentialBlock::encrypt(bundle, key, dtn::core::BundleCore::local);
+				dtn::security::PayloadConfidentialBlock::encrypt(bundle, key, session, dtn::core::BundleCore::local);
 			} catch (const ibrcommon::Exception &ex) {
 				throw EncryptException(ex.what());
 			}
@@ -133,6 +133,10 @@ namespace dtn
 			return _currentsize;
 		}
 
+		void BundleStorage::getStats(stats_data&) const
+		{
+		}
+
 		void BundleStorage::allocSpace(const dtn::data::Length &size) throw (StorageSizeExeededException)
 		{
 			ibrcommon::MutexLock l(_sizelock);
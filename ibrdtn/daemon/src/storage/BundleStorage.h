@@ -36,6 +36,8 @@
 #include <stdexcept>
 #include <iterator>
 #include <set>
+#include <map>
+#include <string>
 
 namespace dtn
 {
@@ -133,6 +135,13 @@ namespace dtn
 			 */
 			dtn::data::Length size() const;
 
+			typedef std::map<std::string, std::string> stats_data;
+
+			/**
+			 * Add storage specific statistics to the given map
+			 */
+			virtual void getStats(stats_data &data) const;
+
 			/**
 			 * This method is called if another node accepts custody for a
 			 * bundle of us.
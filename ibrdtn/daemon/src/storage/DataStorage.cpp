@@ -71,20 +71,24 @@ namespace dtn
 		 : ibrcommon::File(file), _stream(NULL), _lock(mutex)
 		{
 			_lock.enter();
-			_stream = new std::ifstream(getPath().c_str(), ios_base::in | ios_base::binary);
 		}
 
 		DataStorage::istream::~istream()
 		{
-			if (_stream != NULL)
-			{
-				delete _stream;
-				_lock.leave();
-			}
+			delete _stream;
+			_lock.leave();
 		}
 
 		std::istream& DataStorage::istream::operator*()
-		{ return *_stream; }
+		{
+			// open the file on first access
+			if (_stream == NULL)
+			{
+				_stream = new std::ifstream(getPath().c_str(), ios_base::in | ios_base::binary);
+			}
+
+			return *_stream;
+		}
 
 		DataStorage::DataStorage(Callback &callback, const ibrcommon::File &path, unsigned int write_buffer, bool initialize)
 		 : _callback(callback), _path(path), _tasks(), _store_sem(write_buffer), _store_limited(write_buffer > 0), _faulty(false)
@@ -139,21 +143,55 @@ namespace dtn
 			_faulty = mode;
 		}
 
-		void DataStorage::iterateAll()
+		void DataStorage::iterateAll(unsigned int workers)
 		{
 			std::list<ibrcommon::File> files;
 			_path.getFiles(files);
 
-			for (std::list<ibrcommon::File>::const_iterator iter = files.begin(); iter != files.end(); ++iter)
+			// skip system, hidden files and directories
+			for (std::list<ibrcommon::File>::iterator iter = files.begin(); iter != files.end();)
 			{
-				if (!(*iter).isSystem() && !(*iter).isDirectory())
+				if ((*iter).isSystem() || (*iter).isDirectory() || ((*iter).getBasename()[0] == '.'))
+				{
+					files.erase(iter++);
+				}
+				else
 				{
-					DataStorage::Hash hash(*iter);
-					DataStorage::istream stream(_global_mutex, *iter);
+					++iter;
+				}
+			}
+
+			if (workers > files.size()) workers = static_cast<unsigned int>(files.size());
+
+			ibrcommon::Mutex files_lock;
+			std::list<IterateWorker*> threads;
 
-					_callback.iterateDataStorage(hash, stream);
+			for (unsigned int i = 0; (workers > 1) && (i < workers); ++i)
+			{
+				IterateWorker *w = new IterateWorker(_callback, files, files_lock);
+
+				try {
+					w->start();
+					threads.push_back(w);
+				} catch (const ibrcommon::ThreadException&) {
+					delete w;
 				}
 			}
+
+			for (std::list<IterateWorker*>::iterator iter = threads.begin(); iter != threads.end(); ++iter)
+			{
+				(*iter)->join();
+				delete (*iter);
+			}
+
+			// process all remaining files sequentially
+			for (std::list<ibrcommon::File>::const_iterator iter = files.begin(); iter != files.end(); ++iter)
+			{
+				DataStorage::Hash hash(*iter);
+				DataStorage::istream stream(_global_mutex, *iter);
+
+				_callback.iterateDataStorage(hash, stream);
+			}
 		}
 
 		void DataStorage::store(const DataStorage::Hash &hash, DataStorage::Container *data)
@@ -290,5 +328,39 @@ namespace dtn
 		DataStorage::RemoveDataTask::~RemoveDataTask()
 		{
 		}
+
+		DataStorage::IterateWorker::IterateWorker(Callback &callback, std::list<ibrcommon::File> &files, ibrcommon::Mutex &lock)
+		 : _callback(callback), _files(files), _files_lock(lock)
+		{
+		}
+
+		DataStorage::IterateWorker::~IterateWorker()
+		{
+			join();
+		}
+
+		void DataStorage::IterateWorker::run() throw ()
+		{
+			while (true)
+			{
+				ibrcommon::File file;
+
+				{
+					ibrcommon::MutexLock l(_files_lock);
+					if (_files.empty()) return;
+					file = _files.front();
+					_files.pop_front();
+				}
+
+				DataStorage::Hash hash(file);
+				DataStorage::istream stream(_stream_lock, file);
+
+				_callback.iterateDataStorage(hash, stream);
+			}
+		}
+
+		void DataStorage::IterateWorker::__cancellation() throw ()
+		{
+		}
 	}
 }
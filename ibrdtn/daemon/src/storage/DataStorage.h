@@ -30,6 +30,7 @@
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/thread/Semaphore.h>
 #include <memory>
+#include <list>
 
 #ifndef DATASTORAGE_H_
 #define DATASTORAGE_H_
@@ -110,8 +111,11 @@ namespace dtn
 
 			/**
 			 * iterate through all the data and call the iterateDataStorage() on each dataset
+			 * @param workers Number of threads calling iterateDataStorage() in parallel. Since
+			 *   parallel workers do not lock the data against the storage thread this must
+			 *   only be greater than one before the storage thread is started.
 			 */
-			void iterateAll();
+			void iterateAll(unsigned int workers = 1);
 
 			/**
 			 * reset the data storage
@@ -158,6 +162,25 @@ namespace dtn
 				const Hash hash;
 			};
 
+			class IterateWorker : public ibrcommon::JoinableThread
+			{
+			public:
+				IterateWorker(Callback &callback, std::list<ibrcommon::File> &files, ibrcommon::Mutex &lock);
+				virtual ~IterateWorker();
+
+			protected:
+				void run() throw ();
+				void __cancellation() throw ();
+
+			private:
+				Callback &_callback;
+				std::list<ibrcommon::File> &_files;
+				ibrcommon::Mutex &_files_lock;
+
+				// workers do not share the global lock for reading
+				ibrcommon::Mutex _stream_lock;
+			};
+
 			Callback &_callback;
 			ibrcommon::File _path;
 			ibrcommon::Queue< Task* > _tasks;
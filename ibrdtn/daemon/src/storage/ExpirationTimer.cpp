@@ -0,0 +1,93 @@
+/*
+ * ExpirationTimer.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "storage/ExpirationTimer.h"
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
+
+namespace dtn
+{
+	namespace storage
+	{
+		ExpirationTimer::ExpirationTimer(Callback &callback)
+		 : _callback(callback), _next(0), _timer(*this, 1)
+		{
+		}
+
+		ExpirationTimer::~ExpirationTimer()
+		{
+			_timer.stop();
+		}
+
+		void ExpirationTimer::start()
+		{
+			// the first timeout looks up the next expiration
+			ibrcommon::MutexLock l(_lock);
+			_next = 0;
+			_timer.set(1);
+			_timer.start();
+		}
+
+		void ExpirationTimer::stop()
+		{
+			_timer.stop();
+		}
+
+		void ExpirationTimer::update(const dtn::data::Timestamp &expiretime)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			if ((_next != 0) && (_next <= expiretime)) return;
+			_next = expiretime;
+
+			const dtn::data::Timestamp now = dtn::utils::Clock::getTime();
+			_timer.set((now == 0) ? 1 : getDelay(expiretime, now));
+		}
+
+		size_t ExpirationTimer::timeout(ibrcommon::Timer*)
+		{
+			const dtn::data::Timestamp now = dtn::utils::Clock::getTime();
+
+			// we can not expire bundles if we have no idea of time
+			if (now == 0) return 1;
+
+			dtn::data::Timestamp next = _callback.expire(now);
+
+			ibrcommon::MutexLock l(_lock);
+
+			// keep an earlier expiration announced during the expiration
+			if ((_next > now) && ((next == 0) || (_next < next))) next = _next;
+
+			_next = next;
+
+			// pause until the next update if there is nothing to expire
+			if (_next == 0) throw ibrcommon::Timer::StopTimerException();
+
+			return getDelay(_next, now);
+		}
+
+		size_t ExpirationTimer::getDelay(const dtn::data::Timestamp &expiretime, const dtn::data::Timestamp &now)
+		{
+			if (expiretime < now) return 1;
+			return (expiretime - now).get<size_t>() + 1;
+		}
+	} /* namespace storage */
+} /* namespace dtn */
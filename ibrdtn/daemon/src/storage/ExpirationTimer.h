@@ -0,0 +1,82 @@
+/*
+ * ExpirationTimer.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef EXPIRATIONTIMER_H_
+#define EXPIRATIONTIMER_H_
+
+#include <ibrdtn/data/Number.h>
+#include <ibrcommon/thread/Timer.h>
+#include <ibrcommon/thread/Mutex.h>
+
+namespace dtn
+{
+	namespace storage
+	{
+		/**
+		 * Triggers the expiration of bundles exactly at the expiration time
+		 * of the next expiring bundle instead of checking it every second.
+		 */
+		class ExpirationTimer : public ibrcommon::TimerCallback
+		{
+		public:
+			class Callback
+			{
+			public:
+				virtual ~Callback() { };
+
+				/**
+				 * Expire all bundles which are expired at the given time
+				 * @return The expiration time of the next expiring bundle, zero if unknown
+				 */
+				virtual dtn::data::Timestamp expire(const dtn::data::Timestamp &timestamp) throw () = 0;
+			};
+
+			ExpirationTimer(Callback &callback);
+			virtual ~ExpirationTimer();
+
+			void start();
+			void stop();
+
+			/**
+			 * Announce the expiration time of a bundle. The timer is re-armed
+			 * if the bundle expires before the next planned expiration.
+			 */
+			void update(const dtn::data::Timestamp &expiretime);
+
+			/**
+			 * @see ibrcommon::TimerCallback::timeout()
+			 */
+			virtual size_t timeout(ibrcommon::Timer*);
+
+		private:
+			/**
+			 * Returns the number of seconds until the given expiration time has passed
+			 */
+			static size_t getDelay(const dtn::data::Timestamp &expiretime, const dtn::data::Timestamp &now);
+
+			ibrcommon::Mutex _lock;
+			Callback &_callback;
+			dtn::data::Timestamp _next;
+			ibrcommon::Timer _timer;
+		};
+	} /* namespace storage */
+} /* namespace dtn */
+#endif /* EXPIRATIONTIMER_H_ */
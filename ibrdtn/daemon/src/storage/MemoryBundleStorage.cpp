@@ -36,7 +36,7 @@ namespace dtn
 		const std::string MemoryBundleStorage::TAG = "MemoryBundleStorage";
 
 		MemoryBundleStorage::MemoryBundleStorage(const dtn::data::Length maxsize)
-		 : BundleStorage(maxsize), _list(this)
+		 : BundleStorage(maxsize), _list(this), _expiration(*this)
 		{
 		}
 
@@ -47,23 +47,21 @@ namespace dtn
 		void MemoryBundleStorage::componentUp() throw ()
 		{
 			// routine checked for throw() on 15.02.2013
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
+			_expiration.start();
 		}
 
 		void MemoryBundleStorage::componentDown() throw ()
 		{
 			// routine checked for throw() on 15.02.2013
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
+			_expiration.stop();
 		}
 
-		void MemoryBundleStorage::raiseEvent(const dtn::core::TimeEvent &time) throw ()
+		dtn::data::Timestamp MemoryBundleStorage::expire(const dtn::data::Timestamp &timestamp) throw ()
 		{
-			if (time.getAction() == dtn::core::TIME_SECOND_TICK)
-			{
-				// do expiration of bundles
-				ibrcommon::MutexLock l(_bundleslock);
-				_list.expire(time.getTimestamp());
-			}
+			// do expiration of bundles
+			ibrcommon::MutexLock l(_bundleslock);
+			_list.expire(timestamp);
+			return _list.getNextExpiration();
 		}
 
 		const std::string MemoryBundleStorage::getName() const
@@ -114,25 +112,15 @@ namespace dtn
 			try {
 				ibrcommon::MutexLock l(_bundleslock);
 
-				for (bundle_list::const_iterator iter = _bundles.begin(); iter != _bundles.end(); ++iter)
-				{
-					const dtn::data::Bundle &bundle = (*iter);
-
-					// the bundles are sorted, therefore it is possible to optimize
-					// the search for the bundle by skipping all "lower" bundles
-					if (id > bundle) continue;
+				const bundle_list::const_iterator iter = _bundles.find(id);
 
-					if (id == bundle)
-					{
-						if (_faulty) {
-							throw dtn::SerializationFailedException("bundle get failed due to faulty setting");
-						}
-
-						return bundle;
+				if (iter != _bundles.end())
+				{
+					if (_faulty) {
+						throw dtn::SerializationFailedException("bundle get failed due to faulty setting");
 					}
 
-					// stop here, following bundles are "greater"
-					break;
+					return (*iter).second;
 				}
 			} catch (const dtn::SerializationFailedException &ex) {
 				// bundle loading failed
@@ -155,7 +143,7 @@ namespace dtn
 
 			for (bundle_list::const_iterator iter = _bundles.begin(); iter != _bundles.end(); ++iter)
 			{
-				const dtn::data::Bundle &bundle = (*iter);
+				const dtn::data::Bundle &bundle = (*iter).second;
 				ret.insert(bundle.destination);
 			}
 
@@ -176,7 +164,7 @@ namespace dtn
 			allocSpace(size);
 
 			// insert Container
-			pair<set<dtn::data::Bundle>::iterator,bool> ret = _bundles.insert( bundle );
+			pair<bundle_list::iterator,bool> ret = _bundles.insert( std::make_pair((const dtn::data::BundleID&)bundle, bundle) );
 
 			if (ret.second)
 			{
@@ -184,6 +172,9 @@ namespace dtn
 				_list.add(m);
 				_priority_index.insert(m);
 
+				// expire the bundle exactly at its expiration time
+				_expiration.update(m.expiretime);
+
 				_bundle_lengths[m] = size;
 
 				// raise bundle added event
@@ -201,23 +192,18 @@ namespace dtn
 		bool MemoryBundleStorage::contains(const dtn::data::BundleID &id)
 		{
 			ibrcommon::MutexLock l(_bundleslock);
-			return (_bundle_lengths.find(id) != _bundle_lengths.end());
+			return (_bundles.find(id) != _bundles.end());
 		}
 
 		dtn::data::MetaBundle MemoryBundleStorage::info(const dtn::data::BundleID &id)
 		{
 			ibrcommon::MutexLock l(_bundleslock);
 
-			for (dtn::data::BundleList::const_iterator iter = _list.begin(); iter != _list.end(); ++iter)
-			{
-				const dtn::data::MetaBundle &meta = (*iter);
-				if (id == meta)
-				{
-					return meta;
-				}
-			}
+			const dtn::data::BundleList::const_iterator iter = _list.find(dtn::data::MetaBundle::create(id));
 
-			throw NoBundleFoundException();
+			if (iter == _list.end()) throw NoBundleFoundException();
+
+			return (*iter);
 		}
 
 		void MemoryBundleStorage::remove(const dtn::data::BundleID &id)
@@ -225,13 +211,13 @@ namespace dtn
 			ibrcommon::MutexLock l(_bundleslock);
 
 			// search for the bundle in the bundle list
-			const bundle_list::const_iterator iter = find(_bundles.begin(), _bundles.end(), id);
+			const bundle_list::iterator iter = _bundles.find(id);
 
 			// if no bundle was found throw an exception
 			if (iter == _bundles.end()) throw NoBundleFoundException();
 
 			// remove item in the bundlelist
-			const dtn::data::MetaBundle m = dtn::data::MetaBundle::create(*iter);
+			const dtn::data::MetaBundle m = dtn::data::MetaBundle::create((*iter).second);
 			_list.remove(m);
 
 			// raise bundle removed event
@@ -247,7 +233,7 @@ namespace dtn
 
 			for (bundle_list::const_iterator iter = _bundles.begin(); iter != _bundles.end(); ++iter)
 			{
-				const dtn::data::Bundle &bundle = (*iter);
+				const dtn::data::Bundle &bundle = (*iter).second;
 
 				// raise bundle removed event
 				eventBundleRemoved(bundle);
@@ -265,7 +251,7 @@ namespace dtn
 		void MemoryBundleStorage::eventBundleExpired(const dtn::data::MetaBundle &b) throw ()
 		{
 			// search for the bundle in the bundle list
-			const bundle_list::iterator iter = find(_bundles.begin(), _bundles.end(), b);
+			const bundle_list::iterator iter = _bundles.find(b);
 
 			// if the bundle was found ...
 			if (iter != _bundles.end())
@@ -286,7 +272,7 @@ namespace dtn
 
 		void MemoryBundleStorage::__erase(const bundle_list::iterator &iter)
 		{
-			const dtn::data::MetaBundle m = dtn::data::MetaBundle::create(*iter);
+			const dtn::data::MetaBundle m = dtn::data::MetaBundle::create((*iter).second);
 
 			// erase the bundle out of the priority index
 			_priority_index.erase(m);
@@ -24,8 +24,8 @@
 
 #include "Component.h"
 #include "core/BundleCore.h"
-#include "core/TimeEvent.h"
 #include "storage/BundleStorage.h"
+#include "storage/ExpirationTimer.h"
 #include "core/Node.h"
 #include "core/EventReceiver.h"
 
@@ -36,7 +36,7 @@ namespace dtn
 {
 	namespace storage
 	{
-		class MemoryBundleStorage : public BundleStorage, public dtn::core::EventReceiver<dtn::core::TimeEvent>, public dtn::daemon::IntegratedComponent, public BundleList::Listener
+		class MemoryBundleStorage : public BundleStorage, public dtn::daemon::IntegratedComponent, public BundleList::Listener, public ExpirationTimer::Callback
 		{
 			static const std::string TAG;
 
@@ -107,10 +107,9 @@ namespace dtn
 			void releaseCustody(const dtn::data::EID &custodian, const dtn::data::BundleID &id);
 
 			/**
-			 * This method is used to receive events.
-			 * @param evt
+			 * @see ExpirationTimer::Callback::expire()
 			 */
-			void raiseEvent(const dtn::core::TimeEvent &evt) throw ();
+			dtn::data::Timestamp expire(const dtn::data::Timestamp &timestamp) throw ();
 
 			/**
 			 * @see Component::getName()
@@ -126,7 +125,8 @@ namespace dtn
 		private:
 			ibrcommon::Mutex _bundleslock;
 
-			typedef std::set<dtn::data::Bundle> bundle_list;
+			// bundles are indexed by their ID for sublinear lookups
+			typedef std::map<dtn::data::BundleID, dtn::data::Bundle> bundle_list;
 			bundle_list _bundles;
 			dtn::data::BundleList _list;
 
@@ -151,6 +151,9 @@ namespace dtn
 
 			typedef std::map<dtn::data::BundleID, dtn::data::Length> size_map;
 			size_map _bundle_lengths;
+
+			// triggers the expiration of the next expiring bundle
+			ExpirationTimer _expiration;
 		};
 	}
 }
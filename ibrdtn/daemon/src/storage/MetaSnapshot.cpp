@@ -0,0 +1,264 @@
+/*
+ * MetaSnapshot.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "storage/MetaSnapshot.h"
+#include <ibrdtn/data/BundleString.h>
+#include <ibrcommon/Logger.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <streambuf>
+
+namespace dtn
+{
+	namespace storage
+	{
+		const std::string MetaSnapshot::TAG = "MetaSnapshot";
+
+		/**
+		 * magic and version of the snapshot format
+		 */
+		static const char SNAPSHOT_MAGIC[8] = { 'I', 'B', 'R', 'M', 'E', 'T', 'A', '1' };
+
+		/**
+		 * read-only stream buffer on top of a memory mapped file
+		 */
+		class MappedBuffer : public std::basic_streambuf<char, std::char_traits<char> >
+		{
+		public:
+			MappedBuffer(char *data, size_t length)
+			{
+				setg(data, data, data + length);
+			}
+		};
+
+		MetaSnapshot::Entry::Entry()
+		 : size(0), mtime(0)
+		{
+		}
+
+		MetaSnapshot::MetaSnapshot(const ibrcommon::File &file)
+		 : _file(file)
+		{
+		}
+
+		MetaSnapshot::~MetaSnapshot()
+		{
+		}
+
+		bool MetaSnapshot::load() throw ()
+		{
+			_entries.clear();
+
+			int fd = ::open(_file.getPath().c_str(), O_RDONLY);
+			if (fd < 0) return false;
+
+			struct stat st;
+			if ((::fstat(fd, &st) != 0) || (st.st_size < static_cast<off_t>(sizeof(SNAPSHOT_MAGIC))))
+			{
+				::close(fd);
+				return false;
+			}
+
+			void *data = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+
+			if (data == MAP_FAILED) return false;
+
+			// the snapshot is read sequentially once
+			::madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+			MappedBuffer buf(static_cast<char*>(data), st.st_size);
+			std::istream stream(&buf);
+
+			const bool ret = parse(stream);
+
+			::munmap(data, st.st_size);
+
+			if (!ret)
+			{
+				IBRCOMMON_LOGGER_TAG(MetaSnapshot::TAG, warning) << "snapshot " << _file.getPath() << " is invalid" << IBRCOMMON_LOGGER_ENDL;
+				_entries.clear();
+			}
+
+			return ret;
+		}
+
+		bool MetaSnapshot::parse(std::istream &stream)
+		{
+			char magic[sizeof(SNAPSHOT_MAGIC)];
+			stream.read(magic, sizeof(magic));
+			if (!stream.good() || (::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0)) return false;
+
+			try {
+				dtn::data::Number count;
+				stream >> count;
+
+				for (dtn::data::Size i = 0; (i < count.get<dtn::data::Size>()) && stream.good(); ++i)
+				{
+					dtn::data::BundleString id;
+					dtn::data::Number size, mtime;
+					stream >> id >> size >> mtime;
+
+					dtn::data::BundleString source;
+					dtn::data::Timestamp timestamp;
+					dtn::data::Number sequencenumber, fragmentoffset, payloadlength;
+					stream >> source >> timestamp >> sequencenumber >> fragmentoffset >> payloadlength;
+
+					dtn::data::BundleID bid;
+					bid.source = dtn::data::EID(source);
+					bid.timestamp = timestamp;
+					bid.sequencenumber = sequencenumber;
+					bid.fragmentoffset = fragmentoffset;
+
+					Entry &e = _entries[id];
+					e.size = size.get<dtn::data::Length>();
+					e.mtime = mtime.get<time_t>();
+					e.meta = dtn::data::MetaBundle::create(bid);
+
+					dtn::data::BundleString destination, reportto, custodian;
+					stream >> e.meta.lifetime >> destination >> reportto >> custodian;
+					stream >> e.meta.appdatalength >> e.meta.procflags >> e.meta.expiretime >> e.meta.hopcount;
+
+					e.meta.destination = dtn::data::EID(destination);
+					e.meta.reportto = dtn::data::EID(reportto);
+					e.meta.custodian = dtn::data::EID(custodian);
+					e.meta.setPayloadLength(payloadlength.get<dtn::data::Length>());
+
+					// the priority is signed
+					char sign = 0;
+					dtn::data::Number priority;
+					stream.get(sign);
+					stream >> priority;
+					e.meta.net_priority = (sign == '-') ? -priority.get<int>() : priority.get<int>();
+				}
+
+				// the snapshot is terminated by the magic
+				stream.read(magic, sizeof(magic));
+				if (stream.fail() || (::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0)) return false;
+
+				return (_entries.size() == count.get<dtn::data::Size>());
+			} catch (const std::exception&) {
+				return false;
+			}
+		}
+
+		bool MetaSnapshot::save() throw ()
+		{
+			const std::string tmp = _file.getPath() + ".tmp";
+
+			try {
+				std::ofstream stream(tmp.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+				if (!stream.good()) return false;
+
+				stream.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+				stream << dtn::data::Number(_entries.size());
+
+				for (entry_map::const_iterator it = _entries.begin(); it != _entries.end(); ++it)
+				{
+					const Entry &e = it->second;
+					const dtn::data::MetaBundle &meta = e.meta;
+
+					stream << dtn::data::BundleString(it->first) << dtn::data::Number(e.size) << dtn::data::Number(e.mtime);
+
+					stream << dtn::data::BundleString(meta.source.getString()) << meta.timestamp << meta.sequencenumber
+							<< meta.fragmentoffset << dtn::data::Number(meta.getPayloadLength());
+
+					stream << meta.lifetime << dtn::data::BundleString(meta.destination.getString())
+							<< dtn::data::BundleString(meta.reportto.getString())
+							<< dtn::data::BundleString(meta.custodian.getString());
+
+					stream << meta.appdatalength << meta.procflags << meta.expiretime << meta.hopcount;
+
+					const int priority = meta.net_priority.get<int>();
+					stream.put((priority < 0) ? '-' : '+');
+					stream << dtn::data::Number((priority < 0) ? -priority : priority);
+				}
+
+				stream.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+				stream.close();
+
+				if (stream.fail())
+				{
+					::unlink(tmp.c_str());
+					return false;
+				}
+			} catch (const std::exception&) {
+				::unlink(tmp.c_str());
+				return false;
+			}
+
+			// replace the previous snapshot atomically
+			if (::rename(tmp.c_str(), _file.getPath().c_str()) != 0)
+			{
+				::unlink(tmp.c_str());
+				return false;
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(MetaSnapshot::TAG, 10) << _entries.size() << " entries written to " << _file.getPath() << IBRCOMMON_LOGGER_ENDL;
+
+			return true;
+		}
+
+		void MetaSnapshot::put(const ibrcommon::File &file, const dtn::data::MetaBundle &meta) throw ()
+		{
+			struct stat st;
+			if (::stat(file.getPath().c_str(), &st) != 0) return;
+
+			Entry &e = _entries[file.getBasename()];
+			e.meta = meta;
+			e.size = st.st_size;
+			e.mtime = st.st_mtime;
+		}
+
+		bool MetaSnapshot::restore(const ibrcommon::File &file, dtn::data::MetaBundle &meta, dtn::data::Length &size) const throw ()
+		{
+			entry_map::const_iterator it = _entries.find(file.getBasename());
+			if (it == _entries.end()) return false;
+
+			const Entry &e = it->second;
+
+			// the file must not be modified since the snapshot was taken
+			struct stat st;
+			if (::stat(file.getPath().c_str(), &st) != 0) return false;
+			if ((static_cast<dtn::data::Length>(st.st_size) != e.size) || (st.st_mtime != e.mtime)) return false;
+
+			meta = e.meta;
+			size = e.size;
+			return true;
+		}
+
+		void MetaSnapshot::clear() throw ()
+		{
+			_entries.clear();
+		}
+
+		size_t MetaSnapshot::size() const throw ()
+		{
+			return _entries.size();
+		}
+	} /* namespace storage */
+} /* namespace dtn */
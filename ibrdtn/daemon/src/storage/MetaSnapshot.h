@@ -0,0 +1,103 @@
+/*
+ * MetaSnapshot.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef METASNAPSHOT_H_
+#define METASNAPSHOT_H_
+
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrcommon/data/File.h>
+#include <sys/types.h>
+#include <string>
+#include <map>
+
+namespace dtn
+{
+	namespace storage
+	{
+		/**
+		 * Persistent snapshot of the meta data of all stored bundles.
+		 * The snapshot is written on shutdown and allows to restore the
+		 * meta data on start-up without de-serializing each bundle file.
+		 * Each entry is bound to the size and modification time of its
+		 * bundle file, modified files are not restored from the snapshot.
+		 */
+		class MetaSnapshot
+		{
+			static const std::string TAG;
+
+		public:
+			MetaSnapshot(const ibrcommon::File &file);
+			virtual ~MetaSnapshot();
+
+			/**
+			 * Load the snapshot file
+			 * @return False, if there is no valid snapshot
+			 */
+			bool load() throw ();
+
+			/**
+			 * Write all entries to the snapshot file
+			 */
+			bool save() throw ();
+
+			/**
+			 * Add the meta data of a bundle stored in the given file
+			 */
+			void put(const ibrcommon::File &file, const dtn::data::MetaBundle &meta) throw ();
+
+			/**
+			 * Get the meta data of the bundle stored in the given file
+			 * @return False, if there is no entry or the file has been modified
+			 */
+			bool restore(const ibrcommon::File &file, dtn::data::MetaBundle &meta, dtn::data::Length &size) const throw ();
+
+			/**
+			 * Remove all entries from memory
+			 */
+			void clear() throw ();
+
+			/**
+			 * Returns the number of entries
+			 */
+			size_t size() const throw ();
+
+		private:
+			class Entry
+			{
+			public:
+				Entry();
+
+				dtn::data::MetaBundle meta;
+				dtn::data::Length size;
+				time_t mtime;
+			};
+
+			typedef std::map<std::string, Entry> entry_map;
+
+			bool parse(std::istream &stream);
+
+			const ibrcommon::File _file;
+			entry_map _entries;
+		};
+	} /* namespace storage */
+} /* namespace dtn */
+
+#endif /* METASNAPSHOT_H_ */
@@ -36,7 +36,17 @@ namespace dtn
 
 		bool MetaStorage::contains(const dtn::data::BundleID &id) const throw ()
 		{
-			return (_bundle_lengths.find(id) != _bundle_lengths.end());
+			return (_index.find(id) != _index.end());
+		}
+
+		const dtn::data::MetaBundle& MetaStorage::find(const dtn::data::BundleID &id) const throw (NoBundleFoundException)
+		{
+			const index_map::const_iterator it = _index.find(id);
+
+			if (it == _index.end())
+				throw NoBundleFoundException();
+
+			return *((*it).second.first);
 		}
 
 		void MetaStorage::expire(const dtn::data::Timestamp &timestamp) throw ()
@@ -44,6 +54,11 @@ namespace dtn
 			_list.expire(timestamp);
 		}
 
+		dtn::data::Timestamp MetaStorage::getNextExpiration() const throw ()
+		{
+			return _list.getNextExpiration();
+		}
+
 		const dtn::data::MetaBundle& MetaStorage::find(const ibrcommon::BloomFilter &filter) const throw (NoBundleFoundException)
 		{
 			for (const_iterator iter = begin(); iter != end(); ++iter)
@@ -81,29 +96,26 @@ namespace dtn
 
 		void MetaStorage::store(const dtn::data::MetaBundle &meta, const dtn::data::Length &space) throw ()
 		{
-			// increment the storage size
-			_bundle_lengths[meta] = space;
+			// add bundle to priority list
+			const std::pair<priority_set::iterator, bool> ret = _priority_index.insert(meta);
+
+			// index the bundle and its storage size
+			_index[meta] = index_entry(ret.first, space);
 
 			// add it to the bundle list
 			_list.add(meta);
-
-			// add bundle to priority list
-			_priority_index.insert(meta);
 		}
 
 		dtn::data::Length MetaStorage::remove(const dtn::data::MetaBundle &meta) throw ()
 		{
-			// get length of the stored bundle
-			size_map::iterator it = _bundle_lengths.find(meta);
+			// get the index entry of the stored bundle
+			index_map::iterator it = _index.find(meta);
 
 			// nothing to remove
-			if (it == _bundle_lengths.end()) return 0;
+			if (it == _index.end()) return 0;
 
 			// store number of bytes for return
-			dtn::data::Length ret = (*it).second;
-
-			// remove length entry
-			_bundle_lengths.erase(it);
+			dtn::data::Length ret = (*it).second.second;
 
 			// remove the bundle from removal set
 			_removal_set.erase(meta);
@@ -112,7 +124,10 @@ namespace dtn
 			_list.remove(meta);
 
 			// remove bundle from priority index
-			_priority_index.erase(meta);
+			_priority_index.erase((*it).second.first);
+
+			// remove index entry
+			_index.erase(it);
 
 			// return released number of bytes
 			return ret;
@@ -149,7 +164,7 @@ namespace dtn
 		{
 			_priority_index.clear();
 			_list.clear();
-			_bundle_lengths.clear();
+			_index.clear();
 			_removal_set.clear();
 		}
 	} /* namespace storage */
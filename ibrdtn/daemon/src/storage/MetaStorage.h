@@ -57,8 +57,10 @@ namespace dtn
 			// bundle list
 			dtn::data::BundleList _list;
 
-			typedef std::map<dtn::data::BundleID, dtn::data::Length> size_map;
-			size_map _bundle_lengths;
+			// keyed index of all stored bundles with their storage size
+			typedef std::pair<priority_set::const_iterator, dtn::data::Length> index_entry;
+			typedef std::map<dtn::data::BundleID, index_entry> index_map;
+			index_map _index;
 
 			typedef std::set<dtn::data::BundleID> id_set;
 			id_set _removal_set;
@@ -82,15 +84,13 @@ namespace dtn
 			bool contains(const dtn::data::BundleID &id) const throw ();
 			void expire(const dtn::data::Timestamp &timestamp) throw ();
 
-			template<class T>
-			const dtn::data::MetaBundle& find(const T &id) const throw (NoBundleFoundException)
-			{
-				dtn::data::BundleList::const_iterator it = _list.find(id);
-				if (it == _list.end())
-					throw NoBundleFoundException();
+			/**
+			 * Returns the expiration time of the next expiring bundle
+			 * or zero if the storage is empty
+			 */
+			dtn::data::Timestamp getNextExpiration() const throw ();
 
-				return (*it);
-			}
+			const dtn::data::MetaBundle& find(const dtn::data::BundleID &id) const throw (NoBundleFoundException);
 
 			const dtn::data::MetaBundle& find(const ibrcommon::BloomFilter &filter) const throw (NoBundleFoundException);
 
@@ -0,0 +1,353 @@
+/*
+ * PayloadStore.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "storage/PayloadStore.h"
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Logger.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <list>
+#include <vector>
+
+namespace dtn
+{
+	namespace storage
+	{
+		const std::string PayloadStore::TAG = "PayloadStore";
+
+		PayloadStore::Stats::Stats()
+		 : objects(0), references(0), bytes_stored(0), bytes_referenced(0)
+		{
+		}
+
+		uint64_t PayloadStore::Stats::getSavedBytes() const
+		{
+			return bytes_referenced - bytes_stored;
+		}
+
+		double PayloadStore::Stats::getRatio() const
+		{
+			if (bytes_stored == 0) return 1.0;
+			return static_cast<double>(bytes_referenced) / static_cast<double>(bytes_stored);
+		}
+
+		PayloadStore::Object::Object(const Key &k, const ibrcommon::File &f, ino_t i, size_t r)
+		 : key(k), file(f), inode(i), refs(r)
+		{
+		}
+
+		PayloadStore::PayloadStore(const ibrcommon::File &path)
+		 : _path(path), _serial(0)
+		{
+		}
+
+		PayloadStore::~PayloadStore()
+		{
+		}
+
+		void PayloadStore::open(const std::list<ibrcommon::File> &references)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			_objects.clear();
+			_inodes.clear();
+
+			ibrcommon::File path = _path;
+			ibrcommon::File::createDirectory(path);
+
+			std::list<ibrcommon::File> files;
+			_path.getFiles(files);
+
+			for (std::list<ibrcommon::File>::const_iterator it = files.begin(); it != files.end(); ++it)
+			{
+				ibrcommon::File f = (*it);
+				if (f.isSystem() || f.isDirectory()) continue;
+
+				// object names are <hash>-<length>-<serial>
+				const std::string name = f.getBasename();
+				char *end = NULL;
+				const uint64_t h = strtoull(name.c_str(), &end, 16);
+				if ((end == NULL) || (*end != '-')) continue;
+				const uint64_t length = strtoull(end + 1, &end, 10);
+				if ((end == NULL) || (*end != '-')) continue;
+				const size_t serial = strtoul(end + 1, NULL, 10);
+				if (serial >= _serial) _serial = serial + 1;
+
+				struct stat st;
+				if (::stat(f.getPath().c_str(), &st) != 0) continue;
+
+				index(Key(h, length), f, st.st_ino, 0);
+			}
+
+			// count the references of each object
+			for (std::list<ibrcommon::File>::const_iterator it = references.begin(); it != references.end(); ++it)
+			{
+				struct stat st;
+				if (::stat(it->getPath().c_str(), &st) != 0) continue;
+
+				inode_map::iterator iit = _inodes.find(st.st_ino);
+				if (iit != _inodes.end()) iit->second->second.refs++;
+			}
+
+			// remove objects without references
+			for (object_map::iterator it = _objects.begin(); it != _objects.end();)
+			{
+				if (it->second.refs > 0) { ++it; continue; }
+				drop(it++);
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(TAG, 10) << _objects.size() << " payload objects indexed" << IBRCOMMON_LOGGER_ENDL;
+		}
+
+		void PayloadStore::clear()
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			_objects.clear();
+			_inodes.clear();
+
+			std::list<ibrcommon::File> files;
+			_path.getFiles(files);
+
+			for (std::list<ibrcommon::File>::const_iterator it = files.begin(); it != files.end(); ++it)
+			{
+				const ibrcommon::File &f = (*it);
+				if (f.isSystem() || f.isDirectory()) continue;
+				::unlink(f.getPath().c_str());
+			}
+		}
+
+		bool PayloadStore::put(const ibrcommon::File &file)
+		{
+			Key key;
+			if (!hash(file, key)) return false;
+
+			struct stat fst;
+			if (::stat(file.getPath().c_str(), &fst) != 0) return false;
+
+			ibrcommon::MutexLock l(_lock);
+
+			// the file is already linked to an object
+			inode_map::iterator iit = _inodes.find(fst.st_ino);
+			if (iit != _inodes.end())
+			{
+				iit->second->second.refs++;
+				return true;
+			}
+
+			// look for an identical object
+			std::pair<object_map::iterator, object_map::iterator> range = _objects.equal_range(key);
+			for (object_map::iterator it = range.first; it != range.second; ++it)
+			{
+				Object &obj = it->second;
+
+				// the hash is not collision free, compare the content
+				if (!equals(obj.file, file)) continue;
+
+				// replace the file by a hard-link to the object
+				if (!replace(obj.file, file)) return false;
+
+				obj.refs++;
+				return true;
+			}
+
+			// add the file as new object
+			std::stringstream name;
+			name << std::hex << std::setw(16) << std::setfill('0') << key.first << "-" << std::dec << key.second << "-" << (_serial++);
+			const ibrcommon::File objfile = _path.get(name.str());
+
+			if (fst.st_nlink > 1)
+			{
+				// the file is linked to a BLOB which may still be written,
+				// so the object has to be a private copy
+				if (!copy(file, objfile) || !replace(objfile, file))
+				{
+					::unlink(objfile.getPath().c_str());
+					return false;
+				}
+			}
+			else if (::link(file.getPath().c_str(), objfile.getPath().c_str()) != 0)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(TAG, 25) << "hard-link failed (" << errno << ") " << objfile.getPath() << " -> " << file.getPath() << IBRCOMMON_LOGGER_ENDL;
+				return false;
+			}
+
+			struct stat st;
+			if (::stat(objfile.getPath().c_str(), &st) != 0)
+			{
+				::unlink(objfile.getPath().c_str());
+				return false;
+			}
+
+			index(key, objfile, st.st_ino, 1);
+			return false;
+		}
+
+		void PayloadStore::release(const ibrcommon::File &file)
+		{
+			struct stat st;
+			const bool known = (::stat(file.getPath().c_str(), &st) == 0);
+
+			::unlink(file.getPath().c_str());
+
+			if (!known) return;
+
+			ibrcommon::MutexLock l(_lock);
+
+			inode_map::iterator it = _inodes.find(st.st_ino);
+			if (it == _inodes.end()) return;
+
+			// drop the object with its last reference
+			Object &obj = it->second->second;
+			if (obj.refs > 0) obj.refs--;
+			if (obj.refs == 0) drop(it->second);
+		}
+
+		PayloadStore::Stats PayloadStore::getStats() const
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			Stats ret;
+			for (object_map::const_iterator it = _objects.begin(); it != _objects.end(); ++it)
+			{
+				const Object &obj = it->second;
+				if (obj.refs == 0) continue;
+
+				ret.objects++;
+				ret.references += obj.refs;
+				ret.bytes_stored += obj.key.second;
+				ret.bytes_referenced += obj.key.second * obj.refs;
+			}
+
+			return ret;
+		}
+
+		bool PayloadStore::hash(const ibrcommon::File &file, Key &key)
+		{
+			std::ifstream stream(file.getPath().c_str(), std::ios::in | std::ios::binary);
+			if (!stream.good()) return false;
+
+			// FNV-1a 64 bit
+			uint64_t h = 14695981039346656037ULL;
+			uint64_t length = 0;
+
+			std::vector<char> buf(65536);
+			while (stream.good())
+			{
+				stream.read(&buf[0], buf.size());
+				const std::streamsize len = stream.gcount();
+
+				for (std::streamsize i = 0; i < len; ++i)
+				{
+					h ^= static_cast<unsigned char>(buf[i]);
+					h *= 1099511628211ULL;
+				}
+
+				length += len;
+			}
+
+			key = Key(h, length);
+			return true;
+		}
+
+		bool PayloadStore::equals(const ibrcommon::File &f1, const ibrcommon::File &f2)
+		{
+			std::ifstream s1(f1.getPath().c_str(), std::ios::in | std::ios::binary);
+			std::ifstream s2(f2.getPath().c_str(), std::ios::in | std::ios::binary);
+
+			if (!s1.good() || !s2.good()) return false;
+
+			std::vector<char> buf1(65536);
+			std::vector<char> buf2(65536);
+
+			while (s1.good() && s2.good())
+			{
+				s1.read(&buf1[0], buf1.size());
+				s2.read(&buf2[0], buf2.size());
+
+				const std::streamsize len = s1.gcount();
+				if (len != s2.gcount()) return false;
+				if (::memcmp(&buf1[0], &buf2[0], len) != 0) return false;
+			}
+
+			return (s1.eof() && s2.eof());
+		}
+
+		bool PayloadStore::copy(const ibrcommon::File &source, const ibrcommon::File &destination)
+		{
+			std::ifstream in(source.getPath().c_str(), std::ios::in | std::ios::binary);
+			if (!in.good()) return false;
+
+			std::ofstream out(destination.getPath().c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+			if (!out.good()) return false;
+
+			std::vector<char> buf(65536);
+			while (in.good())
+			{
+				in.read(&buf[0], buf.size());
+				out.write(&buf[0], in.gcount());
+			}
+
+			out.close();
+			return in.eof() && !out.fail();
+		}
+
+		bool PayloadStore::replace(const ibrcommon::File &object, const ibrcommon::File &file)
+		{
+			// names of temporary files may carry a trailing null character
+			const std::string tmp = std::string(file.getPath().c_str()) + ".dedup";
+			if (::link(object.getPath().c_str(), tmp.c_str()) != 0)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(TAG, 25) << "hard-link failed (" << errno << ") " << tmp << " -> " << object.getPath() << IBRCOMMON_LOGGER_ENDL;
+				return false;
+			}
+
+			if (::rename(tmp.c_str(), file.getPath().c_str()) != 0)
+			{
+				::unlink(tmp.c_str());
+				return false;
+			}
+
+			return true;
+		}
+
+		void PayloadStore::index(const Key &key, const ibrcommon::File &file, ino_t inode, size_t refs)
+		{
+			object_map::iterator it = _objects.insert(std::make_pair(key, Object(key, file, inode, refs)));
+			_inodes[inode] = it;
+		}
+
+		void PayloadStore::drop(object_map::iterator it)
+		{
+			::unlink(it->second.file.getPath().c_str());
+
+			_inodes.erase(it->second.inode);
+			_objects.erase(it);
+		}
+	} /* namespace storage */
+} /* namespace dtn */
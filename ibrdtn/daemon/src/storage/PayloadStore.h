@@ -0,0 +1,168 @@
+/*
+ * PayloadStore.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef PAYLOADSTORE_H_
+#define PAYLOADSTORE_H_
+
+#include <ibrcommon/data/File.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <sys/types.h>
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <list>
+
+namespace dtn
+{
+	namespace storage
+	{
+		/**
+		 * Content-addressed store for payload files. Identical payloads
+		 * share one object on disk, each stored copy is a hard-link to
+		 * that object. The references of each object are counted
+		 * explicitly and rebuilt from the referencing files on open().
+		 * Objects never share their inode with anything else than the
+		 * stored payloads, which must not be modified in place.
+		 */
+		class PayloadStore
+		{
+			static const std::string TAG;
+
+		public:
+			class Stats
+			{
+			public:
+				Stats();
+
+				/** number of distinct payload objects */
+				size_t objects;
+
+				/** number of stored payloads referencing an object */
+				size_t references;
+
+				/** bytes used by the objects on disk */
+				uint64_t bytes_stored;
+
+				/** bytes of all referencing payloads */
+				uint64_t bytes_referenced;
+
+				/** bytes saved by sharing objects */
+				uint64_t getSavedBytes() const;
+
+				/** ratio of referenced to stored bytes */
+				double getRatio() const;
+			};
+
+			PayloadStore(const ibrcommon::File &path);
+			virtual ~PayloadStore();
+
+			/**
+			 * Create the object folder and index all existing objects.
+			 * Each of the given files counts as reference of the object
+			 * it is linked to. Objects without any reference are removed.
+			 */
+			void open(const std::list<ibrcommon::File> &references);
+
+			/**
+			 * Remove all objects
+			 */
+			void clear();
+
+			/**
+			 * Add the payload of the given file to the store. If an identical
+			 * object already exists, the file is replaced by a hard-link to
+			 * that object. Otherwise the file becomes a new object. If the
+			 * file is linked elsewhere, the new object is a private copy.
+			 * @return True, if the payload has been deduplicated
+			 */
+			bool put(const ibrcommon::File &file);
+
+			/**
+			 * Remove the given file and drop the corresponding object
+			 * if it is not referenced anymore.
+			 */
+			void release(const ibrcommon::File &file);
+
+			/**
+			 * Returns the current statistics of the store
+			 */
+			Stats getStats() const;
+
+		private:
+			typedef std::pair<uint64_t, uint64_t> Key;
+
+			class Object
+			{
+			public:
+				Object(const Key &key, const ibrcommon::File &file, ino_t inode, size_t refs);
+
+				Key key;
+				ibrcommon::File file;
+				ino_t inode;
+
+				/** number of stored payloads referencing this object */
+				size_t refs;
+			};
+
+			typedef std::multimap<Key, Object> object_map;
+			typedef std::map<ino_t, object_map::iterator> inode_map;
+
+			/**
+			 * Compute the hash key (FNV-1a, length) of a file
+			 */
+			static bool hash(const ibrcommon::File &file, Key &key);
+
+			/**
+			 * Compare the content of two files
+			 */
+			static bool equals(const ibrcommon::File &f1, const ibrcommon::File &f2);
+
+			/**
+			 * Copy the content of a file into a new file
+			 */
+			static bool copy(const ibrcommon::File &source, const ibrcommon::File &destination);
+
+			/**
+			 * Replace a file by a hard-link to the given object file
+			 */
+			static bool replace(const ibrcommon::File &object, const ibrcommon::File &file);
+
+			/**
+			 * Add an object to the index
+			 */
+			void index(const Key &key, const ibrcommon::File &file, ino_t inode, size_t refs);
+
+			/**
+			 * Remove an object from the index and the disk
+			 */
+			void drop(object_map::iterator it);
+
+			const ibrcommon::File _path;
+
+			mutable ibrcommon::Mutex _lock;
+			object_map _objects;
+			inode_map _inodes;
+			size_t _serial;
+		};
+	} /* namespace storage */
+} /* namespace dtn */
+
+#endif /* PAYLOADSTORE_H_ */
@@ -92,6 +92,10 @@ namespace dtn
 
 			virtual bool has(const dtn::data::BundleID &bundle) const throw ();
 
+			/**
+			 * Remove expired entries from the database. This is disk I/O,
+			 * so it must not be called from the timing wheel.
+			 */
 			virtual void expire(const dtn::data::Timestamp timestamp) throw ();
 
 			/**
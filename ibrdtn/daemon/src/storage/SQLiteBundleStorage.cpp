@@ -38,6 +38,8 @@
 #include <ibrcommon/data/BLOB.h>
 #include <ibrcommon/Logger.h>
 #include <memory>
+#include <sstream>
+#include <iomanip>
 #include <unistd.h>
 
 namespace dtn
@@ -56,37 +58,34 @@ namespace dtn
 
 		SQLiteBundleStorage::SQLiteBLOB::~SQLiteBLOB()
 		{
+			_filestream.close();
+
 			// delete the file if the last reference is destroyed
+			ibrcommon::FileCache::getInstance().invalidate(_file);
 			_file.remove();
 		}
 
 		void SQLiteBundleStorage::SQLiteBLOB::clear()
 		{
-			// close the file
-			_filestream.close();
-
-			// open temporary file
-			_filestream.open(_file.getPath().c_str(), ios::in | ios::out | ios::trunc | ios::binary );
-
-			if (!_filestream.is_open())
+			if (_filestream.is_open())
 			{
-				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, error) << "can not open temporary file " << _file.getPath() << IBRCOMMON_LOGGER_ENDL;
+				// discard the content of the temporary file
+				_filestream.truncate();
+			}
+			else if (::truncate(_file.getPath().c_str(), 0) != 0)
+			{
+				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, error) << "can not truncate temporary file " << _file.getPath() << IBRCOMMON_LOGGER_ENDL;
 				throw ibrcommon::CanNotOpenFileException(_file);
 			}
 		}
 
 		void SQLiteBundleStorage::SQLiteBLOB::open()
 		{
-			ibrcommon::BLOB::_filelimit.wait();
-
 			// open temporary file
-			_filestream.open(_file.getPath().c_str(), ios::in | ios::out | ios::binary );
+			_filestream.open(_file, true);
 
 			if (!_filestream.is_open())
 			{
-				// Release semaphore on failed file open
-				ibrcommon::BLOB::_filelimit.post();
-
 				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, error) << "can not open temporary file " << _file.getPath() << IBRCOMMON_LOGGER_ENDL;
 				throw ibrcommon::CanNotOpenFileException(_file);
 			}
@@ -94,17 +93,14 @@ namespace dtn
 
 		void SQLiteBundleStorage::SQLiteBLOB::close()
 		{
-			// flush the filestream
-			_filestream.flush();
-
-			// close the file
+			// write buffered data and return the file descriptor to the cache
 			_filestream.close();
-
-			ibrcommon::BLOB::_filelimit.post();
 		}
 
 		std::streamsize SQLiteBundleStorage::SQLiteBLOB::__get_size()
 		{
+			// include buffered data
+			_filestream.flush();
 			return _file.size();
 		}
 
@@ -113,8 +109,8 @@ namespace dtn
 			return ibrcommon::BLOB::Reference(new SQLiteBLOB(_blobPath));
 		}
 
-		SQLiteBundleStorage::SQLiteBundleStorage(const ibrcommon::File &path, const dtn::data::Length &maxsize, bool usePersistentBundleSets)
-		 : BundleStorage(maxsize), _database(path.get("sqlite.db"), *this)
+		SQLiteBundleStorage::SQLiteBundleStorage(const ibrcommon::File &path, const dtn::data::Length &maxsize, bool usePersistentBundleSets, const SQLiteDatabase::Options &options)
+		 : BundleStorage(maxsize), _database(path.get("sqlite.db"), *this, options), _payloads(path.get("payloads")), _expiration(*this), _commit_timer(*this), _commit_scheduled(false)
 		{
 			//let the factory create SQLiteBundleSets
 			if (usePersistentBundleSets)
@@ -141,6 +137,11 @@ namespace dtn
 
 				// open the database and create all folders and files if needed
 				_database.open();
+
+				// index the shared payloads and count their references
+				std::list<ibrcommon::File> payloads;
+				_database.getBlockFiles(dtn::data::PayloadBlock::BLOCK_TYPE, payloads);
+				_payloads.open(payloads);
 			} catch (const ibrcommon::Exception &ex) {
 				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
 			}
@@ -188,6 +189,18 @@ namespace dtn
 				}
 			} catch (const ibrcommon::QueueUnblockedException &ex) {
 				// we are aborted, abort all blocking tasks
+				try {
+					while (true)
+					{
+						Task *t = _tasks.take();
+
+						try {
+							dynamic_cast<BlockingTask&>(*t).abort();
+						} catch (const std::bad_cast&) {
+							delete t;
+						}
+					}
+				} catch (const ibrcommon::QueueUnblockedException&) { }
 			}
 		}
 
@@ -196,7 +209,6 @@ namespace dtn
 			// routine checked for throw() on 15.02.2013
 
 			//register Events
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::core::GlobalEvent>::add(this);
 
 			try {
@@ -205,6 +217,8 @@ namespace dtn
 			} catch (const SQLiteDatabase::SQLiteQueryException &ex) {
 				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
 			}
+
+			_expiration.start();
 		}
 
 		void SQLiteBundleStorage::componentDown() throw ()
@@ -212,11 +226,20 @@ namespace dtn
 			// routine checked for throw() on 15.02.2013
 
 			//unregister Events
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::core::GlobalEvent>::remove(this);
 
+			_expiration.stop();
+			ibrcommon::TimerWheel::getInstance().cancel(_commit_timer);
+
 			stop();
 			join();
+
+			// commit pending writes
+			{
+				ibrcommon::RWLock l(_global_lock);
+				_commit_scheduled = false;
+				__sync();
+			}
 		}
 
 		void SQLiteBundleStorage::__cancellation() throw ()
@@ -272,29 +295,17 @@ namespace dtn
 						ibrcommon::BLOB::Reference ref(blob);
 
 						try {
-							// remove the temporary file
-							blob->_file.remove();
-
-							// generate a hard-link, pointing to the BLOB file
-							if ( ::link(file.getPath().c_str(), blob->_file.getPath().c_str()) != 0 )
+							// copy the block file into the BLOB, a hard-link would share
+							// the inode with other bundles referencing the same payload
+							// and the BLOB may be modified in place
 							{
-								IBRCOMMON_LOGGER_DEBUG_TAG(SQLiteBundleStorage::TAG, 25) << "hard-link failed (" << errno << ") " << blob->_file.getPath() << " -> " << file.getPath() << IBRCOMMON_LOGGER_ENDL;
-
-								// copy the BLOB into a new file if hard-links are not supported
 								std::ofstream fout(blob->_file.getPath().c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
-
-								// open the filestream
-								ibrcommon::BLOB::iostream stream = ref.iostream();
-
-								const std::streamsize length = stream.size();
-								ibrcommon::BLOB::copy(fout, (*stream), length);
-							}
-							else
-							{
-								// update BLOB size
-								blob->update();
+								ibrcommon::BLOB::copy(fout, is, file.size());
 							}
 
+							// update BLOB size
+							blob->update();
+
 							// add payload block to the bundle
 							bundle.push_back(ref);
 						} catch (const ibrcommon::Exception &ex) {
@@ -353,10 +364,14 @@ namespace dtn
 			// increment the storage size
 			allocSpace(size);
 
-			// start transaction to store the bundle
-			_database.transaction();
+			// true, while the savepoint of this bundle is open
+			bool group = false;
 
 			try {
+				// start transaction to store the bundle
+				_database.transaction();
+				group = true;
+
 				// store the bundle data in the database
 				_database.store(bundle, size);
 
@@ -417,8 +432,17 @@ namespace dtn
 						// add determine the amount of stored bytes
 						storedBytes += tmpfile.size();
 
-						// store the block into the database
-						_database.store(id, index, block, tmpfile);
+						// share the payload with identical ones
+						_payloads.put(tmpfile);
+
+						try {
+							// store the block into the database
+							_database.store(id, index, block, tmpfile);
+						} catch (const ibrcommon::Exception&) {
+							// drop the reference of the payload
+							_payloads.release(tmpfile);
+							throw;
+						}
 					}
 					else
 					{
@@ -441,28 +465,31 @@ namespace dtn
 				}
 
 				_database.commit();
+				group = false;
 
-				try {
-					// the bundle is stored sucessfully, we could accept custody if it is requested
-					const dtn::data::EID custodian = acceptCustody(meta);
-
-					// update the custody address of this bundle
-					_database.update(SQLiteDatabase::UPDATE_CUSTODIAN, bundle, custodian);
-				} catch (const ibrcommon::Exception&) {
-					// this bundle has no request for custody transfers
-				}
-
-				IBRCOMMON_LOGGER_DEBUG_TAG(SQLiteBundleStorage::TAG, 10) << "bundle " << bundle.toString() << " stored" << IBRCOMMON_LOGGER_ENDL;
+				// expire the bundle exactly at its expiration time
+				_expiration.update(meta.expiretime);
 
-				// raise bundle added event
-				eventBundleAdded(meta);
+				// accept custody and announce the bundle once the batch is committed
+				_uncommitted.push_back(std::make_pair(meta, size));
 			} catch (const ibrcommon::Exception &ex) {
 				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
-				_database.rollback();
+
+				if (group)
+				{
+					try {
+						_database.rollback();
+					} catch (const ibrcommon::Exception &rex) {
+						IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << rex.what() << IBRCOMMON_LOGGER_ENDL;
+					}
+				}
 
 				// free the previously allocated space
 				freeSpace(size);
+				return;
 			}
+
+			__schedule_commit();
 		}
 
 		bool SQLiteBundleStorage::contains(const dtn::data::BundleID &id)
@@ -492,7 +519,19 @@ namespace dtn
 			// remove the bundle in locked state
 			try {
 				ibrcommon::RWLock l(_global_lock);
-				freeSpace( _database.remove(id) );
+
+				// group the deletion with other writes
+				_database.transaction();
+
+				try {
+					freeSpace( _database.remove(id) );
+					_database.commit();
+				} catch (const ibrcommon::Exception&) {
+					_database.rollback();
+					throw;
+				}
+
+				__schedule_commit();
 
 				// raise bundle removed event
 				eventBundleRemoved(id);
@@ -505,6 +544,9 @@ namespace dtn
 		{
 			ibrcommon::RWLock l(_global_lock);
 
+			// finish the open batch before the database is cleared
+			__sync();
+
 			try {
 				_database.clear();
 			} catch (const ibrcommon::Exception &ex) {
@@ -515,6 +557,9 @@ namespace dtn
 			_blockPath.remove(true);
 			ibrcommon::File::createDirectory(_blockPath);
 
+			// delete all shared payloads
+			_payloads.clear();
+
 			// set the storage size to zero
 			clearSpace();
 		}
@@ -541,12 +586,10 @@ namespace dtn
 			return 0;
 		}
 
-		void SQLiteBundleStorage::raiseEvent(const dtn::core::TimeEvent &time) throw ()
+		dtn::data::Timestamp SQLiteBundleStorage::expire(const dtn::data::Timestamp &timestamp) throw ()
 		{
-			if (time.getAction() == dtn::core::TIME_SECOND_TICK)
-			{
-				_tasks.push(new TaskExpire(time.getTimestamp()));
-			}
+			_tasks.push(new TaskExpire(timestamp));
+			return 0;
 		}
 
 		void SQLiteBundleStorage::raiseEvent(const dtn::core::GlobalEvent &global) throw ()
@@ -572,12 +615,112 @@ namespace dtn
 		{
 			try {
 				ibrcommon::RWLock l(storage._global_lock);
-				storage._database.expire(_timestamp);
+
+				// group the deletion with other writes
+				storage._database.transaction();
+
+				try {
+					storage._database.expire(_timestamp);
+					storage._database.commit();
+				} catch (const ibrcommon::Exception&) {
+					storage._database.rollback();
+					throw;
+				}
+
+				storage.__schedule_commit();
+
+				// announce the next expiration
+				const dtn::data::Timestamp &next = storage._database.get_expire_time();
+				if (next > 0) storage._expiration.update(next);
 			} catch (const ibrcommon::Exception &ex) {
 				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
 			}
 		}
 
+		void SQLiteBundleStorage::TaskCommit::run(SQLiteBundleStorage &storage)
+		{
+			ibrcommon::RWLock l(storage._global_lock);
+			storage._commit_scheduled = false;
+			storage.__sync();
+		}
+
+		SQLiteBundleStorage::CommitTimer::CommitTimer(SQLiteBundleStorage &storage)
+		 : _storage(storage)
+		{
+		}
+
+		SQLiteBundleStorage::CommitTimer::~CommitTimer()
+		{
+		}
+
+		void SQLiteBundleStorage::CommitTimer::expired() throw ()
+		{
+			// commit within the task thread, since the wheel must not block on the database
+			_storage._tasks.push(new TaskCommit());
+		}
+
+		void SQLiteBundleStorage::__schedule_commit() throw ()
+		{
+			// commit a full batch right away
+			if (_database.full())
+			{
+				__sync();
+				return;
+			}
+
+			if (_commit_scheduled || !_database.pending()) return;
+
+			_commit_scheduled = true;
+			ibrcommon::TimerWheel::getInstance().schedule(_commit_timer, _database.getOptions().batch_delay);
+		}
+
+		void SQLiteBundleStorage::__sync() throw ()
+		{
+			uncommitted_list stored;
+			stored.swap(_uncommitted);
+
+			try {
+				_database.sync();
+			} catch (const ibrcommon::Exception &ex) {
+				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << "commit of the batch failed, " << stored.size() << " stored bundles discarded: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// the bundles of the batch are gone, free their space
+				for (uncommitted_list::const_iterator it = stored.begin(); it != stored.end(); ++it)
+				{
+					freeSpace((*it).second);
+				}
+				return;
+			}
+
+			for (uncommitted_list::const_iterator it = stored.begin(); it != stored.end(); ++it)
+			{
+				const dtn::data::MetaBundle &meta = (*it).first;
+
+				try {
+					// skip bundles removed within the same batch
+					if (!_database.contains(meta)) continue;
+
+					try {
+						// the bundle is stored sucessfully, we could accept custody if it is requested
+						const dtn::data::EID custodian = acceptCustody(meta);
+
+						// update the custody address of this bundle
+						_database.update(SQLiteDatabase::UPDATE_CUSTODIAN, meta, custodian);
+					} catch (const ibrcommon::Exception&) {
+						// this bundle has no request for custody transfers
+					}
+				} catch (const SQLiteDatabase::SQLiteQueryException &ex) {
+					IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
+					continue;
+				}
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(SQLiteBundleStorage::TAG, 10) << "bundle " << meta.toString() << " stored" << IBRCOMMON_LOGGER_ENDL;
+
+				// raise bundle added event
+				eventBundleAdded(meta);
+			}
+		}
+
 		void SQLiteBundleStorage::TaskIdle::run(SQLiteBundleStorage &storage)
 		{
 			// until IDLE is false
@@ -594,6 +737,9 @@ namespace dtn
 				 */
 				try {
 					ibrcommon::RWLock l(storage._global_lock);
+
+					// finish the open batch before the vacuum
+					storage.__sync();
 					storage._database.vacuum();
 				} catch (const ibrcommon::Exception &ex) {
 					IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
@@ -644,9 +790,43 @@ namespace dtn
 			freeSpace(size);
 		}
 
+		void SQLiteBundleStorage::releaseBlock(const ibrcommon::File &file) throw ()
+		{
+			// removes the file and drops unreferenced payloads
+			_payloads.release(file);
+		}
+
+		void SQLiteBundleStorage::getStats(BundleStorage::stats_data &data) const
+		{
+			const PayloadStore::Stats stats = _payloads.getStats();
+
+			std::stringstream ss;
+			ss << stats.objects; data["dedup-objects"] = ss.str(); ss.str("");
+			ss << stats.references; data["dedup-references"] = ss.str(); ss.str("");
+			ss << stats.bytes_stored; data["dedup-bytes-stored"] = ss.str(); ss.str("");
+			ss << stats.getSavedBytes(); data["dedup-bytes-saved"] = ss.str(); ss.str("");
+			ss << std::fixed << std::setprecision(2) << stats.getRatio(); data["dedup-ratio"] = ss.str();
+		}
+
 		void SQLiteBundleStorage::wait()
 		{
-			_tasks.wait(ibrcommon::Queue<Task*>::QUEUE_EMPTY);
+			// an empty queue does not mean the last task is done,
+			// so queue a barrier behind all pending tasks
+			if (isRunning())
+			{
+				TaskBarrier barrier;
+				_tasks.push(&barrier);
+
+				try {
+					barrier.wait();
+				} catch (const ibrcommon::Exception&) {
+					// storage has been stopped
+				}
+			}
+
+			// commit pending writes
+			ibrcommon::RWLock l(_global_lock);
+			__sync();
 		}
 
 		void SQLiteBundleStorage::setFaulty(bool mode)
@@ -30,7 +30,8 @@
 
 #include "Component.h"
 #include "core/EventReceiver.h"
-#include "core/TimeEvent.h"
+#include "storage/ExpirationTimer.h"
+#include "storage/PayloadStore.h"
 #include "core/GlobalEvent.h"
 #include <ibrdtn/data/MetaBundle.h>
 
@@ -39,6 +40,7 @@
 #include <ibrcommon/thread/Conditional.h>
 #include <ibrcommon/data/File.h>
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/TimerWheel.h>
 
 #include <string>
 #include <list>
@@ -48,7 +50,7 @@ namespace dtn
 {
 	namespace storage
 	{
-		class SQLiteBundleStorage: public BundleStorage, public dtn::core::EventReceiver<dtn::core::GlobalEvent>, public dtn::core::EventReceiver<dtn::core::TimeEvent>, public dtn::daemon::IndependentComponent, public ibrcommon::BLOB::Provider, public SQLiteDatabase::DatabaseListener
+		class SQLiteBundleStorage: public BundleStorage, public dtn::core::EventReceiver<dtn::core::GlobalEvent>, public dtn::daemon::IndependentComponent, public ibrcommon::BLOB::Provider, public SQLiteDatabase::DatabaseListener, public ExpirationTimer::Callback
 		{
 			static const std::string TAG;
 
@@ -65,8 +67,9 @@ namespace dtn
 			 * @param Dateiname der Datenbank
 			 * @param maximale Größe der Datenbank
 			 * @param should bundleSets be stored persistently in database? standard: false
+			 * @param durability and write batching of the database
 			 */
-			SQLiteBundleStorage(const ibrcommon::File &path, const dtn::data::Length &maxsize, bool usePersistentBundleSets = false);
+			SQLiteBundleStorage(const ibrcommon::File &path, const dtn::data::Length &maxsize, bool usePersistentBundleSets = false, const SQLiteDatabase::Options &options = SQLiteDatabase::Options());
 
 			/**
 			 * destructor
@@ -139,14 +142,26 @@ namespace dtn
 			 * This method is used to receive events.
 			 * @param evt
 			 */
-			void raiseEvent(const dtn::core::TimeEvent &evt) throw ();
 			void raiseEvent(const dtn::core::GlobalEvent &evt) throw ();
 
+			/**
+			 * Queues the expiration of bundles, the next expiration time
+			 * is announced once the task has been processed
+			 * @see ExpirationTimer::Callback::expire()
+			 */
+			dtn::data::Timestamp expire(const dtn::data::Timestamp &timestamp) throw ();
+
 			/**
 			 * callbacks for the sqlite database
 			 */
 			void eventBundleExpired(const dtn::data::BundleID &id, const dtn::data::Length size) throw ();
 			void iterateDatabase(const dtn::data::MetaBundle &bundle, const dtn::data::Length size);
+			void releaseBlock(const ibrcommon::File &file) throw ();
+
+			/**
+			 * @see BundleStorage::getStats()
+			 */
+			virtual void getStats(BundleStorage::stats_data &data) const;
 
 
 			/*** BEGIN: methods for unit-testing ***/
@@ -249,6 +264,43 @@ namespace dtn
 				const dtn::data::Timestamp _timestamp;
 			};
 
+			class TaskCommit : public Task
+			{
+			public:
+				TaskCommit() { };
+
+				virtual ~TaskCommit() {};
+				virtual void run(SQLiteBundleStorage &storage);
+			};
+
+			/**
+			 * Returns to the waiting thread once all previous tasks are done
+			 */
+			class TaskBarrier : public BlockingTask
+			{
+			public:
+				TaskBarrier() { };
+
+				virtual ~TaskBarrier() {};
+				virtual void run(SQLiteBundleStorage&) { };
+			};
+
+			/**
+			 * Queues the commit of a pending batch once its delay is over
+			 */
+			class CommitTimer : public ibrcommon::TimerWheel::Task
+			{
+			public:
+				CommitTimer(SQLiteBundleStorage &storage);
+				virtual ~CommitTimer();
+
+			protected:
+				void expired() throw ();
+
+			private:
+				SQLiteBundleStorage &_storage;
+			};
+
 			/**
 			 * A SQLiteBLOB is container for large amount of data. Stored in the database
 			 * working directory.
@@ -274,7 +326,7 @@ namespace dtn
 
 			private:
 				SQLiteBLOB(const ibrcommon::File &path);
-				std::fstream _filestream;
+				ibrcommon::CachedFileStream _filestream;
 				ibrcommon::TemporaryFile _file;
 			};
 
@@ -293,15 +345,44 @@ namespace dtn
 			 */
 			virtual const std::string getName() const;
 
+			/**
+			 * Schedule the commit of the open batch if not already done.
+			 * A full batch is committed right away.
+			 * The calling function has to hold the write lock.
+			 */
+			void __schedule_commit() throw ();
+
+			/**
+			 * Commit the open batch. Custody is accepted and the bundles are
+			 * announced only after the commit succeeded. If the commit fails,
+			 * the space of the discarded bundles is released.
+			 * The calling function has to hold the write lock.
+			 */
+			void __sync() throw ();
+
 			SQLiteDatabase _database;
 
 			ibrcommon::File _blobPath;
 			ibrcommon::File _blockPath;
 
+			// shares identical payloads between stored bundles
+			PayloadStore _payloads;
+
 			// contains all jobs to do
 			ibrcommon::Queue<Task*> _tasks;
 
 			ibrcommon::RWMutex _global_lock;
+
+			// triggers the expiration of the next expiring bundle
+			ExpirationTimer _expiration;
+
+			// commits the open batch after the configured delay
+			CommitTimer _commit_timer;
+			bool _commit_scheduled;
+
+			// bundles and their size stored in the open batch
+			typedef std::list<std::pair<dtn::data::MetaBundle, dtn::data::Length> > uncommitted_list;
+			uncommitted_list _uncommitted;
 		};
 	}
 }
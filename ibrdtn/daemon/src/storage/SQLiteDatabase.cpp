@@ -25,7 +25,9 @@
 #include <ibrdtn/data/SchedulingBlock.h>
 #include <ibrdtn/utils/Clock.h>
 #include <ibrcommon/Logger.h>
+#include <ibrcommon/thread/MutexLock.h>
 #include <stdint.h>
+#include <limits>
 
 namespace dtn
 {
@@ -49,13 +51,21 @@ namespace dtn
 				"a.source = b.source AND a.timestamp = b.timestamp AND a.sequencenumber = b.sequencenumber AND a.fragmentoffset = b.fragmentoffset AND a.fragmentlength = b.fragmentlength"
 		};
 
+		const std::string SQLiteDatabase::_page_filter[] = {
+				"priority < :priority",
+				"priority = :priority AND timestamp >= :timestamp AND (timestamp > :timestamp OR sequencenumber > :sequencenumber OR (sequencenumber = :sequencenumber AND (fragmentoffset > :fragmentoffset OR (fragmentoffset = :fragmentoffset AND (fragmentlength > :fragmentlength OR (fragmentlength = :fragmentlength AND `key` > :key))))))",
+				"ORDER BY priority DESC, timestamp, sequencenumber, fragmentoffset, fragmentlength, `key` LIMIT :limit;"
+		};
+
 		const std::string SQLiteDatabase::_tables[] =
 				{ "bundles", "blocks", "routing", "routing_bundles", "routing_nodes", "properties", "bundle_set", "bundle_set_names" };
 
 		// this is the version of a fresh created db scheme
 		const int SQLiteDatabase::DBSCHEMA_FRESH_VERSION = 8;
 
-		const int SQLiteDatabase::DBSCHEMA_VERSION = 8;
+		const int SQLiteDatabase::DBSCHEMA_VERSION = 9;
+
+		const size_t SQLiteDatabase::STATEMENT_CACHE_LIMIT = 32;
 
 		const std::string SQLiteDatabase::QUERY_SCHEMAVERSION = "SELECT `value` FROM " + SQLiteDatabase::_tables[SQLiteDatabase::SQL_TABLE_PROPERTIES] + " WHERE `key` = 'version' LIMIT 0,1;";
 		const std::string SQLiteDatabase::SET_SCHEMAVERSION = "INSERT INTO " + SQLiteDatabase::_tables[SQLiteDatabase::SQL_TABLE_PROPERTIES] + " (`key`, `value`) VALUES ('version', ?);";
@@ -63,7 +73,7 @@ namespace dtn
 		const std::string SQLiteDatabase::_sql_queries[SQL_QUERIES_END] =
 		{
 			"SELECT " + _select_names[0] + " FROM " + _tables[SQL_TABLE_BUNDLE],
-			"SELECT " + _select_names[0] + " FROM " + _tables[SQL_TABLE_BUNDLE] + " ORDER BY priority DESC, timestamp, sequencenumber, fragmentoffset, fragmentlength LIMIT ?,?;",
+			"SELECT " + _select_names[0] + ", priority, fragmentlength, `key` FROM " + _tables[SQL_TABLE_BUNDLE] + " WHERE ",
 			"SELECT " + _select_names[0] + " FROM "+ _tables[SQL_TABLE_BUNDLE] +" WHERE " + _where_filter[0] + " LIMIT 1;",
 			"SELECT bytes FROM "+ _tables[SQL_TABLE_BUNDLE] +" WHERE " + _where_filter[0] + " LIMIT 1;",
 			"SELECT DISTINCT destination FROM " + _tables[SQL_TABLE_BUNDLE],
@@ -87,6 +97,7 @@ namespace dtn
 			//BLOCK_*
 			"SELECT filename, blocktype FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE " + _where_filter[0] + " ORDER BY ordernumber ASC;",
 			"SELECT filename, blocktype FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE " + _where_filter[0] + " AND ordernumber = ?;",
+			"SELECT filename FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE blocktype = ?;",
 			"DELETE FROM "+ _tables[SQL_TABLE_BLOCK] +";",
 			"INSERT INTO "+ _tables[SQL_TABLE_BLOCK] +" (source, timestamp, sequencenumber, fragmentoffset, fragmentlength, blocktype, filename, ordernumber) VALUES (?,?,?,?,?,?,?,?);",
 
@@ -120,12 +131,13 @@ namespace dtn
 			"CREATE INDEX IF NOT EXISTS blocks_bid ON " + _tables[SQL_TABLE_BLOCK] + " (source, timestamp, sequencenumber, fragmentoffset, fragmentlength);",
 			"CREATE INDEX IF NOT EXISTS bundles_destination ON " + _tables[SQL_TABLE_BUNDLE] + " (destination);",
 			"CREATE INDEX IF NOT EXISTS bundles_destination_priority ON " + _tables[SQL_TABLE_BUNDLE] + " (destination, priority);",
-			"CREATE UNIQUE INDEX IF NOT EXISTS bundles_id ON " + _tables[SQL_TABLE_BUNDLE] + " (source, timestamp, sequencenumber, fragmentoffset, fragmentlength);"
+			"CREATE UNIQUE INDEX IF NOT EXISTS bundles_id ON " + _tables[SQL_TABLE_BUNDLE] + " (source, timestamp, sequencenumber, fragmentoffset, fragmentlength);",
 			"CREATE INDEX IF NOT EXISTS bundles_expire ON " + _tables[SQL_TABLE_BUNDLE] + " (source, timestamp, sequencenumber, fragmentoffset, fragmentlength, expiretime);",
 			"CREATE TABLE IF NOT EXISTS '" + _tables[SQL_TABLE_PROPERTIES] + "' ( `key` TEXT PRIMARY KEY ASC ON CONFLICT REPLACE, `value` TEXT NOT NULL);",
 			"CREATE TABLE IF NOT EXISTS " + _tables[SQL_TABLE_BUNDLE_SET] + " (`source` TEXT NOT NULL, `timestamp` INTEGER NOT NULL, `sequencenumber` INTEGER NOT NULL, `fragmentoffset` INTEGER NOT NULL, `fragmentlength` INTEGER NOT NULL, `expiretime` INTEGER, `set_id` INTEGER, PRIMARY KEY(`set_id`, `source`, `timestamp`, `sequencenumber`, `fragmentoffset`, `fragmentlength`));",
 			"CREATE TABLE IF NOT EXISTS " + _tables[SQL_TABLE_BUNDLE_SET_NAME] + " (`id` INTEGER PRIMARY KEY, `name` TEXT NOT NULL, `persistent` INTEGER NOT NULL);",
-			"CREATE UNIQUE INDEX IF NOT EXISTS bundle_set_names_index ON " + _tables[SQL_TABLE_BUNDLE_SET_NAME] + " (`name`, `persistent`);"
+			"CREATE UNIQUE INDEX IF NOT EXISTS bundle_set_names_index ON " + _tables[SQL_TABLE_BUNDLE_SET_NAME] + " (`name`, `persistent`);",
+			"CREATE INDEX IF NOT EXISTS bundles_order ON " + _tables[SQL_TABLE_BUNDLE] + " (priority DESC, timestamp, sequencenumber, fragmentoffset, fragmentlength);"
 		};
 
 		SQLiteDatabase::SQLBundleQuery::SQLBundleQuery()
@@ -141,6 +153,11 @@ namespace dtn
 			prepare();
 		}
 
+		const std::string& SQLiteDatabase::Statement::getQuery() const throw ()
+		{
+			return _query;
+		}
+
 		SQLiteDatabase::Statement::~Statement()
 		{
 			if (_st != NULL) {
@@ -199,10 +216,45 @@ namespace dtn
 				throw SQLiteQueryException("failed to prepare statement: " + _query);
 		}
 
+		SQLiteDatabase::CachedStatement::CachedStatement(const SQLiteDatabase &database, const std::string &query)
+		 : _database(database), _st(database.acquire(query))
+		{
+		}
+
+		SQLiteDatabase::CachedStatement::~CachedStatement()
+		{
+			_database.release(_st);
+		}
+
+		SQLiteDatabase::Statement& SQLiteDatabase::CachedStatement::operator*()
+		{
+			return *_st;
+		}
+
+		SQLiteDatabase::PageCursor::PageCursor()
+		 : valid(false), priority(0), timestamp(0), sequencenumber(0), fragmentoffset(0), fragmentlength(0), key(0)
+		{
+		}
+
 		SQLiteDatabase::DatabaseListener::~DatabaseListener() {}
 
-		SQLiteDatabase::SQLiteDatabase(const ibrcommon::File &file, DatabaseListener &listener)
-		 : _file(file), _database(NULL), _next_expiration(0), _listener(listener), _faulty(false)
+		void SQLiteDatabase::DatabaseListener::releaseBlock(const ibrcommon::File &file) throw ()
+		{
+			ibrcommon::File f = file;
+			f.remove();
+		}
+
+		SQLiteDatabase::Options::Options()
+		 : journal_mode("WAL"), synchronous("NORMAL"), batch_size(100), batch_delay(100)
+		{
+		}
+
+		SQLiteDatabase::Options::~Options()
+		{
+		}
+
+		SQLiteDatabase::SQLiteDatabase(const ibrcommon::File &file, DatabaseListener &listener, const Options &options)
+		 : _file(file), _options(options), _batch_writes(0), _database(NULL), _next_expiration(0), _listener(listener), _faulty(false)
 		{
 		}
 
@@ -279,20 +331,36 @@ namespace dtn
 					}
 
 					// create all tables
-					for (size_t i = 0; i < (DB_STRUCTURE_END - 1); ++i)
+					for (size_t i = 0; i < DB_STRUCTURE_END; ++i)
 					{
 						Statement st(_database, _db_structure[i]);
 						int err = st.step();
 						if(err != SQLITE_DONE)
 						{
-							IBRCOMMON_LOGGER_TAG(SQLiteDatabase::TAG, error) << "failed to create table " << _tables[i] << "; err: " << err << IBRCOMMON_LOGGER_ENDL;
+							IBRCOMMON_LOGGER_TAG(SQLiteDatabase::TAG, error) << "failed to create structure: " << _db_structure[i] << "; err: " << err << IBRCOMMON_LOGGER_ENDL;
 						}
 					}
 
 					// set new database version
 					setVersion(DBSCHEMA_FRESH_VERSION);
-					j = DBSCHEMA_FRESH_VERSION;
+
+					// continue with the upgrade path of the fresh version
+					j = DBSCHEMA_FRESH_VERSION - 1;
+					break;
+
+				// add the index for paged bundle queries
+				case 8:
+				{
+					Statement st(_database, _db_structure[DB_STRUCTURE_END - 1]);
+					int err = st.step();
+					if(err != SQLITE_DONE)
+					{
+						IBRCOMMON_LOGGER_TAG(SQLiteDatabase::TAG, error) << "failed to create index bundles_order; err: " << err << IBRCOMMON_LOGGER_ENDL;
+					}
+
+					setVersion(9);
 					break;
+				}
 
 				default:
 					// NO UPGRADE PATH HERE
@@ -336,8 +404,17 @@ namespace dtn
 				doUpgrade(0, DBSCHEMA_VERSION);
 			}
 
-			// disable synchronous mode
-			sqlite3_exec(_database, "PRAGMA synchronous = OFF;", NULL, NULL, NULL);
+			try {
+				// with WAL readers do not block the writer and commits do not rewrite the database file
+				const std::string journal_mode = pragma("journal_mode", _options.journal_mode);
+
+				IBRCOMMON_LOGGER_TAG(SQLiteDatabase::TAG, info) << "journal mode: " << journal_mode << ", synchronous: " << _options.synchronous << ", batch size: " << _options.batch_size << IBRCOMMON_LOGGER_ENDL;
+
+				// set the durability of commits
+				pragma("synchronous", _options.synchronous);
+			} catch (const SQLiteQueryException &ex) {
+				IBRCOMMON_LOGGER_TAG(SQLiteDatabase::TAG, warning) << "unable to set the durability options: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			}
 
 			// enable sqlite tracing if debug level is higher than 50
 			if (IBRCOMMON_LOGGER_LEVEL >= 50)
@@ -351,6 +428,16 @@ namespace dtn
 
 		void SQLiteDatabase::close()
 		{
+			try {
+				// commit pending writes
+				sync();
+			} catch (const SQLiteQueryException &ex) {
+				IBRCOMMON_LOGGER_TAG(SQLiteDatabase::TAG, error) << "unable to commit pending writes: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			}
+
+			// finalize all cached statements
+			flush();
+
 			//close Databaseconnection
 			if (sqlite3_close(_database) != SQLITE_OK)
 			{
@@ -361,10 +448,52 @@ namespace dtn
 			SQLiteConfigure::shutdown();
 		}
 
+		SQLiteDatabase::Statement* SQLiteDatabase::acquire(const std::string &query) const throw (SQLiteDatabase::SQLiteQueryException)
+		{
+			{
+				ibrcommon::MutexLock l(_statements_lock);
+				statement_cache::iterator it = _statements.find(query);
+				if (it != _statements.end())
+				{
+					Statement *st = it->second;
+					_statements.erase(it);
+					return st;
+				}
+			}
+
+			return new Statement(_database, query);
+		}
+
+		void SQLiteDatabase::release(Statement *st) const throw ()
+		{
+			st->reset();
+
+			ibrcommon::MutexLock l(_statements_lock);
+			if (_statements.size() < STATEMENT_CACHE_LIMIT)
+			{
+				_statements.insert(std::make_pair(st->getQuery(), st));
+			}
+			else
+			{
+				delete st;
+			}
+		}
+
+		void SQLiteDatabase::flush() throw ()
+		{
+			ibrcommon::MutexLock l(_statements_lock);
+			for (statement_cache::iterator it = _statements.begin(); it != _statements.end(); ++it)
+			{
+				delete it->second;
+			}
+			_statements.clear();
+		}
+
 		void SQLiteDatabase::get(const dtn::data::BundleID &id, dtn::data::MetaBundle &meta) const throw (SQLiteDatabase::SQLiteQueryException, NoBundleFoundException)
 		{
-			// lock the prepared statement
-			Statement st(_database, _sql_queries[BUNDLE_GET_ID]);
+			// borrow the prepared statement
+			CachedStatement cst(*this, _sql_queries[BUNDLE_GET_ID]);
+			Statement &st = *cst;
 
 			// bind bundle id to the statement
 			set_bundleid(st, id);
@@ -476,68 +605,87 @@ namespace dtn
 		{
 			size_t items_added = 0;
 
-			const std::string base_query =
-					"SELECT " + _select_names[0] + " FROM " + _tables[SQL_TABLE_BUNDLE];
-
-			size_t offset = 0;
 			const bool unlimited = (cb.limit() <= 0);
 			const size_t query_limit = 50;
 
 			try {
-				try {
-					const SQLBundleQuery &query = dynamic_cast<const SQLBundleQuery&>(cb);
+				std::string where;
+				const SQLBundleQuery *query = dynamic_cast<const SQLBundleQuery*>(&cb);
 
-					// custom query string
-					const std::string query_string = base_query + " WHERE " + query.getWhere() + " ORDER BY priority DESC, timestamp, sequencenumber, fragmentoffset, fragmentlength LIMIT ?,?;";
+				// custom query string
+				if (query != NULL) where = "(" + query->getWhere() + ") AND ";
 
-					// create statement for custom query
-					Statement st(_database, query_string);
+				// the first page starts with the highest priority, all following
+				// pages seek to the position right after the last row fetched
+				CachedStatement first(*this, _sql_queries[BUNDLE_GET_FILTER] + where + _page_filter[0] + " " + _page_filter[2]);
+				CachedStatement next(*this, _sql_queries[BUNDLE_GET_FILTER] + where + _page_filter[1] + " " + _page_filter[2]);
 
-					while (unlimited || (items_added < query_limit))
-					{
-						// bind the statement parameter
-						int bind_offset = query.bind(*st, 1);
+				PageCursor cursor;
 
-						// query the database
-						__get(cb, st, ret, items_added, bind_offset, offset, query_limit);
+				while (unlimited || (items_added < cb.limit()))
+				{
+					size_t rows = 0;
 
-						// increment the offset, because we might not have enough
-						offset += query_limit;
+					// continue within the priority of the last row
+					if (cursor.valid)
+					{
+						if (query != NULL) query->bind(**next, 1);
+						rows = __get(cb, *next, ret, items_added, cursor, query_limit);
 					}
-				} catch (const std::bad_cast&) {
-					Statement st(_database, _sql_queries[BUNDLE_GET_FILTER]);
 
-					while (unlimited || (items_added < query_limit))
+					// start over with the next lower priority
+					if (rows == 0)
 					{
-						// query the database
-						__get(cb, st, ret, items_added, 1, offset, query_limit);
-
-						// increment the offset, because we might not have enough
-						offset += query_limit;
+						if (query != NULL) query->bind(**first, 1);
+						rows = __get(cb, *first, ret, items_added, cursor, query_limit);
 					}
+
+					// no more bundles available
+					if (rows == 0) break;
 				}
 			} catch (const SQLiteDatabase::SQLiteQueryException &ex) {
 				IBRCOMMON_LOGGER_TAG(SQLiteDatabase::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
-			} catch (const dtn::storage::NoBundleFoundException&) { }
+			}
 
 			if (items_added == 0) throw dtn::storage::NoBundleFoundException();
 		}
 
-		void SQLiteDatabase::__get(const BundleSelector &cb, Statement &st, BundleResult &ret, size_t &items_added, const int bind_offset, const size_t offset, const size_t query_limit) const throw (SQLiteDatabase::SQLiteQueryException, NoBundleFoundException, BundleSelectorException)
+		size_t SQLiteDatabase::__get(const BundleSelector &cb, Statement &st, BundleResult &ret, size_t &items_added, PageCursor &cursor, const size_t query_limit) const throw (SQLiteDatabase::SQLiteQueryException, BundleSelectorException)
 		{
 			const bool unlimited = (cb.limit() <= 0);
+			size_t rows = 0;
 
-			// limit result according to callback result
-			sqlite3_bind_int64(*st, bind_offset, offset);
-			sqlite3_bind_int64(*st, bind_offset + 1, query_limit);
+			// bind the position of the last row
+			if (cursor.valid)
+			{
+				sqlite3_bind_int(*st, sqlite3_bind_parameter_index(*st, ":priority"), cursor.priority);
+				sqlite3_bind_int64(*st, sqlite3_bind_parameter_index(*st, ":timestamp"), cursor.timestamp);
+				sqlite3_bind_int64(*st, sqlite3_bind_parameter_index(*st, ":sequencenumber"), cursor.sequencenumber);
+				sqlite3_bind_int64(*st, sqlite3_bind_parameter_index(*st, ":fragmentoffset"), cursor.fragmentoffset);
+				sqlite3_bind_int64(*st, sqlite3_bind_parameter_index(*st, ":fragmentlength"), cursor.fragmentlength);
+				sqlite3_bind_int64(*st, sqlite3_bind_parameter_index(*st, ":key"), cursor.key);
+			}
+			else
+			{
+				sqlite3_bind_int64(*st, sqlite3_bind_parameter_index(*st, ":priority"), std::numeric_limits<int>::max());
+			}
 
-			// returned no result
-			if ((st.step() == SQLITE_DONE) || _faulty)
-				throw dtn::storage::NoBundleFoundException();
+			// limit the size of the page
+			sqlite3_bind_int64(*st, sqlite3_bind_parameter_index(*st, ":limit"), query_limit);
 
-			// abort if enough bundles are found
-			while (unlimited || (items_added < query_limit))
+			while (!_faulty && (unlimited || (items_added < cb.limit())) && (st.step() == SQLITE_ROW))
 			{
+				rows++;
+
+				// remember the position of this row
+				cursor.valid = true;
+				cursor.timestamp = sqlite3_column_int64(*st, 5);
+				cursor.sequencenumber = sqlite3_column_int64(*st, 6);
+				cursor.fragmentoffset = sqlite3_column_int64(*st, 9);
+				cursor.priority = sqlite3_column_int(*st, 15);
+				cursor.fragmentlength = sqlite3_column_int64(*st, 16);
+				cursor.key = sqlite3_column_int64(*st, 17);
+
 				dtn::data::MetaBundle m;
 
 				// extract the primary values and set them in the bundle object
@@ -555,11 +703,11 @@ namespace dtn
 						items_added++;
 					}
 				}
-
-				if (st.step() != SQLITE_ROW) break;
 			}
 
 			st.reset();
+
+			return rows;
 		}
 
 		void SQLiteDatabase::get(const dtn::data::BundleID &id, dtn::data::Bundle &bundle, blocklist &blocks) const throw (SQLiteDatabase::SQLiteQueryException, NoBundleFoundException)
@@ -623,6 +771,25 @@ namespace dtn
 			}
 		}
 
+		void SQLiteDatabase::getBlockFiles(const int blocktype, std::list<ibrcommon::File> &files) const throw (SQLiteDatabase::SQLiteQueryException)
+		{
+			int err = 0;
+
+			Statement st(_database, _sql_queries[BLOCK_GET_FILES]);
+			sqlite3_bind_int(*st, 1, blocktype);
+
+			while ((err = st.step()) == SQLITE_ROW)
+			{
+				files.push_back( ibrcommon::File( (const char*) sqlite3_column_text(*st, 0) ) );
+			}
+
+			if (err != SQLITE_DONE)
+			{
+				IBRCOMMON_LOGGER_TAG("SQLiteDatabase", error) << "get_block_files() failure: "<< err << " " << sqlite3_errmsg(_database) << IBRCOMMON_LOGGER_ENDL;
+				throw SQLiteQueryException("can not query for block files");
+			}
+		}
+
 		void SQLiteDatabase::store(const dtn::data::Bundle &bundle, const dtn::data::Length &size) throw (SQLiteDatabase::SQLiteQueryException)
 		{
 			int err;
@@ -722,49 +889,93 @@ namespace dtn
 
 		void SQLiteDatabase::transaction() throw (SQLiteDatabase::SQLiteQueryException)
 		{
-			char *zErrMsg = 0;
-
-			// start a transaction
-			int ret = sqlite3_exec(_database, "BEGIN TRANSACTION;", NULL, NULL, &zErrMsg);
-
-			// check if the return value signals an error
-			if ( ret != SQLITE_OK )
+			// open a new batch if there is none
+			if (sqlite3_get_autocommit(_database) != 0)
 			{
-				sqlite3_free( zErrMsg );
-				throw SQLiteQueryException( zErrMsg );
+				exec("BEGIN TRANSACTION;");
+				_batch_writes = 0;
 			}
+
+			// mark the start of this group of writes
+			exec("SAVEPOINT write_group;");
 		}
 
 		void SQLiteDatabase::rollback() throw (SQLiteDatabase::SQLiteQueryException)
 		{
-			char *zErrMsg = 0;
+			// rollback the writes of this group only
+			exec("ROLLBACK TRANSACTION TO SAVEPOINT write_group;");
+			exec("RELEASE SAVEPOINT write_group;");
+		}
 
-			// rollback the whole transaction
-			int ret = sqlite3_exec(_database, "ROLLBACK TRANSACTION;", NULL, NULL, &zErrMsg);
+		void SQLiteDatabase::commit() throw (SQLiteDatabase::SQLiteQueryException)
+		{
+			exec("RELEASE SAVEPOINT write_group;");
+			++_batch_writes;
+		}
 
-			// check if the return value signals an error
-			if ( ret != SQLITE_OK )
-			{
-				sqlite3_free( zErrMsg );
-				throw SQLiteQueryException( zErrMsg );
+		void SQLiteDatabase::sync() throw (SQLiteDatabase::SQLiteQueryException)
+		{
+			if (sqlite3_get_autocommit(_database) != 0) return;
+
+			_batch_writes = 0;
+
+			try {
+				exec("COMMIT TRANSACTION;");
+			} catch (const SQLiteQueryException&) {
+				// discard the batch, if SQLite did not roll it back on its own
+				if (sqlite3_get_autocommit(_database) == 0)
+				{
+					try {
+						exec("ROLLBACK TRANSACTION;");
+					} catch (const SQLiteQueryException&) { };
+				}
+				throw;
 			}
 		}
 
-		void SQLiteDatabase::commit() throw (SQLiteDatabase::SQLiteQueryException)
+		bool SQLiteDatabase::full() const throw ()
+		{
+			return (_batch_writes >= _options.batch_size);
+		}
+
+		bool SQLiteDatabase::pending() const throw ()
+		{
+			return (sqlite3_get_autocommit(_database) == 0);
+		}
+
+		const SQLiteDatabase::Options& SQLiteDatabase::getOptions() const throw ()
+		{
+			return _options;
+		}
+
+		void SQLiteDatabase::exec(const std::string &query) throw (SQLiteDatabase::SQLiteQueryException)
 		{
 			char *zErrMsg = 0;
 
-			// commit the transaction
-			int ret = sqlite3_exec(_database, "END TRANSACTION;", NULL, NULL, &zErrMsg);
+			int ret = sqlite3_exec(_database, query.c_str(), NULL, NULL, &zErrMsg);
 
 			// check if the return value signals an error
 			if ( ret != SQLITE_OK )
 			{
+				const std::string error = (zErrMsg == NULL) ? query : zErrMsg;
 				sqlite3_free( zErrMsg );
-				throw SQLiteQueryException( zErrMsg );
+				throw SQLiteQueryException( error );
 			}
 		}
 
+		std::string SQLiteDatabase::pragma(const std::string &name, const std::string &value) throw (SQLiteDatabase::SQLiteQueryException)
+		{
+			Statement st(_database, "PRAGMA " + name + " = " + value + ";");
+
+			if (st.step() == SQLITE_ROW)
+			{
+				const char *ret = (const char*)sqlite3_column_text(*st, 0);
+				if (ret != NULL) return ret;
+			}
+
+			return value;
+		}
+
 		dtn::data::Length SQLiteDatabase::remove(const dtn::data::BundleID &id) throw (SQLiteDatabase::SQLiteQueryException)
 		{
 			// return value (size of the bundle in bytes)
@@ -801,7 +1012,7 @@ namespace dtn
 				{
 					// delete each referenced block file
 					ibrcommon::File blockfile( (const char*)sqlite3_column_text(*st, 0) );
-					blockfile.remove();
+					_listener.releaseBlock(blockfile);
 				}
 			}
 
@@ -825,6 +1036,9 @@ namespace dtn
 
 		void SQLiteDatabase::clear() throw (SQLiteDatabase::SQLiteQueryException)
 		{
+			// vacuum is not possible within a transaction
+			sync();
+
 			Statement vacuum(_database, _sql_queries[VACUUM]);
 			Statement bundle_clear(_database, _sql_queries[BUNDLE_CLEAR]);
 			Statement block_clear(_database, _sql_queries[BLOCK_CLEAR]);
@@ -842,8 +1056,9 @@ namespace dtn
 
 		bool SQLiteDatabase::contains(const dtn::data::BundleID &id) throw (SQLiteDatabase::SQLiteQueryException)
 		{
-			// lock the prepared statement
-			Statement st(_database, _sql_queries[BUNDLE_GET_ID]);
+			// borrow the prepared statement
+			CachedStatement cst(*this, _sql_queries[BUNDLE_GET_ID]);
+			Statement &st = *cst;
 
 			// bind bundle id to the statement
 			set_bundleid(st, id);
@@ -942,7 +1157,7 @@ namespace dtn
 				while (st.step() == SQLITE_ROW)
 				{
 					ibrcommon::File block((const char*)sqlite3_column_text(*st,0));
-					block.remove();
+					_listener.releaseBlock(block);
 				}
 			} catch (const SQLiteDatabase::SQLiteQueryException &ex) {
 				IBRCOMMON_LOGGER_TAG(SQLiteDatabase::TAG, error) << ex.what() << IBRCOMMON_LOGGER_ENDL;
@@ -1000,6 +1215,9 @@ namespace dtn
 
 		void SQLiteDatabase::vacuum() throw (SQLiteDatabase::SQLiteQueryException)
 		{
+			// vacuum is not possible within a transaction
+			sync();
+
 			Statement st(_database, _sql_queries[VACUUM]);
 			st.step();
 		}
@@ -28,6 +28,7 @@
 #include <ibrdtn/data/EID.h>
 #include <ibrdtn/data/MetaBundle.h>
 #include <ibrcommon/data/File.h>
+#include <ibrcommon/thread/Mutex.h>
 #include <map>
 #include <set>
 #include <list>
@@ -80,6 +81,7 @@ namespace dtn
 
 				BLOCK_GET_ID,
 				BLOCK_GET,
+				BLOCK_GET_FILES,
 				BLOCK_CLEAR,
 				BLOCK_STORE,
 
@@ -110,13 +112,15 @@ namespace dtn
 
 			static const std::string _where_filter[2];
 
+			static const std::string _page_filter[3];
+
 			static const std::string _tables[SQL_TABLE_END];
 
 			// array of sql queries
 			static const std::string _sql_queries[SQL_QUERIES_END];
 
 			// array of the db structure as sql
-			static const int DB_STRUCTURE_END = 15;
+			static const int DB_STRUCTURE_END = 16;
 			static const std::string _db_structure[DB_STRUCTURE_END];
 
 			static const std::string TAG;
@@ -133,6 +137,12 @@ namespace dtn
 				virtual ~DatabaseListener() = 0;
 				virtual void eventBundleExpired(const dtn::data::BundleID&, const dtn::data::Length) throw () = 0;
 				virtual void iterateDatabase(const dtn::data::MetaBundle&, const dtn::data::Length) = 0;
+
+				/**
+				 * Called for each block file which is not referenced by the
+				 * database anymore. The default implementation removes the file.
+				 */
+				virtual void releaseBlock(const ibrcommon::File &file) throw ();
 			};
 
 			class SQLBundleQuery
@@ -178,16 +188,57 @@ namespace dtn
 				void reset() throw ();
 				int step() throw (SQLiteQueryException);
 
+				const std::string& getQuery() const throw ();
+
 			private:
 				sqlite3 *_database;
 				sqlite3_stmt *_st;
 				const std::string _query;
 			};
 
+			/**
+			 * Borrows a prepared statement from the statement cache of
+			 * the database and returns it on destruction.
+			 */
+			class CachedStatement
+			{
+			public:
+				CachedStatement(const SQLiteDatabase &database, const std::string &query);
+				~CachedStatement();
+
+				Statement& operator*();
+
+			private:
+				const SQLiteDatabase &_database;
+				Statement *_st;
+			};
+
+			/**
+			 * Durability and write batching of the database
+			 */
+			class Options
+			{
+			public:
+				Options();
+				~Options();
+
+				// journal mode of the database, e.g. WAL or DELETE
+				std::string journal_mode;
+
+				// synchronous mode of the database: OFF, NORMAL or FULL
+				std::string synchronous;
+
+				// maximum number of writes grouped into one transaction
+				size_t batch_size;
+
+				// maximum delay in milliseconds until a batch is committed
+				size_t batch_delay;
+			};
+
 			typedef std::list<std::pair<int, const ibrcommon::File> > blocklist;
 			typedef std::pair<int, const ibrcommon::File> blocklist_entry;
 
-			SQLiteDatabase(const ibrcommon::File &file, DatabaseListener &listener);
+			SQLiteDatabase(const ibrcommon::File &file, DatabaseListener &listener, const Options &options = Options());
 			virtual ~SQLiteDatabase();
 
 			/**
@@ -245,16 +296,59 @@ namespace dtn
 			 */
 			void get(const dtn::data::BundleID &id, dtn::data::Bundle &bundle, blocklist &blocks) const throw (SQLiteQueryException, NoBundleFoundException);
 
+			/**
+			 * Retrieve the files of all stored blocks of a given type
+			 * @param blocktype
+			 * @param files
+			 */
+			void getBlockFiles(const int blocktype, std::list<ibrcommon::File> &files) const throw (SQLiteQueryException);
+
 			/**
 			 *
 			 * @param bundle
 			 */
 			void store(const dtn::data::Bundle &bundle, const dtn::data::Length &size) throw (SQLiteQueryException);
 			void store(const dtn::data::BundleID &id, int index, const dtn::data::Block &block, const ibrcommon::File &file) throw (SQLiteQueryException);
+
+			/**
+			 * Start a group of writes. The group joins the open batch
+			 * transaction or opens a new one.
+			 */
 			void transaction() throw (SQLiteQueryException);
+
+			/**
+			 * Discard all writes since the last call of transaction()
+			 * without affecting the rest of the batch.
+			 */
 			void rollback() throw (SQLiteQueryException);
+
+			/**
+			 * Finish a group of writes. The writes are durable after
+			 * the next call of sync().
+			 */
 			void commit() throw (SQLiteQueryException);
 
+			/**
+			 * Commit the open batch transaction, if any. If the commit
+			 * fails, the whole batch is rolled back.
+			 */
+			void sync() throw (SQLiteQueryException);
+
+			/**
+			 * Returns true, if the open batch reached the configured batch size
+			 */
+			bool full() const throw ();
+
+			/**
+			 * Returns true, if there are writes not committed yet
+			 */
+			bool pending() const throw ();
+
+			/**
+			 * Returns the options of this database
+			 */
+			const Options& getOptions() const throw ();
+
 			bool empty() const throw (SQLiteQueryException);
 
 			dtn::data::Size count() const throw (SQLiteQueryException);
@@ -276,6 +370,12 @@ namespace dtn
 			 */
 			void iterateAll() throw (SQLiteQueryException);
 
+			/**
+			 * Returns the expiration time of the bundle which expires next
+			 * or zero if there is none
+			 */
+			const dtn::data::Timestamp& get_expire_time() const throw ();
+
 			/*** BEGIN: methods for unit-testing ***/
 
 			/**
@@ -304,13 +404,51 @@ namespace dtn
 			void get(Statement &st, dtn::data::Bundle &bundle, const int offset = 0) const throw (SQLiteQueryException);
 
 			/**
-			 *
-			 * @param st
-			 * @param ret
-			 * @param bind_offset
-			 * @param limit
+			 * Position of the last row returned by a paged query. The next
+			 * page starts right after this row in the order of the
+			 * bundles_order index.
+			 */
+			class PageCursor
+			{
+			public:
+				PageCursor();
+
+				bool valid;
+				int priority;
+				sqlite3_int64 timestamp;
+				sqlite3_int64 sequencenumber;
+				sqlite3_int64 fragmentoffset;
+				sqlite3_int64 fragmentlength;
+				sqlite3_int64 key;
+			};
+
+			/**
+			 * Fetch one page of bundles and pass them to the selector.
+			 * @param cb The selector to feed with the results
+			 * @param st The paged query to execute, already bound to its custom values
+			 * @param ret The result list
+			 * @param items_added Number of items added to the result list so far
+			 * @param cursor Position of the last row fetched, moved to the last row of this page
+			 * @param query_limit Maximum number of rows of this page
+			 * @return The number of rows fetched
 			 */
-			void __get(const BundleSelector &cb, Statement &st, BundleResult &ret, size_t &items_added, const int bind_offset, const size_t offset, const size_t query_limit) const throw (SQLiteQueryException, NoBundleFoundException, BundleSelectorException);
+			size_t __get(const BundleSelector &cb, Statement &st, BundleResult &ret, size_t &items_added, PageCursor &cursor, const size_t query_limit) const throw (SQLiteQueryException, BundleSelectorException);
+
+			/**
+			 * Take a prepared statement for the given query out of the cache
+			 * or prepare a new one if there is no idle statement.
+			 */
+			Statement* acquire(const std::string &query) const throw (SQLiteQueryException);
+
+			/**
+			 * Put a statement back into the cache.
+			 */
+			void release(Statement *st) const throw ();
+
+			/**
+			 * Finalize all cached statements.
+			 */
+			void flush() throw ();
 
 			/**
 			 * updates the nextExpiredTime. The calling function has to have the databaselock.
@@ -323,7 +461,6 @@ namespace dtn
 			 */
 			void new_expire_time(const dtn::data::Timestamp &ttl) throw ();
 			void reset_expire_time() throw ();
-			const dtn::data::Timestamp& get_expire_time() const throw ();
 
 			void set_bundleid(Statement &st, const dtn::data::BundleID &id, int offset = 0) const throw (SQLiteQueryException);
 
@@ -345,8 +482,23 @@ namespace dtn
 			 */
 			void doUpgrade(int oldVersion, int newVersion) throw (ibrcommon::Exception);
 
+			/**
+			 * Execute a statement without results
+			 */
+			void exec(const std::string &query) throw (SQLiteQueryException);
+
+			/**
+			 * Set a pragma and return the resulting value
+			 */
+			std::string pragma(const std::string &name, const std::string &value) throw (SQLiteQueryException);
+
 			ibrcommon::File _file;
 
+			const Options _options;
+
+			// number of write groups in the open batch transaction
+			size_t _batch_writes;
+
 			// holds the database handle
 			sqlite3 *_database;
 
@@ -357,6 +509,12 @@ namespace dtn
 			DatabaseListener &_listener;
 
 			bool _faulty;
+
+			// idle prepared statements, indexed by their query text
+			typedef std::multimap<std::string, Statement*> statement_cache;
+			static const size_t STATEMENT_CACHE_LIMIT;
+			mutable statement_cache _statements;
+			mutable ibrcommon::Mutex _statements_lock;
 		};
 	} /* namespace storage */
 } /* namespace dtn */
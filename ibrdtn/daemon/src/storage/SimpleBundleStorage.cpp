@@ -38,6 +38,7 @@
 #include <fstream>
 #include <cstring>
 #include <cerrno>
+#include <unistd.h>
 
 namespace dtn
 {
@@ -46,7 +47,8 @@ namespace dtn
 		const std::string SimpleBundleStorage::TAG = "SimpleBundleStorage";
 
 		SimpleBundleStorage::SimpleBundleStorage(const ibrcommon::File &workdir, const dtn::data::Length maxsize, const unsigned int buffer_limit)
-		 : BundleStorage(maxsize), _datastore(*this, workdir, buffer_limit), _metastore(this)
+		 : BundleStorage(maxsize), _datastore(*this, workdir, buffer_limit), _metastore(this),
+		   _workdir(workdir), _snapshot(workdir.get(".snapshot")), _expiration(*this)
 		{
 		}
 
@@ -93,21 +95,13 @@ namespace dtn
 		{
 			IBRCOMMON_LOGGER_DEBUG_TAG(SimpleBundleStorage::TAG, 30) << "element successfully removed: " << hash.value << IBRCOMMON_LOGGER_ENDL;
 
-			ibrcommon::RWLock l(_meta_lock);
-
-			for (MetaStorage::const_iterator it = _metastore.begin(); it != _metastore.end(); ++it)
-			{
-				const dtn::data::MetaBundle &meta = (*it);
-				DataStorage::Hash it_hash(BundleContainer::createId(meta));
+			// the hash encodes the bundle ID, use it to look-up the bundle
+			const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(BundleContainer::parseId(hash.value));
 
-				if (it_hash == hash)
-				{
-					// remove bundle and decrement the storage size
-					freeSpace( _metastore.remove(meta) );
+			ibrcommon::RWLock l(_meta_lock);
 
-					return;
-				}
-			}
+			// remove bundle and decrement the storage size
+			freeSpace( _metastore.remove(meta) );
 		}
 
 		void SimpleBundleStorage::eventDataStorageRemoveFailed(const dtn::storage::DataStorage::Hash &hash, const ibrcommon::Exception &ex)
@@ -121,6 +115,16 @@ namespace dtn
 		void SimpleBundleStorage::iterateDataStorage(const dtn::storage::DataStorage::Hash &hash, dtn::storage::DataStorage::istream &stream)
 		{
 			try {
+				dtn::data::MetaBundle meta;
+				dtn::data::Length bundle_size = 0;
+
+				// restore the meta data from the snapshot if the file is unchanged
+				if (_snapshot.restore(stream, meta, bundle_size))
+				{
+					__restore(meta, bundle_size);
+					return;
+				}
+
 				dtn::data::Bundle bundle;
 				dtn::data::DefaultDeserializer ds(*stream);
 
@@ -128,7 +132,7 @@ namespace dtn
 				ds >> bundle;
 				
 				// extract meta data
-				const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(bundle);
+				meta = dtn::data::MetaBundle::create(bundle);
 
 				// check if the hash is different
 				DataStorage::Hash hash2(BundleContainer::createId(meta));
@@ -144,19 +148,8 @@ namespace dtn
 				}
 
 				// allocate space for the bundle
-				const dtn::data::Length bundle_size = static_cast<dtn::data::Length>( (*stream).tellg() );
-				allocSpace(bundle_size);
-
-				// lock the bundle lists
-				ibrcommon::RWLock l(_meta_lock);
-
-				// add the bundle to the stored bundles
-				_metastore.store(meta, bundle_size);
-
-				// raise bundle added event
-				eventBundleAdded(meta);
-
-				IBRCOMMON_LOGGER_DEBUG_TAG(SimpleBundleStorage::TAG, 10) << "bundle restored " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+				bundle_size = static_cast<dtn::data::Length>( (*stream).tellg() );
+				__restore(meta, bundle_size);
 			} catch (const std::exception&) {
 				// report this error to the console
 				IBRCOMMON_LOGGER_TAG(SimpleBundleStorage::TAG, error) << "Unable to restore bundle from file " << hash.value << IBRCOMMON_LOGGER_ENDL;
@@ -166,12 +159,43 @@ namespace dtn
 			}
 		}
 
+		void SimpleBundleStorage::__restore(const dtn::data::MetaBundle &meta, const dtn::data::Length &bundle_size)
+		{
+			// allocate space for the bundle
+			allocSpace(bundle_size);
+
+			// lock the bundle lists
+			ibrcommon::RWLock l(_meta_lock);
+
+			// add the bundle to the stored bundles
+			_metastore.store(meta, bundle_size);
+			_expiration.update(meta.expiretime);
+
+			// raise bundle added event
+			eventBundleAdded(meta);
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(SimpleBundleStorage::TAG, 10) << "bundle restored " << meta.toString() << IBRCOMMON_LOGGER_ENDL;
+		}
+
 		void SimpleBundleStorage::componentUp() throw ()
 		{
 			// routine checked for throw() on 15.02.2013
 
+			// load the meta data snapshot of the last shutdown
+			if (_snapshot.load())
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(SimpleBundleStorage::TAG, 10) << _snapshot.size() << " entries in the meta data snapshot" << IBRCOMMON_LOGGER_ENDL;
+			}
+
+			// bundles not covered by the snapshot are parsed in parallel
+			long workers = ::sysconf(_SC_NPROCESSORS_ONLN);
+			if (workers < 1) workers = 1;
+
 			// load persistent bundles
-			_datastore.iterateAll();
+			_datastore.iterateAll(static_cast<unsigned int>(workers));
+
+			// the snapshot is not needed anymore
+			_snapshot.clear();
 
 			// some output
 			{
@@ -179,7 +203,7 @@ namespace dtn
 				IBRCOMMON_LOGGER_TAG(SimpleBundleStorage::TAG, info) << _metastore.size() << " Bundles restored." << IBRCOMMON_LOGGER_ENDL;
 			}
 
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
+			_expiration.start();
 
 			try {
 				_datastore.start();
@@ -192,7 +216,8 @@ namespace dtn
 		{
 			// routine checked for throw() on 15.02.2013
 
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
+			_expiration.stop();
+
 			try {
 				_datastore.wait();
 				_datastore.stop();
@@ -203,6 +228,21 @@ namespace dtn
 
 				// clear all data structures
 				ibrcommon::RWLock l(_meta_lock);
+
+				// write a snapshot of the meta data for the next start-up
+				for (MetaStorage::const_iterator iter = _metastore.begin(); iter != _metastore.end(); ++iter)
+				{
+					const dtn::data::MetaBundle &meta = (*iter);
+					if (_metastore.isRemoved(meta)) continue;
+					_snapshot.put(_workdir.get(BundleContainer::createId(meta)), meta);
+				}
+
+				if (!_snapshot.save())
+				{
+					IBRCOMMON_LOGGER_TAG(SimpleBundleStorage::TAG, warning) << "unable to write the meta data snapshot" << IBRCOMMON_LOGGER_ENDL;
+				}
+				_snapshot.clear();
+
 				_metastore.clear();
 				clearSpace();
 			} catch (const ibrcommon::Exception &ex) {
@@ -210,13 +250,11 @@ namespace dtn
 			}
 		}
 
-		void SimpleBundleStorage::raiseEvent(const dtn::core::TimeEvent &time) throw ()
+		dtn::data::Timestamp SimpleBundleStorage::expire(const dtn::data::Timestamp &timestamp) throw ()
 		{
-			if (time.getAction() == dtn::core::TIME_SECOND_TICK)
-			{
-				ibrcommon::RWLock l(_meta_lock);
-				_metastore.expire(time.getTimestamp());
-			}
+			ibrcommon::RWLock l(_meta_lock);
+			_metastore.expire(timestamp);
+			return _metastore.getNextExpiration();
 		}
 
 		const std::string SimpleBundleStorage::getName() const
@@ -284,7 +322,7 @@ namespace dtn
 				}
 
 				// search for the bundle in the meta storage
-				const dtn::data::MetaBundle &meta = _metastore.find(dtn::data::MetaBundle::create(id));
+				const dtn::data::MetaBundle &meta = _metastore.find(id);
 
 				// create a hash for the data storage
 				DataStorage::Hash hash(BundleContainer::createId(meta));
@@ -390,13 +428,13 @@ namespace dtn
 			ibrcommon::MutexLock l(_meta_lock);
 
 			// search for the bundle in the meta storage
-			return _metastore.find(dtn::data::MetaBundle::create(id));
+			return _metastore.find(id);
 		}
 
 		void SimpleBundleStorage::remove(const dtn::data::BundleID &id)
 		{
 			ibrcommon::MutexLock l(_meta_lock);
-			const dtn::data::MetaBundle &meta = _metastore.find(dtn::data::MetaBundle::create(id));
+			const dtn::data::MetaBundle &meta = _metastore.find(id);
 
 			// first check if the bundles is already marked as removed
 			if (!_metastore.isRemoved(meta))
@@ -438,6 +476,7 @@ namespace dtn
 
 				// add the new bundles to the meta storage
 				_metastore.store(meta, bundle_size);
+				_expiration.update(meta.expiretime);
 			}
 
 			// put the bundle into the data store
@@ -509,6 +548,20 @@ namespace dtn
 			return ss_hash.str();
 		}
 
+		dtn::data::BundleID SimpleBundleStorage::BundleContainer::parseId(const std::string &id)
+		{
+			std::stringstream ss_raw;
+
+			for (std::string::size_type i = 0; (i + 1) < id.length(); i += 2)
+			{
+				ss_raw.put( static_cast<char>(::strtol(id.substr(i, 2).c_str(), NULL, 16)) );
+			}
+
+			dtn::data::BundleID ret;
+			ss_raw >> ret;
+			return ret;
+		}
+
 		std::ostream& SimpleBundleStorage::BundleContainer::serialize(std::ostream &stream)
 		{
 			// get an serializer for bundles
@@ -27,10 +27,11 @@
 #include "storage/BundleStorage.h"
 #include "core/Node.h"
 #include "core/EventReceiver.h"
-#include "core/TimeEvent.h"
 
 #include "storage/DataStorage.h"
 #include "storage/MetaStorage.h"
+#include "storage/MetaSnapshot.h"
+#include "storage/ExpirationTimer.h"
 
 #include <ibrcommon/thread/Conditional.h>
 #include <ibrcommon/thread/AtomicCounter.h>
@@ -51,7 +52,7 @@ namespace dtn
 		/**
 		 * This storage holds all bundles and fragments in the system memory.
 		 */
-		class SimpleBundleStorage : public DataStorage::Callback, public BundleStorage, public dtn::core::EventReceiver<dtn::core::TimeEvent>, public dtn::daemon::IntegratedComponent, public dtn::data::BundleList::Listener
+		class SimpleBundleStorage : public DataStorage::Callback, public BundleStorage, public dtn::daemon::IntegratedComponent, public dtn::data::BundleList::Listener, public ExpirationTimer::Callback
 		{
 			static const std::string TAG;
 
@@ -129,10 +130,9 @@ namespace dtn
 			void releaseCustody(const dtn::data::EID &custodian, const dtn::data::BundleID &id);
 
 			/**
-			 * This method is used to receive events.
-			 * @param evt
+			 * @see ExpirationTimer::Callback::expire()
 			 */
-			void raiseEvent(const dtn::core::TimeEvent &evt) throw ();
+			dtn::data::Timestamp expire(const dtn::data::Timestamp &timestamp) throw ();
 
 			/**
 			 * @see Component::getName()
@@ -177,6 +177,11 @@ namespace dtn
 				 */
 				static std::string createId(const dtn::data::BundleID &id);
 
+				/**
+				 * restore the bundle ID out of a unique identifier
+				 */
+				static dtn::data::BundleID parseId(const std::string &id);
+
 				/**
 				 * get the unique identifier for this bundle container
 				 */
@@ -193,6 +198,7 @@ namespace dtn
 
 			void __remove(const dtn::data::MetaBundle &meta);
 			void __store(const dtn::data::Bundle &bundle, const dtn::data::Length &bundle_size);
+			void __restore(const dtn::data::MetaBundle &meta, const dtn::data::Length &bundle_size);
 
 			typedef std::map<DataStorage::Hash, dtn::data::Bundle> pending_map;
 			ibrcommon::RWMutex _pending_lock;
@@ -204,6 +210,13 @@ namespace dtn
 			// stores all the meta data in memory
 			ibrcommon::RWMutex _meta_lock;
 			MetaStorage _metastore;
+
+			// persistent copy of the meta data for a fast start-up
+			const ibrcommon::File _workdir;
+			MetaSnapshot _snapshot;
+
+			// triggers the expiration of the next expiring bundle
+			ExpirationTimer _expiration;
 		};
 	}
 }
@@ -33,6 +33,7 @@
 #include "BaseRouterTest.hh"
 #include "routing/RoutingExtension.h"
 #include "routing/BaseRouter.h"
+#include "routing/NodeHandshake.h"
 #include "storage/BundleStorage.h"
 #include "core/Node.h"
 #include "../tools/EventSwitchLoop.h"
@@ -40,6 +41,7 @@
 #include <ibrdtn/data/EID.h>
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/Logger.h>
+#include <string.h>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(BaseRouterTest);
@@ -249,8 +251,182 @@ void BaseRouterTest::testGetSummaryVector()
 	CPPUNIT_ASSERT_EQUAL(true, router.getKnownBundles().has(b));
 }
 
+void BaseRouterTest::testQueryCursor()
+{
+	class ExtensionTest : public dtn::routing::RoutingExtension
+	{
+	public:
+		ExtensionTest() {};
+		~ExtensionTest() {};
+
+		void componentUp() throw () {};
+		void componentDown() throw () {};
+
+		void testQuery(dtn::routing::NeighborDatabase::NeighborEntry &entry, const dtn::storage::BundleSelector &filter, dtn::routing::RoutingResult &result)
+		{
+			try {
+				query(entry, filter, result);
+			} catch (const dtn::storage::NoBundleFoundException&) { }
+		}
+	};
+
+	class BundleFilter : public dtn::storage::BundleSelector
+	{
+	public:
+		BundleFilter() : examined(0) {};
+		virtual ~BundleFilter() {};
+
+		virtual dtn::data::Size limit() const throw () { return 0; };
+
+		virtual bool shouldAdd(const dtn::data::MetaBundle&) const throw (dtn::storage::BundleSelectorException)
+		{
+			examined++;
+			return true;
+		};
+
+		mutable size_t examined;
+	};
+
+	dtn::routing::BaseRouter router;
+	ExtensionTest ex;
+	dtn::routing::NeighborDatabase &db = router.getNeighborDB();
+	dtn::routing::RoutingResult list;
+
+	dtn::core::BundleCore::getInstance().setSeeker(&_storage);
+	_storage.attach(&db.getFeed());
+
+	for (int i = 0; i < 10; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://testcase-one/foo");
+		_storage.store(b);
+	}
+
+	ibrcommon::MutexLock l(db);
+	dtn::routing::NeighborDatabase::NeighborEntry &entry = db.create(dtn::data::EID("dtn://no-neighbor"));
+
+	// the first query examines the whole storage
+	BundleFilter filter;
+	ex.testQuery(entry, filter, list);
+	CPPUNIT_ASSERT_EQUAL((size_t)10, filter.examined);
+	CPPUNIT_ASSERT_EQUAL((size_t)10, list.size());
+
+	// nothing has been added since the last query
+	filter.examined = 0;
+	ex.testQuery(entry, filter, list);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, filter.examined);
+
+	dtn::data::BundleID last;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://testcase-one/foo");
+		_storage.store(b);
+		last = b;
+	}
+
+	// removed bundles are skipped
+	_storage.remove(last);
+
+	// only new bundles are examined
+	filter.examined = 0;
+	ex.testQuery(entry, filter, list);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, filter.examined);
+	CPPUNIT_ASSERT_EQUAL((size_t)12, list.size());
+
+	// an invalid cursor starts over
+	entry.invalidate();
+	filter.examined = 0;
+	ex.testQuery(entry, filter, list);
+	CPPUNIT_ASSERT_EQUAL((size_t)12, filter.examined);
+
+	_storage.detach(&db.getFeed());
+	dtn::core::BundleCore::getInstance().setSeeker(NULL);
+}
+
 /*=== END   tests for class 'BaseRouter' ===*/
 
+void BaseRouterTest::testSummaryVectorDelta()
+{
+	dtn::data::BundleSet vec1, vec2;
+
+	for (int i = 0; i < 105; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://testcase-one/foo");
+
+		if (i < 100) vec1.add(dtn::data::MetaBundle::create(b));
+		vec2.add(dtn::data::MetaBundle::create(b));
+	}
+
+	const ibrcommon::BloomFilter &f1 = vec1.getBloomFilter();
+	const ibrcommon::BloomFilter &f2 = vec2.getBloomFilter();
+
+	// a request carries the version known by the requester
+	{
+		dtn::routing::NodeHandshake request(dtn::routing::NodeHandshake::HANDSHAKE_REQUEST);
+		request.addRequest(dtn::routing::BloomFilterSummaryVector::identifier);
+		request.addRequest(dtn::routing::BloomFilterSummaryDelta::identifier);
+		request.addItem(new dtn::routing::BloomFilterSummaryDelta(42));
+
+		std::stringstream ss;
+		ss << request;
+
+		dtn::routing::NodeHandshake received;
+		ss >> received;
+
+		const dtn::routing::NodeHandshake &r = received;
+		CPPUNIT_ASSERT(r.hasRequest(dtn::routing::BloomFilterSummaryDelta::identifier));
+		CPPUNIT_ASSERT_EQUAL((dtn::data::Size)42, r.get<dtn::routing::BloomFilterSummaryDelta>().getVersion().get<dtn::data::Size>());
+	}
+
+	// a request without parameters is still valid
+	{
+		dtn::routing::NodeHandshake request(dtn::routing::NodeHandshake::HANDSHAKE_REQUEST);
+		request.addRequest(dtn::routing::BloomFilterSummaryVector::identifier);
+
+		std::stringstream ss;
+		ss << request;
+
+		dtn::routing::NodeHandshake received;
+		ss >> received;
+
+		CPPUNIT_ASSERT(received.hasRequest(dtn::routing::BloomFilterSummaryVector::identifier));
+		CPPUNIT_ASSERT_THROW(received.get<dtn::routing::BloomFilterSummaryDelta>(), ibrcommon::Exception);
+	}
+
+	// the response carries the changes only
+	{
+		dtn::routing::NodeHandshake response(dtn::routing::NodeHandshake::HANDSHAKE_RESPONSE);
+		dtn::routing::BloomFilterSummaryDelta *delta = new dtn::routing::BloomFilterSummaryDelta(42, 43, f1, f2);
+		response.addItem(delta);
+
+		CPPUNIT_ASSERT(delta->size() > 0);
+		CPPUNIT_ASSERT(delta->getLength() < dtn::routing::BloomFilterSummaryVector(vec2).getLength());
+
+		std::stringstream ss;
+		ss << response;
+
+		dtn::routing::NodeHandshake received;
+		ss >> received;
+
+		const dtn::routing::BloomFilterSummaryDelta &d = received.get<dtn::routing::BloomFilterSummaryDelta>();
+		CPPUNIT_ASSERT_EQUAL((dtn::data::Size)42, d.getBase().get<dtn::data::Size>());
+		CPPUNIT_ASSERT_EQUAL((dtn::data::Size)43, d.getVersion().get<dtn::data::Size>());
+
+		// apply the changes to the old vector
+		ibrcommon::BloomFilter filter = f1;
+		CPPUNIT_ASSERT(d.apply(filter));
+		CPPUNIT_ASSERT_EQUAL(f2.size(), filter.size());
+		CPPUNIT_ASSERT(::memcmp(f2.table(), filter.table(), f2.size()) == 0);
+
+		// the changes do not apply to filters of a different size
+		ibrcommon::BloomFilter other(f1.size() * 2);
+		CPPUNIT_ASSERT(!d.apply(other));
+	}
+}
+
 void BaseRouterTest::setUp()
 {
 	_storage.clear();
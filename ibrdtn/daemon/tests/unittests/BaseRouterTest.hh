@@ -35,6 +35,8 @@ class BaseRouterTest : public CppUnit::TestFixture {
 		void testIsKnown();
 		void testSetKnown();
 		void testGetSummaryVector();
+		void testQueryCursor();
+		void testSummaryVectorDelta();
 		/*=== END   tests for class 'BaseRouter' ===*/
 
 		void setUp();
@@ -50,6 +52,8 @@ class BaseRouterTest : public CppUnit::TestFixture {
 			CPPUNIT_TEST(testIsKnown);
 			CPPUNIT_TEST(testSetKnown);
 			CPPUNIT_TEST(testGetSummaryVector);
+			CPPUNIT_TEST(testQueryCursor);
+			CPPUNIT_TEST(testSummaryVectorDelta);
 		CPPUNIT_TEST_SUITE_END();
 };
 #endif /* BASEROUTERTEST_HH */
@@ -44,21 +44,40 @@
 #include <ibrcommon/data/File.h>
 #include <ibrcommon/data/BLOB.h>
 #include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/TimeMeasurement.h>
 #include <ibrdtn/data/PayloadBlock.h>
 #include <ibrdtn/data/AgeBlock.h>
 #include "Component.h"
 
 #include "storage/SimpleBundleStorage.h"
 #include "storage/MemoryBundleStorage.h"
+#include "storage/ExpirationTimer.h"
 
 #ifdef HAVE_SQLITE
 #include "storage/SQLiteBundleStorage.h"
 #endif
 
 #include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <set>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(BundleStorageTest);
 
+/**
+ * Expire all bundles of the storage which are expired at the given time
+ * without waiting for the expiration timer of the storage
+ */
+static void expireBundles(dtn::storage::BundleStorage &storage, const dtn::data::Timestamp &timestamp)
+{
+	dynamic_cast<dtn::storage::ExpirationTimer::Callback&>(storage).expire(timestamp);
+
+	// special case for storages deferred mechanisms (SimpleBundleStorage)
+	// wait until all tasks of the storage are processed
+	storage.wait();
+}
+
 /*========================== setup / teardown ==========================*/
 
 size_t BundleStorageTest::testCounter;
@@ -224,7 +243,7 @@ void BundleStorageTest::testAgeBlock(dtn::storage::BundleStorage &storage)
 	dtn::data::Bundle b;
 
 	// set standard variable.sourceurce = dtn::data::EID("dtn://node-one/test");
-	b.lifetime = 1;
+	b.lifetime = 60;
 	b.destination = dtn::data::EID("dtn://node-two/test");
 
 	// add some payload
@@ -408,22 +427,8 @@ void BundleStorageTest::testSizeExpiration(dtn::storage::BundleStorage &storage)
 
 	CPPUNIT_ASSERT_EQUAL(ssize, storage.size());
 
-	TestEventListener<dtn::core::TimeEvent> evtl;
-
-	// raise time event to trigger expiration
-	dtn::core::TimeEvent::raise(timestamp + 21, TIME_SECOND_TICK);
-
-	// wait until the time event has been processed
-	{
-		ibrcommon::Thread::sleep(2000);
-
-		ibrcommon::MutexLock l(evtl.event_cond);
-		while (evtl.event_counter == 0) evtl.event_cond.wait(20000);
-	}
-
-	// special case for storages deferred mechanisms (SimpleBundleStorage)
-	// wait until all tasks of the storage are processed
-	storage.wait();
+	// trigger the expiration after the lifetime of the bundles
+	expireBundles(storage, timestamp + 21);
 
 	// should be empty now
 	CPPUNIT_ASSERT_EQUAL(true, storage.empty());
@@ -509,7 +514,7 @@ void BundleStorageTest::testConcurrentStoreGet(dtn::storage::BundleStorage &stor
 	for (int i = 0; i < 2000; ++i)
 	{
 		dtn::data::Bundle b;
-		b.lifetime = 1;
+		b.lifetime = 60;
 		b.source = dtn::data::EID("dtn://node-two/foo");
 		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
 		b.push_back(ref);
@@ -565,7 +570,7 @@ void BundleStorageTest::testRestore(dtn::storage::BundleStorage &storage)
 		for (int i = 0; i < 2000; ++i)
 		{
 			dtn::data::Bundle b;
-			b.lifetime = 1;
+			b.lifetime = 60;
 			b.source = dtn::data::EID("dtn://node-two/foo");
 			ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
 			b.push_back(ref);
@@ -607,22 +612,8 @@ void BundleStorageTest::testExpiration(dtn::storage::BundleStorage &storage)
 	// check if the storage count is right
 	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, storage.count());
 
-	TestEventListener<dtn::core::TimeEvent> evtl;
-
-	// raise time event to trigger expiration
-	dtn::core::TimeEvent::raise(b.timestamp + 21, TIME_SECOND_TICK);
-
-	// wait until the time event has been processed
-	{
-		ibrcommon::Thread::sleep(2000);
-
-		ibrcommon::MutexLock l(evtl.event_cond);
-		while (evtl.event_counter == 0) evtl.event_cond.wait(20000);
-	}
-
-	// special case for storages deferred mechanisms (SimpleBundleStorage)
-	// wait until all tasks of the storage are processed
-	storage.wait();
+	// trigger the expiration after the lifetime of the bundle
+	expireBundles(storage, b.timestamp + 21);
 
 	// check if the storage count is right
 	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, storage.count());
@@ -726,6 +717,66 @@ void BundleStorageTest::testSelector(dtn::storage::BundleStorage &storage)
 	CPPUNIT_ASSERT_EQUAL((size_t)2, list.size());
 }
 
+void BundleStorageTest::testSelectorPaging()
+{
+	STORAGE_TEST(testSelectorPaging);
+}
+
+void BundleStorageTest::testSelectorPaging(dtn::storage::BundleStorage &storage)
+{
+	dtn::data::Bundle b;
+	b.destination = dtn::data::EID("dtn://node-two/test");
+	b.relabel();
+
+	// store bundles of two sources sharing the same timestamps and
+	// sequence numbers, spread over all priorities
+	for (int i = 0; i < 300; i++) {
+		b.source = dtn::data::EID((i % 2) ? "dtn://node-one/test" : "dtn://node-three/test");
+		b.sequencenumber = i / 2;
+		b.setPriority((dtn::data::PrimaryBlock::PRIORITY)((i / 2) % 3));
+
+		// store the bundle
+		storage.store(b);
+	}
+
+	class BundleFilter : public dtn::storage::BundleSelector
+	{
+	public:
+		BundleFilter(const dtn::data::Size limit)
+		 : _limit(limit)
+		{};
+
+		virtual ~BundleFilter() {};
+
+		virtual dtn::data::Size limit() const throw () { return _limit; };
+
+		virtual bool shouldAdd(const dtn::data::MetaBundle&) const throw (dtn::storage::BundleSelectorException)
+		{
+			return true;
+		};
+
+	private:
+		const dtn::data::Size _limit;
+	};
+
+	dtn::storage::BundleResultList list;
+
+	// query all bundles
+	BundleFilter all(0);
+	storage.get(all, list);
+
+	// every bundle is returned exactly once
+	std::set<dtn::data::BundleID> ids(list.begin(), list.end());
+	CPPUNIT_ASSERT_EQUAL((size_t)300, list.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)300, ids.size());
+
+	// the limit spans more than one page
+	BundleFilter limited(120);
+	list.clear();
+	storage.get(limited, list);
+	CPPUNIT_ASSERT_EQUAL((size_t)120, list.size());
+}
+
 void BundleStorageTest::testDoubleStore()
 {
 	STORAGE_TEST(testDoubleStore);
@@ -762,7 +813,7 @@ void BundleStorageTest::testGet(dtn::storage::BundleStorage &storage)
 	for (int i = 0; i < 2000; ++i)
 	{
 		dtn::data::Bundle b;
-		b.lifetime = 1;
+		b.lifetime = 60;
 		b.source = dtn::data::EID("dtn://node-two/foo");
 		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
 		b.push_back(ref);
@@ -794,7 +845,7 @@ void BundleStorageTest::testFaultyGet(dtn::storage::BundleStorage &storage)
 
 	// set standard variables
 	b.source = dtn::data::EID("dtn://node-one/test");
-	b.lifetime = 1;
+	b.lifetime = 60;
 	b.destination = dtn::data::EID("dtn://node-two/test");
 
 	// add some payload
@@ -836,7 +887,7 @@ void BundleStorageTest::testFaultyStore(dtn::storage::BundleStorage &storage)
 
 	// set standard variables
 	b.source = dtn::data::EID("dtn://node-one/test");
-	b.lifetime = 1;
+	b.lifetime = 60;
 	b.destination = dtn::data::EID("dtn://node-two/test");
 
 	// add some payload
@@ -879,7 +930,7 @@ void BundleStorageTest::testFragment(dtn::storage::BundleStorage &storage)
 
 	// set standard variables
 	b.source = dtn::data::EID("dtn://node-one/test");
-	b.lifetime = 1;
+	b.lifetime = 60;
 	b.destination = dtn::data::EID("dtn://node-two/test");
 
 	// add some payload
@@ -920,7 +971,7 @@ void BundleStorageTest::testContains(dtn::storage::BundleStorage &storage)
 
 	// set standard variables
 	b.source = dtn::data::EID("dtn://node-one/test");
-	b.lifetime = 1;
+	b.lifetime = 60;
 	b.destination = dtn::data::EID("dtn://node-two/test");
 
 	// add some payload
@@ -957,7 +1008,7 @@ void BundleStorageTest::testInfo(dtn::storage::BundleStorage &storage)
 
 	// set standard variables
 	b.source = dtn::data::EID("dtn://node-one/test");
-	b.lifetime = 1;
+	b.lifetime = 60;
 	b.destination = dtn::data::EID("dtn://node-two/test");
 
 	// add some payload
@@ -981,6 +1032,131 @@ void BundleStorageTest::testInfo(dtn::storage::BundleStorage &storage)
 	CPPUNIT_ASSERT_EQUAL((dtn::data::BundleID&)b, (dtn::data::BundleID&)meta);
 }
 
+void BundleStorageTest::testLookupBenchmark()
+{
+	STORAGE_TEST(testLookupBenchmark);
+}
+
+void BundleStorageTest::testLookupBenchmark(dtn::storage::BundleStorage &storage)
+{
+	// disk based storages are only measured with a small number of bundles
+	if (dynamic_cast<dtn::storage::MemoryBundleStorage*>(&storage) != NULL)
+	{
+		benchmarkLookup(storage, 10000, 10000);
+		storage.clear();
+		benchmarkLookup(storage, 100000, 10000);
+	}
+	else
+	{
+		benchmarkLookup(storage, 1000, 1000);
+	}
+}
+
+void BundleStorageTest::benchmarkLookup(dtn::storage::BundleStorage &storage, size_t bundles, size_t lookups)
+{
+	std::vector<dtn::data::BundleID> ids;
+	ibrcommon::TimeMeasurement tm;
+
+	for (size_t i = 0; i < bundles; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://node-one/test");
+		b.destination = dtn::data::EID("dtn://node-two/test");
+		b.lifetime = 3600;
+
+		// add some payload
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		b.push_back(ref);
+		(*ref.iostream()) << "Hallo Welt" << std::endl;
+
+		storage.store(b);
+		ids.push_back(b);
+	}
+
+	// pick the bundles to look-up in a spread order
+	std::vector<dtn::data::BundleID> probes;
+	for (size_t i = 0; i < lookups; ++i)
+	{
+		probes.push_back(ids[(i * 7919) % bundles]);
+	}
+
+	std::cout << std::endl << "lookups with " << bundles << " bundles:";
+
+	tm.start();
+	for (std::vector<dtn::data::BundleID>::const_iterator iter = probes.begin(); iter != probes.end(); ++iter)
+	{
+		CPPUNIT_ASSERT(storage.contains(*iter));
+	}
+	tm.stop();
+	std::cout << " contains " << (tm.getMicroseconds() / lookups) << " us,";
+
+	tm.start();
+	for (std::vector<dtn::data::BundleID>::const_iterator iter = probes.begin(); iter != probes.end(); ++iter)
+	{
+		storage.info(*iter);
+	}
+	tm.stop();
+	std::cout << " info " << (tm.getMicroseconds() / lookups) << " us,";
+
+	tm.start();
+	for (std::vector<dtn::data::BundleID>::const_iterator iter = probes.begin(); iter != probes.end(); ++iter)
+	{
+		storage.get(*iter);
+	}
+	tm.stop();
+	std::cout << " get " << (tm.getMicroseconds() / lookups) << " us" << std::flush;
+}
+
+void BundleStorageTest::testMemoryUsage()
+{
+	STORAGE_TEST(testMemoryUsage);
+}
+
+static size_t getHeapUsage()
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+	return mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+	return mallinfo().uordblks;
+#else
+	return 0;
+#endif
+}
+
+void BundleStorageTest::testMemoryUsage(dtn::storage::BundleStorage &storage)
+{
+	// only the memory storage holds all bundles in memory
+	if (dynamic_cast<dtn::storage::MemoryBundleStorage*>(&storage) == NULL) return;
+
+	const size_t bundles = 100000;
+	const dtn::data::EID destinations[] = {
+		dtn::data::EID("dtn://node-two/test"),
+		dtn::data::EID("dtn://node-three/test"),
+		dtn::data::EID("dtn://node-four/test"),
+		dtn::data::EID("dtn://node-five/test")
+	};
+
+	const size_t heap_before = getHeapUsage();
+
+	for (size_t i = 0; i < bundles; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://node-one/test");
+		b.destination = destinations[i % 4];
+		b.reportto = b.source;
+		b.lifetime = 3600;
+
+		storage.store(b);
+	}
+
+	const size_t heap_after = getHeapUsage();
+
+	CPPUNIT_ASSERT_EQUAL(bundles, storage.count());
+
+	std::cout << std::endl << bundles << " bundles: heap " << (heap_before / 1024) << " kB -> " << (heap_after / 1024) << " kB, "
+			<< ((heap_after - heap_before) / bundles) << " bytes per bundle" << std::flush;
+}
+
 void BundleStorageTest::testQueryBloomFilter()
 {
 	STORAGE_TEST(testQueryBloomFilter);
@@ -993,7 +1169,7 @@ void BundleStorageTest::testQueryBloomFilter(dtn::storage::BundleStorage &storag
 
 	// set standard variables
 	b.source = dtn::data::EID("dtn://node-one/test");
-	b.lifetime = 1;
+	b.lifetime = 60;
 	b.destination = dtn::data::EID("dtn://node-two/test");
 
 	// add some payload
@@ -1043,3 +1219,161 @@ void BundleStorageTest::testQueryBloomFilter(dtn::storage::BundleStorage &storag
 
 	CPPUNIT_ASSERT_EQUAL((size_t)0, list.size());
 }
+
+void BundleStorageTest::testDuplicatePayload()
+{
+	STORAGE_TEST(testDuplicatePayload);
+}
+
+void BundleStorageTest::testDuplicatePayload(dtn::storage::BundleStorage &storage)
+{
+	const std::string payload(4096, 'x');
+	std::list<dtn::data::BundleID> ids;
+
+	// store three bundles with identical payload
+	for (int i = 0; i < 3; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://node-one/test");
+		b.destination = dtn::data::EID("dtn://node-two/test");
+		b.lifetime = 60;
+
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		(*ref.iostream()) << payload << std::flush;
+		b.push_back(ref);
+
+		storage.store(b);
+		ids.push_back(b);
+	}
+
+	storage.wait();
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)3, storage.count());
+
+	// storages with payload deduplication report the saved bytes
+	dtn::storage::BundleStorage::stats_data stats;
+	storage.getStats(stats);
+
+	if (stats.find("dedup-bytes-saved") != stats.end())
+	{
+		CPPUNIT_ASSERT(stats["dedup-bytes-saved"] != "0");
+	}
+
+	{
+		// modify a loaded payload in place, the stored bundles must not change
+		dtn::data::Bundle b = storage.get(ids.front());
+		ibrcommon::BLOB::iostream stream = b.find<dtn::data::PayloadBlock>().getBLOB().iostream();
+		(*stream).seekp(0);
+		(*stream) << "modified" << std::flush;
+
+		// loaded bundles are no references of the shared payload
+		stats.clear();
+		storage.getStats(stats);
+
+		if (stats.find("dedup-references") != stats.end())
+		{
+			CPPUNIT_ASSERT_EQUAL(std::string("3"), stats["dedup-references"]);
+		}
+	}
+
+	// remove the first bundle, the others have to keep their payload
+	storage.remove(ids.front());
+	ids.pop_front();
+
+	for (std::list<dtn::data::BundleID>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+	{
+		dtn::data::Bundle b = storage.get(*it);
+
+		ibrcommon::BLOB::iostream stream = b.find<dtn::data::PayloadBlock>().getBLOB().iostream();
+		std::stringstream ss; ss << (*stream).rdbuf();
+
+		CPPUNIT_ASSERT(ss.str() == payload);
+	}
+
+	storage.remove(ids.front());
+	storage.remove(ids.back());
+	storage.wait();
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, storage.count());
+}
+
+void BundleStorageTest::testRestoreBenchmark()
+{
+	STORAGE_TEST(testRestoreBenchmark);
+}
+
+void BundleStorageTest::testRestoreBenchmark(dtn::storage::BundleStorage &storage)
+{
+	// exclude memory-storage since it does not support bundle restore
+	if (dynamic_cast<dtn::storage::MemoryBundleStorage*>(&storage) != NULL) return;
+
+	dtn::daemon::Component *c = dynamic_cast<dtn::daemon::Component*>(&storage);
+	if (c == NULL) return;
+
+	const size_t bundles = 2000;
+	ibrcommon::TimeMeasurement tm;
+
+	dtn::data::Bundle probe;
+	for (size_t i = 0; i < bundles; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://node-one/test");
+		b.destination = dtn::data::EID("dtn://node-two/test");
+		b.lifetime = 3600;
+		b.set(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON, true);
+
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		b.push_back(ref);
+		(*ref.iostream()) << "Hallo Welt" << std::endl;
+
+		storage.store(b);
+		if (i == (bundles / 2)) probe = b;
+	}
+
+	storage.wait();
+	const dtn::data::MetaBundle meta = storage.info(probe);
+
+	std::cout << std::endl << "restore of " << bundles << " bundles:";
+
+	// restart the storage, the meta data is restored from the snapshot
+	c->terminate();
+
+	tm.start();
+	c->initialize();
+	c->startup();
+	tm.stop();
+
+	std::cout << " " << tm.getMilliseconds() << " ms";
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)bundles, storage.count());
+
+	// restored meta data have to be equal to the stored
+	const dtn::data::MetaBundle restored = storage.info(probe);
+	CPPUNIT_ASSERT(restored.destination == meta.destination);
+	CPPUNIT_ASSERT_EQUAL(meta.lifetime.get<dtn::data::Size>(), restored.lifetime.get<dtn::data::Size>());
+	CPPUNIT_ASSERT_EQUAL(meta.expiretime.get<dtn::data::Size>(), restored.expiretime.get<dtn::data::Size>());
+	CPPUNIT_ASSERT_EQUAL(meta.procflags.get<dtn::data::Size>(), restored.procflags.get<dtn::data::Size>());
+	CPPUNIT_ASSERT_EQUAL(meta.getPayloadLength(), restored.getPayloadLength());
+
+	if (dynamic_cast<dtn::storage::SimpleBundleStorage*>(&storage) != NULL)
+	{
+		// restart without a valid snapshot, all bundle files are parsed
+		c->terminate();
+		::unlink("/tmp/bundle-disk-test/.snapshot");
+
+		tm.start();
+		c->initialize();
+		c->startup();
+		tm.stop();
+
+		std::cout << ", without snapshot " << tm.getMilliseconds() << " ms";
+
+		CPPUNIT_ASSERT_EQUAL((dtn::data::Size)bundles, storage.count());
+		CPPUNIT_ASSERT(storage.info(probe).destination == meta.destination);
+	}
+
+	// the restored bundles are readable
+	dtn::data::Bundle b = storage.get(probe);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::BundleID&)probe, (dtn::data::BundleID&)b);
+
+	std::cout << std::flush;
+}
@@ -42,6 +42,7 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		void testExpiration(dtn::storage::BundleStorage &storage);
 		void testDistinctDestinations(dtn::storage::BundleStorage &storage);
 		void testSelector(dtn::storage::BundleStorage &storage);
+		void testSelectorPaging(dtn::storage::BundleStorage &storage);
 		void testRemoveBloomfilter(dtn::storage::BundleStorage &storage);
 		void testDoubleStore(dtn::storage::BundleStorage &storage);
 		void testGet(dtn::storage::BundleStorage &storage);
@@ -51,6 +52,12 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		void testFragment(dtn::storage::BundleStorage &storage);
 		void testContains(dtn::storage::BundleStorage &storage);
 		void testInfo(dtn::storage::BundleStorage &storage);
+		void testLookupBenchmark(dtn::storage::BundleStorage &storage);
+		void testMemoryUsage(dtn::storage::BundleStorage &storage);
+		void testDuplicatePayload(dtn::storage::BundleStorage &storage);
+		void testRestoreBenchmark(dtn::storage::BundleStorage &storage);
+
+		void benchmarkLookup(dtn::storage::BundleStorage &storage, size_t bundles, size_t lookups);
 
 	public:
 #define CPPUNIT_TEST_ALL_STORAGES(testMethod) \
@@ -78,6 +85,7 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		void testExpiration();
 		void testDistinctDestinations();
 		void testSelector();
+		void testSelectorPaging();
 		void testDoubleStore();
 		void testGet();
 		void testFaultyGet();
@@ -86,6 +94,10 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		void testFragment();
 		void testContains();
 		void testInfo();
+		void testLookupBenchmark();
+		void testMemoryUsage();
+		void testDuplicatePayload();
+		void testRestoreBenchmark();
 
 		void setUp();
 		void tearDown();
@@ -114,6 +126,7 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_ALL_STORAGES(testExpiration);
 		CPPUNIT_TEST_ALL_STORAGES(testDistinctDestinations);
 		CPPUNIT_TEST_ALL_STORAGES(testSelector);
+		CPPUNIT_TEST_ALL_STORAGES(testSelectorPaging);
 		CPPUNIT_TEST_ALL_STORAGES(testDoubleStore);
 		CPPUNIT_TEST_ALL_STORAGES(testGet);
 		CPPUNIT_TEST_ALL_STORAGES(testFaultyGet);
@@ -122,6 +135,10 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_ALL_STORAGES(testFragment);
 		CPPUNIT_TEST_ALL_STORAGES(testContains);
 		CPPUNIT_TEST_ALL_STORAGES(testInfo);
+		CPPUNIT_TEST_ALL_STORAGES(testLookupBenchmark);
+		CPPUNIT_TEST_ALL_STORAGES(testMemoryUsage);
+		CPPUNIT_TEST_ALL_STORAGES(testDuplicatePayload);
+		CPPUNIT_TEST_ALL_STORAGES(testRestoreBenchmark);
 		CPPUNIT_TEST_SUITE_END();
 
 		static size_t testCounter;
@@ -10,6 +10,8 @@
 #include "storage/MemoryBundleStorage.h"
 #include "core/NodeEvent.h"
 #include "net/TransferCompletedEvent.h"
+#include "routing/QueueBundleEvent.h"
+#include "routing/BaseRouter.h"
 
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/EID.h>
@@ -21,9 +23,12 @@
 #include <ibrcommon/thread/MutexLock.h>
 #include <ibrdtn/data/PayloadBlock.h>
 #include <ibrdtn/data/AgeBlock.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrcommon/TimeMeasurement.h>
 #include "Component.h"
 
 #include <unistd.h>
+#include <algorithm>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DatagramClTest);
 
@@ -131,6 +136,120 @@ void DatagramClTest::discoveryTest() {
 }
 
 void DatagramClTest::queueTest() {
+	transferBundle();
+}
+
+void DatagramClTest::selectiveRepeatTest() {
+	// lose every 7th segment, the peer acknowledges selectively
+	_fake_service->setLink(dtn::net::DatagramService::FLOW_SELECTIVE_REPEAT, 7, true);
+
+	ibrcommon::TimeMeasurement tm;
+	tm.start();
+	transferBundle();
+	tm.stop();
+
+	std::cout << std::endl << "selective repeat: " << _fake_service->stats_sent << " segments sent, "
+			<< _fake_service->stats_lost << " lost, " << _fake_service->stats_delivered << " delivered, completed after " << tm;
+
+	// only lost segments have to be repeated
+	CPPUNIT_ASSERT(_fake_service->stats_sent - _fake_service->stats_delivered <= 2 * _fake_service->stats_lost);
+}
+
+void DatagramClTest::goBackNFallbackTest() {
+	// lose every 20th segment, the peer does not support selective repeat
+	_fake_service->setLink(dtn::net::DatagramService::FLOW_SELECTIVE_REPEAT, 20, false);
+
+	ibrcommon::TimeMeasurement tm;
+	tm.start();
+	transferBundle();
+	tm.stop();
+
+	std::cout << std::endl << "go-back-n: " << _fake_service->stats_sent << " segments sent, "
+			<< _fake_service->stats_lost << " lost, " << _fake_service->stats_delivered << " delivered, completed after " << tm;
+
+	// no selective ACK has been received, so the whole window was repeated
+	CPPUNIT_ASSERT(_fake_service->stats_sent - _fake_service->stats_delivered > _fake_service->stats_lost);
+}
+
+void DatagramClTest::selectiveAckTest() {
+	_fake_service->setLink(dtn::net::DatagramService::FLOW_SELECTIVE_REPEAT, 0, true);
+
+	// received bundles are checked against the known bundles of the router
+	dtn::routing::BaseRouter router;
+
+	// create a new bundle
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://fake-peer/test");
+	b.destination = dtn::data::EID("dtn://node-two/test");
+	b.lifetime = 60;
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	{
+		ibrcommon::BLOB::iostream stream = ref.iostream();
+		for (int i = 0; i < 100; ++i)
+			(*stream) << "Hallo Welt" << std::endl;
+	}
+
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss) << b;
+	const std::string data = ss.str();
+
+	// split the bundle into segments
+	const size_t seglen = _fake_service->getParameter().max_msg_length;
+	std::vector<std::string> segments;
+	for (size_t pos = 0; pos < data.size(); pos += seglen)
+		segments.push_back(data.substr(pos, seglen));
+
+	CPPUNIT_ASSERT(segments.size() > 4);
+
+	TestEventListener<dtn::routing::QueueBundleEvent> queued_evtl;
+
+	// deliver each pair of segments in reversed order
+	for (size_t i = 0; i < segments.size(); i += 2)
+	{
+		for (size_t j = std::min(i + 1, segments.size() - 1); j + 1 > i; --j)
+		{
+			char flags = dtn::net::DatagramService::SELECTIVE_REPEAT;
+			if (j == 0) flags |= dtn::net::DatagramService::SEGMENT_FIRST;
+			if (j == segments.size() - 1) flags |= dtn::net::DatagramService::SEGMENT_LAST;
+
+			_fake_service->fakeSegment(flags, j % 16, segments[j].c_str(), segments[j].size());
+		}
+	}
+
+	// wait until the bundle has been received
+	try {
+		ibrcommon::MutexLock l(queued_evtl.event_cond);
+		while (queued_evtl.event_counter == 0) queued_evtl.event_cond.wait(20000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("receive - timeout reached");
+	}
+
+	// wait until all segments are acknowledged
+	ibrcommon::MutexLock l(_fake_service->acks_cond);
+	try {
+		while (_fake_service->acks.size() < segments.size()) _fake_service->acks_cond.wait(20000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("ack - timeout reached");
+	}
+
+	CPPUNIT_ASSERT_EQUAL(segments.size(), _fake_service->acks.size());
+
+	// the first ACK reports the second segment as received
+	const FakeDatagramService::Message &first = _fake_service->acks.front();
+	CPPUNIT_ASSERT(first.flags & dtn::net::DatagramService::SELECTIVE_REPEAT);
+	CPPUNIT_ASSERT_EQUAL(0U, first.seqno);
+	CPPUNIT_ASSERT_EQUAL((char)0x01, first.data[0]);
+
+	// the last ACK acknowledges all segments
+	const FakeDatagramService::Message &last = _fake_service->acks.back();
+	CPPUNIT_ASSERT_EQUAL((unsigned int)(segments.size() % 16), last.seqno);
+	CPPUNIT_ASSERT_EQUAL((char)0x00, last.data[0]);
+}
+
+void DatagramClTest::transferBundle() {
 	// create a new bundle
 	dtn::data::Bundle b;
 
@@ -142,8 +261,11 @@ void DatagramClTest::queueTest() {
 	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
 	b.push_back(ref);
 
-	for (int i = 0; i < 1000; ++i)
-		(*ref.iostream()) << "Hallo Welt" << std::endl;
+	{
+		ibrcommon::BLOB::iostream stream = ref.iostream();
+		for (int i = 0; i < 1000; ++i)
+			(*stream) << "Hallo Welt" << std::endl;
+	}
 
 	{
 		dtn::data::AgeBlock &agebl = b.push_back<dtn::data::AgeBlock>();
@@ -25,6 +25,11 @@ class DatagramClTest : public CppUnit::TestFixture {
 
 	void discoveryTest();
 	void queueTest();
+	void selectiveRepeatTest();
+	void goBackNFallbackTest();
+	void selectiveAckTest();
+
+	void transferBundle();
 
 public:
 	void setUp();
@@ -33,6 +38,9 @@ public:
 	CPPUNIT_TEST_SUITE(DatagramClTest);
 	CPPUNIT_TEST(discoveryTest);
 	CPPUNIT_TEST(queueTest);
+	CPPUNIT_TEST(selectiveRepeatTest);
+	CPPUNIT_TEST(goBackNFallbackTest);
+	CPPUNIT_TEST(selectiveAckTest);
 	CPPUNIT_TEST_SUITE_END();
 };
 
@@ -0,0 +1,152 @@
+/*
+ * EventSwitchTest.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "EventSwitchTest.h"
+#include "core/EventSwitch.h"
+#include <ibrcommon/thread/MutexLock.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(EventSwitchTest);
+
+void EventSwitchTest::setUp()
+{
+}
+
+void EventSwitchTest::tearDown()
+{
+}
+
+void EventSwitchTest::testSingleThread()
+{
+	runEvents(0, 4, 1000);
+}
+
+void EventSwitchTest::testPinnedOrder()
+{
+	runEvents(4, 16, 10000);
+}
+
+void EventSwitchTest::runEvents(size_t threads, size_t keys, size_t events)
+{
+	dtn::core::EventSwitch &es = dtn::core::EventSwitch::getInstance();
+	es.initialize();
+
+	TestProcessor proc;
+	LoopThread loop(threads);
+	loop.start();
+
+	for (size_t i = 0; i < events; ++i)
+	{
+		// pinned events with ascending sequence numbers per key
+		dtn::core::EventSwitch::queue(proc, new TestEvent((i % keys) + 1, i));
+
+		// unpinned events of all priorities
+		dtn::core::EventSwitch::queue(proc, new TestEvent(0, i, static_cast<int>(i % 3) - 1));
+	}
+
+	proc.wait(events * 2);
+
+	loop.stop();
+	loop.join();
+
+	es.terminate();
+
+	CPPUNIT_ASSERT_EQUAL((size_t)0, proc.disorder);
+}
+
+EventSwitchTest::TestEvent::TestEvent(size_t k, size_t s, int prio)
+ : dtn::core::Event(prio), key(k), seq(s)
+{
+	setLoggable(false);
+}
+
+EventSwitchTest::TestEvent::~TestEvent()
+{
+}
+
+const std::string EventSwitchTest::TestEvent::getName() const
+{
+	return "TestEvent";
+}
+
+std::string EventSwitchTest::TestEvent::getMessage() const
+{
+	return "test event";
+}
+
+size_t EventSwitchTest::TestEvent::getOrderingKey() const
+{
+	return key;
+}
+
+EventSwitchTest::TestProcessor::TestProcessor()
+ : disorder(0), _count(0)
+{
+}
+
+EventSwitchTest::TestProcessor::~TestProcessor()
+{
+}
+
+void EventSwitchTest::TestProcessor::process(const dtn::core::Event *evt)
+{
+	const TestEvent &e = static_cast<const TestEvent&>(*evt);
+
+	ibrcommon::MutexLock l(_cond);
+
+	if (e.key != 0)
+	{
+		std::map<size_t, size_t>::iterator it = _last.find(e.key);
+		if ((it != _last.end()) && (it->second > e.seq)) disorder++;
+		_last[e.key] = e.seq;
+	}
+
+	_count++;
+	_cond.signal(true);
+}
+
+void EventSwitchTest::TestProcessor::wait(size_t count)
+{
+	ibrcommon::MutexLock l(_cond);
+	while (_count < count)
+	{
+		_cond.wait();
+	}
+}
+
+EventSwitchTest::LoopThread::LoopThread(size_t threads)
+ : _threads(threads)
+{
+}
+
+EventSwitchTest::LoopThread::~LoopThread()
+{
+	join();
+}
+
+void EventSwitchTest::LoopThread::run() throw ()
+{
+	dtn::core::EventSwitch::getInstance().loop(_threads);
+}
+
+void EventSwitchTest::LoopThread::__cancellation() throw ()
+{
+	dtn::core::EventSwitch::getInstance().shutdown();
+}
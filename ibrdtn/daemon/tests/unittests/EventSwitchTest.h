@@ -0,0 +1,99 @@
+/*
+ * EventSwitchTest.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "core/Event.h"
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/Thread.h>
+#include <map>
+
+#ifndef EVENTSWITCHTEST_H_
+#define EVENTSWITCHTEST_H_
+
+class EventSwitchTest : public CppUnit::TestFixture
+{
+public:
+	void testSingleThread();
+	void testPinnedOrder();
+
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(EventSwitchTest);
+	CPPUNIT_TEST(testSingleThread);
+	CPPUNIT_TEST(testPinnedOrder);
+	CPPUNIT_TEST_SUITE_END();
+
+private:
+	class TestEvent : public dtn::core::Event
+	{
+	public:
+		TestEvent(size_t key, size_t seq, int prio = 0);
+		virtual ~TestEvent();
+
+		const std::string getName() const;
+		std::string getMessage() const;
+		size_t getOrderingKey() const;
+
+		const size_t key;
+		const size_t seq;
+	};
+
+	class TestProcessor : public dtn::core::EventProcessor
+	{
+	public:
+		TestProcessor();
+		virtual ~TestProcessor();
+
+		void process(const dtn::core::Event *evt);
+
+		/**
+		 * Wait until the given number of events has been processed
+		 */
+		void wait(size_t count);
+
+		size_t disorder;
+
+	private:
+		ibrcommon::Conditional _cond;
+		size_t _count;
+		std::map<size_t, size_t> _last;
+	};
+
+	class LoopThread : public ibrcommon::JoinableThread
+	{
+	public:
+		LoopThread(size_t threads);
+		virtual ~LoopThread();
+
+	protected:
+		void run() throw ();
+		void __cancellation() throw ();
+
+	private:
+		const size_t _threads;
+	};
+
+	void runEvents(size_t threads, size_t keys, size_t events);
+};
+
+#endif /* EVENTSWITCHTEST_H_ */
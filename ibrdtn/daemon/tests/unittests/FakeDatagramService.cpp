@@ -21,10 +21,13 @@
 
 #include "FakeDatagramService.h"
 #include "net/DiscoveryBeacon.h"
+#include <ibrcommon/thread/MutexLock.h>
 #include <string.h>
 #include <unistd.h>
 
-FakeDatagramService::FakeDatagramService() : _iface("fake0"), _discovery_sn(0), _fake_peer("dtn://fake-peer") {
+FakeDatagramService::FakeDatagramService()
+ : stats_sent(0), stats_lost(0), stats_delivered(0), _iface("fake0"), _discovery_sn(0), _fake_peer("dtn://fake-peer"),
+   _link_loss(0), _link_selective(false), _peer_next(0) {
 	// set connection parameters
 	_params.max_msg_length = 114;
 	_params.max_seq_numbers = 4;
@@ -72,6 +75,34 @@ void FakeDatagramService::genAck(const unsigned int seqno, const std::string &ad
 	_recv_queue.push(msg);
 }
 
+void FakeDatagramService::genAck(const unsigned int seqno, const std::string &address, const std::vector<char> &bitmap) {
+	Message msg;
+	msg.type = dtn::net::DatagramConvergenceLayer::HEADER_ACK;
+	msg.flags = dtn::net::DatagramService::SELECTIVE_REPEAT;
+	msg.seqno = seqno;
+	msg.address = address;
+	msg.data = bitmap;
+	_recv_queue.push(msg);
+}
+
+void FakeDatagramService::setLink(const dtn::net::DatagramService::FLOWCONTROL flowcontrol, const unsigned int loss, const bool selective) {
+	_params.flowcontrol = flowcontrol;
+	_params.max_seq_numbers = 16;
+	_params.initial_timeout = 50;
+	_link_loss = loss;
+	_link_selective = selective;
+}
+
+void FakeDatagramService::fakeSegment(const char flags, const unsigned int seqno, const char *buf, size_t length) {
+	Message msg;
+	msg.type = dtn::net::DatagramConvergenceLayer::HEADER_SEGMENT;
+	msg.flags = flags;
+	msg.seqno = seqno;
+	msg.address = "fakeaddr";
+	msg.data.assign(buf, buf + length);
+	_recv_queue.push(msg);
+}
+
 void FakeDatagramService::bind() throw (dtn::net::DatagramException) {
 	_recv_queue.reset();
 }
@@ -81,11 +112,66 @@ void FakeDatagramService::shutdown() {
 }
 
 void FakeDatagramService::send(const char &type, const char &flags, const unsigned int &seqno, const std::string &address, const char *buf, size_t length) throw (dtn::net::DatagramException) {
-	if (type == dtn::net::DatagramConvergenceLayer::HEADER_SEGMENT) {
+	if (type == dtn::net::DatagramConvergenceLayer::HEADER_ACK) {
+		Message msg;
+		msg.type = type;
+		msg.flags = flags;
+		msg.seqno = seqno;
+		msg.address = address;
+		if (length > 0) msg.data.assign(buf, buf + length);
+
+		ibrcommon::MutexLock l(acks_cond);
+		acks.push_back(msg);
+		acks_cond.signal(true);
+		return;
+	}
+
+	if (type != dtn::net::DatagramConvergenceLayer::HEADER_SEGMENT) return;
+
+	if (_params.flowcontrol == dtn::net::DatagramService::FLOW_STOPNWAIT) {
 		// wait 50ms and queue an ack
 		ibrcommon::Thread::sleep(50);
 
-		genAck((seqno + 1) % 4, address);
+		genAck((seqno + 1) % _params.max_seq_numbers, address);
+		return;
+	}
+
+	ibrcommon::MutexLock l(_link_lock);
+	stats_sent++;
+
+	// drop every n-th segment
+	if ((_link_loss > 0) && ((stats_sent % _link_loss) == 0)) {
+		stats_lost++;
+		return;
+	}
+
+	const unsigned int window = _params.max_seq_numbers / 2;
+	const unsigned int offset = (seqno + _params.max_seq_numbers - _peer_next) % _params.max_seq_numbers;
+	const bool selective = _link_selective && (flags & dtn::net::DatagramService::SELECTIVE_REPEAT);
+
+	if ((offset == 0) || ((flags & dtn::net::DatagramService::SEGMENT_FIRST) && (offset < window))) {
+		if (offset != 0) _peer_frames.clear();
+		_peer_next = (seqno + 1) % _params.max_seq_numbers;
+		stats_delivered++;
+	} else if (selective && (offset < window)) {
+		_peer_frames.insert(seqno);
+	}
+
+	// accept buffered frames which are in-order now
+	while (_peer_frames.erase(_peer_next) > 0) {
+		_peer_next = (_peer_next + 1) % _params.max_seq_numbers;
+		stats_delivered++;
+	}
+
+	if (selective) {
+		std::vector<char> bitmap((window + 7) / 8, 0);
+		for (std::set<unsigned int>::const_iterator it = _peer_frames.begin(); it != _peer_frames.end(); ++it) {
+			const unsigned int n = ((*it) + _params.max_seq_numbers - _peer_next - 1) % _params.max_seq_numbers;
+			bitmap[n / 8] |= static_cast<char>(1 << (n % 8));
+		}
+		genAck(_peer_next, address, bitmap);
+	} else {
+		genAck(_peer_next, address);
 	}
 }
 
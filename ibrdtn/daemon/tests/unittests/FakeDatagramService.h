@@ -25,8 +25,11 @@
 #include "net/DatagramConvergenceLayer.h"
 #include "net/DatagramService.h"
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/Conditional.h>
 #include <ibrdtn/data/EID.h>
 #include <vector>
+#include <list>
+#include <set>
 
 class FakeDatagramService : public dtn::net::DatagramService {
 public:
@@ -61,15 +64,48 @@ public:
 
 	void fakeDiscovery();
 
+	/**
+	 * Emulate a lossy link to a sliding window peer. Every n-th segment
+	 * is dropped and the peer acknowledges selectively if it supports
+	 * selective repeat.
+	 * @param flowcontrol Flow-control used by the local side
+	 * @param loss Drop every n-th segment, zero disables losses
+	 * @param selective True, if the peer supports selective repeat
+	 */
+	void setLink(const dtn::net::DatagramService::FLOWCONTROL flowcontrol, const unsigned int loss, const bool selective);
+
+	/**
+	 * Inject a segment as if it was sent by the peer
+	 */
+	void fakeSegment(const char flags, const unsigned int seqno, const char *buf, size_t length);
+
+	// segments sent to the peer, dropped by the link and accepted in-order by the peer
+	size_t stats_sent;
+	size_t stats_lost;
+	size_t stats_delivered;
+
+	// ACKs sent to the peer
+	std::list<Message> acks;
+	ibrcommon::Conditional acks_cond;
+
 private:
 	void genAck(const unsigned int seqno, const std::string &address);
 
+	void genAck(const unsigned int seqno, const std::string &address, const std::vector<char> &bitmap);
+
 	DatagramService::Parameter _params;
 	typedef ibrcommon::Queue<Message> msg_queue;
 	msg_queue _recv_queue;
 	const ibrcommon::vinterface _iface;
 	uint16_t _discovery_sn;
 	dtn::data::EID _fake_peer;
+
+	// state of the emulated peer
+	ibrcommon::Mutex _link_lock;
+	unsigned int _link_loss;
+	bool _link_selective;
+	unsigned int _peer_next;
+	std::set<unsigned int> _peer_frames;
 };
 
 #endif /* FAKEDATAGRAMSERVICE_H_ */
@@ -0,0 +1,338 @@
+/*
+ * StaticRouteTableTest.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "config.h"
+#include "StaticRouteTableTest.h"
+#include "routing/StaticRouteTable.h"
+
+#ifdef HAVE_REGEX_H
+#include "routing/StaticRegexRoute.h"
+#endif
+
+#include <ibrcommon/TimeMeasurement.h>
+#include <typeinfo>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StaticRouteTableTest);
+
+/**
+ * route matching a single node
+ */
+class NodeRoute : public dtn::routing::StaticRoute
+{
+public:
+	NodeRoute(const dtn::data::EID &match, const dtn::data::EID &nexthop)
+	 : _match(match), _nexthop(nexthop), _expire(0) { }
+	virtual ~NodeRoute() { }
+
+	bool match(const dtn::data::EID &eid) const { return _match.sameHost(eid); }
+	const dtn::data::EID& getDestination() const { return _nexthop; }
+	const std::string toString() const { return _match.getString() + " => " + _nexthop.getString(); }
+	const dtn::data::Timestamp& getExpiration() const { return _expire; }
+	void raiseExpired() const { }
+	const dtn::data::EID getMatchingNode() const { return _match.getNode(); }
+
+	bool equals(const dtn::routing::StaticRoute &route) const
+	{
+		try {
+			const NodeRoute &r = dynamic_cast<const NodeRoute&>(route);
+			return (_match == r._match) && (_nexthop == r._nexthop);
+		} catch (const std::bad_cast&) {
+			return false;
+		}
+	}
+
+private:
+	const dtn::data::EID _match;
+	const dtn::data::EID _nexthop;
+	const dtn::data::Timestamp _expire;
+};
+
+/**
+ * route matching all destinations containing a literal
+ */
+class LiteralRoute : public dtn::routing::StaticRoute
+{
+public:
+	LiteralRoute(const std::string &literal, const dtn::data::EID &nexthop)
+	 : _literal(literal), _nexthop(nexthop), _expire(0) { }
+	virtual ~LiteralRoute() { }
+
+	bool match(const dtn::data::EID &eid) const { return eid.getString().find(_literal) != std::string::npos; }
+	const dtn::data::EID& getDestination() const { return _nexthop; }
+	const std::string toString() const { return _literal + " => " + _nexthop.getString(); }
+	const dtn::data::Timestamp& getExpiration() const { return _expire; }
+	void raiseExpired() const { }
+	const std::string getMatchingLiteral() const { return _literal; }
+
+	bool equals(const dtn::routing::StaticRoute &route) const
+	{
+		try {
+			const LiteralRoute &r = dynamic_cast<const LiteralRoute&>(route);
+			return (_literal == r._literal) && (_nexthop == r._nexthop);
+		} catch (const std::bad_cast&) {
+			return false;
+		}
+	}
+
+private:
+	const std::string _literal;
+	const dtn::data::EID _nexthop;
+	const dtn::data::Timestamp _expire;
+};
+
+void StaticRouteTableTest::setUp()
+{
+}
+
+void StaticRouteTableTest::tearDown()
+{
+}
+
+void StaticRouteTableTest::testLiteral()
+{
+#ifdef HAVE_REGEX_H
+	const dtn::data::EID hop("dtn://gateway");
+
+	CPPUNIT_ASSERT_EQUAL(std::string("dtn://gateway-"), dtn::routing::StaticRegexRoute("^dtn://gateway-[0-9]\\+/", hop).getMatchingLiteral());
+	CPPUNIT_ASSERT_EQUAL(std::string(".moon.dtn/"), dtn::routing::StaticRegexRoute("dtn://[a-z]*\\.moon\\.dtn/.*", hop).getMatchingLiteral());
+	CPPUNIT_ASSERT_EQUAL(std::string("dtn://"), dtn::routing::StaticRegexRoute("dtn://[[:alpha:]]*\\.dtn", hop).getMatchingLiteral());
+	CPPUNIT_ASSERT_EQUAL(std::string("dtn://nod"), dtn::routing::StaticRegexRoute("dtn://node*", hop).getMatchingLiteral());
+	CPPUNIT_ASSERT_EQUAL(std::string("dtn://"), dtn::routing::StaticRegexRoute("dtn://\\(one\\|two\\)", hop).getMatchingLiteral());
+	CPPUNIT_ASSERT_EQUAL(std::string("/app"), dtn::routing::StaticRegexRoute("x\\{0,3\\}/app", hop).getMatchingLiteral());
+	CPPUNIT_ASSERT_EQUAL(std::string(""), dtn::routing::StaticRegexRoute("dtn://one\\|dtn://two", hop).getMatchingLiteral());
+	CPPUNIT_ASSERT_EQUAL(std::string(""), dtn::routing::StaticRegexRoute(".*", hop).getMatchingLiteral());
+#endif
+}
+
+void StaticRouteTableTest::testMatch()
+{
+	dtn::routing::StaticRouteTable table;
+	std::vector<dtn::routing::StaticRoute*> routes;
+
+	routes.push_back(new NodeRoute(dtn::data::EID("dtn://node-one/app"), dtn::data::EID("dtn://hop-one")));
+	routes.push_back(new NodeRoute(dtn::data::EID("ipn:12.1"), dtn::data::EID("dtn://hop-two")));
+
+#ifdef HAVE_REGEX_H
+	const char *patterns[] = { "dtn://node-.*", "^dtn://node-t[a-z]*/", "one/app$", "dtn://[a-z]*-three", "\\(tw\\|thr\\)", ".*", "ipn:1[0-9]\\.", NULL };
+	for (size_t i = 0; patterns[i] != NULL; ++i)
+	{
+		routes.push_back(new dtn::routing::StaticRegexRoute(patterns[i], dtn::data::EID("dtn://hop-three")));
+	}
+#endif
+
+	for (std::vector<dtn::routing::StaticRoute*>::const_iterator it = routes.begin(); it != routes.end(); ++it)
+	{
+		table.add(*it);
+	}
+	CPPUNIT_ASSERT_EQUAL(routes.size(), table.size());
+
+	const char *destinations[] = { "dtn://node-one/app", "dtn://node-one/other", "dtn://node-two/app", "dtn://node-three/app",
+			"dtn://other/one/app", "ipn:12.4", "ipn:13.1", "dtn://none", NULL };
+
+	// the table has to select the same routes as a linear search
+	for (size_t i = 0; destinations[i] != NULL; ++i)
+	{
+		const dtn::data::EID destination(destinations[i]);
+
+		dtn::routing::StaticRouteTable::route_list expected;
+		for (std::vector<dtn::routing::StaticRoute*>::const_iterator it = routes.begin(); it != routes.end(); ++it)
+		{
+			if ((*it)->match(destination)) expected.push_back(*it);
+		}
+
+		dtn::routing::StaticRouteTable::route_list ret;
+		table.match(destination, ret);
+
+		CPPUNIT_ASSERT_EQUAL(expected.size(), ret.size());
+		CPPUNIT_ASSERT(expected == ret);
+	}
+
+	CPPUNIT_ASSERT(table.hasNextHop(dtn::data::EID("dtn://hop-one")));
+	CPPUNIT_ASSERT(!table.hasNextHop(dtn::data::EID("dtn://hop-four")));
+
+	// remove the node route
+	table.remove(NodeRoute(dtn::data::EID("dtn://node-one/app"), dtn::data::EID("dtn://hop-one")));
+	CPPUNIT_ASSERT(!table.hasNextHop(dtn::data::EID("dtn://hop-one")));
+
+	dtn::routing::StaticRouteTable::route_list ret;
+	table.match(dtn::data::EID("dtn://node-one/app"), ret);
+	for (dtn::routing::StaticRouteTable::route_list::const_iterator it = ret.begin(); it != ret.end(); ++it)
+	{
+		CPPUNIT_ASSERT((*it)->getDestination() != dtn::data::EID("dtn://hop-one"));
+	}
+
+	table.clear();
+	CPPUNIT_ASSERT_EQUAL((size_t)0, table.size());
+
+	ret.clear();
+	table.match(dtn::data::EID("dtn://node-one/app"), ret);
+	CPPUNIT_ASSERT(ret.empty());
+}
+
+void StaticRouteTableTest::testReplace()
+{
+	dtn::routing::StaticRouteTable table;
+
+	table.add(new NodeRoute(dtn::data::EID("dtn://node-one"), dtn::data::EID("dtn://hop-one")));
+	table.add(new NodeRoute(dtn::data::EID("dtn://node-two"), dtn::data::EID("dtn://hop-one")));
+	table.add(new NodeRoute(dtn::data::EID("dtn://node-one"), dtn::data::EID("dtn://hop-one")));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, table.size());
+
+	// the replaced route is ordered behind the other route
+	dtn::routing::StaticRouteTable::route_list ret;
+	table.add(new NodeRoute(dtn::data::EID("dtn://node-two"), dtn::data::EID("dtn://hop-two")));
+	table.match(dtn::data::EID("dtn://node-two/app"), ret);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, ret.size());
+	CPPUNIT_ASSERT(ret.back()->getDestination() == dtn::data::EID("dtn://hop-two"));
+
+#ifdef HAVE_REGEX_H
+	table.add(new dtn::routing::StaticRegexRoute("dtn://node-.*", dtn::data::EID("dtn://hop-three")));
+	table.add(new dtn::routing::StaticRegexRoute("dtn://node-.*", dtn::data::EID("dtn://hop-three")));
+	CPPUNIT_ASSERT_EQUAL((size_t)4, table.size());
+
+	table.remove(dtn::routing::StaticRegexRoute("dtn://node-.*", dtn::data::EID("dtn://hop-three")));
+	CPPUNIT_ASSERT_EQUAL((size_t)3, table.size());
+
+	ret.clear();
+	table.match(dtn::data::EID("dtn://node-three/app"), ret);
+	CPPUNIT_ASSERT(ret.empty());
+#endif
+}
+
+void StaticRouteTableTest::testChurn()
+{
+	dtn::routing::StaticRouteTable table;
+	const dtn::data::EID hop("dtn://hop-one");
+
+	// routes are pushed and expired in rounds, with overlapping literals
+	for (size_t round = 0; round < 20; ++round)
+	{
+		for (size_t i = 0; i < 100; ++i)
+		{
+			std::stringstream ss; ss << "region-" << (round * 50 + i) << ".";
+			table.add(new LiteralRoute(ss.str(), hop));
+		}
+
+		for (size_t i = 0; i < 50; ++i)
+		{
+			std::stringstream ss; ss << "region-" << (round * 50 + i) << ".";
+			table.remove(LiteralRoute(ss.str(), hop));
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL((size_t)50, table.size());
+
+	// only the second half of the last round is left
+	for (size_t n = 0; n < 1100; n += 7)
+	{
+		std::stringstream ss; ss << "dtn://host.region-" << n << ".example/app";
+
+		dtn::routing::StaticRouteTable::route_list ret;
+		table.match(dtn::data::EID(ss.str()), ret);
+
+		const size_t expected = ((n >= 1000) && (n < 1050)) ? 1 : 0;
+		CPPUNIT_ASSERT_EQUAL(expected, ret.size());
+	}
+}
+
+void StaticRouteTableTest::testLookupBenchmark()
+{
+	benchmarkLookup(10, 10000);
+	benchmarkLookup(100, 10000);
+	benchmarkLookup(1000, 10000);
+	benchmarkLookup(5000, 10000);
+}
+
+void StaticRouteTableTest::benchmarkLookup(size_t count, size_t lookups)
+{
+	dtn::routing::StaticRouteTable table;
+	std::vector<dtn::routing::StaticRoute*> routes;
+
+	// half of the routes match a single node, the other half a region
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::stringstream node, hop;
+		hop << "dtn://gateway-" << (i % 10);
+
+#ifdef HAVE_REGEX_H
+		if (i % 2)
+		{
+			node << "dtn://[a-z]*-" << i << "\\.region/.*";
+			routes.push_back(new dtn::routing::StaticRegexRoute(node.str(), dtn::data::EID(hop.str())));
+			continue;
+		}
+#endif
+
+		node << "dtn://node-" << i;
+		routes.push_back(new NodeRoute(dtn::data::EID(node.str()), dtn::data::EID(hop.str())));
+	}
+
+	std::vector<dtn::data::EID> probes;
+	for (size_t i = 0; i < lookups; ++i)
+	{
+		std::stringstream ss;
+		const size_t n = (i * 7919) % count;
+		if (n % 2) ss << "dtn://host-" << n << ".region/app";
+		else ss << "dtn://node-" << n << "/app";
+		probes.push_back(dtn::data::EID(ss.str()));
+	}
+
+	ibrcommon::TimeMeasurement tm;
+	size_t matches = 0;
+
+	// linear search over all routes
+	tm.start();
+	for (std::vector<dtn::data::EID>::const_iterator it = probes.begin(); it != probes.end(); ++it)
+	{
+		for (std::vector<dtn::routing::StaticRoute*>::const_iterator r = routes.begin(); r != routes.end(); ++r)
+		{
+			if ((*r)->match(*it)) ++matches;
+		}
+	}
+	tm.stop();
+
+	const double linear = tm.getMicroseconds();
+
+	for (std::vector<dtn::routing::StaticRoute*>::const_iterator it = routes.begin(); it != routes.end(); ++it)
+	{
+		table.add(*it);
+	}
+
+	// lookup through the table
+	tm.start();
+	for (std::vector<dtn::data::EID>::const_iterator it = probes.begin(); it != probes.end(); ++it)
+	{
+		dtn::routing::StaticRouteTable::route_list ret;
+		table.match(*it, ret);
+		matches -= ret.size();
+	}
+	tm.stop();
+
+	const double indexed = tm.getMicroseconds();
+
+	CPPUNIT_ASSERT_EQUAL((size_t)0, matches);
+
+	std::cout << std::endl << count << " routes: linear " << static_cast<size_t>(lookups / (linear / 1000000.0)) << " lookups/s, "
+			<< "table " << static_cast<size_t>(lookups / (indexed / 1000000.0)) << " lookups/s" << std::flush;
+}
@@ -0,0 +1,53 @@
+/*
+ * StaticRouteTableTest.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <stddef.h>
+
+#ifndef STATICROUTETABLETEST_H_
+#define STATICROUTETABLETEST_H_
+
+class StaticRouteTableTest : public CppUnit::TestFixture
+{
+public:
+	void testLiteral();
+	void testMatch();
+	void testReplace();
+	void testChurn();
+	void testLookupBenchmark();
+
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(StaticRouteTableTest);
+	CPPUNIT_TEST(testLiteral);
+	CPPUNIT_TEST(testMatch);
+	CPPUNIT_TEST(testReplace);
+	CPPUNIT_TEST(testChurn);
+	CPPUNIT_TEST(testLookupBenchmark);
+	CPPUNIT_TEST_SUITE_END();
+
+private:
+	void benchmarkLookup(size_t routes, size_t lookups);
+};
+
+#endif /* STATICROUTETABLETEST_H_ */
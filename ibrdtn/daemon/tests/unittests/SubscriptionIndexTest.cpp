@@ -0,0 +1,159 @@
+/*
+ * SubscriptionIndexTest.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "SubscriptionIndexTest.h"
+#include "api/SubscriptionIndex.h"
+#include "api/Registration.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SubscriptionIndexTest);
+
+void SubscriptionIndexTest::setUp()
+{
+}
+
+void SubscriptionIndexTest::tearDown()
+{
+}
+
+void SubscriptionIndexTest::testExact()
+{
+	dtn::api::Registration r1, r2;
+	dtn::api::SubscriptionIndex index;
+
+	index.add(dtn::data::EID("dtn://node/app"), &r1);
+	index.add(dtn::data::EID("dtn://node/app"), &r2);
+	index.add(dtn::data::EID("dtn://node/other"), &r2);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, index.size());
+
+	dtn::api::SubscriptionIndex::registration_set ret;
+	index.find(dtn::data::EID("dtn://node/app"), ret);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, ret.size());
+
+	ret.clear();
+	index.find(dtn::data::EID("dtn://node/other"), ret);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, ret.size());
+	CPPUNIT_ASSERT(ret.find(&r2) != ret.end());
+
+	ret.clear();
+	index.find(dtn::data::EID("dtn://node/ap"), ret);
+	CPPUNIT_ASSERT(ret.empty());
+
+	ret.clear();
+	index.find(dtn::data::EID("ipn:1.2"), ret);
+	CPPUNIT_ASSERT(ret.empty());
+}
+
+void SubscriptionIndexTest::testPattern()
+{
+	dtn::api::Registration r1, r2, r3;
+	dtn::api::SubscriptionIndex index;
+
+	// the dots match any character
+	index.add(dtn::data::EID("dtn://node.example/app"), &r1);
+
+	// group subscription with a literal prefix
+	index.add(dtn::data::EID("dtn://group/.*"), &r2);
+
+	// expression without a usable prefix
+	index.add(dtn::data::EID("dtn://[a-zA-Z]*/app"), &r3);
+
+	dtn::api::SubscriptionIndex::registration_set ret;
+	index.find(dtn::data::EID("dtn://node.example/app"), ret);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, ret.size());
+	CPPUNIT_ASSERT(ret.find(&r1) != ret.end());
+	CPPUNIT_ASSERT(ret.find(&r3) == ret.end());
+
+	ret.clear();
+	index.find(dtn::data::EID("dtn://nodeXexample/app"), ret);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, ret.size());
+	CPPUNIT_ASSERT(ret.find(&r1) != ret.end());
+	CPPUNIT_ASSERT(ret.find(&r3) != ret.end());
+
+	ret.clear();
+	index.find(dtn::data::EID("dtn://node.example/app2"), ret);
+	CPPUNIT_ASSERT(ret.empty());
+
+	ret.clear();
+	index.find(dtn::data::EID("dtn://group/foo"), ret);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, ret.size());
+	CPPUNIT_ASSERT(ret.find(&r2) != ret.end());
+
+	ret.clear();
+	index.find(dtn::data::EID("dtn://groups/foo"), ret);
+	CPPUNIT_ASSERT(ret.empty());
+}
+
+void SubscriptionIndexTest::testRemove()
+{
+	dtn::api::Registration r1, r2;
+	dtn::api::SubscriptionIndex index;
+
+	index.add(dtn::data::EID("dtn://group/.*"), &r1);
+	index.add(dtn::data::EID("dtn://group/.*"), &r2);
+	index.add(dtn::data::EID("dtn://group/a.*"), &r2);
+	index.add(dtn::data::EID("dtn://node/app"), &r1);
+	CPPUNIT_ASSERT_EQUAL((size_t)4, index.size());
+
+	index.remove(dtn::data::EID("dtn://group/.*"), &r1);
+	index.remove(dtn::data::EID("dtn://node/app"), &r1);
+
+	// unknown subscriptions are ignored
+	index.remove(dtn::data::EID("dtn://node/app"), &r2);
+	index.remove(dtn::data::EID("dtn://other/.*"), &r2);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, index.size());
+
+	dtn::api::SubscriptionIndex::registration_set ret;
+	index.find(dtn::data::EID("dtn://group/abc"), ret);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, ret.size());
+	CPPUNIT_ASSERT(ret.find(&r2) != ret.end());
+
+	index.remove(dtn::data::EID("dtn://group/.*"), &r2);
+	index.remove(dtn::data::EID("dtn://group/a.*"), &r2);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, index.size());
+
+	ret.clear();
+	index.find(dtn::data::EID("dtn://group/abc"), ret);
+	CPPUNIT_ASSERT(ret.empty());
+}
+
+void SubscriptionIndexTest::testRegistration()
+{
+	dtn::api::Registration *reg = new dtn::api::Registration();
+
+	// drain the initial notification
+	reg->subscribe(dtn::data::EID("dtn://index-test/.*"));
+	reg->wait_for_bundle();
+
+	dtn::api::Registration::notifySubscribers(dtn::data::EID("dtn://index-test/app"), dtn::api::Registration::NOTIFY_NEIGHBOR_AVAILABLE);
+	CPPUNIT_ASSERT_EQUAL(dtn::api::Registration::NOTIFY_NEIGHBOR_AVAILABLE, reg->wait());
+
+	reg->unsubscribe(dtn::data::EID("dtn://index-test/.*"));
+	reg->subscribe(dtn::data::EID("dtn://index-test/app"));
+
+	// not subscribed anymore
+	dtn::api::Registration::notifySubscribers(dtn::data::EID("dtn://index-test/other"), dtn::api::Registration::NOTIFY_NEIGHBOR_AVAILABLE);
+	dtn::api::Registration::notifySubscribers(dtn::data::EID("dtn://index-test/app"), dtn::api::Registration::NOTIFY_SHUTDOWN);
+	CPPUNIT_ASSERT_EQUAL(dtn::api::Registration::NOTIFY_SHUTDOWN, reg->wait());
+
+	// the registration removes itself from the index
+	delete reg;
+	dtn::api::Registration::notifySubscribers(dtn::data::EID("dtn://index-test/app"), dtn::api::Registration::NOTIFY_SHUTDOWN);
+}
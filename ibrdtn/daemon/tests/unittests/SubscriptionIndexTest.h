@@ -0,0 +1,47 @@
+/*
+ * SubscriptionIndexTest.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef SUBSCRIPTIONINDEXTEST_H_
+#define SUBSCRIPTIONINDEXTEST_H_
+
+class SubscriptionIndexTest : public CppUnit::TestFixture
+{
+public:
+	void testExact();
+	void testPattern();
+	void testRemove();
+	void testRegistration();
+
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(SubscriptionIndexTest);
+	CPPUNIT_TEST(testExact);
+	CPPUNIT_TEST(testPattern);
+	CPPUNIT_TEST(testRemove);
+	CPPUNIT_TEST(testRegistration);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif /* SUBSCRIPTIONINDEXTEST_H_ */
@@ -0,0 +1,486 @@
+/*
+ * TCPClTest.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "TCPClTest.h"
+#include "../tools/TestEventListener.h"
+#include "storage/MemoryBundleStorage.h"
+#include "net/ConnectionEvent.h"
+#include "net/BundleTransfer.h"
+#include "routing/QueueBundleEvent.h"
+#include "routing/BaseRouter.h"
+#include "core/BundleCore.h"
+#include "Component.h"
+
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/streams/StreamConnection.h>
+#include <ibrdtn/streams/StreamContactHeader.h>
+#include <ibrdtn/streams/StreamDataSegment.h>
+#include <ibrcommon/data/File.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/net/socket.h>
+#include <ibrcommon/net/socketstream.h>
+#include <ibrcommon/net/vaddress.h>
+#include <ibrcommon/net/vinterface.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/TimeMeasurement.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <list>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TCPClTest);
+
+dtn::storage::BundleStorage* TCPClTest::_storage = NULL;
+
+/**
+ * A TCPCL client based on the blocking StreamConnection
+ */
+class StreamClient : public dtn::streams::StreamConnection::Callback, public ibrcommon::JoinableThread
+{
+public:
+	StreamClient(int port)
+	 : _stream(connect(port)), _conn(*this, _stream, 4096), forwarded(0)
+	{
+		_conn.exceptions(std::ios::badbit | std::ios::eofbit);
+	}
+
+	virtual ~StreamClient()
+	{
+		join();
+	}
+
+	void handshake(const dtn::data::EID &eid)
+	{
+		dtn::data::Bitset<dtn::streams::StreamContactHeader::HEADER_BITS> flags;
+		flags.setBit(dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS, true);
+		flags.setBit(dtn::streams::StreamContactHeader::REQUEST_NEGATIVE_ACKNOWLEDGMENTS, true);
+		_conn.handshake(eid, 10, flags);
+	}
+
+	void send(const dtn::data::Bundle &b)
+	{
+		dtn::data::DefaultSerializer(_conn) << b;
+		_conn << std::flush;
+	}
+
+	void eventShutdown(dtn::streams::StreamConnection::ConnectionShutdownCases) throw () { }
+	void eventTimeout() throw () { }
+	void eventError() throw () { }
+	void eventBundleRefused() throw () { }
+	void eventBundleAck(const dtn::data::Length&) throw () { }
+	void eventConnectionUp(const dtn::streams::StreamContactHeader&) throw () { }
+	void eventConnectionDown() throw () { }
+
+	void eventBundleForwarded() throw ()
+	{
+		ibrcommon::MutexLock l(cond);
+		forwarded++;
+		cond.signal(true);
+	}
+
+	ibrcommon::Conditional cond;
+	unsigned int forwarded;
+	std::list<dtn::data::Bundle> received;
+
+protected:
+	void run() throw ()
+	{
+		try {
+			dtn::data::DefaultDeserializer deserializer(_conn);
+
+			while (_conn.good())
+			{
+				dtn::data::Bundle b;
+				deserializer >> b;
+
+				ibrcommon::MutexLock l(cond);
+				received.push_back(b);
+				cond.signal(true);
+			}
+		} catch (const std::exception&) { };
+	}
+
+	void __cancellation() throw ()
+	{
+		_conn.shutdown(dtn::streams::StreamConnection::CONNECTION_SHUTDOWN_ERROR);
+		_stream.close();
+	}
+
+private:
+	static ibrcommon::clientsocket* connect(int port)
+	{
+		ibrcommon::tcpsocket *sock = new ibrcommon::tcpsocket(ibrcommon::vaddress("127.0.0.1", port));
+		sock->up();
+		return sock;
+	}
+
+	ibrcommon::socketstream _stream;
+	dtn::streams::StreamConnection _conn;
+};
+
+/**
+ * Counts established connections
+ */
+class ConnectionUpListener : public dtn::core::EventReceiver<dtn::net::ConnectionEvent>
+{
+public:
+	ConnectionUpListener() : up(0) {
+		dtn::core::EventDispatcher<dtn::net::ConnectionEvent>::add(this);
+	}
+
+	virtual ~ConnectionUpListener() {
+		dtn::core::EventDispatcher<dtn::net::ConnectionEvent>::remove(this);
+	}
+
+	void raiseEvent(const dtn::net::ConnectionEvent &evt) throw () {
+		if (evt.getState() != dtn::net::ConnectionEvent::CONNECTION_UP) return;
+		ibrcommon::MutexLock l(cond);
+		up++;
+		cond.signal(true);
+	}
+
+	ibrcommon::Conditional cond;
+	unsigned int up;
+};
+
+static std::string procStatus(const std::string &key)
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.compare(0, key.length(), key) == 0)
+		{
+			std::stringstream ss(line.substr(key.length() + 1));
+			std::string value;
+			ss >> value;
+			return value;
+		}
+	}
+	return "?";
+}
+
+static void sendAll(int fd, const std::string &data)
+{
+	size_t pos = 0;
+	while (pos < data.size())
+	{
+		const ssize_t ret = ::send(fd, data.data() + pos, data.size() - pos, 0);
+		CPPUNIT_ASSERT(ret > 0);
+		pos += ret;
+	}
+}
+
+void TCPClTest::setUp() {
+	// create a new event switch
+	_esl = new ibrtest::EventSwitchLoop();
+
+	// enable blob path
+	ibrcommon::File blob_path("/tmp/blobs");
+
+	// check if the BLOB path exists
+	if (!blob_path.exists()) {
+		// try to create the BLOB path
+		ibrcommon::File::createDirectory(blob_path);
+	}
+
+	// enable the blob provider
+	ibrcommon::BLOB::changeProvider(new ibrcommon::FileBLOBProvider(blob_path), true);
+
+	// add standard memory base storage
+	_storage = new dtn::storage::MemoryBundleStorage();
+
+	// make storage globally available
+	dtn::core::BundleCore::getInstance().setStorage(_storage);
+	dtn::core::BundleCore::getInstance().setSeeker(_storage);
+
+	// initialize BundleCore
+	dtn::core::BundleCore::getInstance().initialize();
+
+	// start-up event switch
+	_esl->start();
+
+	try {
+		dtn::daemon::Component &c = dynamic_cast<dtn::daemon::Component&>(*_storage);
+		c.initialize();
+	} catch (const bad_cast&) {
+	}
+
+	// startup BundleCore
+	dtn::core::BundleCore::getInstance().startup();
+
+	try {
+		dtn::daemon::Component &c = dynamic_cast<dtn::daemon::Component&>(*_storage);
+		c.startup();
+	} catch (const bad_cast&) {
+	}
+
+	_cl = NULL;
+}
+
+void TCPClTest::tearDown() {
+	stopCl();
+
+	_esl->stop();
+
+	try {
+		dtn::daemon::Component &c = dynamic_cast<dtn::daemon::Component&>(*_storage);
+		c.terminate();
+	} catch (const bad_cast&) {
+	}
+
+	// shutdown BundleCore
+	dtn::core::BundleCore::getInstance().terminate();
+
+	_esl->join();
+	delete _esl;
+	_esl = NULL;
+
+	// delete storage
+	delete _storage;
+}
+
+void TCPClTest::startCl(size_t reactor_threads, int port) {
+	_cl = new dtn::net::TCPConvergenceLayer(reactor_threads);
+	_cl->add(ibrcommon::vinterface(ibrcommon::vinterface::LOOPBACK), port);
+
+	// add convergence layer to bundle core
+	dtn::core::BundleCore::getInstance().getConnectionManager().add(_cl);
+
+	_cl->initialize();
+	_cl->startup();
+}
+
+void TCPClTest::stopCl() {
+	if (_cl == NULL) return;
+
+	_cl->terminate();
+
+	// remove convergence layer from bundle core
+	dtn::core::BundleCore::getInstance().getConnectionManager().remove(_cl);
+
+	delete _cl;
+	_cl = NULL;
+}
+
+void TCPClTest::threadInteropTest() {
+	interop(0, 4561);
+}
+
+void TCPClTest::reactorInteropTest() {
+	interop(2, 4562);
+}
+
+void TCPClTest::connectionBenchmark() {
+	std::cout << std::endl;
+	benchmark(0, 4563, 100, 20);
+	benchmark(2, 4564, 100, 20);
+}
+
+void TCPClTest::interop(size_t reactor_threads, int port) {
+	startCl(reactor_threads, port);
+
+	// received bundles are checked against the known bundles of the router
+	dtn::routing::BaseRouter router;
+
+	TestEventListener<dtn::routing::QueueBundleEvent> queued_evtl;
+
+	const dtn::data::EID client_eid("dtn://client");
+
+	StreamClient client(port);
+	client.handshake(client_eid);
+	client.start();
+
+	// create a bundle larger than a single segment
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://client/app");
+	b.destination = dtn::data::EID("dtn://node-two/test");
+	b.lifetime = 60;
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	{
+		ibrcommon::BLOB::iostream stream = ref.iostream();
+		for (int i = 0; i < 2000; ++i)
+			(*stream) << "Hallo Welt" << std::endl;
+	}
+
+	client.send(b);
+
+	// wait until the bundle has been received
+	try {
+		ibrcommon::MutexLock l(queued_evtl.event_cond);
+		while (queued_evtl.event_counter == 0) queued_evtl.event_cond.wait(20000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("receive - timeout reached");
+	}
+
+	// wait until the last segment has been acknowledged
+	try {
+		ibrcommon::MutexLock l(client.cond);
+		while (client.forwarded == 0) client.cond.wait(20000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("ack - timeout reached");
+	}
+
+	CPPUNIT_ASSERT(_storage->contains(b));
+
+	// send a bundle to the client
+	dtn::data::Bundle r;
+	r.source = dtn::data::EID("dtn://node-two/app");
+	r.destination = dtn::data::EID("dtn://client/test");
+	r.lifetime = 60;
+	r.push_back(ref);
+	_storage->store(r);
+
+	_cl->queue(dtn::core::Node(client_eid), dtn::net::BundleTransfer(client_eid, dtn::data::MetaBundle::create(r), dtn::core::Node::CONN_TCPIP));
+
+	try {
+		ibrcommon::MutexLock l(client.cond);
+		while (client.received.empty()) client.cond.wait(20000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("transmit - timeout reached");
+	}
+
+	CPPUNIT_ASSERT(client.received.front() == r);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Length)ref.size(), client.received.front().find<dtn::data::PayloadBlock>().getLength());
+
+	client.stop();
+	client.join();
+
+	stopCl();
+}
+
+void TCPClTest::benchmark(size_t reactor_threads, int port, size_t connections, size_t bundles) {
+	// received bundles are checked against the known bundles of the router
+	dtn::routing::BaseRouter router;
+
+	TestEventListener<dtn::routing::QueueBundleEvent> queued_evtl;
+	ConnectionUpListener up_evtl;
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	{
+		ibrcommon::BLOB::iostream stream = ref.iostream();
+		for (int i = 0; i < 100; ++i)
+			(*stream) << "Hallo Welt" << std::endl;
+	}
+
+	// prepare contact headers and bundles in segments
+	std::vector<std::string> headers;
+	std::vector<std::string> data;
+
+	for (size_t i = 0; i < connections; ++i)
+	{
+		std::stringstream eid; eid << "dtn://bench-" << i;
+
+		dtn::streams::StreamContactHeader header(dtn::data::EID(eid.str()));
+		header._keepalive = 10;
+		header._flags = dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS;
+
+		std::stringstream hs;
+		hs << header;
+		headers.push_back(hs.str());
+
+		std::stringstream ds;
+		for (size_t k = 0; k < bundles; ++k)
+		{
+			dtn::data::Bundle b;
+			b.source = dtn::data::EID(eid.str() + "/app");
+			b.destination = dtn::data::EID("dtn://node-two/test");
+			b.lifetime = 60;
+			b.push_back(ref);
+
+			std::stringstream bs;
+			dtn::data::DefaultSerializer(bs) << b;
+			const std::string bundle = bs.str();
+
+			dtn::streams::StreamDataSegment seg(dtn::streams::StreamDataSegment::MSG_DATA_SEGMENT, bundle.size());
+			seg._flags = dtn::streams::StreamDataSegment::MSG_MARK_BEGINN | dtn::streams::StreamDataSegment::MSG_MARK_END;
+			ds << seg << bundle;
+		}
+		data.push_back(ds.str());
+	}
+
+	const std::string rss_before = procStatus("VmRSS");
+
+	startCl(reactor_threads, port);
+
+	// open all connections
+	std::vector<ibrcommon::tcpsocket*> sockets;
+	for (size_t i = 0; i < connections; ++i)
+	{
+		ibrcommon::tcpsocket *sock = new ibrcommon::tcpsocket(ibrcommon::vaddress("127.0.0.1", port));
+		sock->up();
+		sendAll(sock->fd(), headers[i]);
+		sockets.push_back(sock);
+	}
+
+	// wait until all connections are up
+	try {
+		ibrcommon::MutexLock l(up_evtl.cond);
+		while (up_evtl.up < connections) up_evtl.cond.wait(20000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("connection setup - timeout reached");
+	}
+
+	const std::string rss_up = procStatus("VmRSS");
+	const std::string threads_up = procStatus("Threads");
+
+	ibrcommon::TimeMeasurement tm;
+	tm.start();
+
+	for (size_t i = 0; i < connections; ++i)
+	{
+		sendAll(sockets[i]->fd(), data[i]);
+	}
+
+	// wait until all bundles are received
+	try {
+		ibrcommon::MutexLock l(queued_evtl.event_cond);
+		while (queued_evtl.event_counter < (connections * bundles)) queued_evtl.event_cond.wait(60000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("receive - timeout reached");
+	}
+
+	tm.stop();
+
+	const double rate = static_cast<double>(connections * bundles) / (static_cast<double>(tm.getMicroseconds()) / 1000000.0);
+
+	std::cout << (reactor_threads == 0 ? "thread per connection" : "reactor") << ": "
+			<< connections << " connections, " << threads_up << " threads, VmRSS " << rss_before << " kB -> " << rss_up << " kB, "
+			<< (connections * bundles) << " bundles in " << tm << " (" << static_cast<size_t>(rate) << " bundles/s)" << std::endl;
+
+	for (std::vector<ibrcommon::tcpsocket*>::iterator iter = sockets.begin(); iter != sockets.end(); ++iter)
+	{
+		delete (*iter);
+	}
+
+	stopCl();
+}
@@ -31,7 +31,7 @@ namespace dtn
 	namespace data
 	{
 		Bundle::Bundle(bool zero_timestamp)
-		 : PrimaryBlock(zero_timestamp)
+		 : PrimaryBlock(zero_timestamp), _blocks(new block_list())
 		{
 			// if the timestamp is not set, add a ageblock
 			if (timestamp == 0)
@@ -43,27 +43,36 @@ namespace dtn
 
 		Bundle::~Bundle()
 		{
-			clear();
+		}
+
+		void Bundle::detach()
+		{
+			if (_blocks.unique()) return;
+
+			// the blocks itself are still shared with the copies
+			_blocks = refcnt_ptr<block_list>(new block_list(*_blocks));
 		}
 
 		Bundle::iterator Bundle::begin()
 		{
-			return _blocks.begin();
+			detach();
+			return _blocks->begin();
 		}
 
 		Bundle::iterator Bundle::end()
 		{
-			return _blocks.end();
+			detach();
+			return _blocks->end();
 		}
 
 		Bundle::const_iterator Bundle::begin() const
 		{
-			return _blocks.begin();
+			return _blocks->begin();
 		}
 
 		Bundle::const_iterator Bundle::end() const
 		{
-			return _blocks.end();
+			return _blocks->end();
 		}
 
 		bool Bundle::operator==(const BundleID& other) const
@@ -113,7 +122,7 @@ namespace dtn
 		{
 			for (iterator it = b; it != e;)
 			{
-				_blocks.erase(it++);
+				_blocks->erase(it++);
 			}
 
 			if (size() > 0) {
@@ -126,7 +135,7 @@ namespace dtn
 
 		void Bundle::erase(iterator it)
 		{
-			_blocks.erase(it);
+			_blocks->erase(it);
 
 			if (size() > 0) {
 				// set the last block bit
@@ -138,7 +147,9 @@ namespace dtn
 
 		void Bundle::clear()
 		{
-			_blocks.clear();
+			// do not copy the blocks to drop them
+			if (_blocks.unique()) _blocks->clear();
+			else _blocks = refcnt_ptr<block_list>(new block_list());
 		}
 
 		dtn::data::PayloadBlock& Bundle::insert(iterator before, ibrcommon::BLOB::Reference &ref)
@@ -153,7 +164,7 @@ namespace dtn
 			dtn::data::PayloadBlock *tmpblock = new dtn::data::PayloadBlock(ref);
 			block_elem block( static_cast<dtn::data::Block*>(tmpblock) );
 
-			_blocks.insert(before, block);
+			_blocks->insert(before, block);
 
 			// set the last block bit
 			iterator last = end();
@@ -165,9 +176,11 @@ namespace dtn
 
 		dtn::data::PayloadBlock& Bundle::push_front(ibrcommon::BLOB::Reference &ref)
 		{
+			detach();
+
 			dtn::data::PayloadBlock *tmpblock = new dtn::data::PayloadBlock(ref);
 			block_elem block( static_cast<dtn::data::Block*>(tmpblock) );
-			_blocks.push_front(block);
+			_blocks->push_front(block);
 
 			// if this was the first element
 			if (size() == 1)
@@ -183,6 +196,8 @@ namespace dtn
 
 		dtn::data::PayloadBlock& Bundle::push_back(ibrcommon::BLOB::Reference &ref)
 		{
+			detach();
+
 			if (size() > 0) {
 				// remove the last block bit
 				iterator last = end();
@@ -192,7 +207,7 @@ namespace dtn
 
 			dtn::data::PayloadBlock *tmpblock = new dtn::data::PayloadBlock(ref);
 			block_elem block( static_cast<dtn::data::Block*>(tmpblock) );
-			_blocks.push_back(block);
+			_blocks->push_back(block);
 
 			// set the last block bit
 			block->set(dtn::data::Block::LAST_BLOCK, true);
@@ -202,8 +217,10 @@ namespace dtn
 
 		dtn::data::Block& Bundle::push_front(dtn::data::ExtensionBlock::Factory &factory)
 		{
+			detach();
+
 			block_elem block( factory.create() );
-			_blocks.push_front(block);
+			_blocks->push_front(block);
 
 			// if this was the first element
 			if (size() == 1)
@@ -219,6 +236,8 @@ namespace dtn
 
 		dtn::data::Block& Bundle::push_back(dtn::data::ExtensionBlock::Factory &factory)
 		{
+			detach();
+
 			if (size() > 0) {
 				// remove the last block bit
 				iterator last = end();
@@ -227,7 +246,7 @@ namespace dtn
 			}
 
 			block_elem block( factory.create() );
-			_blocks.push_back(block);
+			_blocks->push_back(block);
 
 			// set the last block bit
 			block->set(dtn::data::Block::LAST_BLOCK, true);
@@ -245,7 +264,7 @@ namespace dtn
 			}
 
 			block_elem block( factory.create() );
-			_blocks.insert(before, block);
+			_blocks->insert(before, block);
 
 			// set the last block bit
 			iterator last = end();
@@ -257,7 +276,7 @@ namespace dtn
 
 		Size Bundle::size() const
 		{
-			return _blocks.size();
+			return _blocks->size();
 		}
 
 		bool Bundle::allEIDsInCBHE() const
@@ -49,6 +49,12 @@ namespace dtn
 		class MetaBundle;
 		class BundleID;
 
+		/**
+		 * A bundle shares its list of blocks with all of its copies. The list
+		 * is copied when one of the copies is modified or a non-const iterator
+		 * is requested. Thus, iterators obtained before a bundle is copied
+		 * must not be used to modify the bundle afterwards.
+		 */
 		class Bundle : public PrimaryBlock
 		{
 			friend class BundleBuilder;
@@ -138,7 +144,12 @@ namespace dtn
 			dtn::data::Length getPayloadLength() const;
 
 		private:
-			block_list _blocks;
+			/**
+			 * Make the list of blocks exclusive to this bundle
+			 */
+			void detach();
+
+			refcnt_ptr<block_list> _blocks;
 		};
 
 		template<class T>
@@ -160,9 +171,11 @@ namespace dtn
 		template<class T>
 		T& Bundle::push_front()
 		{
+			detach();
+
 			T *tmpblock = new T();
 			block_elem block( static_cast<dtn::data::Block*>(tmpblock) );
-			_blocks.push_front(block);
+			_blocks->push_front(block);
 
 			// if this was the first element
 			if (size() == 1)
@@ -179,6 +192,8 @@ namespace dtn
 		template<class T>
 		T& Bundle::push_back()
 		{
+			detach();
+
 			if (size() > 0) {
 				// remove the last block bit
 				iterator last = end();
@@ -188,7 +203,7 @@ namespace dtn
 
 			T *tmpblock = new T();
 			block_elem block( static_cast<dtn::data::Block*>(tmpblock) );
-			_blocks.push_back(block);
+			_blocks->push_back(block);
 
 			// set the last block bit
 			block->set(dtn::data::Block::LAST_BLOCK, true);
@@ -208,7 +223,7 @@ namespace dtn
 
 			T *tmpblock = new T();
 			block_elem block( static_cast<dtn::data::Block*>(tmpblock) );
-			_blocks.insert(before, block);
+			_blocks->insert(before, block);
 
 			// set the last block bit
 			iterator last = end();
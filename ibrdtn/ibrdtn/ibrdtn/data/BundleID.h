@@ -77,8 +77,12 @@ namespace dtn
 			 */
 			size_t raw(unsigned char *data, size_t len) const;
 
-		private:
+			/**
+			 * Maximum length of the RAW data array
+			 */
 			static const unsigned int RAW_LENGTH_MAX;
+
+		private:
 			bool _fragment;
 			dtn::data::Length _payloadlength;
 		};
@@ -26,6 +26,7 @@
 #include "ibrdtn/data/Exceptions.h"
 #include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/Logger.h>
+#include <algorithm>
 
 namespace dtn
 {
@@ -118,20 +119,39 @@ namespace dtn
 				c._initialized = true;
 			}
 
-			ibrcommon::BLOB::iostream stream = c._blob.iostream();
-			(*stream).seekp(obj.fragmentoffset.get<std::streampos>());
-
 			const dtn::data::PayloadBlock &p = obj.find<dtn::data::PayloadBlock>();
 			const Length plength = p.getLength();
+			const Length offset = obj.fragmentoffset.get<dtn::data::Length>();
 
 			// skip write operation if chunk is already in the merged bundle
-			if (c.contains(obj.fragmentoffset.get<dtn::data::Length>(), plength)) return c;
+			if (c.contains(offset, plength)) return c;
 
-			// copy payload of the fragment into the new blob
+			// copy the ranges of the fragment payload which are not merged yet into the new blob
 			{
+				ibrcommon::BLOB::iostream stream = c._blob.iostream();
 				ibrcommon::BLOB::Reference ref = p.getBLOB();
 				ibrcommon::BLOB::iostream s = ref.iostream();
-				(*stream) << (*s).rdbuf() << std::flush;
+
+				const Length end = offset + plength;
+				Length pos = offset;
+
+				for (std::set<BundleMerger::Chunk>::const_iterator iter = c._chunks.begin(); iter != c._chunks.end(); ++iter)
+				{
+					const BundleMerger::Chunk &chunk = (*iter);
+					const Length chunk_end = chunk.offset + chunk.length;
+
+					if (chunk.offset >= end) break;
+					if (chunk_end <= pos) continue;
+
+					if (chunk.offset > pos) BundleMerger::Container::copy(*s, pos - offset, *stream, pos, chunk.offset - pos);
+					pos = chunk_end;
+
+					if (pos >= end) break;
+				}
+
+				if (pos < end) BundleMerger::Container::copy(*s, pos - offset, *stream, pos, end - pos);
+
+				(*stream) << std::flush;
 			}
 
 			// add the chunk to the list of chunks
@@ -224,6 +244,44 @@ namespace dtn
 			return c;
 		}
 
+		void BundleMerger::Container::copy(std::istream &in, Length in_offset, std::ostream &out, Length out_offset, Length length)
+		{
+			char buf[4096];
+
+			in.seekg(in_offset);
+
+			// not all streams are able to seek behind the end, fill the gap instead
+			out.seekp(0, std::ios::end);
+			std::streampos size = out.tellp();
+
+			if (size < static_cast<std::streampos>(out_offset))
+			{
+				std::fill(buf, buf + sizeof(buf), 0);
+
+				for (Length gap = out_offset - size; gap > 0;)
+				{
+					const std::streamsize chunk = static_cast<std::streamsize>((gap < sizeof(buf)) ? gap : sizeof(buf));
+					out.write(buf, chunk);
+					gap -= static_cast<Length>(chunk);
+				}
+			}
+			else
+			{
+				out.seekp(out_offset);
+			}
+
+			while (length > 0)
+			{
+				const std::streamsize chunk = static_cast<std::streamsize>((length < sizeof(buf)) ? length : sizeof(buf));
+				in.read(buf, chunk);
+
+				if (in.gcount() != chunk) throw ibrcommon::Exception("Fragment payload is shorter than announced.");
+
+				out.write(buf, chunk);
+				length -= static_cast<Length>(chunk);
+			}
+		}
+
 		BundleMerger::Container BundleMerger::getContainer()
 		{
 			ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
@@ -264,7 +322,11 @@ namespace dtn
 				// if the next offset is too small, we do not got all fragments
 				if (chunk.offset > position) return false;
 
-				position = chunk.offset + chunk.length;
+				// chunks contained in a previous one do not move the position
+				if (chunk.offset + chunk.length > position)
+				{
+					position = chunk.offset + chunk.length;
+				}
 			}
 
 			// return true, if we reached the application data length
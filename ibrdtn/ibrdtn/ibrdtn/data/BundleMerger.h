@@ -25,6 +25,7 @@
 #include "ibrcommon/data/BLOB.h"
 #include "ibrdtn/data/Bundle.h"
 #include <set>
+#include <iostream>
 
 namespace dtn
 {
@@ -62,6 +63,11 @@ namespace dtn
 				bool contains(Length offset, Length length) const;
 				void add(Length offset, Length length);
 
+				/**
+				 * Copy a range of data from one stream into another
+				 */
+				static void copy(std::istream &in, Length in_offset, std::ostream &out, Length out_offset, Length length);
+
 				dtn::data::Bundle _bundle;
 				ibrcommon::BLOB::Reference _blob;
 				bool _initialized;
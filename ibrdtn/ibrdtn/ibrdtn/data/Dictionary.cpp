@@ -23,16 +23,16 @@
 #include "ibrdtn/data/Number.h"
 #include "ibrdtn/data/Exceptions.h"
 #include "ibrdtn/data/Bundle.h"
-#include <map>
-#include <stdexcept>
+#include <algorithm>
 #include <iostream>
-#include <vector>
+#include <cstring>
 
 namespace dtn
 {
 	namespace data
 	{
 		Dictionary::Dictionary()
+		 : _index(16, 0), _entries(0), _ref_index(16, 0)
 		{
 		}
 
@@ -40,13 +40,14 @@ namespace dtn
 		 * create a dictionary with all EID of the given bundle
 		 */
 		Dictionary::Dictionary(const dtn::data::Bundle &bundle)
+		 : _index(16, 0), _entries(0), _ref_index(16, 0)
 		{
 			add(bundle);
 		}
 
 		Dictionary::Dictionary(const Dictionary &d)
+		 : _bytes(d._bytes), _index(d._index), _entries(d._entries), _refs(d._refs), _ref_index(d._ref_index)
 		{
-			this->operator=(d);
 		}
 
 		/**
@@ -54,7 +55,11 @@ namespace dtn
 		 */
 		Dictionary& Dictionary::operator=(const Dictionary &d)
 		{
-			_bytestream.str(d._bytestream.str());
+			_bytes = d._bytes;
+			_index = d._index;
+			_entries = d._entries;
+			_refs = d._refs;
+			_ref_index = d._ref_index;
 			return (*this);
 		}
 
@@ -62,75 +67,151 @@ namespace dtn
 		{
 		}
 
-		Number Dictionary::get(const std::string &value) const throw (EntryNotFoundException)
+		size_t Dictionary::hash(const char *data, size_t length)
 		{
-			std::string bytes = _bytestream.str();
-			const char *bytebegin = bytes.c_str();
-			const char *bytepos = bytebegin;
-			const char *byteend = bytebegin + bytes.length() + 1;
+			// FNV-1a
+			size_t h = 2166136261U;
+			for (size_t i = 0; i < length; ++i)
+			{
+				h = (h ^ static_cast<unsigned char>(data[i])) * 16777619U;
+			}
+			return h;
+		}
 
-			if (bytes.length() <= 0) throw EntryNotFoundException();
+		size_t Dictionary::find(const char *data, size_t length, size_t h) const
+		{
+			const size_t mask = _index.size() - 1;
+			size_t slot = h & mask;
 
-			while (bytepos < byteend)
+			while (_index[slot] != 0)
 			{
-				std::string dictstr(bytepos);
+				const Size offset = _index[slot] - 1;
 
-				if (dictstr == value)
+				if ((offset + length < _bytes.size()) && (_bytes[offset + length] == '\0')
+						&& (_bytes.compare(offset, length, data, length) == 0))
 				{
-					return bytepos - bytebegin;
+					break;
 				}
 
-				bytepos += dictstr.length() + 1;
+				slot = (slot + 1) & mask;
+			}
+
+			return slot;
+		}
+
+		void Dictionary::grow()
+		{
+			std::vector<Size> index(_index.size() * 2, 0);
+			const size_t mask = index.size() - 1;
+
+			for (std::vector<Size>::const_iterator it = _index.begin(); it != _index.end(); ++it)
+			{
+				if ((*it) == 0) continue;
+
+				const char *data = _bytes.c_str() + (*it) - 1;
+				size_t slot = hash(data, ::strlen(data)) & mask;
+				while (index[slot] != 0) slot = (slot + 1) & mask;
+				index[slot] = (*it);
 			}
 
-			 throw EntryNotFoundException();
+			_index.swap(index);
 		}
 
-		bool Dictionary::exists(const std::string &value) const
+		Size Dictionary::add(const std::string &value)
 		{
-			std::string bytes = _bytestream.str();
-			const char *bytepos = bytes.c_str();
-			const char *byteend = bytepos + bytes.length();
+			const size_t slot = find(value.c_str(), value.length(), hash(value.c_str(), value.length()));
+
+			// return the offset of an existing entry
+			if (_index[slot] != 0) return _index[slot] - 1;
+
+			const Size offset = _bytes.size();
+			_bytes.append(value);
+			_bytes.push_back('\0');
 
-			if (bytes.length() <= 0) return false;
+			_index[slot] = offset + 1;
+			if (++_entries * 2 > _index.size()) grow();
 
-			while (bytepos < byteend)
+			return offset;
+		}
+
+		void Dictionary::reindex()
+		{
+			std::fill(_index.begin(), _index.end(), 0);
+			_entries = 0;
+
+			Size offset = 0;
+			while (offset < _bytes.size())
 			{
-				std::string dictstr(bytepos);
+				const size_t end = _bytes.find('\0', offset);
 
-				if (dictstr == value)
+				// ignore trailing bytes without termination
+				if (end == std::string::npos) break;
+
+				const size_t slot = find(_bytes.c_str() + offset, end - offset, hash(_bytes.c_str() + offset, end - offset));
+
+				// keep the first occurrence of duplicate entries
+				if (_index[slot] == 0)
 				{
-					return true;
+					_index[slot] = offset + 1;
+					if (++_entries * 2 > _index.size()) grow();
 				}
 
-				bytepos += dictstr.length() + 1;
+				offset = end + 1;
+			}
+		}
+
+		size_t Dictionary::findRef(const EID &eid) const
+		{
+			const size_t mask = _ref_index.size() - 1;
+			size_t slot = eid.hash() & mask;
+
+			while ((_ref_index[slot] != 0) && (_refs[_ref_index[slot] - 1].first != eid))
+			{
+				slot = (slot + 1) & mask;
 			}
 
-			return false;
+			return slot;
 		}
 
-		void Dictionary::add(const std::string &value)
+		void Dictionary::growRefs()
 		{
-			if (!exists(value))
+			_ref_index.assign(_ref_index.size() * 2, 0);
+			const size_t mask = _ref_index.size() - 1;
+
+			for (size_t i = 0; i < _refs.size(); ++i)
 			{
-				_bytestream << value << '\0';
+				size_t slot = _refs[i].first.hash() & mask;
+				while (_ref_index[slot] != 0) slot = (slot + 1) & mask;
+				_ref_index[slot] = i + 1;
 			}
 		}
 
+		size_t Dictionary::addRef(const EID &eid)
+		{
+			const size_t slot = findRef(eid);
+			if (_ref_index[slot] != 0) return _ref_index[slot] - 1;
+
+			const Size scheme = add(eid.getScheme());
+			const Size ssp = add(eid.getSSP());
+
+			_refs.push_back(std::make_pair(eid, Reference(scheme, ssp)));
+			_ref_index[slot] = _refs.size();
+
+			if (_refs.size() * 2 > _ref_index.size()) growRefs();
+
+			return _refs.size() - 1;
+		}
+
 		void Dictionary::add(const EID &eid)
 		{
-			add(eid.getScheme());
-			add(eid.getSSP());
+			addRef(eid);
 		}
 
 		void Dictionary::add(const list<EID> &eids)
 		{
-			list<EID>::const_iterator iter = eids.begin();
-
-			while (iter != eids.end())
+			for (list<EID>::const_iterator iter = eids.begin(); iter != eids.end(); ++iter)
 			{
-				add(*iter);
-				++iter;
+				addRef(*iter);
 			}
 		}
 
@@ -150,43 +231,86 @@ namespace dtn
 			}
 		}
 
-		EID Dictionary::get(const Number &scheme, const Number &ssp)
+		bool Dictionary::equals(const Bundle &bundle) const
 		{
-			char buffer[1024];
+			if (_refs.empty()) return false;
+
+			std::vector<bool> seen(_refs.size(), false);
+			size_t count = 0;
 
-			_bytestream.seekg(scheme.get<std::streampos>());
-			_bytestream.get(buffer, 1024, '\0');
-			std::string scheme_str(buffer);
+			const EID *primary[] = { &bundle.destination, &bundle.source, &bundle.reportto, &bundle.custodian };
 
-			_bytestream.seekg(ssp.get<std::streampos>());
-			_bytestream.get(buffer, 1024, '\0');
-			std::string ssp_str(buffer);
+			for (size_t i = 0; i < 4; ++i)
+			{
+				const size_t slot = findRef(*primary[i]);
+				if (_ref_index[slot] == 0) return false;
+				if (!seen[_ref_index[slot] - 1]) { seen[_ref_index[slot] - 1] = true; count++; }
+			}
 
-			return EID(scheme_str, ssp_str);
+			for (Bundle::const_iterator iter = bundle.begin(); iter != bundle.end(); ++iter)
+			{
+				const Block::eid_list &eids = (**iter).getEIDList();
+				for (Block::eid_list::const_iterator it = eids.begin(); it != eids.end(); ++it)
+				{
+					const size_t slot = findRef(*it);
+					if (_ref_index[slot] == 0) return false;
+					if (!seen[_ref_index[slot] - 1]) { seen[_ref_index[slot] - 1] = true; count++; }
+				}
+			}
+
+			// there must not be any additional entry
+			return (count == _refs.size());
+		}
+
+		EID Dictionary::get(const Number &scheme, const Number &ssp)
+		{
+			const Size scheme_offset = scheme.get<Size>();
+			const Size ssp_offset = ssp.get<Size>();
+
+			if ((scheme_offset >= _bytes.size()) || (ssp_offset >= _bytes.size()))
+				throw EntryNotFoundException();
+
+			// the buffer is always zero-terminated by c_str()
+			return EID(std::string(_bytes.c_str() + scheme_offset), std::string(_bytes.c_str() + ssp_offset));
 		}
 
 		void Dictionary::clear()
 		{
-			_bytestream.str("");
+			_bytes.clear();
+			std::fill(_index.begin(), _index.end(), 0);
+			_entries = 0;
+			_refs.clear();
+			std::fill(_ref_index.begin(), _ref_index.end(), 0);
 		}
 
 		Size Dictionary::getSize() const
 		{
-			return _bytestream.str().length();
+			return _bytes.size();
 		}
 
 		dtn::data::Dictionary::Reference Dictionary::getRef(const EID &eid) const
 		{
+			// use the cached reference of added EIDs
+			const size_t ref_slot = findRef(eid);
+			if (_ref_index[ref_slot] != 0) return _refs[_ref_index[ref_slot] - 1].second;
+
 			const std::string scheme = eid.getScheme();
 			const std::string ssp = eid.getSSP();
-			return make_pair(get(scheme), get(ssp));
+
+			const size_t scheme_slot = find(scheme.c_str(), scheme.length(), hash(scheme.c_str(), scheme.length()));
+			if (_index[scheme_slot] == 0) throw EntryNotFoundException();
+
+			const size_t ssp_slot = find(ssp.c_str(), ssp.length(), hash(ssp.c_str(), ssp.length()));
+			if (_index[ssp_slot] == 0) throw EntryNotFoundException();
+
+			return make_pair(Number(_index[scheme_slot] - 1), Number(_index[ssp_slot] - 1));
 		}
 
 		std::ostream &operator<<(std::ostream &stream, const dtn::data::Dictionary &obj)
 		{
 			dtn::data::Number length(obj.getSize());
 			stream << length;
-			stream << obj._bytestream.str();
+			stream.write(obj._bytes.data(), obj._bytes.size());
 
 			return stream;
 		}
@@ -200,10 +324,10 @@ namespace dtn
 			if (length == 0)
 				throw dtn::InvalidDataException("Dictionary size is zero!");
 
-			obj._bytestream.str("");
-			std::vector<char> data(length.get<size_t>());
-			stream.read(&data[0], data.size());
-			obj._bytestream.write(&data[0], data.size());
+			obj.clear();
+			obj._bytes.resize(length.get<size_t>());
+			stream.read(&obj._bytes[0], obj._bytes.size());
+			obj.reindex();
 
 			return stream;
 		}
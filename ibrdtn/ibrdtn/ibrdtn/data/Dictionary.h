@@ -27,8 +27,8 @@
 #include "ibrdtn/data/EID.h"
 #include "ibrdtn/data/Number.h"
 #include <list>
-#include <sstream>
-#include <list>
+#include <string>
+#include <vector>
 #include <stdint.h>
 
 namespace dtn
@@ -37,6 +37,12 @@ namespace dtn
 	{
 		class Bundle;
 
+		/**
+		 * The dictionary of a bundle. All entries are stored in one contiguous
+		 * buffer and indexed by a hash table of their offsets. References of
+		 * added EIDs are cached, so a lookup of an EID does not create any
+		 * string.
+		 */
 		class Dictionary
 		{
 		public:
@@ -109,15 +115,60 @@ namespace dtn
 			typedef std::pair<Number, Number> Reference;
 			Reference getRef(const EID &eid) const;
 
+			/**
+			 * Returns true, if the dictionary contains exactly the
+			 * EIDs of the given bundle.
+			 */
+			bool equals(const Bundle &bundle) const;
+
 			friend std::ostream &operator<<(std::ostream &stream, const dtn::data::Dictionary &obj);
 			friend std::istream &operator>>(std::istream &stream, dtn::data::Dictionary &obj);
 
 		private:
-			bool exists(const std::string&) const;
-			void add(const std::string&);
-			Number get(const std::string&) const throw (EntryNotFoundException);
+			typedef std::pair<EID, Reference> ref_entry;
+
+			/**
+			 * add a string and return its offset
+			 */
+			Size add(const std::string&);
+
+			/**
+			 * add an EID and return the position of its reference
+			 */
+			size_t addRef(const EID &eid);
+
+			/**
+			 * search for a string, returns the slot of the index
+			 */
+			size_t find(const char *data, size_t length, size_t hash) const;
+
+			/**
+			 * search for a cached EID reference, returns the slot of the index
+			 */
+			size_t findRef(const EID &eid) const;
+
+			/**
+			 * rebuild the index of all entries in the buffer
+			 */
+			void reindex();
+
+			void grow();
+			void growRefs();
+
+			static size_t hash(const char *data, size_t length);
+
+			// contiguous buffer of zero-terminated entries
+			std::string _bytes;
+
+			// hash table with (offset + 1) of each entry, zero marks a free slot
+			std::vector<Size> _index;
+			size_t _entries;
+
+			// cached references of added EIDs
+			std::vector<ref_entry> _refs;
 
-			std::stringstream _bytestream;
+			// hash table with (position + 1) of each cached reference
+			std::vector<size_t> _ref_index;
 		};
 	}
 }
@@ -22,8 +22,10 @@
 #include "ibrdtn/config.h"
 #include "ibrdtn/data/EID.h"
 #include "ibrdtn/utils/Utils.h"
+#include <ibrcommon/thread/MutexLock.h>
 #include <sstream>
 #include <iostream>
+#include <vector>
 
 #include <ibrcommon/ibrcommon.h>
 #ifdef IBRCOMMON_SUPPORT_SSL
@@ -185,47 +187,292 @@ namespace dtn
 #endif
 		}
 
+		/**
+		 * Interned values of an EID. Entries are immutable, reference
+		 * counted and unique within the table.
+		 */
+		class EID::Entry
+		{
+		public:
+			Entry(const Scheme t, const std::string &s, const std::string &p, const std::string &a, const Number &n, const Number &na, const size_t h)
+			 : scheme_type(t), scheme(s), ssp(p), application(a), cbhe_node(n), cbhe_application(na), hash(h), refcount(1), next(NULL)
+			{
+				std::stringstream ss;
+
+				switch (scheme_type) {
+				case SCHEME_CBHE:
+					ss << getSchemeName(SCHEME_CBHE) << ":" << cbhe_node.get<size_t>();
+					ss << "." << cbhe_application.get<size_t>();
+					break;
+
+				case SCHEME_DTN:
+					ss << getSchemeName(SCHEME_DTN) << ":" << ssp;
+
+					if (application.length() > 0) {
+						ss << "/" << application;
+					}
+					break;
+
+				default:
+					ss << scheme << ":" << ssp;
+					break;
+				}
+
+				str = ss.str();
+			}
+
+			bool equals(const Scheme t, const std::string &s, const std::string &p, const std::string &a, const Number &n, const Number &na) const
+			{
+				return (scheme_type == t) && (cbhe_node == n) && (cbhe_application == na)
+						&& (ssp == p) && (application == a) && (scheme == s);
+			}
+
+			const Scheme scheme_type;
+			const std::string scheme;
+
+			// the ssp carries the node part of the DTN scheme
+			const std::string ssp;
+			const std::string application;
+
+			const Number cbhe_node;
+			const Number cbhe_application;
+
+			const size_t hash;
+
+			// cached string representation
+			std::string str;
+
+			size_t refcount;
+			Entry *next;
+		};
+
+		/**
+		 * Global hash table of all interned EID entries
+		 */
+		class EID::Table
+		{
+		public:
+			static Table& getInstance()
+			{
+				// the table is never freed, because static EIDs
+				// may be destroyed after the table
+				static Table *table = new Table();
+				return *table;
+			}
+
+			const Entry* intern(const Scheme t, const std::string &s, const std::string &p, const std::string &a, const Number &n, const Number &na)
+			{
+				const size_t h = hash(t, s, p, a, n, na);
+
+				ibrcommon::MutexLock l(_lock);
+
+				for (Entry *e = _buckets[h & (_buckets.size() - 1)]; e != NULL; e = e->next)
+				{
+					if ((e->hash == h) && e->equals(t, s, p, a, n, na)) {
+						__sync_add_and_fetch(&e->refcount, 1);
+						return e;
+					}
+				}
+
+				Entry *e = new Entry(t, s, p, a, n, na, h);
+				Entry *&bucket = _buckets[h & (_buckets.size() - 1)];
+				e->next = bucket;
+				bucket = e;
+
+				if (++_size > _buckets.size()) grow();
+
+				return e;
+			}
+
+			const Entry* acquire(const Entry *e)
+			{
+				__sync_add_and_fetch(&const_cast<Entry*>(e)->refcount, 1);
+				return e;
+			}
+
+			void release(const Entry *entry)
+			{
+				Entry *e = const_cast<Entry*>(entry);
+
+				// drop references without locking as long as this is not the last one
+				size_t ref = e->refcount;
+				while (ref > 1)
+				{
+					const size_t cur = __sync_val_compare_and_swap(&e->refcount, ref, ref - 1);
+					if (cur == ref) return;
+					ref = cur;
+				}
+
+				// the last reference is only dropped while holding the lock
+				// to avoid races with concurrent lookups of the same entry
+				ibrcommon::MutexLock l(_lock);
+				if (__sync_sub_and_fetch(&e->refcount, 1) > 0) return;
+
+				Entry **prev = &_buckets[e->hash & (_buckets.size() - 1)];
+				while (*prev != e) prev = &(*prev)->next;
+				*prev = e->next;
+				_size--;
+
+				delete e;
+			}
+
+			const Entry* none()
+			{
+				return acquire(_none);
+			}
+
+			size_t size()
+			{
+				ibrcommon::MutexLock l(_lock);
+				return _size;
+			}
+
+		private:
+			Table()
+			 : _buckets(64, NULL), _size(0), _none(NULL)
+			{
+				// keep a permanent reference to dtn:none
+				_none = intern(SCHEME_DTN, "", "none", "", 0, 0);
+			}
+
+			static size_t hash(const Scheme t, const std::string &s, const std::string &p, const std::string &a, const Number &n, const Number &na)
+			{
+				// FNV-1a
+				size_t h = 2166136261U;
+				h = (h ^ static_cast<size_t>(t)) * 16777619U;
+				h = (h ^ n.get<size_t>()) * 16777619U;
+				h = (h ^ na.get<size_t>()) * 16777619U;
+
+				const std::string *fields[] = { &s, &p, &a };
+				for (size_t i = 0; i < 3; ++i)
+				{
+					const std::string &f = *fields[i];
+					for (std::string::const_iterator it = f.begin(); it != f.end(); ++it)
+					{
+						h = (h ^ static_cast<unsigned char>(*it)) * 16777619U;
+					}
+					h = (h ^ 0xff) * 16777619U;
+				}
+
+				return h;
+			}
+
+			void grow()
+			{
+				std::vector<Entry*> buckets(_buckets.size() * 2, NULL);
+
+				for (std::vector<Entry*>::iterator it = _buckets.begin(); it != _buckets.end(); ++it)
+				{
+					Entry *e = *it;
+					while (e != NULL)
+					{
+						Entry *next = e->next;
+						Entry *&bucket = buckets[e->hash & (buckets.size() - 1)];
+						e->next = bucket;
+						bucket = e;
+						e = next;
+					}
+				}
+
+				_buckets.swap(buckets);
+			}
+
+			ibrcommon::Mutex _lock;
+			std::vector<Entry*> _buckets;
+			size_t _size;
+			const Entry *_none;
+		};
+
+		size_t EID::getInternedCount()
+		{
+			return Table::getInstance().size();
+		}
+
+		void EID::assign(const Scheme scheme_type, const std::string &scheme, const std::string &ssp, const std::string &application, const Number &cbhe_node, const Number &cbhe_application)
+		{
+			const Entry *e = NULL;
+			Table &table = Table::getInstance();
+
+			// only the values relevant for the scheme are interned
+			switch (scheme_type) {
+			case SCHEME_CBHE:
+				e = table.intern(scheme_type, "", "", "", cbhe_node, cbhe_application);
+				break;
+
+			case SCHEME_DTN:
+				e = table.intern(scheme_type, "", ssp, application, 0, 0);
+				break;
+
+			default:
+				e = table.intern(scheme_type, scheme, ssp, "", 0, 0);
+				break;
+			}
+
+			if (_entry != NULL) table.release(_entry);
+			_entry = e;
+
+			release_regex();
+		}
+
+		void EID::release_regex()
+		{
+#ifdef HAVE_REGEX_H
+			if (_regex != NULL) {
+				regfree((regex_t*)_regex);
+				delete (regex_t*)_regex;
+				_regex = NULL;
+			}
+#endif
+		}
+
 		EID::EID()
-		: _scheme_type(SCHEME_DTN), _scheme(), _ssp("none"), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL)
+		: _entry(Table::getInstance().none()), _regex(NULL)
 		{
 		}
 
 		EID::EID(const Scheme scheme_type, const std::string &scheme, const std::string &ssp, const std::string &application)
-		: _scheme_type(scheme_type), _scheme(scheme), _ssp(ssp), _application(application), _cbhe_node(0), _cbhe_application(0), _regex(NULL)
+		: _entry(NULL), _regex(NULL)
 		{
 			if (scheme_type == SCHEME_CBHE) {
 				throw dtn::InvalidDataException("This constructor does not work for CBHE schemes");
 			}
+
+			assign(scheme_type, scheme, ssp, application, 0, 0);
 		}
 
 		EID::EID(const std::string &scheme, const std::string &ssp)
-		 : _scheme_type(SCHEME_EXTENDED), _scheme(), _ssp(ssp), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL)
+		 : _entry(NULL), _regex(NULL)
 		{
 			// resolve scheme
-			_scheme_type = resolveScheme(scheme);
+			Scheme scheme_type = resolveScheme(scheme);
+			std::string node = ssp;
+			std::string application;
+			Number cbhe_node = 0;
+			Number cbhe_application = 0;
 
-			switch (_scheme_type) {
+			switch (scheme_type) {
 			case SCHEME_CBHE:
 				// extract CBHE numbers
-				extractCBHE(ssp, _cbhe_node, _cbhe_application);
-				if (_cbhe_node == 0) {
-					_scheme_type = SCHEME_DTN;
-					_ssp = "none";
+				extractCBHE(ssp, cbhe_node, cbhe_application);
+				if (cbhe_node == 0) {
+					scheme_type = SCHEME_DTN;
+					node = "none";
 				}
 				break;
 
 			case SCHEME_DTN:
-				extractDTN(ssp, _ssp, _application);
+				extractDTN(ssp, node, application);
 				break;
 
 			default:
-				_scheme = scheme;
 				break;
 			}
+
+			assign(scheme_type, scheme, node, application, cbhe_node, cbhe_application);
 		}
 
 		EID::EID(const std::string &orig_value)
-		: _scheme_type(SCHEME_DTN), _scheme(), _ssp("none"), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL)
+		: _entry(NULL), _regex(NULL)
 		{
 			try {
 				if (orig_value.length() == 0) {
@@ -259,53 +506,48 @@ namespace dtn
 				}
 
 				// resolve scheme
-				_scheme_type = resolveScheme(scheme);
+				const Scheme scheme_type = resolveScheme(scheme);
+				std::string node = ssp;
+				std::string application;
+				Number cbhe_node = 0;
+				Number cbhe_application = 0;
 
-				switch (_scheme_type) {
+				switch (scheme_type) {
 				case SCHEME_CBHE:
 					// extract CBHE numbers
-					extractCBHE(ssp, _cbhe_node, _cbhe_application);
+					extractCBHE(ssp, cbhe_node, cbhe_application);
 					break;
 
 				case SCHEME_DTN:
 					// extract DTN scheme node/application
-					extractDTN(ssp, _ssp, _application);
+					extractDTN(ssp, node, application);
 					break;
 
 				default:
-					_scheme = scheme;
-					_ssp = ssp;
 					break;
 				}
+
+				assign(scheme_type, scheme, node, application, cbhe_node, cbhe_application);
 			} catch (const std::exception&) {
-				_scheme_type = SCHEME_DTN;
-				_ssp = "none";
+				if (_entry != NULL) Table::getInstance().release(_entry);
+				_entry = Table::getInstance().none();
 			}
 		}
 
 		EID::EID(const dtn::data::Number &node, const dtn::data::Number &application)
-		 : _scheme_type(SCHEME_CBHE), _scheme(), _ssp(), _application(), _cbhe_node(node), _cbhe_application(application), _regex(NULL)
+		 : _entry(NULL), _regex(NULL)
 		{
 			// set dtn:none if the node is zero
 			if (node == 0) {
-				_scheme_type = SCHEME_DTN;
-				_ssp = "none";
+				_entry = Table::getInstance().none();
+			} else {
+				assign(SCHEME_CBHE, "", "", "", node, application);
 			}
 		}
 
 		EID::EID(const EID &other)
+		 : _entry(Table::getInstance().acquire(other._entry)), _regex(NULL)
 		{
-			_scheme_type = other._scheme_type;
-			_scheme = other._scheme;
-			_ssp = other._ssp;
-
-			_application = other._application;
-
-			_cbhe_node = other._cbhe_node;
-			_cbhe_application = other._cbhe_application;
-
-			_regex = NULL;
-
 			if(other._regex != NULL)
 			{
 				prepare();
@@ -314,29 +556,33 @@ namespace dtn
 
 		EID::~EID()
 		{
-#ifdef HAVE_REGEX_H
-			if (_regex != NULL) {
-				regfree((regex_t*)_regex);
-				delete (regex_t*)_regex;
-				_regex = NULL;
-			}
-#endif
+			release_regex();
+			Table::getInstance().release(_entry);
 		}
 
-		bool EID::operator==(const EID &other) const
+		EID& EID::operator=(const EID &other)
 		{
-			if (_scheme_type != other._scheme_type) return false;
-
-			switch (_scheme_type) {
-			case SCHEME_CBHE:
-				return (_cbhe_node == other._cbhe_node) && (_cbhe_application == other._cbhe_application);
+			if (_entry != other._entry)
+			{
+				Table &table = Table::getInstance();
+				table.release(_entry);
+				_entry = table.acquire(other._entry);
+			}
 
-			case SCHEME_DTN:
-				return (_ssp == other._ssp) && (_application == other._application);
+			release_regex();
 
-			default:
-				return (_scheme == other._scheme) && (_ssp == other._ssp);
+			if (other._regex != NULL)
+			{
+				prepare();
 			}
+
+			return (*this);
+		}
+
+		bool EID::operator==(const EID &other) const
+		{
+			// interned entries are unique
+			return (_entry == other._entry);
 		}
 
 		bool EID::operator==(const std::string &other) const
@@ -356,43 +602,49 @@ namespace dtn
 
 		bool EID::sameHost(const EID &other) const
 		{
-			if (_scheme_type != other._scheme_type) return false;
+			if (_entry == other._entry) return true;
+			if (_entry->scheme_type != other._entry->scheme_type) return false;
 
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
-				return _cbhe_node == other._cbhe_node;
+				return _entry->cbhe_node == other._entry->cbhe_node;
 
 			case SCHEME_DTN:
-				return _ssp == other._ssp;
+				return _entry->ssp == other._entry->ssp;
 
 			default:
-				return (_scheme == other._scheme) && (_ssp == other._ssp);
+				return (_entry->scheme == other._entry->scheme) && (_entry->ssp == other._entry->ssp);
 			}
 		}
 
 		bool EID::operator<(const EID &other) const
 		{
-			if (_scheme_type < other._scheme_type) return true;
-			if (_scheme_type != other._scheme_type) return false;
+			if (_entry == other._entry) return false;
+
+			const Entry &e = *_entry;
+			const Entry &o = *other._entry;
+
+			if (e.scheme_type < o.scheme_type) return true;
+			if (e.scheme_type != o.scheme_type) return false;
 
-			switch (_scheme_type) {
+			switch (e.scheme_type) {
 			case SCHEME_CBHE:
-				if (_cbhe_node < other._cbhe_node) return true;
-				if (_cbhe_node != other._cbhe_node) return false;
+				if (e.cbhe_node < o.cbhe_node) return true;
+				if (e.cbhe_node != o.cbhe_node) return false;
 
-				return (_cbhe_application < other._cbhe_application);
+				return (e.cbhe_application < o.cbhe_application);
 
 			case SCHEME_DTN:
-				if (_ssp < other._ssp) return true;
-				if (_ssp != other._ssp) return false;
+				if (e.ssp < o.ssp) return true;
+				if (e.ssp != o.ssp) return false;
 
-				return (_application < other._application);
+				return (e.application < o.application);
 
 			default:
-				if (_scheme < other._scheme) return true;
-				if (_scheme != other._scheme) return false;
+				if (e.scheme < o.scheme) return true;
+				if (e.scheme != o.scheme) return false;
 
-				return (_ssp < other._ssp);
+				return (e.ssp < o.ssp);
 			}
 		}
 
@@ -401,189 +653,159 @@ namespace dtn
 			return other < (*this);
 		}
 
-		std::string EID::getString() const
+		size_t EID::hash() const throw ()
 		{
-			std::stringstream ss;
-
-			switch (_scheme_type) {
-			case SCHEME_CBHE:
-				ss << getSchemeName(SCHEME_CBHE) << ":" << _cbhe_node.get<size_t>();
-				ss << "." << _cbhe_application.get<size_t>();
-				break;
-
-			case SCHEME_DTN:
-				ss << getSchemeName(SCHEME_DTN) << ":" << _ssp;
-
-				if (_application.length() > 0) {
-					ss << "/" << _application;
-				}
-				break;
-
-			default:
-				ss << _scheme << ":" << _ssp;
-				break;
-			}
+			return _entry->hash;
+		}
 
-			return ss.str();
+		std::string EID::getString() const
+		{
+			return _entry->str;
 		}
 
 		void EID::setApplication(const Number &app) throw ()
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
-				_cbhe_application = app;
+				assign(SCHEME_CBHE, "", "", "", _entry->cbhe_node, app);
 				break;
 
 			case SCHEME_DTN:
-				_application = app.toString();
+				assign(SCHEME_DTN, "", _entry->ssp, app.toString(), 0, 0);
 				break;
 
 			default:
 				// not defined
+				release_regex();
 				break;
 			}
-
-#ifdef HAVE_REGEX_H
-			if (_regex != NULL) {
-				regfree((regex_t*)_regex);
-				delete (regex_t*)_regex;
-				_regex = NULL;
-			}
-#endif
 		}
 
 		void EID::setApplication(const std::string &app) throw ()
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
 				// get CBHE Number for the application string
-				_cbhe_application = EID::getApplicationNumber(app);
+				assign(SCHEME_CBHE, "", "", "", _entry->cbhe_node, EID::getApplicationNumber(app));
 				break;
 
 			case SCHEME_DTN:
-				_application = app;
+				assign(SCHEME_DTN, "", _entry->ssp, app, 0, 0);
 				break;
 
 			default:
 				// not defined
+				release_regex();
 				break;
 			}
-
-#ifdef HAVE_REGEX_H
-			if (_regex != NULL) {
-				regfree((regex_t*)_regex);
-				delete (regex_t*)_regex;
-				_regex = NULL;
-			}
-#endif
 		}
 
 		std::string EID::getApplication() const throw ()
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
-				if (_cbhe_application > 0) {
-					return _cbhe_application.toString();
+				if (_entry->cbhe_application > 0) {
+					return _entry->cbhe_application.toString();
 				}
 				return "";
 
 			case SCHEME_DTN:
-				return _application;
+				return _entry->application;
 
 			default:
-				return _ssp;
+				return _entry->ssp;
 			}
 		}
 
 		bool EID::isApplication(const dtn::data::Number &app) const throw ()
 		{
-			if (_scheme_type != SCHEME_CBHE) return false;
-			return (_cbhe_application == app);
+			if (_entry->scheme_type != SCHEME_CBHE) return false;
+			return (_entry->cbhe_application == app);
 		}
 
 		bool EID::isApplication(const std::string &app) const throw ()
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
-				return (_cbhe_application == getApplicationNumber(app));
+				return (_entry->cbhe_application == getApplicationNumber(app));
 
 			case SCHEME_DTN:
-				return (_application == app);
+				return (_entry->application == app);
 
 			default:
-				return (app == _ssp);
+				return (app == _entry->ssp);
 			}
 		}
 
 		std::string EID::getHost() const throw ()
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
-				return _cbhe_node.toString();
+				return _entry->cbhe_node.toString();
 			case SCHEME_DTN:
-				return _ssp;
+				return _entry->ssp;
 			default:
-				return _ssp;
+				return _entry->ssp;
 			}
 		}
 
 		const std::string EID::getScheme() const
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
 				return getSchemeName(SCHEME_CBHE);
 			case SCHEME_DTN:
 				return getSchemeName(SCHEME_DTN);
 			default:
-				return _scheme;
+				return _entry->scheme;
 			}
 		}
 
 		const std::string EID::getSSP() const
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
 			{
 				std::stringstream ss;
-				ss << _cbhe_node.get<size_t>();
-				ss << "." << _cbhe_application.get<size_t>();
+				ss << _entry->cbhe_node.get<size_t>();
+				ss << "." << _entry->cbhe_application.get<size_t>();
 
 				return ss.str();
 			}
 
 			case SCHEME_DTN:
-				if (_application.length() > 0) {
+				if (_entry->application.length() > 0) {
 					std::stringstream ss;
-					ss << _ssp << "/" << _application;
+					ss << _entry->ssp << "/" << _entry->application;
 					return ss.str();
 				} else {
-					return _ssp;
+					return _entry->ssp;
 				}
 
 			default:
-				return _ssp;
+				return _entry->ssp;
 			}
 		}
 
 		EID EID::getNode() const throw ()
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
-				return EID(_cbhe_node, 0);
+				return EID(_entry->cbhe_node, 0);
 			case SCHEME_DTN:
-				return EID(_scheme_type, "", _ssp, "");
+				return EID(_entry->scheme_type, "", _entry->ssp, "");
 			default:
-				return EID(_scheme_type, _scheme, _ssp, "");
+				return EID(_entry->scheme_type, _entry->scheme, _entry->ssp, "");
 			}
 		}
 
 		bool EID::hasApplication() const
 		{
-			switch (_scheme_type) {
+			switch (_entry->scheme_type) {
 			case SCHEME_CBHE:
-				return (_cbhe_application > 0);
+				return (_entry->cbhe_application > 0);
 			case SCHEME_DTN:
-				return _application != "";
+				return _entry->application != "";
 			default:
 				return true;
 			}
@@ -591,17 +813,17 @@ namespace dtn
 
 		bool EID::isCompressable() const
 		{
-			return ((_scheme_type == SCHEME_CBHE) || ((_scheme_type == SCHEME_DTN) && (_ssp == "none")));
+			return ((_entry->scheme_type == SCHEME_CBHE) || isNone());
 		}
 
 		bool EID::isNone() const
 		{
-			return (_scheme_type == SCHEME_DTN) && (_ssp == "none");
+			return (_entry->scheme_type == SCHEME_DTN) && (_entry->ssp == "none");
 		}
 
 		std::string EID::getDelimiter() const
 		{
-			if (_scheme_type == EID::SCHEME_CBHE) {
+			if (_entry->scheme_type == EID::SCHEME_CBHE) {
 				return ".";
 			} else {
 				return "/";
@@ -612,7 +834,7 @@ namespace dtn
 		{
 			if (isCompressable())
 			{
-				return make_pair(_cbhe_node, _cbhe_application);
+				return make_pair(_entry->cbhe_node, _entry->cbhe_application);
 			}
 
 			return make_pair(0, 0);
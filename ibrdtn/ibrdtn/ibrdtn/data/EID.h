@@ -31,6 +31,12 @@ namespace dtn
 {
 	namespace data
 	{
+		/**
+		 * An endpoint identifier. All EIDs are interned in a global table,
+		 * thus an instance only carries a reference to a shared and immutable
+		 * entry. Copies are cheap and two EIDs are equal if and only if they
+		 * refer to the same entry.
+		 */
 		class EID
 		{
 		public:
@@ -70,6 +76,8 @@ namespace dtn
 
 			virtual ~EID();
 
+			EID& operator=(const EID &other);
+
 			bool operator==(const EID &other) const;
 
 			bool operator==(const std::string &other) const;
@@ -82,6 +90,17 @@ namespace dtn
 			bool operator<(const EID &other) const;
 			bool operator>(const EID &other) const;
 
+			/**
+			 * Returns a hash value of this EID. The hash is computed
+			 * once when the EID is interned.
+			 */
+			size_t hash() const throw ();
+
+			/**
+			 * Returns the number of distinct EIDs currently interned
+			 */
+			static size_t getInternedCount();
+
 			std::string getString() const;
 
 			void setApplication(const dtn::data::Number &app) throw ();
@@ -141,6 +160,9 @@ namespace dtn
 			bool match(const dtn::data::EID &other) const;
 
 		private:
+			class Entry;
+			class Table;
+
 			/**
 			 * private constructor to create a modified EID
 			 */
@@ -156,18 +178,18 @@ namespace dtn
 			 */
 			static void extractDTN(const std::string &ssp, std::string &node, std::string &application);
 
-			// abstract values
-			Scheme _scheme_type;
-			std::string _scheme;
-			std::string _ssp;
+			/**
+			 * Replace the referenced entry by the interned entry of the given values
+			 */
+			void assign(const Scheme scheme_type, const std::string &scheme, const std::string &ssp, const std::string &application, const Number &cbhe_node, const Number &cbhe_application);
 
-			// DTN scheme
-			// the ssp carries the node part
-			std::string _application;
+			/**
+			 * Free the regex structure
+			 */
+			void release_regex();
 
-			// CBHE scheme
-			Number _cbhe_node;
-			Number _cbhe_application;
+			// interned values
+			const Entry *_entry;
 
 			// regex structure
 			void *_regex;
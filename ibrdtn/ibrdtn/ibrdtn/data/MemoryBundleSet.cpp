@@ -22,6 +22,7 @@
  */
 
 #include "ibrdtn/data/MemoryBundleSet.h"
+#include <vector>
 
 namespace dtn
 {
@@ -217,12 +218,34 @@ namespace dtn
 //			// if the lists are equal return an empty list
 //			if (filter == _bf) return ret;
 
-			// iterate through all items to find the differences
-			for (bundle_set::const_iterator iter = _bundles.begin(); iter != _bundles.end(); ++iter)
+			// test the items against the filter in batches
+			static const size_t batch_size = 32;
+			const size_t raw_max = dtn::data::BundleID::RAW_LENGTH_MAX;
+
+			std::vector<unsigned char> data(batch_size * raw_max);
+			const unsigned char* keys[batch_size];
+			size_t lengths[batch_size];
+			bool found[batch_size];
+
+			bundle_set::const_iterator iter = _bundles.begin();
+			while (iter != _bundles.end())
 			{
-				if (!(*iter).isIn(filter))
+				const bundle_set::const_iterator batch_begin = iter;
+				size_t n = 0;
+
+				for (; (iter != _bundles.end()) && (n < batch_size); ++iter, ++n)
+				{
+					keys[n] = &data[n * raw_max];
+					lengths[n] = (*iter).raw(&data[n * raw_max], raw_max);
+				}
+
+				filter.contains_many(keys, lengths, n, found);
+
+				// collect the differences
+				size_t i = 0;
+				for (bundle_set::const_iterator it = batch_begin; i < n; ++it, ++i)
 				{
-					ret.insert( (*iter) );
+					if (!found[i]) ret.insert( (*it) );
 				}
 			}
 
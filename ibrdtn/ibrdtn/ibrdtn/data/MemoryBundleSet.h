@@ -85,7 +85,9 @@ namespace dtn
 			virtual bool has(const dtn::data::BundleID &bundle) const throw ();
 
 			/**
-			 * Check for expired entries in this bundle-set and remove them
+			 * Check for expired entries in this bundle-set and remove them.
+			 * A bundle-set does not schedule its own expiration, the owner
+			 * calls this periodically.
 			 */
 			virtual void expire(const Timestamp timestamp) throw ();
 
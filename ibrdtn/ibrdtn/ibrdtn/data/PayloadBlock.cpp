@@ -21,6 +21,7 @@
 
 #include "ibrdtn/data/PayloadBlock.h"
 #include "ibrdtn/data/Exceptions.h"
+#include "ibrdtn/streams/StreamConnection.h"
 #include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/Logger.h>
 
@@ -30,6 +31,10 @@ namespace dtn
 	{
 		const dtn::data::block_t PayloadBlock::BLOCK_TYPE = 1;
 
+		PayloadBlock::Sink::~Sink()
+		{
+		}
+
 		PayloadBlock::PayloadBlock()
 		 : Block(PayloadBlock::BLOCK_TYPE), _blobref(ibrcommon::BLOB::create())
 		{
@@ -60,7 +65,11 @@ namespace dtn
 			ibrcommon::BLOB::iostream io = blobref.iostream();
 
 			try {
-				ibrcommon::BLOB::copy(stream, *io, io.size());
+				// hand file-backed payloads directly to the connection
+				if (!__sendfile(stream, io, 0, io.size()))
+				{
+					ibrcommon::BLOB::copy(stream, *io, io.size());
+				}
 				length += io.size();
 			} catch (const ibrcommon::IOException &ex) {
 				throw dtn::SerializationFailedException(ex.what());
@@ -75,6 +84,9 @@ namespace dtn
 			ibrcommon::BLOB::iostream io = blobref.iostream();
 
 			try {
+				// hand file-backed payloads directly to the connection
+				if (__sendfile(stream, io, clip_offset, clip_length)) return stream;
+
 				(*io).seekg(clip_offset, std::ios::beg);
 				ibrcommon::BLOB::copy(stream, *io, clip_length);
 			} catch (const ibrcommon::IOException &ex) {
@@ -84,6 +96,24 @@ namespace dtn
 			return stream;
 		}
 
+		bool PayloadBlock::__sendfile(std::ostream &stream, ibrcommon::BLOB::iostream &io, const Length &offset, const Length &length) const
+		{
+			Sink *sink = dynamic_cast<Sink*>(&stream);
+			if (sink != NULL)
+			{
+				sink->append(_blobref, offset, length);
+				return true;
+			}
+
+			dtn::streams::StreamConnection *conn = dynamic_cast<dtn::streams::StreamConnection*>(&stream);
+			if (conn == NULL) return false;
+
+			const ibrcommon::File *file = io.file();
+			if (file == NULL) return false;
+
+			return conn->sendfile(*file, offset, length);
+		}
+
 		std::istream& PayloadBlock::deserialize(std::istream &stream, const Length &length)
 		{
 			// lock the BLOB
@@ -37,6 +37,21 @@ namespace dtn
 		public:
 			static const dtn::data::block_t BLOCK_TYPE;
 
+			/**
+			 * Streams implementing this interface get a reference to the
+			 * payload data instead of a copy during the serialization.
+			 */
+			class Sink
+			{
+			public:
+				virtual ~Sink() = 0;
+
+				/**
+				 * Append a range of the payload to the stream
+				 */
+				virtual void append(const ibrcommon::BLOB::Reference &ref, const Length &offset, const Length &length) = 0;
+			};
+
 			PayloadBlock();
 			PayloadBlock(ibrcommon::BLOB::Reference ref);
 			virtual ~PayloadBlock();
@@ -57,6 +72,14 @@ namespace dtn
 			std::ostream &serialize(std::ostream &stream, const Length &clip_offset, const Length &clip_length) const;
 
 		private:
+			/**
+			 * Transfer a range of the payload without copying, if the stream
+			 * is a payload sink or a stream connection and the BLOB is stored
+			 * in a file.
+			 * @return False, if the data has to be copied by the caller.
+			 */
+			bool __sendfile(std::ostream &stream, ibrcommon::BLOB::iostream &io, const Length &offset, const Length &length) const;
+
 			ibrcommon::BLOB::Reference _blobref;
 		};
 	}
@@ -54,11 +54,16 @@ namespace dtn
 
 		void DefaultSerializer::rebuildDictionary(const dtn::data::Bundle &obj)
 		{
-			// clear the dictionary
-			_dictionary.clear();
+			// keep the dictionary if it has been built for the same EIDs,
+			// e.g. by a preceding call of getLength()
+			if (!_dictionary.equals(obj))
+			{
+				// clear the dictionary
+				_dictionary.clear();
 
-			// rebuild the dictionary
-			_dictionary.add(obj);
+				// rebuild the dictionary
+				_dictionary.add(obj);
+			}
 
 			// check if the bundle header could be compressed
 			_compressable = isCompressable(obj);
@@ -399,11 +404,9 @@ namespace dtn
 
 		Length DefaultSerializer::getLength(const dtn::data::PrimaryBlock& obj) const
 		{
+			// length of the block after the block length field
 			Length len = 0;
 
-			len += sizeof(dtn::data::BUNDLE_VERSION);		// bundle version
-			len += obj.procflags.getLength();	// processing flags
-
 			// primary header
 			dtn::data::Number primaryheader[14];
 			dtn::data::Dictionary::Reference ref;
@@ -494,9 +497,8 @@ namespace dtn
 				len += primaryheader[13].getLength();
 			}
 
-			len += Number(len).getLength();
-
-			return len;
+			// bundle version, processing flags and block length
+			return sizeof(dtn::data::BUNDLE_VERSION) + obj.procflags.getLength() + Number(len).getLength() + len;
 		}
 
 		Length DefaultSerializer::getLength(const dtn::data::Block &obj) const
@@ -26,12 +26,17 @@
 
 #include <openssl/err.h>
 #include <openssl/rsa.h>
+#include <openssl/rand.h>
 #include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/Logger.h>
 
 #include <stdint.h>
 #include <typeinfo>
 #include <algorithm>
+#include <string.h>
+#include <map>
+#include <list>
+#include <sstream>
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
 #include <cassert>
@@ -43,6 +48,100 @@ namespace dtn
 	{
 		const dtn::data::block_t PayloadConfidentialBlock::BLOCK_TYPE = SecurityBlock::PAYLOAD_CONFIDENTIAL_BLOCK;
 
+		/**
+		 * Remembers recently decrypted session keys, indexed by the
+		 * private key file, its modification time and the encrypted form
+		 * of the session key.
+		 */
+		class SessionKeyCache
+		{
+		public:
+			static const size_t MAX_ENTRIES = 64;
+
+			static SessionKeyCache& getInstance()
+			{
+				static SessionKeyCache instance;
+				return instance;
+			}
+
+			bool get(const std::string &index, unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes])
+			{
+				ibrcommon::MutexLock l(_lock);
+				std::map<std::string, std::string>::const_iterator it = _keys.find(index);
+				if (it == _keys.end()) return false;
+
+				::memcpy(key, it->second.c_str(), ibrcommon::AES128Stream::key_size_in_bytes);
+				return true;
+			}
+
+			void put(const std::string &index, const unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes])
+			{
+				ibrcommon::MutexLock l(_lock);
+				if (_keys.find(index) != _keys.end()) return;
+
+				// evict the oldest entry
+				if (_order.size() >= MAX_ENTRIES)
+				{
+					_keys.erase(_order.front());
+					_order.pop_front();
+				}
+
+				_keys[index] = std::string(reinterpret_cast<const char*>(key), ibrcommon::AES128Stream::key_size_in_bytes);
+				_order.push_back(index);
+			}
+
+			void flush(const std::string &prefix)
+			{
+				ibrcommon::MutexLock l(_lock);
+				for (std::list<std::string>::iterator it = _order.begin(); it != _order.end();)
+				{
+					if (it->compare(0, prefix.size(), prefix) == 0) {
+						_keys.erase(*it);
+						_order.erase(it++);
+					} else {
+						++it;
+					}
+				}
+			}
+
+		private:
+			SessionKeyCache() { }
+			~SessionKeyCache() { }
+
+			ibrcommon::Mutex _lock;
+			std::map<std::string, std::string> _keys;
+			std::list<std::string> _order;
+		};
+
+		PayloadConfidentialBlock::SessionKey::SessionKey(const dtn::security::SecurityKey &long_key)
+		{
+			uint32_t salt;
+
+			// create a random key
+			createSaltAndKey(salt, key, ibrcommon::AES128Stream::key_size_in_bytes);
+
+			// get the RSA key
+			RSA *rsa_key = long_key.getRSA();
+
+			// encrypt the random key
+			TLVList params;
+			addKey(params, key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key);
+
+			// free the RSA key
+			long_key.free(rsa_key);
+
+			try {
+				encrypted_key = params.get(SecurityBlock::key_information);
+			} catch (const ElementMissingException&) {
+				throw ibrcommon::Exception("failed to encrypt the session key");
+			}
+		}
+
+		PayloadConfidentialBlock::SessionKey::~SessionKey()
+		{
+			OPENSSL_cleanse(key, ibrcommon::AES128Stream::key_size_in_bytes);
+		}
+
 		dtn::data::Block* PayloadConfidentialBlock::Factory::create()
 		{
 			return new PayloadConfidentialBlock();
@@ -58,12 +157,19 @@ namespace dtn
 		}
 
 		void PayloadConfidentialBlock::encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source)
+		{
+			// create a fresh session key for this bundle
+			const SessionKey session(long_key);
+			encrypt(bundle, long_key, session, source);
+		}
+
+		void PayloadConfidentialBlock::encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const SessionKey &session, const dtn::data::EID& source)
 		{
 			// contains the random salt
 			uint32_t salt;
 
-			// contains the random key
-			unsigned char ephemeral_key[ibrcommon::AES128Stream::key_size_in_bytes];
+			// the key of the session
+			const unsigned char *ephemeral_key = session.key;
 
 			unsigned char iv[ibrcommon::AES128Stream::iv_len];
 			unsigned char tag[ibrcommon::AES128Stream::tag_len];
@@ -71,8 +177,12 @@ namespace dtn
 			// create a new correlator value
 			dtn::data::Number correlator = createCorrelatorValue(bundle);
 
-			// create a random salt and key
-			createSaltAndKey(salt, ephemeral_key, ibrcommon::AES128Stream::key_size_in_bytes);
+			// create a random salt
+			if (!RAND_bytes(reinterpret_cast<unsigned char *>(&salt), sizeof(uint32_t)))
+			{
+				IBRCOMMON_LOGGER_ex(critical) << "failed to generate salt. maybe /dev/urandom is missing for seeding the PRNG" << IBRCOMMON_LOGGER_ENDL;
+				ERR_print_errors_fp(stderr);
+			}
 
 			// count all PCBs
 			dtn::data::Size pcbs_size = std::count(bundle.begin(), bundle.end(), PayloadConfidentialBlock::BLOCK_TYPE);
@@ -137,14 +247,8 @@ namespace dtn
 			// store encypted key, tag, iv and salt
 			addSalt(pcb._ciphersuite_params, salt);
 
-			// get the RSA key
-			RSA *rsa_key = long_key.getRSA();
-
-			// encrypt the random key and add it to the ciphersuite params
-			addKey(pcb._ciphersuite_params, ephemeral_key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key);
-
-			// free the RSA key
-			long_key.free(rsa_key);
+			// add the encrypted session key to the ciphersuite params
+			pcb._ciphersuite_params.set(SecurityBlock::key_information, session.encrypted_key);
 
 			pcb._ciphersuite_params.set(SecurityBlock::initialization_vector, iv, ibrcommon::AES128Stream::iv_len);
 			pcb._ciphersuite_flags |= SecurityBlock::CONTAINS_CIPHERSUITE_PARAMS;
@@ -207,7 +311,7 @@ namespace dtn
 							(pcb._ciphersuite_id == SecurityBlock::PCB_RSA_AES128_PAYLOAD_PIB_PCB))
 						{
 							// try to decrypt the symmetric AES key
-							if (!getKey(pcb._ciphersuite_params, key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key))
+							if (!getSessionKey(pcb, long_key, rsa_key, key))
 							{
 								IBRCOMMON_LOGGER_TAG("PayloadConfidentialBlock", critical) << "could not get symmetric key decrypted" << IBRCOMMON_LOGGER_ENDL;
 								throw ibrcommon::Exception("decrypt failed - could not get symmetric key decrypted");
@@ -262,6 +366,32 @@ namespace dtn
 			long_key.free(rsa_key);
 		}
 
+		bool PayloadConfidentialBlock::getSessionKey(const PayloadConfidentialBlock &pcb, const dtn::security::SecurityKey &long_key, RSA *rsa_key, unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes])
+		{
+			std::string index;
+			try {
+				// a replaced key file must not hit the keys of its predecessor
+				std::stringstream ss;
+				ss << long_key.file.getPath() << '\0' << long_key.file.lastmodify() << '\0' << pcb._ciphersuite_params.get(SecurityBlock::key_information);
+				index = ss.str();
+			} catch (const ElementMissingException&) {
+				return false;
+			}
+
+			if (SessionKeyCache::getInstance().get(index, key)) return true;
+
+			if (!getKey(pcb._ciphersuite_params, key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key))
+				return false;
+
+			SessionKeyCache::getInstance().put(index, key);
+			return true;
+		}
+
+		void PayloadConfidentialBlock::flush(const ibrcommon::File &file)
+		{
+			SessionKeyCache::getInstance().flush(file.getPath() + '\0');
+		}
+
 		bool PayloadConfidentialBlock::decryptPayload(dtn::data::Bundle& bundle, const unsigned char ephemeral_key[ibrcommon::AES128Stream::key_size_in_bytes], const uint32_t salt)
 		{
 			// TODO handle fragmentation
@@ -59,6 +59,30 @@ namespace dtn
 					virtual dtn::data::Block* create();
 				};
 
+				/**
+				A symmetric session key together with its RSA encrypted form. A
+				session key may be used for several bundles to the same destination
+				to avoid the costly RSA operations. Salt and initialisation vector
+				are still unique for each bundle.
+				*/
+				class SessionKey
+				{
+				public:
+					/**
+					Creates a random key and encrypts it using the public key
+					of the destination.
+					@param long_key the public key of the destination
+					*/
+					SessionKey(const dtn::security::SecurityKey &long_key);
+					~SessionKey();
+
+					/** the plaintext AES key */
+					unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes];
+
+					/** the AES key encrypted with the public key of the destination */
+					std::string encrypted_key;
+				};
+
 				/** The block type of this class. */
 				static const dtn::data::block_t BLOCK_TYPE;
 
@@ -74,6 +98,16 @@ namespace dtn
 				*/
 				static void encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source);
 
+				/**
+				Encrypts the Payload inside this Bundle using a previously created
+				session key instead of a fresh one.
+				@param bundle the bundle with the to be encrypted payload
+				@param long_key the public key of the destination
+				@param session the session key created with long_key
+				@param source the security source
+				*/
+				static void encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const SessionKey &session, const dtn::data::EID& source);
+
 				/**
 				Decrypts the Payload inside this Bundle. All correlated Blocks, which
 				are found, will be decrypted, too, placed at the position, where their 
@@ -87,6 +121,13 @@ namespace dtn
 				*/
 				static void decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key);
 
+				/**
+				Drops all cached session keys recovered with the private key in the
+				given file. Has to be called if the key file is replaced or removed.
+				@param file the private key file
+				*/
+				static void flush(const ibrcommon::File &file);
+
 			protected:
 				/**
 				Creates an empty PayloadConfidentialBlock. With ciphersuite_id set to
@@ -94,6 +135,13 @@ namespace dtn
 				*/
 				PayloadConfidentialBlock();
 
+				/**
+				Recovers the symmetric key of a PayloadConfidentialBlock. Already
+				decrypted keys are taken from a cache to skip the RSA operation.
+				@return true if the key is available
+				*/
+				static bool getSessionKey(const PayloadConfidentialBlock &pcb, const dtn::security::SecurityKey &long_key, RSA *rsa_key, unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes]);
+
 				/**
 				Decrypts the payload using the ephemeral_key and salt.
 				@param bundle the payload containing bundle
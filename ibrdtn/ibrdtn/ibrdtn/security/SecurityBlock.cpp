@@ -538,9 +538,9 @@ namespace dtn
 			// get key, convert with reinterpret_cast
 			const unsigned char *encrypted_key = reinterpret_cast<const unsigned char*>(key_string.c_str());
 			std::vector<unsigned char> the_key(RSA_size(rsa));
-			RSA_blinding_on(rsa, NULL);
+			// the rsa context is shared with other threads, rely on
+			// blinding being enabled by default for private key operations
 			int plaintext_key_len = RSA_private_decrypt(static_cast<int>(key_string.size()), encrypted_key, &the_key[0], rsa, RSA_PKCS1_OAEP_PADDING);
-			RSA_blinding_off(rsa);
 			if (plaintext_key_len == -1)
 			{
 				IBRCOMMON_LOGGER_ex(critical) << "failed to decrypt the symmetric AES key" << IBRCOMMON_LOGGER_ENDL;
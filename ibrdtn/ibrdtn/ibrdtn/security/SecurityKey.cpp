@@ -22,18 +22,124 @@
 #include "ibrdtn/security/SecurityKey.h"
 #include <ibrcommon/ssl/SHA256Stream.h>
 #include <ibrcommon/Logger.h>
+#include <ibrcommon/thread/MutexLock.h>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <map>
 
 #include <openssl/sha.h>
 #include <openssl/pem.h>
 #include <openssl/err.h>
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+static int EVP_PKEY_up_ref(EVP_PKEY *key)
+{
+	CRYPTO_add(&key->references, 1, CRYPTO_LOCK_EVP_PKEY);
+	return 1;
+}
+#endif
+
 namespace dtn
 {
 	namespace security
 	{
+		/**
+		 * Holds the parsed RSA and EVP contexts of key files. Each entry is
+		 * valid as long as the modification time of the file does not change.
+		 */
+		class KeyContextCache
+		{
+		public:
+			static KeyContextCache& getInstance()
+			{
+				static KeyContextCache instance;
+				return instance;
+			}
+
+			RSA* getRSA(const SecurityKey &key, RSA* (SecurityKey::*load)() const)
+			{
+				const time_t mtime = key.file.lastmodify();
+
+				ibrcommon::MutexLock l(_lock);
+				Entry &e = get(key, mtime);
+
+				if (e.rsa == NULL) e.rsa = (key.*load)();
+				RSA_up_ref(e.rsa);
+				return e.rsa;
+			}
+
+			EVP_PKEY* getEVP(const SecurityKey &key, EVP_PKEY* (SecurityKey::*load)() const)
+			{
+				const time_t mtime = key.file.lastmodify();
+
+				ibrcommon::MutexLock l(_lock);
+				Entry &e = get(key, mtime);
+
+				if (e.evp == NULL) e.evp = (key.*load)();
+				if (e.evp != NULL) EVP_PKEY_up_ref(e.evp);
+				return e.evp;
+			}
+
+			void flush(const ibrcommon::File &file)
+			{
+				ibrcommon::MutexLock l(_lock);
+				for (std::map<Index, Entry>::iterator it = _entries.begin(); it != _entries.end();)
+				{
+					if (it->first.first == file.getPath()) {
+						release(it->second);
+						_entries.erase(it++);
+					} else {
+						++it;
+					}
+				}
+			}
+
+		private:
+			typedef std::pair<std::string, SecurityKey::KeyType> Index;
+
+			struct Entry
+			{
+				Entry() : mtime(0), rsa(NULL), evp(NULL) { }
+				time_t mtime;
+				RSA *rsa;
+				EVP_PKEY *evp;
+			};
+
+			KeyContextCache() { }
+
+			~KeyContextCache()
+			{
+				for (std::map<Index, Entry>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+					release(it->second);
+			}
+
+			Entry& get(const SecurityKey &key, const time_t mtime)
+			{
+				Entry &e = _entries[Index(key.file.getPath(), key.type)];
+
+				// drop outdated contexts
+				if (e.mtime != mtime)
+				{
+					release(e);
+					e.mtime = mtime;
+				}
+
+				return e;
+			}
+
+			static void release(Entry &e)
+			{
+				if (e.rsa != NULL) RSA_free(e.rsa);
+				if (e.evp != NULL) EVP_PKEY_free(e.evp);
+				e.rsa = NULL;
+				e.evp = NULL;
+			}
+
+			ibrcommon::Mutex _lock;
+			std::map<Index, Entry> _entries;
+		};
+
 		SecurityKey::SecurityKey()
 		 : type(KEY_UNSPEC), trustlevel(NONE)
 		{}
@@ -51,6 +157,11 @@ namespace dtn
 			EVP_PKEY_free(key);
 		}
 
+		void SecurityKey::flush(const ibrcommon::File &file)
+		{
+			KeyContextCache::getInstance().flush(file);
+		}
+
 		bool SecurityKey::operator==(const SecurityKey &key)
 		{
 			return getFingerprint() == key.getFingerprint();
@@ -78,9 +189,9 @@ namespace dtn
 			switch (type)
 			{
 			case KEY_PRIVATE:
-				return getPrivateRSA();
+				return KeyContextCache::getInstance().getRSA(*this, &SecurityKey::getPrivateRSA);
 			case KEY_PUBLIC:
-				return getPublicRSA();
+				return KeyContextCache::getInstance().getRSA(*this, &SecurityKey::getPublicRSA);
 			default:
 				return NULL;
 			}
@@ -88,28 +199,39 @@ namespace dtn
 
 		EVP_PKEY* SecurityKey::getEVP() const
 		{
-			EVP_PKEY* ret = EVP_PKEY_new();
-			FILE * pkey_file = fopen(file.getPath().c_str(), "r");
-
 			switch (type)
 			{
-				case KEY_PRIVATE:
-				{
-					ret = PEM_read_PrivateKey(pkey_file, &ret, NULL, NULL);
-					break;
-				}
+			case KEY_PRIVATE:
+				return KeyContextCache::getInstance().getEVP(*this, &SecurityKey::getPrivateEVP);
+			case KEY_PUBLIC:
+				return KeyContextCache::getInstance().getEVP(*this, &SecurityKey::getPublicEVP);
+			default:
+				return NULL;
+			}
+		}
 
-				case KEY_PUBLIC:
-				{
-					ret = PEM_read_PUBKEY(pkey_file, &ret, NULL, NULL);
-					break;
-				}
+		EVP_PKEY* SecurityKey::getPrivateEVP() const
+		{
+			FILE * pkey_file = fopen(file.getPath().c_str(), "r");
+			if (!pkey_file) {
+				IBRCOMMON_LOGGER_ex(critical) << "Failed to open " << file.getPath() << IBRCOMMON_LOGGER_ENDL;
+				throw ibrcommon::Exception("Failed to open " + file.getPath());
+			}
 
-				default:
-					ret = NULL;
-					break;
+			EVP_PKEY* ret = PEM_read_PrivateKey(pkey_file, NULL, NULL, NULL);
+			fclose(pkey_file);
+			return ret;
+		}
+
+		EVP_PKEY* SecurityKey::getPublicEVP() const
+		{
+			FILE * pkey_file = fopen(file.getPath().c_str(), "r");
+			if (!pkey_file) {
+				IBRCOMMON_LOGGER_ex(critical) << "Failed to open " << file.getPath() << IBRCOMMON_LOGGER_ENDL;
+				throw ibrcommon::Exception("Failed to open " + file.getPath());
 			}
 
+			EVP_PKEY* ret = PEM_read_PUBKEY(pkey_file, NULL, NULL, NULL);
 			fclose(pkey_file);
 			return ret;
 		}
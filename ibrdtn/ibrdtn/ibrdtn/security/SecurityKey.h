@@ -100,6 +100,13 @@ namespace dtn
 			static void free(RSA* key);
 			static void free(EVP_PKEY* key);
 
+			/**
+			 * Parsed keys are cached per key file until the file is modified.
+			 * This drops the cached contexts of the given file and has to be
+			 * called if a key file is replaced or removed.
+			 */
+			static void flush(const ibrcommon::File &file);
+
 			friend std::ostream &operator<<(std::ostream &stream, const SecurityKey &key)
 			{
 				// key type
@@ -152,6 +159,8 @@ namespace dtn
 		private:
 			RSA* getPublicRSA() const;
 			RSA* getPrivateRSA() const;
+			EVP_PKEY* getPrivateEVP() const;
+			EVP_PKEY* getPublicEVP() const;
 		};
 	}
 }
@@ -22,7 +22,11 @@
 #include "ibrdtn/streams/StreamConnection.h"
 #include <ibrcommon/Logger.h>
 #include <ibrcommon/TimeMeasurement.h>
+#include <ibrcommon/net/socketstream.h>
 #include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace dtn
 {
@@ -266,35 +270,8 @@ namespace dtn
 				// wrap a segment around the data
 				StreamDataSegment seg(StreamDataSegment::MSG_DATA_SEGMENT, (iend - ibegin));
 
-				// set the start flag
-				if (get(STREAM_SOB))
+				if (__mark(seg, char_traits<char>::eq_int_type(c, char_traits<char>::eof())))
 				{
-					seg._flags |= StreamDataSegment::MSG_MARK_BEGINN;
-					unset(STREAM_SKIP);
-					unset(STREAM_SOB);
-				}
-
-				if (char_traits<char>::eq_int_type(c, char_traits<char>::eof()))
-				{
-					// set the end flag
-					seg._flags |= StreamDataSegment::MSG_MARK_END;
-					set(STREAM_SOB);
-				}
-
-				if (!get(STREAM_SKIP))
-				{
-					// put the segment into the queue
-					if (get(STREAM_ACK_SUPPORT))
-					{
-						_segments.push(seg);
-					}
-					else if (seg._flags & StreamDataSegment::MSG_MARK_END)
-					{
-						// without ACK support we have to assume that a bundle is forwarded
-						// when the last segment is sent.
-						_conn.eventBundleForwarded();
-					}
-
 					ibrcommon::MutexLock l(_sendlock);
 					if (!_stream.good()) throw StreamErrorException("stream went bad");
 
@@ -333,6 +310,127 @@ namespace dtn
 			return traits_type::eof();
 		}
 
+		bool StreamConnection::StreamBuffer::__mark(StreamDataSegment &seg, bool last)
+		{
+			// set the start flag
+			if (get(STREAM_SOB))
+			{
+				seg._flags |= StreamDataSegment::MSG_MARK_BEGINN;
+				unset(STREAM_SKIP);
+				unset(STREAM_SOB);
+			}
+
+			if (last)
+			{
+				// set the end flag
+				seg._flags |= StreamDataSegment::MSG_MARK_END;
+				set(STREAM_SOB);
+			}
+
+			if (get(STREAM_SKIP)) return false;
+
+			// put the segment into the queue
+			if (get(STREAM_ACK_SUPPORT))
+			{
+				_segments.push(seg);
+			}
+			else if (seg._flags & StreamDataSegment::MSG_MARK_END)
+			{
+				// without ACK support we have to assume that a bundle is forwarded
+				// when the last segment is sent.
+				_conn.eventBundleForwarded();
+			}
+
+			return true;
+		}
+
+		bool StreamConnection::StreamBuffer::sendfile(const ibrcommon::File &file, const dtn::data::Length &offset, const dtn::data::Length &length)
+		{
+			// only plain sockets are able to take the file directly
+			ibrcommon::socketstream *sock = dynamic_cast<ibrcommon::socketstream*>(&_stream);
+			if (sock == NULL) return false;
+
+			// small ranges are copied through the buffer
+			if (length <= _buffer_size) return false;
+
+			const int fd = ::open(file.getPath().c_str(), O_RDONLY);
+			if (fd == -1) return false;
+
+			// segments are limited to get acknowledgments during the transfer
+			const Length segment_size = std::max<Length>(_buffer_size, 0x100000);
+
+			try {
+				// send buffered data, but do not mark the end of the bundle
+				char *ibegin = &out_buf_[0];
+				char *iend = pptr();
+				setp(&out_buf_[0], &out_buf_[0] + _buffer_size - 1);
+
+				if (iend != ibegin)
+				{
+					StreamDataSegment seg(StreamDataSegment::MSG_DATA_SEGMENT, (iend - ibegin));
+
+					if (__mark(seg, false))
+					{
+						ibrcommon::MutexLock l(_sendlock);
+						if (!_stream.good()) throw StreamErrorException("stream went bad");
+
+						_stream << seg;
+						_stream.write(ibegin, (iend - ibegin));
+
+						// record statistics
+						_conn._callback.addTrafficOut(iend - ibegin);
+					}
+				}
+
+				// the last byte stays in the buffer and is sent with the end mark
+				Length pos = offset;
+				const Length end = offset + length - 1;
+
+				while (pos < end)
+				{
+					const Length seg_len = std::min(end - pos, segment_size);
+					StreamDataSegment seg(StreamDataSegment::MSG_DATA_SEGMENT, seg_len);
+
+					if (__mark(seg, false))
+					{
+						ibrcommon::MutexLock l(_sendlock);
+						if (!_stream.good()) throw StreamErrorException("stream went bad");
+
+						_stream << seg;
+						sock->sendfile(fd, pos, seg_len);
+
+						// record statistics
+						_conn._callback.addTrafficOut(seg_len);
+					}
+
+					pos += seg_len;
+				}
+
+				// read the last byte into the buffer
+				char c = 0;
+				if ((::lseek(fd, end, SEEK_SET) == -1) || (::read(fd, &c, 1) != 1))
+				{
+					throw StreamErrorException("can not read from file " + file.getPath());
+				}
+				sputc(c);
+			} catch (const StreamErrorException&) {
+				// set failed bit
+				set(STREAM_FAILED);
+				::close(fd);
+				throw;
+			} catch (const std::exception &ex) {
+				// set failed bit
+				set(STREAM_FAILED);
+				::close(fd);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 10) << "exception in sendfile(): " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				throw StreamErrorException(std::string("sendfile failed: ") + ex.what());
+			}
+
+			::close(fd);
+			return true;
+		}
+
 		// This is called to flush the buffer.
 		// This is called when we're done with the file stream (or when .flush() is called).
 		int StreamConnection::StreamBuffer::sync()
@@ -653,11 +751,23 @@ namespace dtn
 			return traits_type::eof();
 		}
 
-		size_t StreamConnection::StreamBuffer::timeout(ibrcommon::Timer*)
+		size_t StreamConnection::StreamBuffer::timeout(ibrcommon::Timer *timer)
 		{
 			if (__good())
 			{
-				shutdown(StreamDataSegment::MSG_SHUTDOWN_IDLE_TIMEOUT);
+				// the timer runs on the shared timing wheel, never wait for the send lock
+				try {
+					try {
+						ibrcommon::MutexTryLock l(_sendlock);
+						_stream << StreamDataSegment(StreamDataSegment::MSG_SHUTDOWN_IDLE_TIMEOUT) << std::flush;
+					} catch (const ibrcommon::MutexException&) {
+						// another thread is sending, the connection is not idle
+						return timer->getTimeout();
+					}
+				} catch (const std::exception&) {
+					// set failed bit
+					set(STREAM_FAILED);
+				}
 			}
 			throw ibrcommon::Timer::StopTimerException();
 		}
@@ -70,6 +70,11 @@ namespace dtn
 			_buf.keepalive();
 		}
 
+		bool StreamConnection::sendfile(const ibrcommon::File &file, const dtn::data::Length &offset, const dtn::data::Length &length)
+		{
+			return _buf.sendfile(file, offset, length);
+		}
+
 		void StreamConnection::shutdown(ConnectionShutdownCases csc)
 		{
 			if (csc == CONNECTION_SHUTDOWN_SIMPLE_SHUTDOWN)
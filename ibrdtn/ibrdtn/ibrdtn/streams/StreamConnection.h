@@ -32,6 +32,7 @@
 #include <ibrcommon/thread/Timer.h>
 #include <ibrcommon/Exceptions.h>
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/data/File.h>
 #include <iostream>
 #include <streambuf>
 #include <vector>
@@ -201,6 +202,16 @@ namespace dtn
 			 */
 			void keepalive();
 
+			/**
+			 * Write a range of a file as data of the current bundle. The data
+			 * is handed to the kernel without copying it through the stream
+			 * buffers. This is only possible if the connection runs on a plain
+			 * socket stream.
+			 * @return False, if the range has not been written and has to be
+			 * copied through the stream by the caller.
+			 */
+			bool sendfile(const ibrcommon::File &file, const dtn::data::Length &offset, const dtn::data::Length &length);
+
 			/**
 			 * enables the idle timeout thread
 			 * @param seconds
@@ -264,6 +275,11 @@ namespace dtn
 				 */
 				void keepalive();
 
+				/**
+				 * Write a range of a file using sendfile()
+				 */
+				bool sendfile(const ibrcommon::File &file, const dtn::data::Length &offset, const dtn::data::Length &length);
+
 				/**
 				 * Idle timeout timer callback
 				 * @param timer
@@ -317,6 +333,14 @@ namespace dtn
 
 				void skipData(dtn::data::Length &size);
 
+				/**
+				 * Set the begin and end marks of a data segment and put
+				 * it into the queue of segments to acknowledge.
+				 * @return False, if the segment belongs to a skipped
+				 * transmission and must not be sent.
+				 */
+				bool __mark(StreamDataSegment &seg, bool last);
+
 				bool get(const StateBits bit) const;
 				void set(const StateBits bit);
 				void unset(const StateBits bit);
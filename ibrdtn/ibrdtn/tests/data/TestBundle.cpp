@@ -0,0 +1,108 @@
+/*
+ * TestBundle.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "data/TestBundle.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/ScopeControlHopLimitBlock.h>
+#include <ibrcommon/TimeMeasurement.h>
+#include <iostream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TestBundle);
+
+void TestBundle::setUp()
+{
+}
+
+void TestBundle::tearDown()
+{
+}
+
+void TestBundle::copyOnWriteTest(void)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://node-one/app");
+	b.destination = dtn::data::EID("dtn://node-two/app");
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	const dtn::data::Bundle copy = b;
+	CPPUNIT_ASSERT_EQUAL(b.size(), copy.size());
+
+	// the copy shares the blocks of the original
+	CPPUNIT_ASSERT(&(**copy.begin()) == &(**static_cast<const dtn::data::Bundle&>(b).begin()));
+
+	// modifications of the original are not visible in the copy
+	b.push_back<dtn::data::ScopeControlHopLimitBlock>();
+	CPPUNIT_ASSERT_EQUAL(copy.size() + 1, b.size());
+	CPPUNIT_ASSERT(copy.find(dtn::data::ScopeControlHopLimitBlock::BLOCK_TYPE) == copy.end());
+
+	// modifications of a copy are not visible in the original
+	dtn::data::Bundle other = copy;
+	other.erase(other.find(dtn::data::PayloadBlock::BLOCK_TYPE));
+	CPPUNIT_ASSERT_EQUAL(copy.size() - 1, other.size());
+	CPPUNIT_ASSERT(copy.find(dtn::data::PayloadBlock::BLOCK_TYPE) != copy.end());
+	CPPUNIT_ASSERT(b.find(dtn::data::PayloadBlock::BLOCK_TYPE) != b.end());
+}
+
+void TestBundle::clearTest(void)
+{
+	dtn::data::Bundle b;
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	const dtn::data::Size size = b.size();
+
+	dtn::data::Bundle copy = b;
+	copy.clear();
+
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Size(0), copy.size());
+	CPPUNIT_ASSERT_EQUAL(size, b.size());
+}
+
+void TestBundle::copyBenchmark(void)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://node-one/app");
+	b.destination = dtn::data::EID("dtn://node-two/app");
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+	b.push_back<dtn::data::ScopeControlHopLimitBlock>();
+
+	const size_t copies = 1000000;
+
+	ibrcommon::TimeMeasurement tm;
+	dtn::data::Length length = 0;
+
+	tm.start();
+	for (size_t i = 0; i < copies; ++i)
+	{
+		const dtn::data::Bundle copy = b;
+		length += copy.size();
+	}
+	tm.stop();
+
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Length(copies * b.size()), length);
+
+	std::cout << std::endl << b.size() << " blocks: " << static_cast<size_t>(copies / (tm.getMicroseconds() / 1000000.0)) << " copies/s" << std::flush;
+}
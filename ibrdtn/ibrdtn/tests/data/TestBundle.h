@@ -0,0 +1,46 @@
+/*
+ * TestBundle.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef TESTBUNDLE_H_
+#define TESTBUNDLE_H_
+
+class TestBundle : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TestBundle);
+	CPPUNIT_TEST (copyOnWriteTest);
+	CPPUNIT_TEST (clearTest);
+	CPPUNIT_TEST (copyBenchmark);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void copyOnWriteTest(void);
+	void clearTest(void);
+	void copyBenchmark(void);
+};
+
+#endif /* TESTBUNDLE_H_ */
@@ -0,0 +1,120 @@
+/*
+ * TestBundleMerger.cpp
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "data/TestBundleMerger.h"
+#include <ibrdtn/data/BundleMerger.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/EID.h>
+#include <set>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TestBundleMerger);
+
+void TestBundleMerger::setUp()
+{
+}
+
+void TestBundleMerger::tearDown()
+{
+}
+
+dtn::data::Bundle TestBundleMerger::createFragment(const std::string &payload, size_t offset, size_t length)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://node/test");
+	b.destination = dtn::data::EID("dtn://dest/test");
+	b.timestamp = 42;
+	b.sequencenumber = 23;
+
+	b.set(dtn::data::PrimaryBlock::FRAGMENT, true);
+	b.fragmentoffset = offset;
+	b.appdatalength = payload.length();
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	{
+		ibrcommon::BLOB::iostream stream = ref.iostream();
+		(*stream) << payload.substr(offset, length);
+	}
+	b.push_back(ref);
+
+	return b;
+}
+
+std::string TestBundleMerger::getPayload(const dtn::data::Bundle &b)
+{
+	ibrcommon::BLOB::Reference ref = b.find<dtn::data::PayloadBlock>().getBLOB();
+	ibrcommon::BLOB::iostream stream = ref.iostream();
+
+	std::stringstream ss;
+	ss << (*stream).rdbuf();
+	return ss.str();
+}
+
+void TestBundleMerger::mergeTest(void)
+{
+	std::string payload;
+	for (int i = 0; i < 1000; ++i) payload.push_back(static_cast<char>('a' + (i % 26)));
+
+	dtn::data::BundleMerger::Container c = dtn::data::BundleMerger::getContainer();
+
+	// merge the fragments in reverse order
+	c << createFragment(payload, 900, 100);
+	c << createFragment(payload, 300, 600);
+	CPPUNIT_ASSERT(!c.isComplete());
+	c << createFragment(payload, 0, 300);
+	CPPUNIT_ASSERT(c.isComplete());
+
+	dtn::data::Bundle &merged = c.getBundle();
+	CPPUNIT_ASSERT(!merged.get(dtn::data::PrimaryBlock::FRAGMENT));
+	CPPUNIT_ASSERT_EQUAL(payload, getPayload(merged));
+}
+
+void TestBundleMerger::overlapTest(void)
+{
+	std::string payload;
+	for (int i = 0; i < 10000; ++i) payload.push_back(static_cast<char>('0' + (i % 10)));
+
+	dtn::data::BundleMerger::Container c = dtn::data::BundleMerger::getContainer();
+
+	// overlapping fragments with gaps which are filled afterwards
+	c << createFragment(payload, 2000, 3000);
+	c << createFragment(payload, 6000, 4000);
+	c << createFragment(payload, 1000, 8000);
+	c << createFragment(payload, 3000, 1000);
+	CPPUNIT_ASSERT(!c.isComplete());
+	c << createFragment(payload, 0, 1500);
+	CPPUNIT_ASSERT(c.isComplete());
+
+	CPPUNIT_ASSERT_EQUAL(payload, getPayload(c.getBundle()));
+}
+
+void TestBundleMerger::completeTest(void)
+{
+	std::set<dtn::data::BundleMerger::Chunk> chunks;
+	chunks.insert(dtn::data::BundleMerger::Chunk(0, 100));
+	chunks.insert(dtn::data::BundleMerger::Chunk(10, 20));
+
+	// a chunk contained in a previous one must not hide the gap
+	CPPUNIT_ASSERT(!dtn::data::BundleMerger::Chunk::isComplete(200, chunks));
+
+	chunks.insert(dtn::data::BundleMerger::Chunk(100, 100));
+	CPPUNIT_ASSERT(dtn::data::BundleMerger::Chunk::isComplete(200, chunks));
+}
@@ -0,0 +1,52 @@
+/*
+ * TestBundleMerger.h
+ *
+ * Copyright (C) 2026 IBR, TU Braunschweig
+ *
+ * Written-by: agent <agent@local>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <ibrdtn/data/Bundle.h>
+#include <string>
+
+#ifndef TESTBUNDLEMERGER_H_
+#define TESTBUNDLEMERGER_H_
+
+class TestBundleMerger : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TestBundleMerger);
+	CPPUNIT_TEST (mergeTest);
+	CPPUNIT_TEST (overlapTest);
+	CPPUNIT_TEST (completeTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void mergeTest(void);
+	void overlapTest(void);
+	void completeTest(void);
+
+private:
+	static dtn::data::Bundle createFragment(const std::string &payload, size_t offset, size_t length);
+	static std::string getPayload(const dtn::data::Bundle &b);
+};
+
+#endif /* TESTBUNDLEMERGER_H_ */
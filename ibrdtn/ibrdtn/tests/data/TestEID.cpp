@@ -87,3 +87,39 @@ void TestEID::testCBHEHost(void)
 	CPPUNIT_ASSERT_EQUAL(std::string("12"), a.getHost());
 	CPPUNIT_ASSERT_EQUAL(std::string("ipn:12.0"), a.getNode().getString());
 }
+
+void TestEID::testInterning(void)
+{
+	const size_t count = dtn::data::EID::getInternedCount();
+
+	{
+		dtn::data::EID a("dtn://interning-test/app");
+		dtn::data::EID b("dtn", "//interning-test/app");
+		dtn::data::EID c = a.getNode();
+		c.setApplication("app");
+
+		// all of them share the same entry
+		CPPUNIT_ASSERT(a == b);
+		CPPUNIT_ASSERT(a == c);
+		CPPUNIT_ASSERT_EQUAL(a.hash(), c.hash());
+		CPPUNIT_ASSERT(!(a < c) && !(c < a));
+
+		// the node entry has been released by setApplication()
+		CPPUNIT_ASSERT_EQUAL(count + 1, dtn::data::EID::getInternedCount());
+
+		// assignment replaces the referenced entry
+		c = dtn::data::EID("dtn://interning-test/other");
+		CPPUNIT_ASSERT(a != c);
+		CPPUNIT_ASSERT(a < c);
+		CPPUNIT_ASSERT_EQUAL(std::string("dtn://interning-test/other"), c.getString());
+		CPPUNIT_ASSERT_EQUAL(std::string("dtn://interning-test/app"), b.getString());
+	}
+
+	// unreferenced entries are removed from the table
+	CPPUNIT_ASSERT_EQUAL(count, dtn::data::EID::getInternedCount());
+
+	// invalid EIDs and zero CBHE nodes refer to dtn:none
+	CPPUNIT_ASSERT(dtn::data::EID("invalid") == dtn::data::EID());
+	CPPUNIT_ASSERT(dtn::data::EID(0, 1) == dtn::data::EID());
+	CPPUNIT_ASSERT(dtn::data::EID().isNone());
+}
@@ -34,6 +34,7 @@ class TestEID : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST (testCBHEConstructorSchemeSsp);
 	CPPUNIT_TEST (testCBHEEquals);
 	CPPUNIT_TEST (testCBHEHost);
+	CPPUNIT_TEST (testInterning);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -47,6 +48,7 @@ protected:
 	void testCBHEConstructorSchemeSsp(void);
 	void testCBHEEquals(void);
 	void testCBHEHost(void);
+	void testInterning(void);
 
 };
 
@@ -30,6 +30,7 @@
 #include <ibrdtn/data/AgeBlock.h>
 #include <ibrdtn/data/ScopeControlHopLimitBlock.h>
 #include <ibrdtn/data/BundleBuilder.h>
+#include <ibrcommon/TimeMeasurement.h>
 #include <iostream>
 #include <sstream>
 
@@ -400,3 +401,104 @@ void TestSerializer::serializer_outin_structure(void)
 	CPPUNIT_ASSERT_NO_THROW( b2.find<dtn::data::AgeBlock>() );
 	CPPUNIT_ASSERT_NO_THROW( b2.find<dtn::data::ScopeControlHopLimitBlock>() );
 }
+
+/**
+ * create a bundle with a number of extension blocks carrying EIDs
+ */
+static void createEIDBundle(dtn::data::Bundle &b, size_t blocks, size_t eids)
+{
+	b.source = dtn::data::EID("dtn://node1/app1");
+	b.destination = dtn::data::EID("dtn://node2/app2");
+	b.reportto = dtn::data::EID("dtn://node3/report");
+	b.lifetime = 3600;
+	b.timestamp = 12345678;
+	b.sequencenumber = 1234;
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	(*ref.iostream()) << "hello world" << std::flush;
+	b.push_back(ref);
+
+	for (size_t i = 0; i < blocks; ++i)
+	{
+		dtn::data::Block &block = b.push_front<dtn::data::ScopeControlHopLimitBlock>();
+
+		for (size_t j = 0; j < eids; ++j)
+		{
+			std::stringstream ss;
+			ss << "dtn://node-" << i << "/app-" << j;
+			block.addEID(dtn::data::EID(ss.str()));
+		}
+	}
+}
+
+void TestSerializer::serializer_dictionary_reuse(void)
+{
+	dtn::data::Bundle b1, b2;
+	createEIDBundle(b1, 4, 4);
+	createEIDBundle(b2, 2, 2);
+
+	std::stringstream ss1, ss2;
+	dtn::data::DefaultSerializer(ss1) << b1;
+	dtn::data::DefaultSerializer(ss2) << b2;
+
+	// a serializer reused for several bundles has to produce the same output
+	std::stringstream ss;
+	dtn::data::DefaultSerializer ds(ss);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)ss1.str().length(), ds.getLength(b1));
+	ds << b1;
+	CPPUNIT_ASSERT_EQUAL((size_t)ss2.str().length(), ds.getLength(b2));
+	ds << b2;
+
+	CPPUNIT_ASSERT(ss.str() == (ss1.str() + ss2.str()));
+
+	// the EIDs have to survive a round-trip
+	dtn::data::Bundle b3;
+	dtn::data::DefaultDeserializer(ss1) >> b3;
+
+	CPPUNIT_ASSERT(b1.reportto == b3.reportto);
+	CPPUNIT_ASSERT_EQUAL(b1.size(), b3.size());
+
+	dtn::data::Bundle::const_iterator it3 = b3.begin();
+	for (dtn::data::Bundle::const_iterator it1 = b1.begin(); it1 != b1.end(); ++it1, ++it3)
+	{
+		CPPUNIT_ASSERT((**it1).getEIDList() == (**it3).getEIDList());
+	}
+}
+
+void TestSerializer::serializer_benchmark(void)
+{
+	const size_t rounds = 2000;
+
+	dtn::data::Bundle b;
+	createEIDBundle(b, 16, 4);
+
+	ibrcommon::TimeMeasurement tm;
+	std::string data;
+
+	tm.start();
+	for (size_t i = 0; i < rounds; ++i)
+	{
+		std::stringstream ss;
+		dtn::data::DefaultSerializer ds(ss);
+		ds.getLength(b);
+		ds << b;
+		if (i == 0) data = ss.str();
+	}
+	tm.stop();
+
+	const double ser = static_cast<double>(tm.getMicroseconds()) / static_cast<double>(rounds);
+
+	tm.start();
+	for (size_t i = 0; i < rounds; ++i)
+	{
+		std::stringstream ss(data);
+		dtn::data::Bundle b2;
+		dtn::data::DefaultDeserializer(ss) >> b2;
+	}
+	tm.stop();
+
+	const double deser = static_cast<double>(tm.getMicroseconds()) / static_cast<double>(rounds);
+
+	std::cout << std::endl << "bundle with 64 extension block EIDs: serialize " << ser << " us, deserialize " << deser << " us" << std::flush;
+}
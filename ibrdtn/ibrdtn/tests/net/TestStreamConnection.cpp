@@ -30,6 +30,11 @@
 #include <ibrcommon/thread/Thread.h>
 #include <ibrdtn/data/Serializer.h>
 #include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/data/File.h>
+#include <ibrdtn/data/BundleFragment.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <fstream>
+#include <sstream>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (TestStreamConnection);
 
@@ -257,3 +262,130 @@ void TestStreamConnection::connectionUpDown()
 	CPPUNIT_ASSERT_EQUAL((unsigned int) 2000, srv.recv_bundles);
 }
 
+
+void TestStreamConnection::fileTransfer()
+{
+	class receiver : public ibrcommon::JoinableThread, dtn::streams::StreamConnection::Callback
+	{
+	private:
+		ibrcommon::tcpserversocket _server;
+
+	public:
+		receiver(int port) : _server(port)
+		{
+			_server.up();
+		}
+
+		virtual ~receiver() {
+			join();
+			_server.down();
+		};
+
+		void __cancellation() throw () { }
+
+		void eventShutdown(dtn::streams::StreamConnection::ConnectionShutdownCases) throw () {};
+		void eventTimeout() throw () {};
+		void eventError() throw () {};
+		void eventBundleRefused() throw () {};
+		void eventBundleForwarded() throw () {};
+		void eventBundleAck(const dtn::data::Length&) throw () {};
+		void eventConnectionUp(const dtn::streams::StreamContactHeader&) throw () {};
+		void eventConnectionDown() throw () {};
+
+		std::vector<dtn::data::Bundle> bundles;
+
+	protected:
+		void run() throw ()
+		{
+			try {
+				ibrcommon::vaddress peeraddr;
+				ibrcommon::socketstream conn(_server.accept(peeraddr));
+				dtn::streams::StreamConnection stream(*this, conn);
+
+				stream.handshake(dtn::data::EID("dtn:server"), 0, dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS);
+
+				for (int i = 0; i < 2; ++i)
+				{
+					dtn::data::Bundle b;
+					dtn::data::DefaultDeserializer(stream) >> b;
+					bundles.push_back(b);
+				}
+			} catch (const std::exception&) { }
+		}
+	};
+
+	class sender : public dtn::streams::StreamConnection::Callback
+	{
+	public:
+		sender() : segments(0) { }
+
+		void eventShutdown(dtn::streams::StreamConnection::ConnectionShutdownCases) throw () {};
+		void eventTimeout() throw () {};
+		void eventError() throw () {};
+		void eventBundleRefused() throw () {};
+		void eventBundleForwarded() throw () {};
+		void eventBundleAck(const dtn::data::Length&) throw () {};
+		void eventConnectionUp(const dtn::streams::StreamContactHeader&) throw () {};
+		void eventConnectionDown() throw () {};
+		void addTrafficOut(size_t) throw () { segments++; };
+
+		size_t segments;
+	};
+
+	// create a payload file larger than one sendfile segment
+	ibrcommon::TemporaryFile file(ibrcommon::File("/tmp"), "sendfile");
+	std::string data;
+	{
+		std::stringstream ss;
+		for (size_t i = 0; ss.tellp() < 0x180000; ++i) ss << i << ";";
+		data = ss.str();
+
+		std::ofstream fs(file.getPath().c_str(), std::ios::out | std::ios::binary);
+		fs << data;
+	}
+
+	receiver srv(1235);
+	srv.start();
+
+	sender cb;
+	ibrcommon::vaddress addr("127.0.0.1", 1235);
+	ibrcommon::socketstream conn(new ibrcommon::tcpsocket(addr));
+	dtn::streams::StreamConnection stream(cb, conn);
+	stream.handshake(dtn::data::EID("dtn:client"), 0, dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS);
+
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://client/test");
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::open(file);
+	b.push_back(ref);
+
+	// send the whole bundle and a fragment resuming at an offset
+	dtn::data::DefaultSerializer(stream) << b;
+	stream << std::flush;
+	dtn::data::DefaultSerializer(stream) << dtn::data::BundleFragment(b, 1000, -1);
+	stream << std::flush;
+
+	srv.join();
+	conn.close();
+	file.remove();
+
+	// the payload is not split into segments of the stream buffer size
+	CPPUNIT_ASSERT(cb.segments < 16);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)2, srv.bundles.size());
+
+	const dtn::data::Length offsets[] = { 0, 1000 };
+	for (size_t i = 0; i < 2; ++i)
+	{
+		const dtn::data::Bundle &rb = srv.bundles[i];
+		const dtn::data::PayloadBlock &p = rb.find<dtn::data::PayloadBlock>();
+		ibrcommon::BLOB::Reference ref = p.getBLOB();
+		ibrcommon::BLOB::iostream io = ref.iostream();
+
+		std::stringstream ss;
+		ss << (*io).rdbuf();
+
+		CPPUNIT_ASSERT_EQUAL(b.source.getString(), rb.source.getString());
+		CPPUNIT_ASSERT_EQUAL(offsets[i], rb.fragmentoffset.get<dtn::data::Length>());
+		CPPUNIT_ASSERT(data.substr(offsets[i]) == ss.str());
+	}
+}
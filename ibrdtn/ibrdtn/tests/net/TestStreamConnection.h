@@ -29,6 +29,7 @@ class TestStreamConnection : public CPPUNIT_NS :: TestFixture
 {
 	CPPUNIT_TEST_SUITE (TestStreamConnection);
 	CPPUNIT_TEST (connectionUpDown);
+	CPPUNIT_TEST (fileTransfer);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -37,6 +38,7 @@ public:
 
 protected:
 	void connectionUpDown(void);
+	void fileTransfer(void);
 };
 
 
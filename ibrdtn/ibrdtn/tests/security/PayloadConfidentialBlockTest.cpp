@@ -26,8 +26,11 @@
 #include <ibrdtn/data/EID.h>
 #include <ibrdtn/data/PayloadBlock.h>
 #include <ibrcommon/data/File.h>
+#include <ibrcommon/TimeMeasurement.h>
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <cstdlib>
+#include <iostream>
 #include <sstream>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (PayloadConfidentialBlockTest);
@@ -217,3 +220,137 @@ void PayloadConfidentialBlockTest::decrypt(const dtn::security::SecurityKey &pub
 		throw ibrcommon::Exception("decryption failed!");
 	}
 }
+
+void PayloadConfidentialBlockTest::sessionKeyTest(void)
+{
+	dtn::security::SecurityKey pubkey;
+	pubkey.type = dtn::security::SecurityKey::KEY_PUBLIC;
+	pubkey.file = ibrcommon::File("test-key.pem");
+	pubkey.reference = dtn::data::EID("dtn://test");
+
+	dtn::security::SecurityKey pkey;
+	pkey.type = dtn::security::SecurityKey::KEY_PRIVATE;
+	pkey.file = ibrcommon::File("test-key.pem");
+	pkey.reference = pubkey.reference;
+
+	// one session key for several bundles
+	const dtn::security::PayloadConfidentialBlock::SessionKey session(pubkey);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://source/test");
+		b.destination = pubkey.reference;
+
+		dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << _testdata << std::flush;
+
+		dtn::security::PayloadConfidentialBlock::encrypt(b, pubkey, session, b.source);
+		CPPUNIT_ASSERT_EQUAL((size_t)2, b.size());
+
+		dtn::security::PayloadConfidentialBlock::decrypt(b, pkey);
+		CPPUNIT_ASSERT_EQUAL((size_t)1, b.size());
+
+		ibrcommon::BLOB::iostream stream = b.find<dtn::data::PayloadBlock>().getBLOB().iostream();
+		std::stringstream ss; ss << (*stream).rdbuf();
+		CPPUNIT_ASSERT(ss.str() == _testdata);
+	}
+}
+
+void PayloadConfidentialBlockTest::payloadSizesTest(void)
+{
+	dtn::security::SecurityKey pubkey;
+	pubkey.type = dtn::security::SecurityKey::KEY_PUBLIC;
+	pubkey.file = ibrcommon::File("test-key.pem");
+	pubkey.reference = dtn::data::EID("dtn://test");
+
+	dtn::security::SecurityKey pkey;
+	pkey.type = dtn::security::SecurityKey::KEY_PRIVATE;
+	pkey.file = ibrcommon::File("test-key.pem");
+	pkey.reference = pubkey.reference;
+
+	const dtn::security::PayloadConfidentialBlock::SessionKey session(pubkey);
+
+	// payloads within one chunk and across several chunks of the cipher stream
+	const size_t sizes[] = { 1024, 65536, 1048576 };
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		const std::string data(sizes[i], 'x');
+
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://source/test");
+		b.destination = pubkey.reference;
+
+		dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << data << std::flush;
+
+		dtn::security::PayloadConfidentialBlock::encrypt(b, pubkey, session, b.source);
+		CPPUNIT_ASSERT_EQUAL((size_t)2, b.size());
+
+		dtn::security::PayloadConfidentialBlock::decrypt(b, pkey);
+		CPPUNIT_ASSERT_EQUAL((size_t)1, b.size());
+
+		ibrcommon::BLOB::iostream stream = b.find<dtn::data::PayloadBlock>().getBLOB().iostream();
+		std::stringstream ss; ss << (*stream).rdbuf();
+		CPPUNIT_ASSERT(ss.str() == data);
+	}
+}
+
+void PayloadConfidentialBlockTest::benchmarkTest(void)
+{
+	std::cout << std::endl;
+
+	benchmark(1024, 200);
+	benchmark(65536, 50);
+	benchmark(1048576, 10);
+
+	// the largest payload takes too long for every run, set
+	// IBRDTN_BENCHMARK_LARGE in the environment to include it
+	if (::getenv("IBRDTN_BENCHMARK_LARGE") != NULL)
+		benchmark(104857600, 1);
+}
+
+void PayloadConfidentialBlockTest::benchmark(size_t size, size_t rounds)
+{
+	dtn::security::SecurityKey pubkey;
+	pubkey.type = dtn::security::SecurityKey::KEY_PUBLIC;
+	pubkey.file = ibrcommon::File("test-key.pem");
+	pubkey.reference = dtn::data::EID("dtn://test");
+
+	dtn::security::SecurityKey pkey;
+	pkey.type = dtn::security::SecurityKey::KEY_PRIVATE;
+	pkey.file = ibrcommon::File("test-key.pem");
+	pkey.reference = pubkey.reference;
+
+	const dtn::security::PayloadConfidentialBlock::SessionKey session(pubkey);
+
+	const std::string data(size, 'x');
+	double enc = 0, dec = 0;
+
+	for (size_t r = 0; r < rounds; ++r)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://source/test");
+		b.destination = pubkey.reference;
+
+		dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << data << std::flush;
+
+		ibrcommon::TimeMeasurement tm;
+
+		tm.start();
+		dtn::security::PayloadConfidentialBlock::encrypt(b, pubkey, session, b.source);
+		tm.stop();
+		enc += static_cast<double>(tm.getMicroseconds());
+
+		tm.start();
+		dtn::security::PayloadConfidentialBlock::decrypt(b, pkey);
+		tm.stop();
+		dec += static_cast<double>(tm.getMicroseconds());
+	}
+
+	// bytes per microsecond equals MB/s
+	const double bytes = static_cast<double>(size) * static_cast<double>(rounds);
+	std::cout << "payload of " << size << " bytes: encrypt " << (bytes / enc) << " MB/s, decrypt " << (bytes / dec) << " MB/s" << std::endl;
+}
@@ -34,6 +34,9 @@ class PayloadConfidentialBlockTest : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST_SUITE (PayloadConfidentialBlockTest);
 	CPPUNIT_TEST (encryptTest);
 	CPPUNIT_TEST (decryptTest);
+	CPPUNIT_TEST (sessionKeyTest);
+	CPPUNIT_TEST (payloadSizesTest);
+	CPPUNIT_TEST (benchmarkTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -43,8 +46,13 @@ public:
 protected:
 	void encryptTest(void);
 	void decryptTest(void);
+	void sessionKeyTest(void);
+	void payloadSizesTest(void);
+	void benchmarkTest(void);
 
 private:
+	void benchmark(size_t size, size_t rounds);
+
 	void encrypt(const dtn::security::SecurityKey &pubkey, dtn::data::Bundle &b);
 	void decrypt(const dtn::security::SecurityKey &pubkey, dtn::data::Bundle &b);
 	std::string getHex(std::istream &stream);
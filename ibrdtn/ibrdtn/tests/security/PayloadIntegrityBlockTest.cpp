@@ -26,8 +26,11 @@
 #include <ibrdtn/data/EID.h>
 #include <ibrdtn/data/PayloadBlock.h>
 #include <ibrcommon/data/File.h>
+#include <ibrcommon/TimeMeasurement.h>
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <cstdlib>
+#include <iostream>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (PayloadIntegrityBlockTest);
 
@@ -163,3 +166,70 @@ void PayloadIntegrityBlockTest::verifyCompromisedTest(void)
 
 	CPPUNIT_ASSERT_THROW(dtn::security::PayloadIntegrityBlock::verify(recv_b, pubkey), dtn::security::VerificationFailedException);
 }
+
+void PayloadIntegrityBlockTest::payloadSizesTest(void)
+{
+	// payloads within one chunk and across several chunks of the digest
+	const size_t sizes[] = { 1024, 65536, 1048576 };
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		const std::string data(sizes[i], 'x');
+
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://test");
+		b.destination = pubkey.reference;
+
+		dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << data << std::flush;
+
+		dtn::security::PayloadIntegrityBlock::sign(b, pkey, pkey.reference);
+		dtn::security::PayloadIntegrityBlock::verify(b, pubkey);
+	}
+}
+
+void PayloadIntegrityBlockTest::benchmarkTest(void)
+{
+	std::cout << std::endl;
+
+	benchmark(1024, 200);
+	benchmark(65536, 50);
+	benchmark(1048576, 10);
+
+	// the largest payload takes too long for every run, set
+	// IBRDTN_BENCHMARK_LARGE in the environment to include it
+	if (::getenv("IBRDTN_BENCHMARK_LARGE") != NULL)
+		benchmark(104857600, 1);
+}
+
+void PayloadIntegrityBlockTest::benchmark(size_t size, size_t rounds)
+{
+	const std::string data(size, 'x');
+	double sign = 0, verify = 0;
+
+	for (size_t r = 0; r < rounds; ++r)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://test");
+		b.destination = pubkey.reference;
+
+		dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << data << std::flush;
+
+		ibrcommon::TimeMeasurement tm;
+
+		tm.start();
+		dtn::security::PayloadIntegrityBlock::sign(b, pkey, pkey.reference);
+		tm.stop();
+		sign += static_cast<double>(tm.getMicroseconds());
+
+		tm.start();
+		dtn::security::PayloadIntegrityBlock::verify(b, pubkey);
+		tm.stop();
+		verify += static_cast<double>(tm.getMicroseconds());
+	}
+
+	// bytes per microsecond equals MB/s
+	const double bytes = static_cast<double>(size) * static_cast<double>(rounds);
+	std::cout << "payload of " << size << " bytes: sign " << (bytes / sign) << " MB/s, verify " << (bytes / verify) << " MB/s" << std::endl;
+}
@@ -34,6 +34,8 @@ class PayloadIntegrityBlockTest : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST (verifyTest);
 	CPPUNIT_TEST (verifySkipTest);
 	CPPUNIT_TEST (verifyCompromisedTest);
+	CPPUNIT_TEST (payloadSizesTest);
+	CPPUNIT_TEST (benchmarkTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -45,8 +47,12 @@ protected:
 	void verifyTest(void);
 	void verifySkipTest(void);
 	void verifyCompromisedTest(void);
+	void payloadSizesTest(void);
+	void benchmarkTest(void);
 
 private:
+	void benchmark(size_t size, size_t rounds);
+
 	dtn::security::SecurityKey pubkey;
 	dtn::security::SecurityKey pkey;
 